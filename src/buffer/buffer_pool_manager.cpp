@@ -20,6 +20,7 @@ BufferPoolManager::~BufferPoolManager() {
 }
 
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   if (page_id == INVALID_PAGE_ID) return nullptr;
   // this page is already inside the page table.
   if (page_table_.count(page_id)) {
@@ -58,6 +59,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
 }
 
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   frame_id_t frame_id = INVALID_FRAME_ID;
   if (!free_list_.empty()) {
     frame_id = free_list_.front();
@@ -94,7 +96,12 @@ Page *BufferPoolManager::NewPage(page_id_t &page_id) {
 }
 
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
-  if (!page_table_.count(page_id)) return true;
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if (!page_table_.count(page_id)) {
+    // not buffered, only the disk manager knows it
+    DeallocatePage(page_id);
+    return true;
+  }
   frame_id_t frame_of_page = page_table_[page_id];
   if (pages_[frame_of_page].GetPinCount() != 0) return false;
 
@@ -142,6 +149,7 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
 }
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   //  size_t cnt = 0;
   //  for (Page *p = pages_; cnt < pool_size_; ++p, ++cnt) {
   //    if (p->page_id_ == page_id)  // find the page to be unpinned
@@ -178,6 +186,7 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   if (page_table_.count(page_id)) {
     disk_manager_->WritePage(page_id, pages_[page_table_[page_id]].GetData());
     return true;
@@ -120,25 +120,29 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
   {
     //initialize metadata
     catalog_meta_ = CatalogMeta::NewInstance(heap_);
+    next_table_id_ = 0;
+    next_index_id_ = 0;
   }
 
   else // load tableinfo and indexinfo
   {
     // Deserialize catalog meta
     char* buf = buffer_pool_manager->FetchPage(CATALOG_META_PAGE_ID)->GetData();
-    CatalogMeta * Catalog_meta_ = CatalogMeta::DeserializeFrom(buf, heap_);
+    catalog_meta_ = CatalogMeta::DeserializeFrom(buf, heap_);
     buffer_pool_manager->UnpinPage(CATALOG_META_PAGE_ID, false);
+    next_table_id_ = catalog_meta_->GetNextTableId();
+    next_index_id_ = catalog_meta_->GetNextIndexId();
 
     // load tableinfo first
-    auto table_meta_it = Catalog_meta_->table_meta_pages_.begin();
-    for (; table_meta_it != Catalog_meta_->table_meta_pages_.end(); ++table_meta_it)
+    auto table_meta_it = catalog_meta_->table_meta_pages_.begin();
+    for (; table_meta_it != catalog_meta_->table_meta_pages_.end(); ++table_meta_it)
     {
       LoadTable(table_meta_it->first, table_meta_it->second);
     }
 
     // load indexinfo
-    auto index_info_it = Catalog_meta_->index_meta_pages_.begin();
-    for (; index_info_it != Catalog_meta_->index_meta_pages_.end(); ++index_info_it)
+    auto index_info_it = catalog_meta_->index_meta_pages_.begin();
+    for (; index_info_it != catalog_meta_->index_meta_pages_.end(); ++index_info_it)
     {
       LoadIndex(index_info_it->first, index_info_it->second);
     }
@@ -147,6 +151,8 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
 
 CatalogManager::~CatalogManager() {
 
+  FlushIndexFilters();
+  FlushTableMetas();
   FlushCatalogMetaPage();
   /*
   // Serialize new catalog meta to the CATALOG_META_PAGE
@@ -168,7 +174,8 @@ CatalogManager::~CatalogManager() {
 }
 
 dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema,
-                                    Transaction *txn, TableInfo *&table_info) {
+                                    Transaction *txn, TableInfo *&table_info, TableLayout layout,
+                                    const std::vector<uint32_t> &cluster_key) {
   // whether the table exists
   auto exists = table_names_.find(table_name);
 
@@ -177,6 +184,16 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     return DB_TABLE_ALREADY_EXIST;
   }
 
+  else if (layout == TableLayout::kColumn && ColumnPageLayout(schema).GetCapacity() == 0) // rows too wide
+  {
+    return DB_FAILED;
+  }
+
+  else if (layout != TableLayout::kRow && !cluster_key.empty()) // only rows are clustered
+  {
+    return DB_FAILED;
+  }
+
   else // not exist
   {
     // get table id and add to table names map
@@ -184,10 +201,12 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     table_names_[table_name] = table_id;
 
     // create new table heap
-    TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, schema, txn, log_manager_, lock_manager_, heap_);
+    TableHeap *table_heap =
+        TableHeap::Create(buffer_pool_manager_, schema, txn, log_manager_, lock_manager_, heap_, layout, cluster_key);
 
     // create table metadata
-    auto tmd = TableMetadata::Create(table_id, table_name, table_heap->GetFirstPageId(), schema, heap_);
+    auto tmd = TableMetadata::Create(table_id, table_name, table_heap->GetFirstPageId(), table_heap->GetFsmPageId(),
+                                     schema, heap_, layout, cluster_key);
 
     // get a new page to store table meta
     page_id_t pid;
@@ -199,6 +218,8 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     // write table metadata to the page
     char *buf = reinterpret_cast<char *>(heap_->Allocate(PAGE_SIZE));
 
+    // zeroed, nothing behind the metadata is taken for statistics
+    memset(buf, 0, PAGE_SIZE);
     tmd->SerializeTo(buf);
   
     /*char buf_[PAGE_SIZE];
@@ -208,7 +229,7 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     }*/
 
     table_meta_page->SetData(buf);
-    buffer_pool_manager_->UnpinPage(pid, false);
+    buffer_pool_manager_->UnpinPage(pid, true);
 
     // create and initialize table info
     table_info = TableInfo::Create(heap_);
@@ -222,6 +243,7 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     
     // add to tables map
     tables_[table_id] = table_info;
+    table_heap->SetRootCallback([this, table_id](const TableHeap *) { FlushTableMeta(table_id); });
 
     // update CatalogMetaPage
     SerializeToCatalogMetaPage();
@@ -371,7 +393,7 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   }*/
 
   page->SetData(buf);
-  buffer_pool_manager_->UnpinPage(page_id, false);
+  buffer_pool_manager_->UnpinPage(page_id, true);
 
   // update CatalogMetaPage
   SerializeToCatalogMetaPage();
@@ -445,6 +467,9 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   {
     table_id_t table_id = table_it->second;
 
+    // give back the pinned insertion target
+    tables_[table_id]->GetTableHeap()->ReleaseInsertPage();
+
     // delete in the table names map
     table_names_.erase(table_name);
 
@@ -489,13 +514,18 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
 
   else // drop index
   {
+    index_id_t index_id = index_it->second;
     tables_indexes_it->second.erase(index_it);
-    indexes_.erase(index_it->second);
+
+    // free the pages of the tree
+    indexes_[index_id]->GetIndex()->Destroy();
+    indexes_.erase(index_id);
 
     // delete the page
 
     // get page id
-    page_id_t page_id = catalog_meta_->index_meta_pages_[index_it->second];
+    page_id_t page_id = catalog_meta_->index_meta_pages_[index_id];
+    catalog_meta_->index_meta_pages_.erase(index_id);
 
     // delete
     buffer_pool_manager_->DeletePage(page_id);
@@ -509,6 +539,46 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
   return DB_FAILED;
 }
 
+dberr_t CatalogManager::AnalyzeTable(const string &table_name, TableStatistics *&statistics) {
+  auto table_names_it = table_names_.find(table_name);
+  if (table_names_it == table_names_.end())
+  {
+    return DB_TABLE_NOT_EXIST;
+  }
+  TableInfo *table_info = tables_[table_names_it->second];
+  page_id_t page_id = catalog_meta_->table_meta_pages_[table_names_it->second];
+
+  statistics = table_info->GetStatistics();
+  if (statistics == nullptr)
+  {
+    statistics = TableStatistics::Create(table_info->GetMemHeap());
+    table_info->SetStatistics(statistics);
+  }
+  statistics->Collect(table_info->GetTableHeap());
+
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr)
+  {
+    return DB_FAILED;
+  }
+  // the metadata is written again, metadata of an older format is shorter than the current one
+  TableMetadata *table_meta = table_info->GetMetaData();
+  table_meta->SyncWithHeap(table_info->GetTableHeap());
+  uint32_t ofs = table_meta->SerializeTo(page->GetData());
+  if (statistics->Shrink(PAGE_SIZE - ofs))
+  {
+    statistics->SerializeTo(page->GetData() + ofs);
+  }
+  else
+  {
+    // too wide a table keeps its statistics in memory only
+    memset(page->GetData() + ofs, 0, PAGE_SIZE - ofs);
+  }
+  buffer_pool_manager_->UnpinPage(page_id, true);
+
+  return DB_SUCCESS;
+}
+
 dberr_t CatalogManager::SerializeToCatalogMetaPage() const {
   // Serialize new catalog meta to the CATALOG_META_PAGE
     
@@ -522,16 +592,20 @@ dberr_t CatalogManager::SerializeToCatalogMetaPage() const {
     // write data to the page
     catalog_meta_page->SetData(buf);
 
-    // unpin the page
-    buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, false);
+    // unpin the page, it has to be written back if it gets evicted
+    buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, true);
 
     return DB_SUCCESS;
 }
 
 dberr_t CatalogManager::FlushCatalogMetaPage() const {
   
-  bool b = buffer_pool_manager_->FlushPage(CATALOG_META_PAGE_ID);
+  // the page may have been evicted by a large statement, only a page in the pool can be flushed
+  [[maybe_unused]] Page *catalog_meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
+  ASSERT(catalog_meta_page != nullptr, "CatalogMetaPage Not Fetched");
+  [[maybe_unused]] bool b = buffer_pool_manager_->FlushPage(CATALOG_META_PAGE_ID);
   ASSERT(b, "CatalogMetaPage Pinned");
+  buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, false);
   
   /*
   // flush table meta pages
@@ -556,6 +630,70 @@ dberr_t CatalogManager::FlushCatalogMetaPage() const {
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::FlushIndexFilters() const
+{
+  // the filter of each index lives right behind its metadata
+  for (auto &it : indexes_)
+  {
+    auto meta_page_it = catalog_meta_->index_meta_pages_.find(it.first);
+    if (meta_page_it == catalog_meta_->index_meta_pages_.end())
+    {
+      continue;
+    }
+    IndexInfo *index_info = it.second;
+    Page *page = buffer_pool_manager_->FetchPage(meta_page_it->second);
+    if (page == nullptr)
+    {
+      return DB_FAILED;
+    }
+    index_info->GetFilter()->SerializeTo(page->GetData() + index_info->GetMetaData()->GetSerializedSize(),
+                                         buffer_pool_manager_);
+    buffer_pool_manager_->UnpinPage(meta_page_it->second, true);
+  }
+
+  return DB_SUCCESS;
+}
+
+dberr_t CatalogManager::FlushTableMetas() const
+{
+  for (auto &it : tables_)
+  {
+    // every heap gives back its insertion target, tables without a meta page too
+    it.second->GetTableHeap()->ReleaseInsertPage();
+    if (FlushTableMeta(it.first) != DB_SUCCESS)
+    {
+      return DB_FAILED;
+    }
+  }
+
+  return DB_SUCCESS;
+}
+
+dberr_t CatalogManager::FlushTableMeta(const table_id_t table_id) const
+{
+  // the table heap may have moved its first page or built a free space map
+  auto meta_page_it = catalog_meta_->table_meta_pages_.find(table_id);
+  if (meta_page_it == catalog_meta_->table_meta_pages_.end())
+  {
+    return DB_SUCCESS;
+  }
+  TableInfo *table_info = tables_.at(table_id);
+  TableMetadata *table_meta = table_info->GetMetaData();
+  if (!table_meta->SyncWithHeap(table_info->GetTableHeap()))
+  {
+    return DB_SUCCESS;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(meta_page_it->second);
+  if (page == nullptr)
+  {
+    return DB_FAILED;
+  }
+  table_meta->SerializeTo(page->GetData());
+  buffer_pool_manager_->UnpinPage(meta_page_it->second, true);
+
+  return DB_SUCCESS;
+}
+
 dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t page_id) 
 {
     // create table_info
@@ -564,7 +702,17 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
 
     // get data from page
     char* buf = buffer_pool_manager_->FetchPage(page_id)->GetData();
-    TableMetadata::DeserializeFrom(buf, table_meta, table_info->GetMemHeap());
+    uint32_t ofs = TableMetadata::DeserializeFrom(buf, table_meta, table_info->GetMemHeap());
+
+    // statistics of an analyzed table are stored behind the metadata
+    if (table_meta != nullptr)
+    {
+      auto *statistics = TableStatistics::Create(table_info->GetMemHeap());
+      if (statistics->DeserializeFrom(buf + ofs) != 0)
+      {
+        table_info->SetStatistics(statistics);
+      }
+    }
     buffer_pool_manager_->UnpinPage(page_id, false);
 
     if (table_meta != nullptr) 
@@ -572,11 +720,15 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
       Schema* sch = table_meta->GetSchema();
 
       // table_info and table_heap are created by table_meta
-      auto *table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(), sch, log_manager_, lock_manager_, table_info->GetMemHeap());
+      auto *table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(), table_meta->GetFsmPageId(), sch,
+                                           log_manager_, lock_manager_, table_info->GetMemHeap(),
+                                           table_meta->GetLayout(), table_meta->GetClusterKey());
       table_info->Init(table_meta, table_heap);
+      table_heap->SetRootCallback([this, table_id](const TableHeap *) { FlushTableMeta(table_id); });
 
       // add to table names map
       table_names_[table_meta->GetTableName()] = table_id;
+      index_names_[table_meta->GetTableName()];
 
       // add to table map
       tables_[table_id] = table_info;
@@ -596,8 +748,7 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
 
     // get data from page
     char* buf = buffer_pool_manager_->FetchPage(page_id)->GetData();
-    IndexMetadata::DeserializeFrom(buf, index_meta, index_info->GetMemHeap());
-    buffer_pool_manager_->UnpinPage(page_id, false);
+    uint32_t ofs = IndexMetadata::DeserializeFrom(buf, index_meta, index_info->GetMemHeap());
 
     if (index_meta != nullptr) 
     {
@@ -607,6 +758,18 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
 
       // index_info is created by index_meta and table_info
       index_info->Init(index_meta, table_it->second, buffer_pool_manager_);
+
+      // key filter is stored behind the metadata, older pages and filters not
+      // written back at a clean close need a scan
+      if (!index_info->LoadFilter(buf + ofs, buffer_pool_manager_))
+      {
+        index_info->RebuildFilter();
+      }
+      // the filter on disk goes stale with the next insert, a crash before
+      // FlushIndexFilters must not leave it looking clean
+      BloomFilter::MarkOpen(buf + ofs);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      buffer_pool_manager_->FlushPage(page_id);
       
       // get table name
       string table_name;
@@ -621,16 +784,15 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
       }
 
       // add to index names map
-      std::unordered_map<std::string, index_id_t> index_name;
-      index_name[index_meta->GetIndexName()] = index_id;
-      index_names_[table_name] = index_name;
+      index_names_[table_name][index_meta->GetIndexName()] = index_id;
 
       // add to index map
       indexes_[index_id] = index_info;
 
       return DB_SUCCESS;
     }
-  
+
+  buffer_pool_manager_->UnpinPage(page_id, false);
   return DB_FAILED;
 }
 
@@ -0,0 +1,306 @@
+#include "catalog/statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+#include "record/vector_batch.h"
+
+/*
+ * FNV-1a over the key bytes, then the finalizer of MurmurHash3 so that the
+ * high bits picking the register are spread as well as the low ones.
+ */
+uint64_t HyperLogLog::Hash(const char *key, uint32_t len) {
+  uint64_t h = 14695981039346656037ULL;
+  for (uint32_t i = 0; i < len; i++) {
+    h ^= static_cast<uint8_t>(key[i]);
+    h *= 1099511628211ULL;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+void HyperLogLog::Insert(const char *key, uint32_t len) {
+  uint64_t h = Hash(key, len);
+  uint32_t index = static_cast<uint32_t>(h >> (64 - STATS_HLL_PRECISION));
+  uint64_t rest = h << STATS_HLL_PRECISION;
+  // position of the first set bit of the rest of the hash
+  uint8_t rank = 1;
+  while (rank <= 64 - STATS_HLL_PRECISION && (rest & (uint64_t(1) << 63)) == 0) {
+    rest <<= 1;
+    rank++;
+  }
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+double HyperLogLog::Estimate() const {
+  double m = NUM_REGISTERS, sum = 0;
+  uint32_t zeros = 0;
+  for (auto r : registers_) {
+    sum += std::ldexp(1.0, -r);
+    zeros += r == 0;
+  }
+  double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  // few values leave registers empty, counting them is more accurate then
+  if (estimate <= 2.5 * m && zeros > 0) return m * std::log(m / zeros);
+  return estimate;
+}
+
+double TableStatistics::KeyOf(TypeId type, const char *data, uint32_t len) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return MACH_READ_FROM(int32_t, data);
+    case TypeId::kTypeFloat:
+      return MACH_READ_FROM(float, data);
+    default: {
+      uint64_t key = 0;
+      for (uint32_t i = 0; i < 8; i++) key = key << 8 | (i < len ? static_cast<uint8_t>(data[i]) : 0);
+      return static_cast<double>(key);
+    }
+  }
+}
+
+void TableStatistics::Collect(TableHeap *table_heap) {
+  const Schema *schema = table_heap->GetSchema();
+  uint32_t column_count = schema->GetColumnCount();
+  std::vector<uint32_t> all(column_count);
+  std::iota(all.begin(), all.end(), 0);
+
+  std::vector<page_id_t> pages = table_heap->ScanPages(nullptr);
+  row_count_ = 0;
+  page_count_ = static_cast<uint32_t>(pages.size());
+  columns_.assign(column_count, ColumnStatistics());
+
+  std::vector<HyperLogLog> sketches(column_count);
+  std::vector<std::vector<double>> samples(column_count);
+  std::vector<uint32_t> seen(column_count, 0);
+  std::vector<double> min(column_count), max(column_count);
+  // a fixed seed, analyzing the same tuples twice gives the same histograms
+  std::mt19937_64 random(column_count);
+
+  VectorBatch batch(schema, all);
+  size_t next = 0;
+  uint32_t slot = 0;
+  while (next < pages.size()) {
+    batch.Reset();
+    while (!batch.IsFull() && next < pages.size()) {
+      if (table_heap->ReadBatch(pages[next], slot, batch)) {
+        next++;
+        slot = 0;
+      }
+    }
+    row_count_ += batch.GetSize();
+    for (uint32_t c = 0; c < column_count; c++) {
+      const ColumnVector &vector = batch.GetColumn(c);
+      for (uint32_t i = 0; i < batch.GetSize(); i++) {
+        if (vector.IsNull(i)) {
+          columns_[c].null_count++;
+          continue;
+        }
+        const char *data = vector.GetValues() + i * vector.GetWidth();
+        uint32_t len = vector.GetWidth();
+        if (vector.GetType() == TypeId::kTypeChar) {
+          len = MACH_READ_FROM(uint16_t, data);
+          data += sizeof(uint16_t);
+        }
+        sketches[c].Insert(data, len);
+        double key = KeyOf(vector.GetType(), data, len);
+        min[c] = seen[c] == 0 ? key : std::min(min[c], key);
+        max[c] = seen[c] == 0 ? key : std::max(max[c], key);
+        // reservoir sampling, each value seen so far is in the sample with the same chance
+        if (samples[c].size() < STATS_SAMPLE_SIZE) {
+          samples[c].push_back(key);
+        } else {
+          uint64_t j = random() % (seen[c] + 1);
+          if (j < STATS_SAMPLE_SIZE) samples[c][j] = key;
+        }
+        seen[c]++;
+      }
+    }
+  }
+
+  for (uint32_t c = 0; c < column_count; c++) {
+    auto &column = columns_[c];
+    auto &sample = samples[c];
+    if (sample.empty()) continue;
+    column.distinct =
+        std::max(1u, std::min(seen[c], static_cast<uint32_t>(std::lround(sketches[c].Estimate()))));
+    std::sort(sample.begin(), sample.end());
+    size_t buckets = std::min<size_t>(STATS_HISTOGRAM_BUCKETS, sample.size());
+    column.bounds.resize(buckets + 1);
+    column.bounds[0] = min[c];
+    for (size_t b = 1; b < buckets; b++) column.bounds[b] = sample[b * sample.size() / buckets];
+    column.bounds[buckets] = max[c];
+  }
+}
+
+double TableStatistics::fraction_below(uint32_t column, double key) const {
+  auto &bounds = columns_[column].bounds;
+  uint32_t buckets = static_cast<uint32_t>(bounds.size()) - 1;
+  if (key <= bounds[0]) return 0;
+  if (key > bounds[buckets]) return 1;
+  // bounds[i] < key <= bounds[i + 1], the keys are taken to be spread evenly over the bucket
+  uint32_t i = static_cast<uint32_t>(std::lower_bound(bounds.begin(), bounds.end(), key) - bounds.begin()) - 1;
+  double lo = bounds[i], hi = bounds[i + 1];
+  return (i + (key - lo) / (hi - lo)) / buckets;
+}
+
+double TableStatistics::fraction_equal(uint32_t column, double key) const {
+  auto &bounds = columns_[column].bounds;
+  uint32_t buckets = static_cast<uint32_t>(bounds.size()) - 1;
+  if (key < bounds[0] || key > bounds[buckets]) return 0;
+  double fraction = 1.0 / columns_[column].distinct;
+  // a value that is the bound of several buckets fills the buckets between
+  auto equal = std::equal_range(bounds.begin(), bounds.end(), key);
+  if (equal.second - equal.first > 1) fraction = std::max(fraction, (equal.second - equal.first - 1.0) / buckets);
+  return std::min(fraction, 1.0);
+}
+
+double TableStatistics::Selectivity(uint32_t column, CompareOp op, const Field &key) const {
+  if (row_count_ == 0) return 0;
+  double nulls = static_cast<double>(columns_[column].null_count) / row_count_;
+  if (op == CompareOp::kIsNull) return nulls;
+  if (op == CompareOp::kNotNull) return 1 - nulls;
+  // nothing compares to null, and a column of nulls has no histogram
+  if (key.IsNull() || columns_[column].bounds.empty()) return 0;
+
+  double value;
+  if (key.GetTypeId() == TypeId::kTypeChar) {
+    value = KeyOf(key.GetTypeId(), key.GetData(), key.GetLength());
+  } else {
+    char buf[sizeof(int32_t)];
+    key.SerializeTo(buf);
+    value = KeyOf(key.GetTypeId(), buf, sizeof(buf));
+  }
+  double equal = fraction_equal(column, value), below = fraction_below(column, value);
+  double fraction;
+  switch (op) {
+    case CompareOp::kEq:
+      fraction = equal;
+      break;
+    case CompareOp::kNe:
+      fraction = 1 - equal;
+      break;
+    case CompareOp::kLt:
+      fraction = below;
+      break;
+    case CompareOp::kLe:
+      fraction = below + equal;
+      break;
+    case CompareOp::kGt:
+      fraction = 1 - below - equal;
+      break;
+    default:
+      fraction = 1 - below;
+      break;
+  }
+  return std::clamp(fraction, 0.0, 1.0) * (1 - nulls);
+}
+
+double TableStatistics::LookupCost(double probes, double rows) const {
+  double pages = page_count_;
+  // expected pages holding rows tuples picked at random among the pages
+  double fetched = pages == 0 ? 0 : pages * (1 - std::pow(1 - 1 / pages, rows));
+  return probes * INDEX_PROBE_COST + rows * INDEX_TUPLE_COST + fetched * FETCH_PAGE_COST;
+}
+
+bool TableStatistics::Shrink(uint32_t size) {
+  while (GetSerializedSize() > size) {
+    bool merged = false;
+    for (auto &column : columns_) {
+      size_t buckets = column.bounds.empty() ? 0 : column.bounds.size() - 1;
+      if (buckets <= 1) continue;
+      // keep every other bound, the greatest one included
+      std::vector<double> bounds;
+      for (size_t b = 0; b < buckets; b += 2) bounds.push_back(column.bounds[b]);
+      bounds.push_back(column.bounds[buckets]);
+      column.bounds = std::move(bounds);
+      merged = true;
+    }
+    if (!merged) return false;
+  }
+  return true;
+}
+
+uint32_t TableStatistics::SerializeTo(char *buf) const {
+  uint32_t ser_size = 0;
+
+  MACH_WRITE_UINT32(buf, TABLE_STATISTICS_MAGIC_NUM);
+  MOVE_FORWARD(buf, ser_size, uint32_t);
+
+  MACH_WRITE_UINT32(buf, row_count_);
+  MOVE_FORWARD(buf, ser_size, uint32_t);
+
+  MACH_WRITE_UINT32(buf, page_count_);
+  MOVE_FORWARD(buf, ser_size, uint32_t);
+
+  MACH_WRITE_UINT32(buf, GetColumnCount());
+  MOVE_FORWARD(buf, ser_size, uint32_t);
+
+  for (auto &column : columns_) {
+    MACH_WRITE_UINT32(buf, column.null_count);
+    MOVE_FORWARD(buf, ser_size, uint32_t);
+
+    MACH_WRITE_UINT32(buf, column.distinct);
+    MOVE_FORWARD(buf, ser_size, uint32_t);
+
+    MACH_WRITE_UINT32(buf, column.bounds.empty() ? 0 : static_cast<uint32_t>(column.bounds.size()) - 1);
+    MOVE_FORWARD(buf, ser_size, uint32_t);
+
+    for (auto bound : column.bounds) {
+      MACH_WRITE_TO(double, buf, bound);
+      MOVE_FORWARD(buf, ser_size, double);
+    }
+  }
+
+  return ser_size;
+}
+
+uint32_t TableStatistics::GetSerializedSize() const {
+  uint32_t size = sizeof(uint32_t) * 4;
+  for (auto &column : columns_) size += sizeof(uint32_t) * 3 + sizeof(double) * column.bounds.size();
+  return size;
+}
+
+uint32_t TableStatistics::DeserializeFrom(char *buf) {
+  ASSERT(buf != nullptr, "TableStatistics::DeserializeFrom : Null buf");
+  uint32_t ser_cnt = 0;
+
+  // tables never analyzed have nothing here
+  if (MACH_READ_UINT32(buf) != TABLE_STATISTICS_MAGIC_NUM) return 0;
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  row_count_ = MACH_READ_UINT32(buf);
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  page_count_ = MACH_READ_UINT32(buf);
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  uint32_t column_count = MACH_READ_UINT32(buf);
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  columns_.assign(column_count, ColumnStatistics());
+  for (auto &column : columns_) {
+    column.null_count = MACH_READ_UINT32(buf);
+    MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+    column.distinct = MACH_READ_UINT32(buf);
+    MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+    uint32_t buckets = MACH_READ_UINT32(buf);
+    MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+    column.bounds.resize(buckets == 0 ? 0 : buckets + 1);
+    for (auto &bound : column.bounds) {
+      bound = MACH_READ_FROM(double, buf);
+      MOVE_FORWARD(buf, ser_cnt, double);
+    }
+  }
+
+  return ser_cnt;
+}
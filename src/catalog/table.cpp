@@ -22,6 +22,22 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
   MACH_WRITE_UINT32(buf, root_page_id_);
   MOVE_FORWARD(buf, ser_cnt, uint32_t);
 
+  // write free space map page id
+  MACH_WRITE_UINT32(buf, fsm_page_id_);
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  // write layout
+  MACH_WRITE_UINT32(buf, static_cast<uint32_t>(layout_));
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  // write cluster key
+  MACH_WRITE_UINT32(buf, cluster_key_.size());
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+  for (auto column : cluster_key_) {
+    MACH_WRITE_UINT32(buf, column);
+    MOVE_FORWARD(buf, ser_cnt, uint32_t);
+  }
+
   // write schema
   STEP_FORWARD(buf, ser_cnt, schema_->SerializeTo(buf));
 
@@ -30,10 +46,12 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
 
 uint32_t TableMetadata::GetSerializedSize() const {
   /* 
-  ints: TABLE_METADATA_MAGIC_NUM, table_id_, table_name_.length(), root_page_id_
+  ints: TABLE_METADATA_MAGIC_NUM, table_id_, table_name_.length(), root_page_id_, fsm_page_id_, layout_,
+        cluster_key_.size(), cluster_key_
+  string: table_name_
   Schema: schema_
   */
-  return sizeof(uint32_t) * 4 + schema_->GetSerializedSize();
+  return sizeof(uint32_t) * (7 + cluster_key_.size()) + table_name_.length() + schema_->GetSerializedSize();
 }
 
 /**
@@ -47,13 +65,18 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
   uint32_t table_name_len;
   std::string table_name;
   uint32_t root_page_id;
+  page_id_t fsm_page_id = INVALID_PAGE_ID;
+  TableLayout layout = TableLayout::kRow;
+  std::vector<uint32_t> cluster_key;
   
   uint32_t ser_cnt = 0;
   uint32_t i;
 
   // read and check magic_number
   magic_number = MACH_READ_UINT32(buf);
-  ASSERT(magic_number == TABLE_METADATA_MAGIC_NUM, "TableMetadata::DeserializeFrom : Magic Number Not Match");
+  ASSERT(magic_number == TABLE_METADATA_MAGIC_NUM || magic_number == TABLE_METADATA_MAGIC_NUM_V3 ||
+             magic_number == TABLE_METADATA_MAGIC_NUM_V2 || magic_number == TABLE_METADATA_MAGIC_NUM_V1,
+         "TableMetadata::DeserializeFrom : Magic Number Not Match");
   MOVE_FORWARD(buf, ser_cnt, uint32_t);
 
   // read table id
@@ -75,12 +98,34 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
   root_page_id = MACH_READ_UINT32(buf);
   MOVE_FORWARD(buf, ser_cnt, uint32_t);
 
+  // read free space map page id, the heap builds one on first use if there is none
+  if (magic_number != TABLE_METADATA_MAGIC_NUM_V1) {
+    fsm_page_id = MACH_READ_INT32(buf);
+    MOVE_FORWARD(buf, ser_cnt, uint32_t);
+  }
+
+  // read layout, tables written before column pages store rows
+  if (magic_number == TABLE_METADATA_MAGIC_NUM || magic_number == TABLE_METADATA_MAGIC_NUM_V3) {
+    layout = static_cast<TableLayout>(MACH_READ_UINT32(buf));
+    MOVE_FORWARD(buf, ser_cnt, uint32_t);
+  }
+
+  // read cluster key, tables written before clustered tables keep rows anywhere
+  if (magic_number == TABLE_METADATA_MAGIC_NUM) {
+    uint32_t key_size = MACH_READ_UINT32(buf);
+    MOVE_FORWARD(buf, ser_cnt, uint32_t);
+    for (i = 0; i < key_size; ++i) {
+      cluster_key.push_back(MACH_READ_UINT32(buf));
+      MOVE_FORWARD(buf, ser_cnt, uint32_t);
+    }
+  }
+
   // read schema
   Schema *schema = nullptr;
   uint32_t step = Schema::DeserializeFrom(buf, schema, heap);
   STEP_FORWARD(buf, ser_cnt, step);
 
-  table_meta = Create(table_id, table_name, root_page_id, schema, heap);
+  table_meta = Create(table_id, table_name, root_page_id, fsm_page_id, schema, heap, layout, cluster_key);
 
   return ser_cnt;
 }
@@ -91,12 +136,23 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
  * @param heap Memory heap passed by TableInfo
  */
 TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name,
-                                     page_id_t root_page_id, TableSchema *schema, MemHeap *heap) {
+                                     page_id_t root_page_id, page_id_t fsm_page_id, TableSchema *schema,
+                                     MemHeap *heap, TableLayout layout, const std::vector<uint32_t> &cluster_key) {
   // allocate space for table metadata
   void *buf = heap->Allocate(sizeof(TableMetadata));
   
-  return new(buf)TableMetadata(table_id, table_name, root_page_id, schema);
+  return new(buf)TableMetadata(table_id, table_name, root_page_id, fsm_page_id, schema, layout, cluster_key);
+}
+
+bool TableMetadata::SyncWithHeap(const TableHeap *table_heap) {
+  if (root_page_id_ == table_heap->GetFirstPageId() && fsm_page_id_ == table_heap->GetFsmPageId()) return false;
+  root_page_id_ = table_heap->GetFirstPageId();
+  fsm_page_id_ = table_heap->GetFsmPageId();
+  return true;
 }
 
-TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema)
-        : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema) {}
+TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id,
+                             page_id_t fsm_page_id, TableSchema *schema, TableLayout layout,
+                             const std::vector<uint32_t> &cluster_key)
+        : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), fsm_page_id_(fsm_page_id),
+          schema_(schema), layout_(layout), cluster_key_(cluster_key) {}
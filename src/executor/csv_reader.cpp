@@ -0,0 +1,108 @@
+#include "executor/csv_reader.h"
+
+#include <cstring>
+
+CsvReader::CsvReader(const std::string &file_name) : buf_(CSV_READ_BUFFER_SIZE) {
+  file_ = fopen(file_name.c_str(), "rb");
+}
+
+CsvReader::~CsvReader() {
+  if (file_ != nullptr) fclose(file_);
+}
+
+bool CsvReader::NextRecord(std::vector<CsvField> &fields) {
+  if (!IsOpen() || malformed_) return false;
+  while (true) {
+    uint32_t newlines = 0;
+    size_t record_end = FindRecordEnd(newlines);
+    if (record_end == end_) {
+      // the record goes on past the buffer
+      if (Fill()) continue;
+      if (begin_ == end_) return false;
+      // last record without a trailing newline, Fill may have moved it
+      record_end = end_;
+      newlines++;
+    }
+    line_no_ += newlines;
+    size_t next = record_end == end_ ? end_ : record_end + 1;
+    size_t stop = record_end;
+    if (stop > begin_ && buf_[stop - 1] == '\r') stop--;
+    if (stop == begin_) {
+      // blank line
+      begin_ = next;
+      continue;
+    }
+    bool is_valid = SplitRecord(stop, fields);
+    begin_ = next;
+    if (!is_valid) {
+      malformed_ = true;
+      return false;
+    }
+    return true;
+  }
+}
+
+bool CsvReader::Fill() {
+  if (eof_) return false;
+  if (begin_ > 0) {
+    memmove(buf_.data(), buf_.data() + begin_, end_ - begin_);
+    end_ -= begin_;
+    begin_ = 0;
+  }
+  // a single record larger than the buffer
+  if (end_ == buf_.size()) buf_.resize(buf_.size() * 2);
+  size_t n = fread(buf_.data() + end_, 1, buf_.size() - end_, file_);
+  end_ += n;
+  if (n == 0) eof_ = true;
+  return n > 0;
+}
+
+size_t CsvReader::FindRecordEnd(uint32_t &newlines) const {
+  // an escaped quote flips the state twice, so counting quotes is enough
+  bool quoted = false;
+  for (size_t i = begin_; i < end_; i++) {
+    if (buf_[i] == '"') {
+      quoted = !quoted;
+    } else if (buf_[i] == '\n') {
+      newlines++;
+      if (!quoted) return i;
+    }
+  }
+  return end_;
+}
+
+bool CsvReader::SplitRecord(size_t record_end, std::vector<CsvField> &fields) {
+  fields.clear();
+  char *data = buf_.data();
+  size_t r = begin_;
+  while (true) {
+    if (r < record_end && data[r] == '"') {
+      // unescape in place, the result is never longer than the input
+      size_t w = ++r;
+      size_t field_begin = w;
+      while (true) {
+        if (r >= record_end) return false;
+        if (data[r] == '"') {
+          if (r + 1 < record_end && data[r + 1] == '"') {
+            data[w++] = '"';
+            r += 2;
+            continue;
+          }
+          r++;
+          break;
+        }
+        data[w++] = data[r++];
+      }
+      if (r < record_end && data[r] != ',') return false;
+      fields.push_back({std::string_view(data + field_begin, w - field_begin), false});
+    } else {
+      size_t field_begin = r;
+      while (r < record_end && data[r] != ',') r++;
+      fields.push_back({std::string_view(data + field_begin, r - field_begin), r == field_begin});
+    }
+    if (r >= record_end) break;
+    // skip ','
+    r++;
+  }
+  return true;
+}
@@ -1,8 +1,14 @@
 #include "executor/execute_engine.h"
-#include "common/IntervalMerge.h"
+#include "executor/operators.h"
 #include "common/comparison.h"
+#include "record/scan_predicate.h"
 #include "glog/logging.h"
+#include <algorithm>
+#include <charconv>
+#include <numeric>
+#include<deque>
 #include<filesystem>
+#include <sstream>
 
 static const std::string db_file_posfix{".db"};
 static const std::filesystem::path db_root_dir = std::filesystem::current_path() / "database";
@@ -14,10 +20,142 @@ void output(const uint32_t len, const Field *text) {
   std::cout << text << blanks;
 }
 
-void output(const uint32_t len, const std::string &str) {
-  auto indent = len - str.length();
-  std::string blanks(indent, ' ');
-  std::cout << str << blanks;
+/**
+ * Append the conditions ast is an and of to conjuncts
+ */
+static void split_conjuncts(pSyntaxNode ast, std::vector<pSyntaxNode> &conjuncts) {
+  if (ast->type_ == kNodeConnector && strcmp(ast->val_, "and") == 0) {
+    split_conjuncts(ast->child_, conjuncts);
+    split_conjuncts(ast->child_->next_, conjuncts);
+    return;
+  }
+  conjuncts.push_back(ast);
+}
+
+/**
+ * Append the nodes of the columns compared in ast to columns, columns compared to a column included
+ */
+static void collect_column_nodes(pSyntaxNode ast, std::vector<pSyntaxNode> &columns) {
+  if (ast->type_ == kNodeCompareOperator) {
+    columns.push_back(ast->child_);
+    if (ast->child_->next_->type_ == kNodeIdentifier) columns.push_back(ast->child_->next_);
+    return;
+  }
+  collect_column_nodes(ast->child_, columns);
+  collect_column_nodes(ast->child_->next_, columns);
+}
+
+/**
+ * @return whether a column of ast is compared to a column
+ */
+static bool compares_columns(pSyntaxNode ast) {
+  if (ast->type_ == kNodeCompareOperator) return ast->child_->next_->type_ == kNodeIdentifier;
+  return compares_columns(ast->child_) || compares_columns(ast->child_->next_);
+}
+
+/**
+ * @return the and of conditions, relinked into a tree of new connectors, nullptr if there are none
+ */
+static pSyntaxNode and_of(const std::vector<pSyntaxNode> &conditions) {
+  if (conditions.empty()) return nullptr;
+  pSyntaxNode ast = conditions[0];
+  ast->next_ = nullptr;
+  char text[] = "and";
+  for (size_t i = 1; i < conditions.size(); i++) {
+    pSyntaxNode connector = CreateSyntaxNode(kNodeConnector, text);
+    connector->child_ = ast;
+    ast->next_ = conditions[i];
+    conditions[i]->next_ = nullptr;
+    ast = connector;
+  }
+  return ast;
+}
+
+/**
+ * @return the clause of the select ast of type, nullptr if it has none
+ */
+static pSyntaxNode find_clause(pSyntaxNode ast, SyntaxNodeType type) {
+  for (auto node = ast->child_; node != nullptr; node = node->next_) {
+    if (node->type_ == type) return node;
+  }
+  return nullptr;
+}
+
+/**
+ * @return whether the select ast groups its rows or aggregates them
+ */
+static bool aggregates_rows(pSyntaxNode ast) {
+  if (find_clause(ast, kNodeGroupBy) != nullptr) return true;
+  if (ast->child_->type_ != kNodeColumnList) return false;
+  for (auto node = ast->child_->child_; node != nullptr; node = node->next_) {
+    if (node->type_ == kNodeAggregate) return true;
+  }
+  return false;
+}
+
+/**
+ * Append the nodes of the columns an aggregating select ast reads to columns: those grouped by, selected and
+ * aggregated
+ */
+static void collect_aggregated_columns(pSyntaxNode ast, std::vector<pSyntaxNode> &columns) {
+  pSyntaxNode group_node = find_clause(ast, kNodeGroupBy);
+  if (group_node != nullptr) {
+    for (auto node = group_node->child_; node != nullptr; node = node->next_) columns.push_back(node);
+  }
+  if (ast->child_->type_ != kNodeColumnList) return;
+  for (auto node = ast->child_->child_; node != nullptr; node = node->next_) {
+    pSyntaxNode column = node->type_ == kNodeAggregate ? node->child_ : node;
+    if (column->type_ == kNodeIdentifier) columns.push_back(column);
+  }
+}
+
+/**
+ * Read the limit of the select ast, limit is SIZE_MAX if it has none
+ * @return false if the limit or the offset is not a count of rows
+ */
+static bool read_limit(pSyntaxNode ast, size_t &limit, size_t &offset) {
+  limit = SIZE_MAX;
+  offset = 0;
+  pSyntaxNode limit_node = find_clause(ast, kNodeLimit);
+  if (limit_node == nullptr) return true;
+  for (auto node = limit_node->child_; node != nullptr; node = node->next_) {
+    size_t &count = node == limit_node->child_ ? limit : offset;
+    std::string_view text(node->val_);
+    auto res = std::from_chars(text.data(), text.data() + text.size(), count);
+    if (res.ec != std::errc() || res.ptr != text.data() + text.size()) {
+      ENABLE_ERROR << "limit and offset are counts of rows, " << text << " is not one" << DISABLED;
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @return rows a limit reads, the ones its offset skips included
+ */
+static size_t limit_rows(size_t limit, size_t offset) {
+  return limit == SIZE_MAX ? SIZE_MAX : limit + std::min(offset, SIZE_MAX - 1 - limit);
+}
+
+/**
+ * Find the column or aggregate node selected by the aggregating select ast, the order by keys of its groups name
+ * those
+ * @return false if it is not selected
+ */
+static bool locate_selected(pSyntaxNode ast, pSyntaxNode node, uint32_t &position) {
+  position = 0;
+  for (auto column = ast->child_->child_; column != nullptr; column = column->next_, position++) {
+    if (column->type_ != node->type_) continue;
+    if (node->type_ != kNodeAggregate) {
+      if (strcmp(column->val_, node->val_) == 0) return true;
+    } else if (strcasecmp(column->val_, node->val_) == 0 && column->child_->type_ == node->child_->type_ &&
+               (node->child_->type_ == kNodeAllColumns || strcmp(column->child_->val_, node->child_->val_) == 0)) {
+      return true;
+    }
+  }
+  ENABLE_ERROR << "groups are ordered by the columns and aggregates selected, " << node->val_ << " is not one"
+               << DISABLED;
+  return false;
 }
 
 ExecuteEngine::ExecuteEngine() {
@@ -38,6 +176,13 @@ ExecuteEngine::ExecuteEngine() {
 }
 
 dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
+  dberr_t res = dispatch(ast, context);
+  // rows built while running the statement are all dead now
+  statement_heap_.Reset();
+  return res;
+}
+
+dberr_t ExecuteEngine::dispatch(pSyntaxNode ast, ExecuteContext *context) {
   if (ast == nullptr) {
     return DB_FAILED;
   }
@@ -81,6 +226,12 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
       return ExecuteExecfile(ast, context);
     case kNodeQuit:
       return ExecuteQuit(ast, context);
+    case kNodeCopy:
+      return ExecuteCopy(ast, context);
+    case kNodeVacuum:
+      return ExecuteVacuum(ast, context);
+    case kNodeAnalyze:
+      return ExecuteAnalyze(ast, context);
     default:
       break;
   }
@@ -188,13 +339,34 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
 
   auto cur = ast;
   std::string table_name{cur->child_->val_};
+  auto options = cur->child_->next_->next_;
   cur = cur->child_->next_->child_;
   if (database_structure[current_db_].count(table_name)) {
     ENABLE_ERROR << "table " << table_name << " already exists" << DISABLED;
     return DB_TABLE_ALREADY_EXIST;
   }
 
-  if (!parse_column_definitions(table_name, cur)) {
+  TableLayout layout = TableLayout::kRow;
+  if (options != nullptr && !parse_table_options(options->child_, layout)) {
+    ENABLE_ERROR << "the only table option is layout = row | column" << DISABLED;
+    return DB_FAILED;
+  }
+
+  bool clustered = ast->val_ != nullptr && strcmp(ast->val_, "clustered") == 0;
+  if (clustered) {
+    auto key_node = cur;
+    while (key_node != nullptr && key_node->type_ != kNodeColumnList) key_node = key_node->next_;
+    if (key_node == nullptr) {
+      ENABLE_ERROR << "a clustered table needs a primary key" << DISABLED;
+      return DB_FAILED;
+    }
+    if (layout != TableLayout::kRow) {
+      ENABLE_ERROR << "a clustered table stores whole rows, layout = column is not supported" << DISABLED;
+      return DB_FAILED;
+    }
+  }
+
+  if (!parse_column_definitions(table_name, cur, layout, clustered)) {
     ENABLE_ERROR << "create table failed" << DISABLED;
     return DB_FAILED;
   }
@@ -273,12 +445,36 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
 
   ASSERT(target_table != nullptr, "Null Table Fetch");
   IndexInfo *target_index = nullptr;
-  if (target_db->catalog_mgr_->CreateIndex(table_name, index_name, column_names, context->txn_, target_index) ==
-      DB_FAILED)
-    return DB_INDEX_ALREADY_EXIST;
+  dberr_t created = target_db->catalog_mgr_->CreateIndex(table_name, index_name, column_names, context->txn_,
+                                                         target_index);
+  if (created != DB_SUCCESS) return created;
 
   ASSERT(target_index != nullptr, "Null Index Fetch");
 
+  // the rows already in the table are loaded into the new index in one sorted pass
+  std::vector<uint32_t> key_columns;
+  for (auto col : target_index->GetIndexKeySchema()->GetColumns()) {
+    uint32_t column_id;
+    target_table->GetSchema()->GetColumnIndex(col->GetName(), column_id);
+    key_columns.push_back(column_id);
+  }
+  std::deque<Row> keys;
+  std::vector<RowId> row_ids;
+  std::vector<Field> key_fields;
+  auto table_heap = target_table->GetTableHeap();
+  for (auto it = table_heap->Begin(nullptr, key_columns); it != table_heap->End(); ++it) {
+    key_fields.clear();
+    for (auto column_id : key_columns) key_fields.push_back(*it->GetField(column_id));
+    keys.emplace_back(key_fields, &statement_heap_);
+    row_ids.push_back(it->GetRowId());
+  }
+  if (target_index->GetIndex()->BulkLoad(keys, row_ids, context->txn_) != DB_SUCCESS) {
+    target_db->catalog_mgr_->DropIndex(table_name, index_name);
+    ENABLE_ERROR << "create index failed (unique key constraints violated)" << DISABLED;
+    return DB_FAILED;
+  }
+  for (auto &key : keys) target_index->AddToFilter(key);
+
   std::unordered_set<std::string> col_set;
   for (auto &col : column_names) col_set.insert(std::move(col));
   database_structure[current_db_][table_name].insert(std::make_pair(std::move(index_name), std::move(col_set)));
@@ -323,6 +519,7 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
     return DB_FAILED;
   }
   auto col_node = ast->child_;
+  if (col_node->next_->type_ == kNodeJoin) return select_join(ast);
   std::string table_name{col_node->next_->val_};
   TableInfo *table_info = nullptr;
   if (dbs_[current_db_]->catalog_mgr_->GetTable(table_name, table_info) == DB_FAILED) {
@@ -336,6 +533,62 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
     table_column_names.insert(std::make_pair(col->GetName(), i));
     ++i;
   }
+  pSyntaxNode condition_node = find_clause(ast, kNodeConditions);
+  pSyntaxNode condition = condition_node != nullptr ? condition_node->child_ : nullptr;
+
+  if (aggregates_rows(ast)) {
+    // scan -> (filter) -> aggregation -> projection -> output, the scan hands out each column the
+    // aggregation reads once
+    std::vector<pSyntaxNode> column_nodes;
+    collect_aggregated_columns(ast, column_nodes);
+    for (auto node : column_nodes) {
+      if (!table_column_names.count(node->val_)) {
+        ENABLE_ERROR << "column " << node->val_ << " not exist" << DISABLED;
+        return DB_COLUMN_NAME_NOT_EXIST;
+      }
+      if (std::find(used_columns.begin(), used_columns.end(), node->val_) == used_columns.end()) {
+        used_columns.emplace_back(node->val_);
+      }
+    }
+    // count(*) alone still has rows to count
+    if (used_columns.empty()) used_columns.push_back(table_info->GetSchema()->GetColumn(0)->GetName());
+    std::vector<uint32_t> used_index;
+    std::vector<Column *> columns;
+    for (auto &col_name : used_columns) {
+      used_index.push_back(table_column_names[col_name]);
+      columns.push_back(const_cast<Column *>(table_info->GetSchema()->GetColumn(used_index.back())));
+    }
+    Schema schema(columns);
+    auto locate = [&used_columns](const char *name, uint32_t &position) {
+      position = std::find(used_columns.begin(), used_columns.end(), name) - used_columns.begin();
+      return true;
+    };
+    std::unique_ptr<RowCondition> row_condition;
+    std::vector<uint32_t> read = used_index;
+    if (condition != nullptr) {
+      row_condition = parse_row_condition(condition, table_info);
+      if (row_condition == nullptr) return DB_FAILED;
+      row_condition->CollectColumns(read);
+    }
+    // the batches of a scan of the whole table are aggregated as they are, the rows an index finds one by one
+    OperatorPtr rows;
+    if (condition != nullptr && plan_access(condition, table_info).probe != nullptr) {
+      rows = plan_scan(condition, table_info, std::move(used_index));
+      if (rows == nullptr) return DB_FAILED;
+      rows = plan_aggregate(std::move(rows), &schema, ast, locate);
+    } else {
+      auto batches = plan_batches(condition, table_info, read, std::move(row_condition));
+      rows = plan_aggregate(std::move(batches), std::move(used_index), &schema, ast, locate);
+    }
+    if (rows == nullptr) return DB_FAILED;
+    rows = plan_order(std::move(rows), ast, [ast](pSyntaxNode node, uint32_t &position) {
+      return locate_selected(ast, node, position);
+    });
+    if (rows == nullptr) return DB_FAILED;
+    OutputOperator plan(std::move(rows));
+    plan.Run();
+    return DB_SUCCESS;
+  }
 
   if (col_node->type_ != kNodeAllColumns) {
     ASSERT(col_node->type_ == kNodeColumnList, "Wrong node type");
@@ -348,18 +601,406 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
       used_columns.push_back(std::move(col_name));
     }
   }
-  std::unordered_set<RowId> ans_set;
-  pSyntaxNode condition_node = col_node->next_->next_;
-  if (!condition_node) {
-    // fetch a;; ids
-    table_info->GetTableHeap()->FetchAllIds(ans_set);
+  if (used_columns.empty()) {
     for (auto &col : table_info->GetSchema()->GetColumns()) used_columns.push_back(col->GetName());
+  }
+  std::vector<uint32_t> used_index;
+  for (auto &col_name : used_columns) used_index.push_back(table_column_names[col_name]);
+
+  // the columns ordered by are read after the ones selected, the rows are projected to those once sorted
+  pSyntaxNode order_node = find_clause(ast, kNodeOrderBy);
+  std::vector<uint32_t> read_index = used_index;
+  std::vector<IndexInfo *> order_indexes;
+  if (order_node != nullptr) {
+    for (auto node = order_node->child_; node != nullptr; node = node->next_) {
+      pSyntaxNode key = node->child_;
+      if (key->type_ == kNodeAggregate) {
+        ENABLE_ERROR << "rows are ordered by their columns, " << key->val_ << " is not one" << DISABLED;
+        return DB_FAILED;
+      }
+      if (!table_column_names.count(key->val_)) {
+        ENABLE_ERROR << "column " << key->val_ << " not exist" << DISABLED;
+        return DB_COLUMN_NAME_NOT_EXIST;
+      }
+      uint32_t column = table_column_names[key->val_];
+      if (std::find(read_index.begin(), read_index.end(), column) == read_index.end()) read_index.push_back(column);
+      order_indexes.push_back(find_index(table_info, key->val_));
+    }
+  }
+  size_t limit, offset;
+  if (!read_limit(ast, limit, offset)) return DB_FAILED;
+
+  // a single key with an index of its own is in order in the index already, the rows are read in that order
+  // unless the condition has lookups of its own, or reading them one by one costs more than a scan. A null is
+  // not ordered by the index, the column has to be not null.
+  if (order_indexes.size() == 1 && order_indexes[0] != nullptr &&
+      !table_info->GetSchema()->GetColumn(table_column_names[order_node->child_->child_->val_])->IsNullable() &&
+      (condition == nullptr || plan_access(condition, table_info).probe == nullptr)) {
+    auto statistics = table_info->GetStatistics();
+    bool ordered = true;
+    if (statistics != nullptr) {
+      double wanted = statistics->GetRowCount();
+      if (limit != SIZE_MAX) {
+        double selectivity = condition != nullptr ? estimate_selectivity(condition, table_info) : 1.0;
+        wanted = std::min(wanted, (static_cast<double>(limit) + offset) / std::max(selectivity, 1e-9));
+      }
+      ordered = statistics->LookupCost(1, wanted) < statistics->ScanCost();
+    }
+    if (ordered) {
+      std::unique_ptr<RowCondition> row_condition;
+      std::vector<uint32_t> read = used_index;
+      if (condition != nullptr) {
+        row_condition = parse_row_condition(condition, table_info);
+        if (row_condition == nullptr) return DB_FAILED;
+        row_condition->CollectColumns(read);
+      }
+      // the index walks its keys from the least, the first rows of an ascending order are all it reads
+      Index *index = order_indexes[0]->GetIndex();
+      bool descending = strcmp(order_node->child_->val_, "desc") == 0;
+      size_t wanted = descending || condition != nullptr ? SIZE_MAX : limit_rows(limit, offset);
+      auto scan = [index, descending, wanted](std::vector<RowId> &rids) {
+        index->ScanInOrder(rids, wanted);
+        if (descending) std::reverse(rids.begin(), rids.end());
+      };
+      OperatorPtr rows =
+          std::make_unique<IndexOrderScanOperator>(table_info->GetTableHeap(), std::move(read), std::move(scan));
+      if (row_condition != nullptr) rows = std::make_unique<FilterOperator>(std::move(rows), std::move(row_condition));
+      rows = std::make_unique<ProjectionOperator>(std::move(rows), std::move(used_index));
+      if (limit != SIZE_MAX || offset != 0) rows = std::make_unique<LimitOperator>(std::move(rows), limit, offset);
+      OutputOperator plan(std::move(rows));
+      plan.Run();
+      return DB_SUCCESS;
+    }
+  }
+
+  // scan -> (filter) -> projection -> (sort) -> (limit) -> output, the rows stream from the pages to the screen
+  // unless they are sorted
+  size_t selected = used_index.size();
+  auto rows = plan_scan(condition, table_info, read_index);
+  if (rows == nullptr) return DB_FAILED;
+  rows = plan_order(std::move(rows), ast, [&read_index, &table_column_names](pSyntaxNode node, uint32_t &position) {
+    position = std::find(read_index.begin(), read_index.end(), table_column_names[node->val_]) - read_index.begin();
+    return true;
+  });
+  if (rows == nullptr) return DB_FAILED;
+  if (read_index.size() > selected) {
+    std::vector<uint32_t> columns(selected);
+    std::iota(columns.begin(), columns.end(), 0);
+    rows = std::make_unique<ProjectionOperator>(std::move(rows), std::move(columns));
+  }
+  OutputOperator plan(std::move(rows));
+  plan.Run();
+
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::select_join(pSyntaxNode ast) {
+  pSyntaxNode col_node = ast->child_, join_node = col_node->next_, condition_node = find_clause(ast, kNodeConditions);
+  std::vector<TableInfo *> tables;
+  std::vector<pSyntaxNode> conjuncts;
+  for (auto node = join_node->child_; node != nullptr; node = node->next_) {
+    if (node->type_ == kNodeConditions) {
+      split_conjuncts(node->child_, conjuncts);
+      continue;
+    }
+    TableInfo *table_info = nullptr;
+    if (dbs_[current_db_]->catalog_mgr_->GetTable(node->val_, table_info) != DB_SUCCESS) {
+      ENABLE_ERROR << " table " << node->val_ << " not exist" << DISABLED;
+      return DB_TABLE_NOT_EXIST;
+    }
+    if (std::find(tables.begin(), tables.end(), table_info) != tables.end()) {
+      ENABLE_ERROR << " table " << node->val_ << " joined more than once" << DISABLED;
+      return DB_FAILED;
+    }
+    tables.push_back(table_info);
+  }
+  if (condition_node != nullptr) split_conjuncts(condition_node->child_, conjuncts);
+
+  // a column is named table.column, or column alone if only one of the tables has it
+  using ColumnRef = std::pair<uint32_t, uint32_t>;
+  auto resolve = [ast, &tables](const char *name, ColumnRef &ref) {
+    const char *dot = strchr(name, '.');
+    uint32_t found = 0;
+    for (uint32_t t = 0; t < tables.size(); t++) {
+      if (dot != nullptr && tables[t]->GetTableName() != std::string(name, dot - name)) continue;
+      uint32_t column;
+      if (tables[t]->GetSchema()->GetColumnIndex(dot != nullptr ? dot + 1 : name, column) != DB_SUCCESS) continue;
+      ref = {t, column};
+      found++;
+    }
+    if (found == 1) return true;
+    ENABLE_ERROR << "column " << name << (found == 0 ? " not exist" : " is ambiguous") << DISABLED;
+    return false;
+  };
+  auto column_of = [&tables](const ColumnRef &ref) { return tables[ref.first]->GetSchema()->GetColumn(ref.second); };
+
+  std::vector<std::vector<uint32_t>> read(tables.size());
+  std::vector<ColumnRef> outputs;
+  bool aggregate = aggregates_rows(ast);
+  if (aggregate) {
+    std::vector<pSyntaxNode> column_nodes;
+    collect_aggregated_columns(ast, column_nodes);
+    for (auto node : column_nodes) {
+      ColumnRef ref;
+      if (!resolve(node->val_, ref)) return DB_COLUMN_NAME_NOT_EXIST;
+      read[ref.first].push_back(ref.second);
+    }
+  } else if (col_node->type_ == kNodeAllColumns) {
+    for (uint32_t t = 0; t < tables.size(); t++) {
+      for (uint32_t c = 0; c < tables[t]->GetSchema()->GetColumnCount(); c++) outputs.emplace_back(t, c);
+    }
   } else {
-    if (!parse_condition(condition_node->child_, table_info, ans_set)) return DB_FAILED;
+    for (auto node = col_node->child_; node != nullptr; node = node->next_) {
+      ColumnRef ref;
+      if (!resolve(node->val_, ref)) return DB_COLUMN_NAME_NOT_EXIST;
+      outputs.push_back(ref);
+    }
+  }
+  for (auto &ref : outputs) read[ref.first].push_back(ref.second);
+  // the joined rows are sorted before they are projected, the columns ordered by are read too
+  pSyntaxNode order_node = find_clause(ast, kNodeOrderBy);
+  if (!aggregate && order_node != nullptr) {
+    for (auto node = order_node->child_; node != nullptr; node = node->next_) {
+      if (node->child_->type_ == kNodeAggregate) {
+        ENABLE_ERROR << "rows are ordered by their columns, " << node->child_->val_ << " is not one" << DISABLED;
+        return DB_FAILED;
+      }
+      ColumnRef ref;
+      if (!resolve(node->child_->val_, ref)) return DB_COLUMN_NAME_NOT_EXIST;
+      read[ref.first].push_back(ref.second);
+    }
+  }
+
+  struct JoinKey {
+    ColumnRef left;
+    ColumnRef right;
+  };
+  std::vector<JoinKey> keys;
+  std::vector<std::vector<pSyntaxNode>> pushed(tables.size());
+  std::vector<std::pair<uint32_t, pSyntaxNode>> residuals;
+  for (auto conjunct : conjuncts) {
+    std::vector<pSyntaxNode> column_nodes;
+    collect_column_nodes(conjunct, column_nodes);
+    std::vector<ColumnRef> refs;
+    for (auto node : column_nodes) {
+      refs.emplace_back();
+      if (!resolve(node->val_, refs.back())) return DB_COLUMN_NAME_NOT_EXIST;
+      read[refs.back().first].push_back(refs.back().second);
+    }
+    if (compares_columns(conjunct)) {
+      if (conjunct->type_ != kNodeCompareOperator || strcmp(conjunct->val_, "=") != 0 ||
+          refs[0].first == refs[1].first || column_of(refs[0])->GetType() != column_of(refs[1])->GetType()) {
+        ENABLE_ERROR << "columns are only compared by = to join two tables, on columns of the same type" << DISABLED;
+        return DB_FAILED;
+      }
+      keys.push_back(refs[0].first < refs[1].first ? JoinKey{refs[0], refs[1]} : JoinKey{refs[1], refs[0]});
+      continue;
+    }
+    uint32_t last = 0;
+    bool single = true;
+    for (auto &ref : refs) {
+      single = single && ref.first == refs[0].first;
+      last = std::max(last, ref.first);
+    }
+    if (!single) {
+      residuals.emplace_back(last, conjunct);
+      continue;
+    }
+    // the scan of the table reads its columns by their names alone
+    for (auto node : column_nodes) {
+      char *dot = strchr(node->val_, '.');
+      if (dot != nullptr) node->val_ = dot + 1;
+    }
+    pushed[last].push_back(conjunct);
+  }
+
+  // the rows of a table hand out the columns read in the order of the table, those of the join the rows of
+  // the tables one after the other
+  std::vector<uint32_t> offsets(tables.size() + 1, 0);
+  std::vector<std::unique_ptr<Schema>> schemas;
+  std::vector<Column *> joined_columns;
+  for (uint32_t t = 0; t < tables.size(); t++) {
+    auto &columns = read[t];
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+    // a table none of whose columns are used still has rows to join
+    if (columns.empty()) columns.push_back(0);
+    std::vector<Column *> table_columns;
+    for (auto c : columns) table_columns.push_back(const_cast<Column *>(tables[t]->GetSchema()->GetColumn(c)));
+    joined_columns.insert(joined_columns.end(), table_columns.begin(), table_columns.end());
+    schemas.push_back(std::make_unique<Schema>(table_columns));
+    offsets[t + 1] = offsets[t] + static_cast<uint32_t>(columns.size());
   }
+  auto position = [&read, &offsets](const ColumnRef &ref) {
+    auto &columns = read[ref.first];
+    return offsets[ref.first] +
+           static_cast<uint32_t>(std::lower_bound(columns.begin(), columns.end(), ref.second) - columns.begin());
+  };
+  Schema joined_schema(joined_columns);
+
+  // a condition checked on the joined rows, its compares read the columns where the join put them
+  std::function<std::unique_ptr<RowCondition>(pSyntaxNode)> joined_condition = [&](pSyntaxNode node) {
+    if (node->type_ == kNodeConnector) {
+      auto lhs = joined_condition(node->child_);
+      auto rhs = joined_condition(node->child_->next_);
+      if (lhs == nullptr || rhs == nullptr) return std::unique_ptr<RowCondition>();
+      return std::make_unique<RowCondition>(strcmp(node->val_, "and") == 0, std::move(lhs), std::move(rhs));
+    }
+    ColumnRef ref;
+    resolve(node->child_->val_, ref);
+    CompareOp op;
+    [[maybe_unused]] bool is_op = ScanPredicate::ParseOp(node->val_, op);
+    ASSERT(is_op, "Invalid compare token");
+    Field key_field = make_field(column_of(ref), node->child_->next_);
+    if (key_field.GetTypeId() == kTypeInvalid) return std::unique_ptr<RowCondition>();
+    return std::make_unique<RowCondition>(ScanPredicate::Create(&joined_schema, position(ref), op, key_field));
+  };
 
-  pretty_print(table_info, used_columns, table_column_names, ans_set);
+  // the size of a table is its pages, the fraction of them an analyzed table is expected to keep, its rows are
+  // counted only if it was analyzed or a unique key picks one, and reading it costs a scan or the lookups of
+  // its condition
+  std::vector<pSyntaxNode> conditions;
+  std::vector<double> sizes, rows, costs;
+  for (uint32_t t = 0; t < tables.size(); t++) {
+    conditions.push_back(and_of(pushed[t]));
+    auto statistics = tables[t]->GetStatistics();
+    auto access = conditions[t] != nullptr ? plan_access(conditions[t], tables[t]) : AccessPath();
+    if (statistics != nullptr) {
+      double selectivity = conditions[t] != nullptr ? estimate_selectivity(conditions[t], tables[t]) : 1.0;
+      sizes.push_back(statistics->GetPageCount() * selectivity);
+      rows.push_back(statistics->GetRowCount() * selectivity);
+      costs.push_back(access.probe != nullptr ? access.cost : statistics->ScanCost());
+    } else {
+      // a table never analyzed is sized by walking its pages
+      double pages = static_cast<double>(tables[t]->GetTableHeap()->ScanPages(nullptr).size());
+      bool unique = access.probe != nullptr && access.rank == 3;
+      sizes.push_back(pages);
+      rows.push_back(unique ? 1 : std::numeric_limits<double>::infinity());
+      costs.push_back(unique ? INDEX_PROBE_COST + FETCH_PAGE_COST : pages * SEQ_PAGE_COST);
+    }
+  }
 
+  // scans -> joins, each with the filter of the conditions its table completes -> projection -> output
+  OperatorPtr plan = plan_scan(conditions[0], tables[0], read[0]);
+  if (plan == nullptr) return DB_FAILED;
+  double size = sizes[0], count = rows[0];
+  for (uint32_t t = 1; t < tables.size(); t++) {
+    std::vector<JoinKey> table_keys;
+    for (auto &key : keys) {
+      if (key.right.first == t) table_keys.push_back(key);
+    }
+    // a key of the table with an index of its own may be looked up for each row joined so far, the key of a
+    // unique column first
+    auto statistics = tables[t]->GetStatistics();
+    IndexInfo *index_info = nullptr;
+    for (uint32_t i = 0; i < table_keys.size(); i++) {
+      auto left = column_of(table_keys[i].left), right = column_of(table_keys[i].right);
+      // the index holds keys as long as the column, a longer char of the other table is not looked up
+      if (left->GetLength() != right->GetLength()) continue;
+      // only the index of the primary key or of a unique column is looked up
+      IndexInfo *found = find_index(tables[t], right->GetName());
+      if (found == nullptr || (!right->IsUnique() && found->GetIndexName() != "_primary_keys")) continue;
+      if (index_info != nullptr && !right->IsUnique()) continue;
+      index_info = found;
+      std::swap(table_keys[0], table_keys[i]);
+    }
+    double matches = 1, index_cost = std::numeric_limits<double>::infinity();
+    if (index_info != nullptr && count < std::numeric_limits<double>::infinity()) {
+      uint32_t column = table_keys[0].right.second;
+      if (statistics != nullptr) {
+        // a key of a column that is not unique is taken to find as many rows as any of its values has
+        double distinct = std::max(1u, statistics->GetDistinctCount(column));
+        if (!tables[t]->GetSchema()->GetColumn(column)->IsUnique()) {
+          matches = (statistics->GetRowCount() - statistics->GetNullCount(column)) / distinct;
+        }
+        index_cost = statistics->LookupCost(count, count * matches);
+        matches *= rows[t] / std::max(1u, statistics->GetRowCount());
+      } else {
+        index_cost = count * (INDEX_PROBE_COST + FETCH_PAGE_COST);
+      }
+    }
+
+    if (index_cost < costs[t]) {
+      // few rows joined so far: the keys they have are looked up, the condition of the table is checked on
+      // the rows found
+      std::vector<uint32_t> outer_keys, inner_keys;
+      for (auto &key : table_keys) {
+        outer_keys.push_back(position(key.left));
+        inner_keys.push_back(key.right.second);
+      }
+      std::unique_ptr<RowCondition> condition;
+      std::vector<uint32_t> columns = read[t];
+      columns.insert(columns.end(), inner_keys.begin(), inner_keys.end());
+      if (conditions[t] != nullptr) {
+        condition = parse_row_condition(conditions[t], tables[t]);
+        if (condition == nullptr) return DB_FAILED;
+        condition->CollectColumns(columns);
+      }
+      auto lookup = [index_info](const Field &key, std::vector<RowId> &rids) {
+        std::vector<Field> fields;
+        fields.push_back(key);
+        Row key_row(fields);
+        if (index_info->MayContain(key_row)) index_info->GetIndex()->ScanKey(key_row, rids, nullptr);
+      };
+      plan = std::make_unique<IndexJoinOperator>(std::move(plan), tables[t]->GetTableHeap(), read[t],
+                                                 std::move(columns), std::move(outer_keys), std::move(inner_keys),
+                                                 std::move(lookup), std::move(condition));
+      size = std::max(size, sizes[t]);
+      count *= matches;
+    } else {
+      std::vector<uint32_t> left_keys, right_keys;
+      for (auto &key : table_keys) {
+        left_keys.push_back(position(key.left));
+        right_keys.push_back(position(key.right) - offsets[t]);
+      }
+      auto scan = plan_scan(conditions[t], tables[t], read[t]);
+      if (scan == nullptr) return DB_FAILED;
+      std::vector<Column *> left_columns(joined_columns.begin(), joined_columns.begin() + offsets[t]);
+      schemas.push_back(std::make_unique<Schema>(left_columns));
+      // the smaller side is the one held in memory
+      bool build_left = size < sizes[t];
+      plan = std::make_unique<HashJoinOperator>(std::move(plan), std::move(scan), schemas.back().get(),
+                                                schemas[t].get(), std::move(left_keys), std::move(right_keys),
+                                                build_left);
+      // a join on keys is taken to find about as many rows as its larger side, as one along a foreign key does
+      bool has_keys = !table_keys.empty();
+      size = has_keys ? std::max(size, sizes[t]) : size * sizes[t];
+      count = has_keys ? std::max(count, rows[t]) : count * rows[t];
+    }
+    for (auto &residual : residuals) {
+      if (residual.first != t) continue;
+      auto condition = joined_condition(residual.second);
+      if (condition == nullptr) return DB_FAILED;
+      plan = std::make_unique<FilterOperator>(std::move(plan), std::move(condition));
+    }
+  }
+  if (aggregate) {
+    auto locate = [&resolve, &position](const char *name, uint32_t &column) {
+      ColumnRef ref;
+      if (!resolve(name, ref)) return false;
+      column = position(ref);
+      return true;
+    };
+    plan = plan_aggregate(std::move(plan), &joined_schema, ast, locate);
+    if (plan == nullptr) return DB_FAILED;
+    plan = plan_order(std::move(plan), ast, [ast](pSyntaxNode node, uint32_t &position) {
+      return locate_selected(ast, node, position);
+    });
+    if (plan == nullptr) return DB_FAILED;
+  } else {
+    plan = plan_order(std::move(plan), ast, [&resolve, &position](pSyntaxNode node, uint32_t &column) {
+      ColumnRef ref;
+      resolve(node->val_, ref);
+      column = position(ref);
+      return true;
+    });
+    if (plan == nullptr) return DB_FAILED;
+    std::vector<uint32_t> output_columns;
+    for (auto &ref : outputs) output_columns.push_back(position(ref));
+    plan = std::make_unique<ProjectionOperator>(std::move(plan), std::move(output_columns));
+  }
+  OutputOperator output(std::move(plan));
+  output.Run();
   return DB_SUCCESS;
 }
 
@@ -400,8 +1041,17 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
     ENABLE_ERROR << "insertion failed (unique key constraints violated)" << DISABLED;
     return DB_FAILED;
   }
-  Row data_row(data_tuple);
-  if (!tb_info->GetTableHeap()->InsertTuple(data_row, nullptr)) {
+  Row data_row(data_tuple, &statement_heap_);
+  auto table_heap = tb_info->GetTableHeap();
+  // the primary key of a clustered table is looked up on the page of the key
+  if (table_heap->IsClustered() && table_heap->FindKey(data_row, nullptr)) {
+    ENABLE_ERROR << "insertion failed (unique key constraints violated)" << DISABLED;
+    return DB_FAILED;
+  }
+  for (std::size_t i = 0; i < tb_info->GetSchema()->GetColumnCount(); i++) {
+    column_index.emplace(tb_info->GetSchema()->GetColumn(i)->GetName(), i);
+  }
+  if (!table_heap->InsertTuple(data_row, nullptr, reindex_moved(table_name, column_index))) {
     ENABLE_ERROR << "insertion failed (entry too large)" << DISABLED;
     return DB_FAILED;
   }
@@ -436,6 +1086,7 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
     for (auto &idx : database_structure[current_db_][table_name]) {
       dbs_[current_db_]->catalog_mgr_->GetIndex(table_name, idx.first, index_info);
       index_info->GetIndex()->Destroy();
+      index_info->GetFilter()->Clear();
     }
     table_info->GetTableHeap()->FreeHeap();
   } else {
@@ -446,11 +1097,22 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
     std::unordered_set<RowId> toRemove;
     if (!parse_condition(ast->child_, table_info, toRemove)) return DB_FAILED;
     auto table_heap = table_info->GetTableHeap();
+    // only the index keys are needed, the chars stored out of line are freed without being read
+    std::vector<uint32_t> keyed;
+    IndexInfo *index_info = nullptr;
+    for (auto &idx : database_structure[current_db_][table_name]) {
+      if (dbs_[current_db_]->catalog_mgr_->GetIndex(table_name, idx.first, index_info) == DB_FAILED) continue;
+      for (auto &col : index_info->GetIndexKeySchema()->GetColumns()) keyed.push_back(column_index[col->GetName()]);
+    }
 
+    // the fields of a removed row are dropped before the next one is read
+    ArenaMemHeap row_heap;
     for (auto &rid : toRemove) {
-      Row data(rid);
-      if (table_heap->GetTuple(&data, nullptr) == false) ASSERT(false, "error when parsing conditions");
+      row_heap.Reset();
+      Row data(rid, &row_heap);
+      if (table_heap->GetTuple(&data, nullptr, keyed) == false) ASSERT(false, "error when parsing conditions");
       update_index(table_name, data.GetRowId(), data.GetFields(), column_index, false);
+      table_heap->ApplyDelete(rid, nullptr);
     }
   }
 
@@ -482,10 +1144,10 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
     column_index.insert(std::make_pair(col->GetName(), i));
     ++i;
   }
+  ASSERT(ast->next_->type_ == kNodeUpdateValues, "Wrong Type");
   auto update_node = ast->next_->child_;
 
   // fetch updated values
-  ASSERT(update_node->type_ == kNodeUpdateValues, "Wrong Type");
   while (update_node) {
     auto f = get_field(update_node->child_, table_info);
     std::string col_name{update_node->child_->val_};
@@ -507,7 +1169,7 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
   // now we have all the effected rows.
   do_update(table_info, updated, ans_set, column_index);
 
-  return DB_FAILED;
+  return DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteTrxBegin(pSyntaxNode ast, ExecuteContext *context) {
@@ -547,6 +1209,171 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
   return DB_SUCCESS;
 }
 
+dberr_t ExecuteEngine::ExecuteCopy(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteCopy" << std::endl;
+#endif
+  ASSERT(ast->child_ != nullptr && ast->child_->next_ != nullptr, "Unexpected Tree Structure");
+  if (current_db_.empty()) {
+    ENABLE_ERROR << "Current Database Not Assigned" << DISABLED;
+    return DB_FAILED;
+  }
+  auto target_db = dbs_[current_db_];
+  std::string table_name(ast->child_->val_);
+  std::string file_name(ast->child_->next_->val_);
+
+  TableInfo *tb_info = nullptr;
+  if (target_db->catalog_mgr_->GetTable(table_name, tb_info) == DB_FAILED) {
+    ENABLE_ERROR << "table " << table_name << " not exist" << DISABLED;
+    return DB_TABLE_NOT_EXIST;
+  }
+  CsvReader reader(file_name);
+  if (!reader.IsOpen()) {
+    ENABLE_ERROR << "cannot open file " << file_name << DISABLED;
+    return DB_FAILED;
+  }
+
+  // key columns of every index, the keys are collected and loaded after the last row
+  std::vector<IndexInfo *> indexes;
+  std::vector<std::vector<uint32_t>> key_columns;
+  for (auto &it : database_structure[current_db_][table_name]) {
+    IndexInfo *index = nullptr;
+    if (target_db->catalog_mgr_->GetIndex(table_name, it.first, index) == DB_FAILED) continue;
+    std::vector<uint32_t> columns;
+    for (auto col : index->GetIndexKeySchema()->GetColumns()) {
+      uint32_t column_id;
+      tb_info->GetSchema()->GetColumnIndex(col->GetName(), column_id);
+      columns.push_back(column_id);
+    }
+    indexes.push_back(index);
+    key_columns.push_back(std::move(columns));
+  }
+  std::vector<std::deque<Row>> keys(indexes.size());
+
+  auto table_heap = tb_info->GetTableHeap();
+  std::vector<RowId> row_ids;
+  std::vector<CsvField> record;
+  std::vector<Field> data_tuple;
+  std::vector<Field> key_fields;
+  // nothing of a failed copy stays in the table
+  auto roll_back = [&]() {
+    table_heap->ReleaseInsertPage();
+    for (auto &rid : row_ids) table_heap->ApplyDelete(rid, nullptr);
+  };
+  // a clustered heap moves rows when it splits a page: the rows copied so far are indexed at the end,
+  // the rows that were there before are indexed already
+  std::unordered_map<RowId, size_t> copied;
+  std::unordered_map<std::string, std::size_t> column_index;
+  for (std::size_t i = 0; i < tb_info->GetSchema()->GetColumnCount(); i++) {
+    column_index.emplace(tb_info->GetSchema()->GetColumn(i)->GetName(), i);
+  }
+  auto reindex = reindex_moved(table_name, column_index);
+  auto moved = [&](Row &row, const RowId &old_rid) {
+    auto it = copied.find(old_rid);
+    if (it == copied.end()) {
+      reindex(row, old_rid);
+      return;
+    }
+    auto position = it->second;
+    copied.erase(it);
+    row_ids[position] = row.GetRowId();
+    copied.emplace(row.GetRowId(), position);
+  };
+  // consecutive rows keep filling the same page without a trip through the free space map
+  table_heap->HoldInsertPage();
+  // a row lives until it is inserted, only its keys stay for the bulk load
+  ArenaMemHeap row_heap;
+  while (reader.NextRecord(record)) {
+    row_heap.Reset();
+    data_tuple.clear();
+    if (!make_csv_tuple(record, *tb_info->GetSchema(), data_tuple)) {
+      roll_back();
+      ENABLE_ERROR << "copy failed (data types unmatched at line " << reader.GetLineNo() << ")" << DISABLED;
+      return DB_FAILED;
+    }
+    Row data_row(data_tuple, &row_heap);
+    if (table_heap->IsClustered() && table_heap->FindKey(data_row, nullptr)) {
+      roll_back();
+      ENABLE_ERROR << "copy failed (unique key constraints violated at line " << reader.GetLineNo() << ")" << DISABLED;
+      return DB_FAILED;
+    }
+    if (!table_heap->InsertTuple(data_row, nullptr, moved)) {
+      roll_back();
+      ENABLE_ERROR << "copy failed (entry too large at line " << reader.GetLineNo() << ")" << DISABLED;
+      return DB_FAILED;
+    }
+    if (table_heap->IsClustered()) copied.emplace(data_row.GetRowId(), row_ids.size());
+    row_ids.push_back(data_row.GetRowId());
+    for (size_t i = 0; i < indexes.size(); i++) {
+      key_fields.clear();
+      for (auto column_id : key_columns[i]) key_fields.push_back(data_tuple[column_id]);
+      keys[i].emplace_back(key_fields, &statement_heap_);
+    }
+  }
+  table_heap->ReleaseInsertPage();
+  if (reader.IsMalformed()) {
+    roll_back();
+    ENABLE_ERROR << "copy failed (malformed record at line " << reader.GetLineNo() << ")" << DISABLED;
+    return DB_FAILED;
+  }
+
+  for (size_t i = 0; i < indexes.size(); i++) {
+    if (indexes[i]->GetIndex()->BulkLoad(keys[i], row_ids, nullptr) == DB_SUCCESS) continue;
+    for (size_t j = 0; j < i; j++) {
+      for (size_t k = 0; k < row_ids.size(); k++) indexes[j]->GetIndex()->RemoveEntry(keys[j][k], row_ids[k], nullptr);
+    }
+    roll_back();
+    ENABLE_ERROR << "copy failed (unique key constraints violated)" << DISABLED;
+    return DB_FAILED;
+  }
+  for (size_t i = 0; i < indexes.size(); i++) {
+    for (auto &key : keys[i]) indexes[i]->AddToFilter(key);
+  }
+  std::cout << row_ids.size() << " rows copied" << std::endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuum" << std::endl;
+#endif
+  if (current_db_.empty()) {
+    ENABLE_ERROR << "Current Database Not Assigned" << DISABLED;
+    return DB_FAILED;
+  }
+  std::string table_name(ast->child_->val_);
+  TableInfo *tb_info = nullptr;
+  if (dbs_[current_db_]->catalog_mgr_->GetTable(table_name, tb_info) == DB_FAILED) {
+    ENABLE_ERROR << "table " << table_name << " not exist" << DISABLED;
+    return DB_TABLE_NOT_EXIST;
+  }
+  std::unordered_map<std::string, std::size_t> column_index;
+  for (std::size_t i = 0; i < tb_info->GetSchema()->GetColumnCount(); i++) {
+    column_index.emplace(tb_info->GetSchema()->GetColumn(i)->GetName(), i);
+  }
+  auto freed = tb_info->GetTableHeap()->Vacuum(nullptr, reindex_moved(table_name, column_index));
+  std::cout << freed << " pages freed" << std::endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteAnalyze" << std::endl;
+#endif
+  if (current_db_.empty()) {
+    ENABLE_ERROR << "Current Database Not Assigned" << DISABLED;
+    return DB_FAILED;
+  }
+  std::string table_name(ast->child_->val_);
+  TableStatistics *statistics = nullptr;
+  if (dbs_[current_db_]->catalog_mgr_->AnalyzeTable(table_name, statistics) != DB_SUCCESS) {
+    ENABLE_ERROR << "table " << table_name << " not exist" << DISABLED;
+    return DB_TABLE_NOT_EXIST;
+  }
+  std::cout << statistics->GetRowCount() << " rows, " << statistics->GetPageCount() << " pages analyzed" << std::endl;
+  return DB_SUCCESS;
+}
+
 bool ExecuteEngine::generate_db_struct(const string &db_name, const DBStorageEngine *db) {
   if (!db) return false;
   std::vector<TableInfo *> all_tables;
@@ -592,7 +1419,7 @@ void ExecuteEngine::make_db_tuple(pSyntaxNode head, const Schema &schema,
       };
 
       case (kNodeNumber): {
-        if (table_columns[i]->GetType() != kTypeFloat || table_columns[i]->GetType() != kTypeInt) goto ERROR;
+        if (table_columns[i]->GetType() != kTypeFloat && table_columns[i]->GetType() != kTypeInt) goto ERROR;
         if (table_columns[i]->GetType() == kTypeFloat) {
           tup.emplace_back(TypeId::kTypeFloat, (float)atof(cur->val_));
         } else if (table_columns[i]->GetType() == kTypeInt) {
@@ -611,6 +1438,45 @@ ERROR:
   tup.clear();
 }
 
+bool ExecuteEngine::make_csv_tuple(const std::vector<CsvField> &record, const Schema &schema,
+                                   std::vector<Field> &tup) {
+  auto &table_columns = schema.GetColumns();
+  if (record.size() != table_columns.size()) return false;
+  for (size_t i = 0; i < record.size(); i++) {
+    auto &text = record[i].text;
+    auto type = table_columns[i]->GetType();
+    if (record[i].is_null) {
+      if (!table_columns[i]->IsNullable()) return false;
+      tup.emplace_back(type);
+      continue;
+    }
+    switch (type) {
+      case kTypeInt: {
+        int32_t value;
+        auto res = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (res.ec != std::errc() || res.ptr != text.data() + text.size()) return false;
+        tup.emplace_back(kTypeInt, value);
+        break;
+      }
+      case kTypeFloat: {
+        float value;
+        auto res = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (res.ec != std::errc() || res.ptr != text.data() + text.size()) return false;
+        tup.emplace_back(kTypeFloat, value);
+        break;
+      }
+      case kTypeChar: {
+        if (text.size() > table_columns[i]->GetLength()) return false;
+        tup.emplace_back(kTypeChar, const_cast<char *>(text.data()), text.size(), true);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
 bool ExecuteEngine::check_index_constrains(const std::string &table_name, const std::vector<Field> &data_tuple,
                                            std::unordered_map<std::string, std::size_t> &column_index) {
   auto &indexes = database_structure[current_db_][table_name];
@@ -618,15 +1484,21 @@ bool ExecuteEngine::check_index_constrains(const std::string &table_name, const
   std::vector<Field> key_fields;
   std::vector<RowId> results;
   IndexInfo *index = nullptr;
+  // the key of one index at a time
+  ArenaMemHeap key_heap(ROW_HEAP_CHUNK_SIZE);
   for (auto it = indexes.begin(); it != indexes.end(); ++it) {
     if (db_engine->catalog_mgr_->GetIndex(table_name, it->first, index) != DB_FAILED) {
       ASSERT(index != nullptr, "Invalid Fetch");
+      key_heap.Reset();
       key_fields.clear();
       for (auto &col_name : index->GetIndexKeySchema()->GetColumns()) {
         std::string name{col_name->GetName()};
         key_fields.push_back(data_tuple[column_index[name]]);
       }
-      if (index->GetIndex()->ScanKey(Row(key_fields), results, nullptr) == DB_SUCCESS) return false;
+      Row key_row(key_fields, &key_heap);
+      // most new keys are rejected by the filter without touching the tree
+      if (!index->MayContain(key_row)) continue;
+      if (index->GetIndex()->ScanKey(key_row, results, nullptr) == DB_SUCCESS) return false;
     }
   }
 
@@ -640,18 +1512,22 @@ void ExecuteEngine::update_index(const string &table_name, const RowId &rid, con
   std::vector<Field> key_fields;
   std::vector<RowId> results;
   IndexInfo *index = nullptr;
+  // the key of one index at a time
+  ArenaMemHeap key_heap(ROW_HEAP_CHUNK_SIZE);
   for (auto it = indexes.begin(); it != indexes.end(); ++it) {
     if (db_engine->catalog_mgr_->GetIndex(table_name, it->first, index) != DB_FAILED) {
       ASSERT(index != nullptr, "Invalid Fetch");
+      key_heap.Reset();
       key_fields.clear();
       for (auto &col_name : index->GetIndexKeySchema()->GetColumns()) {
         std::string name{col_name->GetName()};
         key_fields.push_back(data_tuple[column_index[name]]);
       }
-      if (insert)
-        index->GetIndex()->InsertEntry(Row(key_fields), rid, nullptr);
-      else
-        index->GetIndex()->RemoveEntry(Row(key_fields), rid, nullptr);
+      Row key_row(key_fields, &key_heap);
+      if (insert) {
+        if (index->GetIndex()->InsertEntry(key_row, rid, nullptr) == DB_SUCCESS) index->AddToFilter(key_row);
+      } else
+        index->GetIndex()->RemoveEntry(key_row, rid, nullptr);
     }
   }
 }
@@ -663,23 +1539,53 @@ void ExecuteEngine::update_index(const string &table_name, const RowId &rid, con
   std::vector<Field> key_fields;
   std::vector<RowId> results;
   IndexInfo *index = nullptr;
+  // the key of one index at a time
+  ArenaMemHeap key_heap(ROW_HEAP_CHUNK_SIZE);
   for (auto it = indexes.begin(); it != indexes.end(); ++it) {
     if (db_engine->catalog_mgr_->GetIndex(table_name, it->first, index) != DB_FAILED) {
       ASSERT(index != nullptr, "Invalid Fetch");
+      key_heap.Reset();
       key_fields.clear();
       for (auto &col_name : index->GetIndexKeySchema()->GetColumns()) {
         std::string name{col_name->GetName()};
         key_fields.push_back(*data_tuple[column_index[name]]);
       }
-      if (insert)
-        index->GetIndex()->InsertEntry(Row(key_fields), rid, nullptr);
-      else
-        index->GetIndex()->RemoveEntry(Row(key_fields), rid, nullptr);
+      Row key_row(key_fields, &key_heap);
+      if (insert) {
+        if (index->GetIndex()->InsertEntry(key_row, rid, nullptr) == DB_SUCCESS) index->AddToFilter(key_row);
+      } else
+        index->GetIndex()->RemoveEntry(key_row, rid, nullptr);
     }
   }
 }
 
-bool ExecuteEngine::parse_column_definitions(const string &table_name, pSyntaxNode head) {
+TableHeap::MoveCallback ExecuteEngine::reindex_moved(const string &table_name,
+                                                     unordered_map<std::string, std::size_t> &column_index) {
+  // a moved row is found by the indexes at its new rid
+  return [this, table_name, &column_index](Row &row, const RowId &old_rid) {
+    update_index(table_name, old_rid, row.GetFields(), column_index, false);
+    update_index(table_name, row.GetRowId(), row.GetFields(), column_index, true);
+  };
+}
+
+bool ExecuteEngine::parse_table_options(pSyntaxNode head, TableLayout &layout) {
+  for (; head != nullptr; head = head->next_) {
+    ASSERT(head->type_ == kNodeTableOption, "Unexpected Syntax Tree Structure");
+    std::string name{head->child_->val_}, value{head->child_->next_->val_};
+    if (name != "layout") return false;
+    if (value == "row") {
+      layout = TableLayout::kRow;
+    } else if (value == "column") {
+      layout = TableLayout::kColumn;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ExecuteEngine::parse_column_definitions(const string &table_name, pSyntaxNode head, TableLayout layout,
+                                             bool clustered) {
   if (!head) return false;
 
   TableInfo *table_info = nullptr;
@@ -687,12 +1593,24 @@ bool ExecuteEngine::parse_column_definitions(const string &table_name, pSyntaxNo
   std::vector<Column *> table_defs;
   int i = 0;
 
+  // a key column is never null, the columns of the primary key are listed after the others
+  std::unordered_set<std::string> key_columns;
+  for (auto node = head; node != nullptr; node = node->next_) {
+    if (node->type_ != kNodeColumnList) continue;
+    for (auto key_node = node->child_; key_node != nullptr; key_node = key_node->next_) {
+      key_columns.insert(key_node->val_);
+    }
+  }
+
   while (head && head->type_ != kNodeColumnList) {
     bool is_unique = false;
-    bool is_nullable = true;
-    if (strcmp(head->val_, "unique") == 0)  // this is a unique
+    bool is_nullable = key_columns.count(head->child_->val_) == 0;
+    if (head->val_ == nullptr)  // plain column
+      ;
+    else if (strcmp(head->val_, "unique") == 0) {  // this is a unique
       is_unique = true;
-    else if (strcmp(head->val_, "not null") == 0)  // not null
+      is_nullable = false;
+    } else if (strcmp(head->val_, "not null") == 0)  // not null
       is_nullable = false;
     Column *column = parse_single_column(head->child_, i, is_nullable, is_unique);
     i++;
@@ -705,25 +1623,38 @@ bool ExecuteEngine::parse_column_definitions(const string &table_name, pSyntaxNo
     head = head->next_;
   }
 
-  //  void *buf = mem_heap->Allocate(sizeof(TableSchema));
-  auto *tb_schema = new TableSchema(table_defs);
-
-  dbs_[current_db_]->catalog_mgr_->CreateTable(table_name, tb_schema, nullptr, table_info);
-  if (!table_info) goto ERROR;
-  database_structure[current_db_].insert(std::make_pair(table_name, PseudoIndex()));
-
+  std::vector<std::string> pm_keys;
+  std::vector<uint32_t> cluster_key;
   if (head) {
     ASSERT(head->type_ == kNodeColumnList, "Unexpected Syntax Tree Structure");
-    head = head->child_;
-    std::vector<std::string> pm_keys;
-    std::unordered_set<std::string> key_set;
-
     // generate primary key
-    while (head) {
-      pm_keys.emplace_back(head->val_);
-      head = head->next_;
+    for (auto key_node = head->child_; key_node != nullptr; key_node = key_node->next_) {
+      pm_keys.emplace_back(key_node->val_);
+    }
+  }
+  for (auto &key : clustered ? pm_keys : std::vector<std::string>()) {
+    auto column =
+        std::find_if(table_defs.begin(), table_defs.end(), [&](Column *col) { return col->GetName() == key; });
+    if (column == table_defs.end()) goto ERROR;
+    cluster_key.push_back(column - table_defs.begin());
+  }
+
+  {
+    //  void *buf = mem_heap->Allocate(sizeof(TableSchema));
+    auto *tb_schema = new TableSchema(table_defs);
+
+    // a column layout fails if not even one row fits a page
+    if (dbs_[current_db_]->catalog_mgr_->CreateTable(table_name, tb_schema, nullptr, table_info, layout,
+                                                     cluster_key) != DB_SUCCESS) {
+      delete tb_schema;
+      goto ERROR;
     }
+  }
+  database_structure[current_db_].insert(std::make_pair(table_name, PseudoIndex()));
 
+  // the rows of a clustered table are ordered by the primary key, they are found without an index
+  if (!pm_keys.empty() && !clustered) {
+    std::unordered_set<std::string> key_set(pm_keys.begin(), pm_keys.end());
     dbs_[current_db_]->catalog_mgr_->CreateIndex(table_name, "_primary_keys", pm_keys, nullptr, index_info);
     database_structure[current_db_][table_name].insert(std::make_pair("_primary_keys", std::move(key_set)));
   }
@@ -759,31 +1690,44 @@ Column *ExecuteEngine::parse_single_column(pSyntaxNode ast, const int column_pos
     for (auto &c : num_in_str)
       if (!isdigit(c)) return nullptr;
     int len = atoi(num_in_str.c_str());
-    // string is too long
-    if (len <= 0 || len >= 0xFF) return nullptr;
+    // string is too long, the long ones are kept out of line by the table heap
+    if (len <= 0 || len >= static_cast<int>(VARCHAR_MAX_LEN)) return nullptr;
     return new Column(column_name, TypeId::kTypeChar, len, column_position, is_nullable, is_unique);
   }
 
   return nullptr;
 }
 bool ExecuteEngine::parse_condition(pSyntaxNode ast, const TableInfo *table_info, std::unordered_set<RowId> &ans_set) {
+  auto condition = parse_row_condition(ast, table_info);
+  if (condition == nullptr) return false;
+  auto access = plan_access(ast, table_info);
+  if (access.exact) {
+    // the lookups find exactly the rows, none is read
+    access.probe(ans_set);
+    return true;
+  }
   if (ast->type_ == kNodeCompareOperator) {
-    return parse_compare(ast, table_info, ans_set);
-  } else if (ast->type_ == kNodeConnector) {
-    std::unordered_set<RowId> other;
-    bool b1 = parse_condition(ast->child_, table_info, ans_set);
-    bool b2 = parse_condition(ast->child_->next_, table_info, other);
-    if (b1 == false || b2 == false) return false;
-    if (strcmp(ast->val_, "and") == 0)
-      set_and(ans_set, other);
-    else if (strcmp(ast->val_, "or") == 0)
-      set_or(ans_set, other);
+    // a single compare is evaluated on the tuple bytes, the pages are scanned in parallel
+    table_info->GetTableHeap()->FetchId(ans_set, *parse_predicate(ast, table_info));
     return true;
-
-  } else
-    goto ERROR;
-ERROR:
-  ASSERT(false, "Unexpected Syntax Tree Structure");
+  }
+  // the rows the lookups or the pushed down compare find are read and the whole condition is checked on them
+  std::vector<uint32_t> columns;
+  condition->CollectColumns(columns);
+  auto table_heap = table_info->GetTableHeap();
+  OperatorPtr scan;
+  if (access.probe != nullptr) {
+    scan = std::make_unique<IndexScanOperator>(table_heap, std::move(columns), access.probe);
+  } else {
+    pSyntaxNode pushed = find_pushed(ast, table_info);
+    scan = std::make_unique<SeqScanOperator>(table_heap, std::move(columns),
+                                             pushed != nullptr ? parse_predicate(pushed, table_info) : nullptr);
+  }
+  FilterOperator filter(std::move(scan), std::move(condition));
+  filter.Init();
+  const Row *row;
+  while (filter.Next(&row)) ans_set.insert(row->GetRowId());
+  return true;
 }
 
 bool ExecuteEngine::parse_compare(pSyntaxNode ast, const TableInfo *table_info, std::unordered_set<RowId> &ans_set) {
@@ -791,7 +1735,9 @@ bool ExecuteEngine::parse_compare(pSyntaxNode ast, const TableInfo *table_info,
   std::string compare_token{ast->val_};
   std::string key_column_name{ast->child_->val_};
 
-  ASSERT(comparisons.count(compare_token) != 0, "Invalid compare token");
+  CompareOp op;
+  [[maybe_unused]] bool is_op = ScanPredicate::ParseOp(compare_token, op);
+  ASSERT(is_op, "Invalid compare token");
   // std::string compare_key_str{ast->child_->next_->val_};
   uint32_t key_index;
   if (table_info->GetSchema()->GetColumnIndex(key_column_name, key_index) == DB_FAILED) {
@@ -806,21 +1752,27 @@ bool ExecuteEngine::parse_compare(pSyntaxNode ast, const TableInfo *table_info,
 
   if (key_field.GetTypeId() == kTypeInvalid) return false;
 
-  if (index_info && compare_token == "=")  // has a index '='    ueey, just scan key.
+  auto table_heap = table_info->GetTableHeap();
+  if (table_heap->IsClustered() && table_heap->GetClusterKey()[0] == key_index &&
+      table_heap->FetchKeyRange(ans_set, op, key_field)) {
+    // a range of the key the rows are ordered by, only the pages holding it are read
+  } else if (index_info && compare_token == "=")  // has a index '='    ueey, just scan key.
   {
     std::vector<Field> f;
     f.push_back(key_field);
-    index_info->GetIndex()->ScanKey(Row(f), ans_set);
+    Row key_row(f, &statement_heap_);
+    if (index_info->MayContain(key_row)) index_info->GetIndex()->ScanKey(key_row, ans_set);
   } else if (!index_info || idx_comps.count(compare_token) == 0)  // no index, or the token cannot be proccssed by index
   {
-    table_info->GetTableHeap()->FetchId(ans_set, key_index, table_info->GetSchema(), key_field,
-                                        comparisons.find(compare_token)->second);
+    // filter on the tuple bytes, only the matching ids come out of the pages
+    auto predicate = ScanPredicate::Create(table_info->GetSchema(), key_index, op, key_field);
+    table_info->GetTableHeap()->FetchId(ans_set, *predicate);
   } else  // token can be done
   {
     std::vector<Field> f;
     f.push_back(key_field);
     auto cmp_args = idx_comps.find(compare_token)->second;
-    index_info->GetIndex()->RangeScanKey(Row(f), ans_set, cmp_args.left, cmp_args.key_included);
+    index_info->GetIndex()->RangeScanKey(Row(f, &statement_heap_), ans_set, cmp_args.left, cmp_args.key_included);
   }
 
   return true;
@@ -833,19 +1785,290 @@ Field ExecuteEngine::get_field(pSyntaxNode ast, const TableInfo *table_info) {
 
   uint32_t column_index;
   if (table_info->GetSchema()->GetColumnIndex(column_name, column_index) == DB_FAILED) return Field(kTypeInvalid);
-  const Column *column = table_info->GetSchema()->GetColumn(column_index);
+  return make_field(table_info->GetSchema()->GetColumn(column_index), val_node);
+}
+
+Field ExecuteEngine::make_field(const Column *column, pSyntaxNode val_node) {
   if (val_node->type_ == kNodeNull && column->IsNullable())
     return Field(column->GetType());
   else if (val_node->type_ == kNodeString && column->GetType() == kTypeChar)
     return Field(kTypeChar, val_node->val_, strlen(val_node->val_), true);
   else if (val_node->type_ == kNodeNumber && column->GetType() == kTypeFloat)
-    return Field(kTypeChar, (float)(atof(val_node->val_)));
+    return Field(kTypeFloat, (float)(atof(val_node->val_)));
   else if (val_node->type_ == kNodeNumber && column->GetType() == kTypeInt)
     return Field(kTypeInt, atoi(val_node->val_));
   else
     return Field(kTypeInvalid);
 }
 
+OperatorPtr ExecuteEngine::plan_scan(pSyntaxNode ast, const TableInfo *table_info, std::vector<uint32_t> columns) {
+  auto table_heap = table_info->GetTableHeap();
+  if (ast == nullptr) {
+    auto scan = plan_batches(nullptr, table_info, columns, nullptr);
+    return std::make_unique<VectorProjectionOperator>(std::move(scan), std::move(columns));
+  }
+  auto condition = parse_row_condition(ast, table_info);
+  if (condition == nullptr) return nullptr;
+  // the columns compared are read as well, chars stored out of line included
+  std::vector<uint32_t> read = columns;
+  condition->CollectColumns(read);
+  auto access = plan_access(ast, table_info);
+  if (access.probe != nullptr) {
+    // the few rows the lookups find are read one by one, the rest of the condition is checked on them
+    OperatorPtr scan = std::make_unique<IndexScanOperator>(table_heap, std::move(read), std::move(access.probe));
+    if (!access.exact) scan = std::make_unique<FilterOperator>(std::move(scan), std::move(condition));
+    return std::make_unique<ProjectionOperator>(std::move(scan), std::move(columns));
+  }
+  auto scan = plan_batches(ast, table_info, read, std::move(condition));
+  return std::make_unique<VectorProjectionOperator>(std::move(scan), std::move(columns));
+}
+
+VectorOperatorPtr ExecuteEngine::plan_batches(pSyntaxNode ast, const TableInfo *table_info,
+                                              const std::vector<uint32_t> &read,
+                                              std::unique_ptr<RowCondition> condition) {
+  auto table_heap = table_info->GetTableHeap();
+  if (ast == nullptr) return std::make_unique<VectorScanOperator>(table_heap, read);
+  // a scan of the whole table goes through the vectorized pipeline, a batch at a time, a single compare is
+  // all the scan has to check
+  pSyntaxNode pushed = find_pushed(ast, table_info);
+  VectorOperatorPtr scan = std::make_unique<VectorScanOperator>(
+      table_heap, read, pushed != nullptr ? parse_predicate(pushed, table_info) : nullptr);
+  if (ast->type_ != kNodeCompareOperator) {
+    scan = std::make_unique<VectorFilterOperator>(std::move(scan), std::move(condition));
+  }
+  return scan;
+}
+
+OperatorPtr ExecuteEngine::plan_aggregate(OperatorPtr plan, Schema *schema, pSyntaxNode ast,
+                                          const std::function<bool(const char *, uint32_t &)> &locate) {
+  std::vector<uint32_t> keys, outputs;
+  std::vector<Aggregate> aggregates;
+  if (!parse_aggregates(schema, ast, locate, keys, aggregates, outputs)) return nullptr;
+  plan = std::make_unique<HashAggregateOperator>(std::move(plan), schema, std::move(keys), std::move(aggregates));
+  return std::make_unique<ProjectionOperator>(std::move(plan), std::move(outputs));
+}
+
+OperatorPtr ExecuteEngine::plan_aggregate(VectorOperatorPtr batches, std::vector<uint32_t> columns, Schema *schema,
+                                          pSyntaxNode ast,
+                                          const std::function<bool(const char *, uint32_t &)> &locate) {
+  std::vector<uint32_t> keys, outputs;
+  std::vector<Aggregate> aggregates;
+  if (!parse_aggregates(schema, ast, locate, keys, aggregates, outputs)) return nullptr;
+  OperatorPtr plan = std::make_unique<HashAggregateOperator>(std::move(batches), std::move(columns), schema,
+                                                             std::move(keys), std::move(aggregates));
+  return std::make_unique<ProjectionOperator>(std::move(plan), std::move(outputs));
+}
+
+bool ExecuteEngine::parse_aggregates(Schema *schema, pSyntaxNode ast,
+                                     const std::function<bool(const char *, uint32_t &)> &locate,
+                                     std::vector<uint32_t> &keys, std::vector<Aggregate> &aggregates,
+                                     std::vector<uint32_t> &outputs) {
+  pSyntaxNode col_node = ast->child_, group_node = find_clause(ast, kNodeGroupBy);
+  if (col_node->type_ == kNodeAllColumns) {
+    ENABLE_ERROR << "the columns selected from groups are named, * is not one" << DISABLED;
+    return false;
+  }
+  if (group_node != nullptr) {
+    for (auto node = group_node->child_; node != nullptr; node = node->next_) {
+      keys.emplace_back();
+      if (!locate(node->val_, keys.back())) return false;
+    }
+  }
+  // the aggregation hands out the keys and then the aggregates, the projection puts them in the order selected
+  for (auto node = col_node->child_; node != nullptr; node = node->next_) {
+    if (node->type_ != kNodeAggregate) {
+      uint32_t column;
+      if (!locate(node->val_, column)) return false;
+      auto key = std::find(keys.begin(), keys.end(), column);
+      if (key == keys.end()) {
+        ENABLE_ERROR << "column " << node->val_ << " is neither grouped by nor aggregated" << DISABLED;
+        return false;
+      }
+      outputs.push_back(static_cast<uint32_t>(key - keys.begin()));
+      continue;
+    }
+    static const std::pair<const char *, AggregateFunction> functions[] = {
+        {"count", AggregateFunction::kCount}, {"sum", AggregateFunction::kSum}, {"avg", AggregateFunction::kAvg},
+        {"min", AggregateFunction::kMin},     {"max", AggregateFunction::kMax}};
+    auto function = std::find_if(std::begin(functions), std::end(functions),
+                                 [node](const auto &function) { return strcasecmp(node->val_, function.first) == 0; });
+    if (function == std::end(functions)) {
+      ENABLE_ERROR << "aggregate function " << node->val_ << " not exist" << DISABLED;
+      return false;
+    }
+    Aggregate aggregate{function->second, 0};
+    if (node->child_->type_ == kNodeAllColumns) {
+      if (aggregate.function != AggregateFunction::kCount) {
+        ENABLE_ERROR << "only count takes *" << DISABLED;
+        return false;
+      }
+      aggregate.function = AggregateFunction::kCountAll;
+    } else {
+      if (!locate(node->child_->val_, aggregate.column)) return false;
+      if ((aggregate.function == AggregateFunction::kSum || aggregate.function == AggregateFunction::kAvg) &&
+          schema->GetColumn(aggregate.column)->GetType() == kTypeChar) {
+        ENABLE_ERROR << node->val_ << " takes a column of int or float" << DISABLED;
+        return false;
+      }
+    }
+    outputs.push_back(static_cast<uint32_t>(keys.size() + aggregates.size()));
+    aggregates.push_back(aggregate);
+  }
+  return true;
+}
+
+OperatorPtr ExecuteEngine::plan_order(OperatorPtr plan, pSyntaxNode ast,
+                                      const std::function<bool(pSyntaxNode, uint32_t &)> &locate) {
+  size_t limit, offset;
+  if (!read_limit(ast, limit, offset)) return nullptr;
+  pSyntaxNode order_node = find_clause(ast, kNodeOrderBy);
+  if (order_node != nullptr) {
+    std::vector<SortKey> keys;
+    for (auto node = order_node->child_; node != nullptr; node = node->next_) {
+      keys.push_back({0, strcmp(node->val_, "desc") == 0});
+      if (!locate(node->child_, keys.back().column)) return nullptr;
+    }
+    // the rows skipped by the offset are among the least ones too
+    plan = std::make_unique<SortOperator>(std::move(plan), std::move(keys), limit_rows(limit, offset));
+  }
+  if (limit == SIZE_MAX && offset == 0) return plan;
+  return std::make_unique<LimitOperator>(std::move(plan), limit, offset);
+}
+
+ExecuteEngine::AccessPath ExecuteEngine::plan_access(pSyntaxNode ast, const TableInfo *table_info) {
+  auto path = plan_lookups(ast, table_info);
+  auto statistics = table_info->GetStatistics();
+  if (path.probe != nullptr && statistics != nullptr && path.cost >= statistics->ScanCost()) {
+    // the lookups find so many rows that reading them one by one costs more than scanning every page
+    return AccessPath();
+  }
+  return path;
+}
+
+ExecuteEngine::AccessPath ExecuteEngine::plan_lookups(pSyntaxNode ast, const TableInfo *table_info) {
+  AccessPath path;
+  auto statistics = table_info->GetStatistics();
+  if (ast->type_ == kNodeCompareOperator) {
+    path.rank = index_rank(ast, table_info);
+    if (path.rank > 0) {
+      path.probe = [this, ast, table_info](std::unordered_set<RowId> &rids) { parse_compare(ast, table_info, rids); };
+      path.exact = true;
+      if (statistics != nullptr) {
+        path.cost = statistics->IndexScanCost(estimate_selectivity(ast, table_info) * statistics->GetRowCount());
+      }
+    }
+    return path;
+  }
+  auto lhs = plan_lookups(ast->child_, table_info);
+  auto rhs = plan_lookups(ast->child_->next_, table_info);
+  if (strcmp(ast->val_, "and") == 0) {
+    // the rows of an and are among those of each side, the side expected to find fewer is looked up
+    bool left = statistics != nullptr ? lhs.cost <= rhs.cost : lhs.rank >= rhs.rank;
+    path = left ? std::move(lhs) : std::move(rhs);
+    path.exact = false;
+    return path;
+  }
+  // the rows of an or are the union of the lookups of its sides, if one side has none the table is scanned anyway
+  if (lhs.probe == nullptr || rhs.probe == nullptr) return path;
+  path.rank = std::min(lhs.rank, rhs.rank);
+  path.cost = lhs.cost + rhs.cost;
+  path.exact = lhs.exact && rhs.exact;
+  path.probe = [lhs = std::move(lhs.probe), rhs = std::move(rhs.probe)](std::unordered_set<RowId> &rids) {
+    lhs(rids);
+    rhs(rids);
+  };
+  return path;
+}
+
+pSyntaxNode ExecuteEngine::find_pushed(pSyntaxNode ast, const TableInfo *table_info) {
+  if (ast->type_ == kNodeCompareOperator) return ast;
+  if (strcmp(ast->val_, "and") != 0) return nullptr;
+  pSyntaxNode lhs = find_pushed(ast->child_, table_info);
+  pSyntaxNode rhs = find_pushed(ast->child_->next_, table_info);
+  if (lhs == nullptr || rhs == nullptr) return lhs != nullptr ? lhs : rhs;
+  // the compare that drops the most tuples leaves the least to the filter after the scan
+  if (table_info->GetStatistics() == nullptr) return lhs;
+  return estimate_selectivity(rhs, table_info) < estimate_selectivity(lhs, table_info) ? rhs : lhs;
+}
+
+double ExecuteEngine::estimate_selectivity(pSyntaxNode ast, const TableInfo *table_info) {
+  auto statistics = table_info->GetStatistics();
+  ASSERT(statistics != nullptr, "Table Not Analyzed");
+  if (ast->type_ == kNodeCompareOperator) {
+    CompareOp op;
+    uint32_t key_index;
+    if (!ScanPredicate::ParseOp(ast->val_, op) ||
+        table_info->GetSchema()->GetColumnIndex(ast->child_->val_, key_index) == DB_FAILED ||
+        key_index >= statistics->GetColumnCount()) {
+      return 1;
+    }
+    // is null and is not null only look at the null fraction
+    if (op == CompareOp::kIsNull || op == CompareOp::kNotNull) {
+      return statistics->Selectivity(key_index, op, Field(kTypeInvalid));
+    }
+    Field key_field = get_field(ast->child_, table_info);
+    if (key_field.GetTypeId() == kTypeInvalid) return 1;
+    return statistics->Selectivity(key_index, op, key_field);
+  }
+  double lhs = estimate_selectivity(ast->child_, table_info);
+  double rhs = estimate_selectivity(ast->child_->next_, table_info);
+  return strcmp(ast->val_, "and") == 0 ? lhs * rhs : lhs + rhs - lhs * rhs;
+}
+
+std::unique_ptr<RowCondition> ExecuteEngine::parse_row_condition(pSyntaxNode ast, const TableInfo *table_info) {
+  if (ast->type_ == kNodeCompareOperator) {
+    auto predicate = parse_predicate(ast, table_info);
+    return predicate == nullptr ? nullptr : std::make_unique<RowCondition>(std::move(predicate));
+  }
+  ASSERT(ast->type_ == kNodeConnector, "Unexpected Syntax Tree Structure");
+  auto lhs = parse_row_condition(ast->child_, table_info);
+  if (lhs == nullptr) return nullptr;
+  auto rhs = parse_row_condition(ast->child_->next_, table_info);
+  if (rhs == nullptr) return nullptr;
+  return std::make_unique<RowCondition>(strcmp(ast->val_, "and") == 0, std::move(lhs), std::move(rhs));
+}
+
+std::unique_ptr<ScanPredicate> ExecuteEngine::parse_predicate(pSyntaxNode ast, const TableInfo *table_info) {
+  std::string key_column_name{ast->child_->val_};
+  uint32_t key_index;
+  if (table_info->GetSchema()->GetColumnIndex(key_column_name, key_index) == DB_FAILED) {
+    ENABLE_ERROR << "column " << key_column_name << "not exist" << DISABLED;
+    return nullptr;
+  }
+  CompareOp op;
+  [[maybe_unused]] bool is_op = ScanPredicate::ParseOp(ast->val_, op);
+  ASSERT(is_op, "Invalid compare token");
+  Field key_field = get_field(ast->child_, table_info);
+  if (key_field.GetTypeId() == kTypeInvalid) return nullptr;
+  return ScanPredicate::Create(table_info->GetSchema(), key_index, op, key_field);
+}
+
+int ExecuteEngine::index_rank(pSyntaxNode ast, const TableInfo *table_info) {
+  // the same choices parse_compare makes
+  std::string compare_token{ast->val_};
+  std::string key_column_name{ast->child_->val_};
+  CompareOp op;
+  uint32_t key_index;
+  if (!ScanPredicate::ParseOp(compare_token, op) ||
+      table_info->GetSchema()->GetColumnIndex(key_column_name, key_index) == DB_FAILED) {
+    return 0;
+  }
+  auto table_heap = table_info->GetTableHeap();
+  bool is_null = ast->child_->next_->type_ == kNodeNull;
+  bool unique = table_info->GetSchema()->GetColumn(key_index)->IsUnique();
+  if (table_heap->IsClustered() && table_heap->GetClusterKey()[0] == key_index && !is_null &&
+      (op == CompareOp::kEq || op == CompareOp::kLt || op == CompareOp::kLe || op == CompareOp::kGt ||
+       op == CompareOp::kGe)) {
+    unique = unique || table_heap->GetClusterKey().size() == 1;
+  } else if (find_index(table_info, key_column_name) == nullptr ||
+             (compare_token != "=" && idx_comps.count(compare_token) == 0)) {
+    return 0;
+  }
+  // a key finds at most one row of a unique column, a range may find any number
+  if (op != CompareOp::kEq) return 1;
+  return unique ? 3 : 2;
+}
+
 IndexInfo *ExecuteEngine::find_index(const TableInfo *table_info, const std::string &column_name) {
   IndexInfo *index_info = nullptr;
   // scan the index that only contains *that* column;
@@ -859,49 +2082,29 @@ IndexInfo *ExecuteEngine::find_index(const TableInfo *table_info, const std::str
   return index_info;
 }
 
-void ExecuteEngine::pretty_print(TableInfo *table_info, std::vector<std::string> &used_columns,
-                                 std::unordered_map<std::string, std::size_t> &column_index,
-                                 std::unordered_set<RowId> &ans_set) {
-  int n_row = ans_set.size();
-  std::vector<std::vector<Field *>> tuples;
-  for (auto &rid : ans_set) {
-    Row row(rid);
-    table_info->GetTableHeap()->GetTuple(&row, nullptr);
-    tuples.push_back(std::move(row.GetFields()));
-  }
-  std::vector<uint32_t> max_length(used_columns.size() + 1);
-  max_length[0] = std::to_string(n_row + 1).length();
-  for (std::size_t i = 1; i < max_length.size(); i++) {
-    auto col_index = column_index[used_columns[i - 1]];
-    for (auto &tuple : tuples) {
-      max_length[i] = max(max_length[i], tuple[col_index]->GetLength());
-    }
-    max_length[i]++;
-  }
-  std::string line = "+";
-  for (auto len : max_length) {
-    line.append(len, '-');
-    line += '+';
-  }
-  std::cout << line << std::endl;
-  for (std::size_t i = 0; i < tuples.size(); i++) {
-    // print index
-    std::cout << '|';
-    output(max_length[0], to_string(i));
-    std::cout << '|';
-
-    for (uint32_t j = 0; j < tuples[i].size(); j++) {
-      output(max_length[j + 1], tuples[i][j]);
-      std::cout << '|';
-    }
-    std::cout << std::endl << line << std::endl;
-  }
-}
 void ExecuteEngine::do_update(const TableInfo *table_info, map<string, Field> new_values,
                               unordered_set<RowId> effected_rows, unordered_map<string, size_t> column_index) {
   auto table_heap = table_info->GetTableHeap();
-  for (auto &rid : effected_rows) {
-    Row cur_row(rid);
+  // a clustered heap moves rows when a page splits, the rows not updated yet are followed to their new rids
+  std::vector<RowId> pending(effected_rows.begin(), effected_rows.end());
+  std::unordered_map<RowId, size_t> positions;
+  for (size_t i = 0; i < pending.size(); i++) positions.emplace(pending[i], i);
+  auto reindex = reindex_moved(table_info->GetTableName(), column_index);
+  auto moved = [&](Row &row, const RowId &old_rid) {
+    reindex(row, old_rid);
+    auto it = positions.find(old_rid);
+    if (it == positions.end()) return;
+    auto position = it->second;
+    positions.erase(it);
+    pending[position] = row.GetRowId();
+    positions.emplace(row.GetRowId(), position);
+  };
+  // holds the row being updated, reset for the next one
+  ArenaMemHeap row_heap;
+  for (auto &rid : pending) {
+    positions.erase(rid);
+    row_heap.Reset();
+    Row cur_row(rid, &row_heap);
     auto res = table_heap->GetTuple(&cur_row, nullptr);
     ASSERT(res, "Invalid Tuple Fetch");
     update_index(table_info->GetTableName(), cur_row.GetRowId(), cur_row.GetFields(), column_index, false);
@@ -914,8 +2117,9 @@ void ExecuteEngine::do_update(const TableInfo *table_info, map<string, Field> ne
       }
     }
     if (!table_heap->UpdateTuple(cur_row, cur_row.GetRowId(), nullptr)) {
-      table_heap->MarkDelete(cur_row.GetRowId(), nullptr);
-      table_heap->InsertTuple(cur_row, nullptr);
+      // the row no longer fits its page, a delete that is never applied would keep its bytes there for good
+      table_heap->ApplyDelete(cur_row.GetRowId(), nullptr);
+      table_heap->InsertTuple(cur_row, nullptr, moved);
     }
 
     update_index(table_info->GetTableName(), cur_row.GetRowId(), cur_row.GetFields(), column_index, true);
@@ -0,0 +1,1286 @@
+#include "executor/operators.h"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
+bool RowCondition::Evaluate(const Row &row) const {
+  if (compare_ != nullptr) return compare_->EvaluateField(*row.GetField(compare_->GetColumnIndex()));
+  if (is_and_) return lhs_->Evaluate(row) && rhs_->Evaluate(row);
+  return lhs_->Evaluate(row) || rhs_->Evaluate(row);
+}
+
+void RowCondition::EvaluateBatch(const VectorBatch &batch, uint64_t *sel) const {
+  if (compare_ != nullptr) {
+    auto &vector = batch.GetColumn(compare_->GetColumnIndex());
+    compare_->EvaluateColumn(vector.GetValues(), vector.GetWidth(), vector.GetNulls(), batch.GetSize(), sel);
+    return;
+  }
+  uint64_t rhs[VECTOR_BATCH_WORDS];
+  lhs_->EvaluateBatch(batch, sel);
+  rhs_->EvaluateBatch(batch, rhs);
+  for (uint32_t w = 0; w < (batch.GetSize() + 63) / 64; w++) sel[w] = is_and_ ? sel[w] & rhs[w] : sel[w] | rhs[w];
+}
+
+void RowCondition::CollectColumns(std::vector<uint32_t> &columns) const {
+  if (compare_ != nullptr) {
+    columns.push_back(compare_->GetColumnIndex());
+    return;
+  }
+  lhs_->CollectColumns(columns);
+  rhs_->CollectColumns(columns);
+}
+
+bool TableScanOperator::Next(const Row **row) {
+  ASSERT(iterator_.has_value(), "TableScanOperator::Next : Not Initialized");
+  // the iterator stays on the row handed out last until it is asked for the next one
+  if (started_ && *iterator_ != table_heap_->End()) ++*iterator_;
+  started_ = true;
+  if (*iterator_ == table_heap_->End()) return false;
+  *row = &**iterator_;
+  return true;
+}
+
+void SeqScanOperator::Init() {
+  started_ = false;
+  iterator_.reset();
+  if (predicate_ != nullptr) {
+    iterator_.emplace(table_heap_->Begin(nullptr, columns_, *predicate_));
+  } else {
+    iterator_.emplace(table_heap_->Begin(nullptr, columns_));
+  }
+}
+
+void IndexScanOperator::Init() {
+  started_ = false;
+  iterator_.reset();
+  std::unordered_set<RowId> rids;
+  probe_(rids);
+  iterator_.emplace(table_heap_->Begin(nullptr, columns_, std::vector<RowId>(rids.begin(), rids.end())));
+}
+
+void IndexOrderScanOperator::Init() {
+  rids_.clear();
+  rows_.clear();
+  heap_.Reset();
+  read_ = next_ = end_ = 0;
+  batch_size_ = 32;
+  scan_(rids_);
+}
+
+bool IndexOrderScanOperator::Next(const Row **row) {
+  while (true) {
+    while (next_ < end_) {
+      auto found = found_.find(rids_[next_++]);
+      // a row deleted since its key was read is left out
+      if (found == found_.end()) continue;
+      *row = &rows_[found->second];
+      return true;
+    }
+    if (!next_batch()) return false;
+  }
+}
+
+bool IndexOrderScanOperator::next_batch() {
+  if (read_ == rids_.size()) return false;
+  rows_.clear();
+  heap_.Reset();
+  found_.clear();
+  next_ = read_;
+  end_ = std::min(rids_.size(), read_ + batch_size_);
+  batch_size_ = std::min<size_t>(2 * batch_size_, INDEX_ORDER_BATCH);
+  std::vector<uint32_t> all;
+  std::vector<RowId> batch(rids_.begin() + next_, rids_.begin() + end_);
+  for (auto iterator = table_heap_->Begin(nullptr, columns_, std::move(batch)); iterator != table_heap_->End();
+       ++iterator) {
+    if (all.empty()) {
+      all.resize(iterator->GetFieldCount());
+      std::iota(all.begin(), all.end(), 0);
+    }
+    found_[iterator->GetRowId()] = static_cast<uint32_t>(rows_.size());
+    rows_.emplace_back(iterator->GetRowId(), &heap_);
+    rows_.back().CopyFields(*iterator, all);
+  }
+  read_ = end_;
+  return true;
+}
+
+bool FilterOperator::Next(const Row **row) {
+  while (child_->Next(row)) {
+    if (condition_->Evaluate(**row)) return true;
+  }
+  return false;
+}
+
+bool ProjectionOperator::Next(const Row **row) {
+  const Row *input;
+  if (!child_->Next(&input)) return false;
+  row_.CopyFields(*input, columns_);
+  row_.SetRowId(input->GetRowId());
+  *row = &row_;
+  return true;
+}
+
+void LimitOperator::Init() {
+  skipped_ = emitted_ = 0;
+  child_->Init();
+}
+
+bool LimitOperator::Next(const Row **row) {
+  // the child is not pulled once the limit is reached
+  if (emitted_ == limit_) return false;
+  for (; skipped_ < offset_; skipped_++) {
+    if (!child_->Next(row)) return false;
+  }
+  if (!child_->Next(row)) return false;
+  emitted_++;
+  return true;
+}
+
+static constexpr uint32_t NO_ENTRY = UINT32_MAX;
+
+/*
+ * FNV-1a over the bytes of the keys, then the finalizer of MurmurHash3 to spread the high bits
+ * that pick a partition as well as the low ones that pick a bucket.
+ */
+static uint64_t hash_bytes(uint64_t h, const char *data, uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    h ^= static_cast<uint8_t>(data[i]);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+static constexpr uint64_t HASH_SEED = 14695981039346656037ULL;
+
+static uint64_t hash_finish(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+HashJoinOperator::HashJoinOperator(OperatorPtr left, OperatorPtr right, Schema *left_schema, Schema *right_schema,
+                                   std::vector<uint32_t> left_keys, std::vector<uint32_t> right_keys,
+                                   bool build_left, size_t memory_budget)
+    : build_left_(build_left), memory_budget_(memory_budget), match_(NO_ENTRY) {
+  ASSERT(left_keys.size() == right_keys.size(), "HashJoinOperator : Keys Not Match");
+  Side left_side{std::move(left), left_schema, std::move(left_keys)};
+  Side right_side{std::move(right), right_schema, std::move(right_keys)};
+  build_ = build_left ? std::move(left_side) : std::move(right_side);
+  probe_ = build_left ? std::move(right_side) : std::move(left_side);
+}
+
+void HashJoinOperator::Init() {
+  close_partitions();
+  arena_.clear();
+  entries_.clear();
+  probe_row_ = nullptr;
+  match_ = NO_ENTRY;
+  build_.child->Init();
+  probe_.child->Init();
+
+  const Row *row;
+  uint64_t hash;
+  while (build_.child->Next(&row)) {
+    // a row with a null key joins nothing, it is left out of the table
+    if (!hash_keys(*row, build_.keys, hash)) continue;
+    if (IsSpilled()) {
+      write_row(partitions_[(hash >> 32) % JOIN_PARTITIONS].build, *row, build_.schema, hash);
+      continue;
+    }
+    uint32_t size = row->GetSerializedSize(build_.schema);
+    buffer_.resize(size);
+    row->SerializeTo(buffer_.data(), build_.schema);
+    add_entry(buffer_.data(), size, hash);
+    if (arena_.size() > memory_budget_) spill();
+  }
+  if (!IsSpilled()) {
+    build_buckets();
+    return;
+  }
+  // the probe side goes to the partitions as well, the partitions are joined one at a time
+  while (probe_.child->Next(&row)) {
+    if (hash_keys(*row, probe_.keys, hash)) {
+      write_row(partitions_[(hash >> 32) % JOIN_PARTITIONS].probe, *row, probe_.schema, hash);
+    }
+  }
+  partition_ = 0;
+  load_partition();
+}
+
+bool HashJoinOperator::Next(const Row **row) {
+  while (true) {
+    while (match_ != NO_ENTRY) {
+      const Entry &entry = entries_[match_];
+      match_ = entry.next;
+      if (entry.hash != probe_hash_) continue;
+      build_row_.DeserializeFrom(arena_.data() + entry.offset, build_.schema);
+      bool equal = true;
+      for (size_t i = 0; i < build_.keys.size() && equal; i++) {
+        equal = build_row_.GetField(build_.keys[i])->CompareEquals(*probe_row_->GetField(probe_.keys[i])) ==
+                CmpBool::kTrue;
+      }
+      if (!equal) continue;
+      if (build_left_) {
+        row_.CopyFields(build_row_, *probe_row_);
+      } else {
+        row_.CopyFields(*probe_row_, build_row_);
+      }
+      *row = &row_;
+      return true;
+    }
+    if (!next_probe()) return false;
+  }
+}
+
+bool HashJoinOperator::hash_keys(const Row &row, const std::vector<uint32_t> &keys, uint64_t &hash) {
+  uint64_t h = HASH_SEED;
+  char buf[sizeof(int32_t)];
+  for (auto key : keys) {
+    const Field *field = row.GetField(key);
+    if (field->IsNull()) return false;
+    const char *data = buf;
+    uint32_t len;
+    if (field->GetTypeId() == TypeId::kTypeChar) {
+      data = field->GetData();
+      len = field->GetLength();
+    } else {
+      len = field->SerializeTo(buf);
+      // 0 and -0 are the same float, they must hash alike to join
+            if (field->GetTypeId() == kTypeFloat && MACH_READ_FROM(float, buf) == 0) MACH_WRITE_TO(float, buf, 0.0f);
+    }
+    h = hash_bytes(h, data, len);
+  }
+  hash = hash_finish(h);
+  return true;
+}
+
+void HashJoinOperator::add_entry(const char *data, uint32_t size, uint64_t hash) {
+  uint32_t offset = static_cast<uint32_t>(arena_.size());
+  arena_.insert(arena_.end(), data, data + size);
+  entries_.push_back({hash, offset, NO_ENTRY});
+}
+
+void HashJoinOperator::build_buckets() {
+  // at least as many buckets as entries, a power of two so that the low bits of a hash pick one
+  size_t count = 1;
+  while (count < entries_.size()) count <<= 1;
+  buckets_.assign(count, NO_ENTRY);
+  for (uint32_t i = 0; i < entries_.size(); i++) {
+    auto &bucket = buckets_[entries_[i].hash & (count - 1)];
+    entries_[i].next = bucket;
+    bucket = i;
+  }
+}
+
+void HashJoinOperator::spill() {
+  partitions_.resize(JOIN_PARTITIONS);
+  for (auto &partition : partitions_) {
+    partition.build = std::tmpfile();
+    partition.probe = std::tmpfile();
+    ASSERT(partition.build != nullptr && partition.probe != nullptr, "HashJoinOperator : Temporary File Failed");
+  }
+  for (uint32_t i = 0; i < entries_.size(); i++) {
+    uint32_t end = i + 1 < entries_.size() ? entries_[i + 1].offset : static_cast<uint32_t>(arena_.size());
+    uint32_t size = end - entries_[i].offset;
+    write_entry(partitions_[(entries_[i].hash >> 32) % JOIN_PARTITIONS].build, entries_[i].hash,
+                arena_.data() + entries_[i].offset, size);
+  }
+  arena_.clear();
+  arena_.shrink_to_fit();
+  entries_.clear();
+}
+
+void HashJoinOperator::write_row(FILE *file, const Row &row, Schema *schema, uint64_t hash) {
+  uint32_t size = row.GetSerializedSize(schema);
+  buffer_.resize(size);
+  row.SerializeTo(buffer_.data(), schema);
+  write_entry(file, hash, buffer_.data(), size);
+}
+
+void HashJoinOperator::write_entry(FILE *file, uint64_t hash, const char *data, uint32_t size) {
+  fwrite(&hash, sizeof(uint64_t), 1, file);
+  fwrite(&size, sizeof(uint32_t), 1, file);
+  fwrite(data, 1, size, file);
+}
+
+bool HashJoinOperator::read_entry(FILE *file, uint64_t &hash) {
+  uint32_t size;
+  if (fread(&hash, sizeof(uint64_t), 1, file) != 1 || fread(&size, sizeof(uint32_t), 1, file) != 1) return false;
+  buffer_.resize(size);
+  return fread(buffer_.data(), 1, size, file) == size;
+}
+
+void HashJoinOperator::load_partition() {
+  arena_.clear();
+  entries_.clear();
+  // the files are still at their ends, where they were written up to
+  while (partitions_[partition_].build != nullptr && partitions_[partition_].probe != nullptr &&
+         partitions_[partition_].level < JOIN_MAX_LEVEL &&
+         static_cast<size_t>(ftell(partitions_[partition_].build)) > memory_budget_) {
+    split_partition();
+    partition_++;
+  }
+  // a partition missing either side joins nothing, its table is left empty
+  const Partition &partition = partitions_[partition_];
+  if (partition.build == nullptr || partition.probe == nullptr) return;
+  rewind(partition.build);
+  uint64_t hash;
+  while (read_entry(partition.build, hash)) add_entry(buffer_.data(), static_cast<uint32_t>(buffer_.size()), hash);
+  build_buckets();
+  rewind(partition.probe);
+}
+
+void HashJoinOperator::split_partition() {
+  Partition partition = partitions_[partition_];
+  partitions_[partition_].build = nullptr;
+  partitions_[partition_].probe = nullptr;
+  // the new partitions are joined right after, so only the files of one partition per level are open at once
+  size_t first = partition_ + 1;
+  partitions_.insert(partitions_.begin() + first, JOIN_PARTITIONS, Partition{nullptr, nullptr, partition.level + 1});
+  // bits of the hash no level before used pick the new partition of a row, its files are made by its first row
+  uint32_t shift = 32 + 5 * (partition.level + 1);
+  for (FILE *Partition::*side : {&Partition::build, &Partition::probe}) {
+    FILE *from = partition.*side;
+    rewind(from);
+    uint64_t hash;
+    while (read_entry(from, hash)) {
+      FILE *&to = partitions_[first + (hash >> shift) % JOIN_PARTITIONS].*side;
+      if (to == nullptr) {
+        to = std::tmpfile();
+        ASSERT(to != nullptr, "HashJoinOperator : Temporary File Failed");
+      }
+      write_entry(to, hash, buffer_.data(), static_cast<uint32_t>(buffer_.size()));
+    }
+    fclose(from);
+  }
+}
+
+bool HashJoinOperator::next_probe() {
+  while (true) {
+    if (!IsSpilled()) {
+      // nothing joins an empty table, the probe side is not read
+      if (entries_.empty() || !probe_.child->Next(&probe_row_)) return false;
+      if (!hash_keys(*probe_row_, probe_.keys, probe_hash_)) continue;
+    } else {
+      if (entries_.empty() || !read_entry(partitions_[partition_].probe, probe_hash_)) {
+        if (++partition_ == partitions_.size()) return false;
+        load_partition();
+        continue;
+      }
+      read_row_.DeserializeFrom(buffer_.data(), probe_.schema);
+      probe_row_ = &read_row_;
+    }
+    match_ = buckets_[probe_hash_ & (buckets_.size() - 1)];
+    if (match_ != NO_ENTRY) return true;
+  }
+}
+
+void HashJoinOperator::close_partitions() {
+  for (auto &partition : partitions_) {
+    if (partition.build != nullptr) fclose(partition.build);
+    if (partition.probe != nullptr) fclose(partition.probe);
+  }
+  partitions_.clear();
+}
+
+IndexJoinOperator::IndexJoinOperator(OperatorPtr outer, TableHeap *table_heap, std::vector<uint32_t> columns,
+                                     std::vector<uint32_t> read, std::vector<uint32_t> outer_keys,
+                                     std::vector<uint32_t> inner_keys, Lookup lookup,
+                                     std::unique_ptr<RowCondition> condition)
+    : outer_(std::move(outer)),
+      table_heap_(table_heap),
+      columns_(std::move(columns)),
+      read_(std::move(read)),
+      outer_keys_(std::move(outer_keys)),
+      inner_keys_(std::move(inner_keys)),
+      lookup_(std::move(lookup)),
+      condition_(std::move(condition)) {
+  ASSERT(!outer_keys_.empty() && outer_keys_.size() == inner_keys_.size(), "IndexJoinOperator : Keys Not Match");
+}
+
+void IndexJoinOperator::Init() {
+  iterator_.reset();
+  rows_.clear();
+  heap_.Reset();
+  next_ = end_ = 0;
+  outer_->Init();
+}
+
+bool IndexJoinOperator::Next(const Row **row) {
+  while (true) {
+    while (next_ < end_) {
+      const Row &outer = rows_[order_[next_++]];
+      bool equal = true;
+      // the first key is equal as it was looked up
+      for (size_t i = 1; i < outer_keys_.size() && equal; i++) {
+        equal = outer.GetField(outer_keys_[i])->CompareEquals(*(*iterator_)->GetField(inner_keys_[i])) ==
+                CmpBool::kTrue;
+      }
+      if (!equal) continue;
+      row_.CopyFields(outer, inner_);
+      *row = &row_;
+      return true;
+    }
+    // the iterator stays on the row of the table read last until it is asked for the next one
+    if (iterator_.has_value() && started_ && *iterator_ != table_heap_->End()) ++*iterator_;
+    started_ = true;
+    if (!iterator_.has_value() || *iterator_ == table_heap_->End()) {
+      if (!next_batch()) return false;
+      continue;
+    }
+    const Row &found = **iterator_;
+    if (condition_ != nullptr && !condition_->Evaluate(found)) continue;
+    auto &group = groups_[found_[found.GetRowId()]];
+    next_ = group.first;
+    end_ = group.second;
+    inner_.CopyFields(found, columns_);
+  }
+}
+
+bool IndexJoinOperator::next_batch() {
+  iterator_.reset();
+  rows_.clear();
+  heap_.Reset();
+  const Row *row;
+  std::vector<uint32_t> all;
+  while (rows_.size() < INDEX_JOIN_BATCH && outer_->Next(&row)) {
+    // a null key joins nothing
+    if (row->GetField(outer_keys_[0])->IsNull()) continue;
+    if (all.empty()) {
+      all.resize(row->GetFieldCount());
+      std::iota(all.begin(), all.end(), 0);
+    }
+    rows_.emplace_back(row->GetRowId(), &heap_);
+    rows_.back().CopyFields(*row, all);
+  }
+  if (rows_.empty()) return false;
+
+  uint32_t key = outer_keys_[0];
+  order_.resize(rows_.size());
+  for (uint32_t i = 0; i < order_.size(); i++) order_[i] = i;
+  std::sort(order_.begin(), order_.end(), [this, key](uint32_t lhs, uint32_t rhs) {
+    return rows_[lhs].GetField(key)->CompareLessThan(*rows_[rhs].GetField(key)) == CmpBool::kTrue;
+  });
+  groups_.clear();
+  found_.clear();
+  std::vector<RowId> rids;
+  for (uint32_t begin = 0, end; begin < order_.size(); begin = end) {
+    const Field *field = rows_[order_[begin]].GetField(key);
+    for (end = begin + 1; end < order_.size(); end++) {
+      if (rows_[order_[end]].GetField(key)->CompareEquals(*field) != CmpBool::kTrue) break;
+    }
+    size_t first = rids.size();
+    lookup_(*field, rids);
+    for (size_t i = first; i < rids.size(); i++) found_[rids[i]] = static_cast<uint32_t>(groups_.size());
+    groups_.emplace_back(begin, end);
+  }
+  iterator_.emplace(table_heap_->Begin(nullptr, read_, std::move(rids)));
+  started_ = false;
+  return true;
+}
+
+/** slots of the hash table of an aggregation before it grows */
+static constexpr size_t AGGREGATE_INITIAL_SLOTS = 256;
+
+static uint32_t align8(uint32_t size) { return (size + 7) & ~7u; }
+
+HashAggregateOperator::HashAggregateOperator(OperatorPtr child, Schema *schema, std::vector<uint32_t> keys,
+                                             std::vector<Aggregate> aggregates, size_t memory_budget)
+    : child_(std::move(child)),
+      schema_(schema),
+      keys_(std::move(keys)),
+      aggregates_(std::move(aggregates)),
+      memory_budget_(memory_budget) {
+  // a key is a null flag and the value, a char as its length and as many bytes as the column may hold
+  for (auto key : keys_) {
+    key_offsets_.push_back(key_size_);
+    auto column = schema_->GetColumn(key);
+    key_size_ += 1 + (column->GetType() == kTypeChar ? sizeof(uint16_t) + column->GetLength() : sizeof(int32_t));
+  }
+  key_.resize(key_size_);
+  // an accumulator is the count of the values and their sum or the least or greatest one, an int in 64 bits and
+  // a float as a double, a char after them as its length and bytes
+  uint32_t offset = align8(sizeof(uint64_t) + key_size_);
+  for (auto &aggregate : aggregates_) {
+    accumulator_offsets_.push_back(offset);
+    offset += 2 * sizeof(uint64_t);
+    if (aggregate.function == AggregateFunction::kMin || aggregate.function == AggregateFunction::kMax) {
+      auto column = schema_->GetColumn(aggregate.column);
+      if (column->GetType() == kTypeChar) offset += align8(sizeof(uint16_t) + column->GetLength());
+    }
+  }
+  slot_size_ = offset;
+}
+
+HashAggregateOperator::HashAggregateOperator(VectorOperatorPtr child, std::vector<uint32_t> columns, Schema *schema,
+                                             std::vector<uint32_t> keys, std::vector<Aggregate> aggregates,
+                                             size_t memory_budget)
+    : HashAggregateOperator(nullptr, schema, std::move(keys), std::move(aggregates), memory_budget) {
+  vector_child_ = std::move(child);
+  columns_ = std::move(columns);
+  batch_keys_.resize(VECTOR_BATCH_SIZE * key_size_);
+  batch_hashes_.resize(VECTOR_BATCH_SIZE);
+  batch_slots_.resize(VECTOR_BATCH_SIZE);
+}
+
+void HashAggregateOperator::Init() {
+  close_partitions();
+  spilled_ = false;
+  reset_table(AGGREGATE_INITIAL_SLOTS);
+  next_ = 0;
+  // without keys there is a single group, there even if the child has no rows
+  if (keys_.empty()) find_slot(hash_finish(HASH_SEED), key_.data(), 0);
+  if (vector_child_ != nullptr) {
+    vector_child_->Init();
+    VectorBatch *batch;
+    while (vector_child_->Next(&batch)) add_batch(*batch);
+  } else {
+    child_->Init();
+    const Row *row;
+    while (child_->Next(&row)) add_row(*row, encode_keys(*row), 0);
+  }
+  for (auto file : writing_) partitions_.push_back({file, 1});
+  writing_.clear();
+}
+
+bool HashAggregateOperator::Next(const Row **row) {
+  while (true) {
+    for (; next_ < capacity_; next_++) {
+      char *slot = slots_.data() + next_ * slot_size_;
+      if (MACH_READ_FROM(uint64_t, slot) != 0) break;
+    }
+    if (next_ == capacity_) {
+      if (partitions_.empty()) return false;
+      load_partition();
+      next_ = 0;
+      continue;
+    }
+    const char *slot = slots_.data() + next_++ * slot_size_;
+    fields_.clear();
+    fields_.reserve(keys_.size() + aggregates_.size());
+    for (size_t i = 0; i < keys_.size(); i++) {
+      const char *key = slot + sizeof(uint64_t) + key_offsets_[i];
+      TypeId type = schema_->GetColumn(keys_[i])->GetType();
+      if (key[0] != 0) {
+        fields_.emplace_back(type);
+      } else if (type == kTypeChar) {
+        fields_.emplace_back(type, const_cast<char *>(key + 1 + sizeof(uint16_t)), MACH_READ_FROM(uint16_t, key + 1),
+                             false);
+      } else if (type == kTypeInt) {
+        fields_.emplace_back(type, MACH_READ_FROM(int32_t, key + 1));
+      } else {
+        fields_.emplace_back(type, MACH_READ_FROM(float, key + 1));
+      }
+    }
+    for (size_t i = 0; i < aggregates_.size(); i++) {
+      const char *accumulator = slot + accumulator_offsets_[i];
+      uint64_t count = MACH_READ_FROM(uint64_t, accumulator);
+      const char *value = accumulator + sizeof(uint64_t);
+      auto &aggregate = aggregates_[i];
+      if (aggregate.function == AggregateFunction::kCountAll || aggregate.function == AggregateFunction::kCount) {
+        fields_.emplace_back(kTypeInt, static_cast<int32_t>(count));
+        continue;
+      }
+      TypeId type = schema_->GetColumn(aggregate.column)->GetType();
+      if (aggregate.function == AggregateFunction::kAvg) type = kTypeFloat;
+      if (count == 0) {
+        fields_.emplace_back(type);
+      } else if (aggregate.function == AggregateFunction::kAvg) {
+        bool is_int = schema_->GetColumn(aggregate.column)->GetType() == kTypeInt;
+        double sum = is_int ? MACH_READ_FROM(int64_t, value) : MACH_READ_FROM(double, value);
+        fields_.emplace_back(kTypeFloat, static_cast<float>(sum / count));
+      } else if (type == kTypeChar) {
+        const char *chars = value + sizeof(uint64_t);
+        fields_.emplace_back(type, const_cast<char *>(chars + sizeof(uint16_t)), MACH_READ_FROM(uint16_t, chars),
+                             false);
+      } else if (type == kTypeFloat) {
+        fields_.emplace_back(type, static_cast<float>(MACH_READ_FROM(double, value)));
+      } else {
+        // a sum too large for an int is handed out as a float
+        int64_t integer = MACH_READ_FROM(int64_t, value);
+        if (integer >= INT32_MIN && integer <= INT32_MAX) {
+          fields_.emplace_back(type, static_cast<int32_t>(integer));
+        } else {
+          fields_.emplace_back(kTypeFloat, static_cast<float>(integer));
+        }
+      }
+    }
+    row_.CopyFields(fields_);
+    *row = &row_;
+    return true;
+  }
+}
+
+uint64_t HashAggregateOperator::encode_keys(const Row &row) {
+  // the bytes of a value a key does not use are zero, so that equal keys are equal bytes
+  memset(key_.data(), 0, key_size_);
+  char buf[sizeof(int32_t)];
+  for (size_t i = 0; i < keys_.size(); i++) {
+    char *key = key_.data() + key_offsets_[i];
+    const Field *field = row.GetField(keys_[i]);
+    if (field->IsNull()) {
+      key[0] = 1;
+    } else if (field->GetTypeId() == kTypeChar) {
+      ASSERT(field->GetLength() <= schema_->GetColumn(keys_[i])->GetLength(), "HashAggregateOperator : Key Too Long");
+      MACH_WRITE_TO(uint16_t, key + 1, static_cast<uint16_t>(field->GetLength()));
+      memcpy(key + 1 + sizeof(uint16_t), field->GetData(), field->GetLength());
+    } else {
+      field->SerializeTo(buf);
+      // 0 and -0 are the same float
+            if (field->GetTypeId() == kTypeFloat && MACH_READ_FROM(float, buf) == 0) MACH_WRITE_TO(float, buf, 0.0f);
+      memcpy(key + 1, buf, sizeof(buf));
+    }
+  }
+  uint64_t hash = hash_finish(hash_bytes(HASH_SEED, key_.data(), key_size_));
+  // a hash of 0 marks a free slot
+  return hash == 0 ? 1 : hash;
+}
+
+void HashAggregateOperator::add_row(const Row &row, uint64_t hash, uint32_t level) {
+  char *slot = find_slot(hash, key_.data(), level);
+  if (slot != nullptr) {
+    accumulate(slot, row);
+    return;
+  }
+  spill_row(row, hash, level);
+}
+
+void HashAggregateOperator::spill_row(const Row &row, uint64_t hash, uint32_t level) {
+  // the table is full, the row waits in a partition picked by bits of the hash no level before used
+  if (writing_.empty()) {
+    spilled_ = true;
+    for (uint32_t i = 0; i < AGGREGATE_PARTITIONS; i++) {
+      writing_.push_back(std::tmpfile());
+      ASSERT(writing_.back() != nullptr, "HashAggregateOperator : Temporary File Failed");
+    }
+  }
+  FILE *file = writing_[(hash >> (32 + 8 * level)) % AGGREGATE_PARTITIONS];
+  uint32_t size = row.GetSerializedSize(schema_);
+  buffer_.resize(size);
+  row.SerializeTo(buffer_.data(), schema_);
+  fwrite(&hash, sizeof(uint64_t), 1, file);
+  fwrite(&size, sizeof(uint32_t), 1, file);
+  fwrite(buffer_.data(), 1, size, file);
+}
+
+char *HashAggregateOperator::find_slot(uint64_t hash, const char *key, uint32_t level) {
+  while (true) {
+    for (size_t i = hash & (capacity_ - 1);; i = (i + 1) & (capacity_ - 1)) {
+      char *slot = slots_.data() + i * slot_size_;
+      uint64_t slot_hash = MACH_READ_FROM(uint64_t, slot);
+      if (slot_hash == hash && memcmp(slot + sizeof(uint64_t), key, key_size_) == 0) return slot;
+      if (slot_hash != 0) continue;
+      // a new group, the table is kept at most three quarters full
+      if (4 * (groups_ + 1) <= 3 * capacity_) {
+        MACH_WRITE_TO(uint64_t, slot, hash);
+        memcpy(slot + sizeof(uint64_t), key, key_size_);
+        groups_++;
+        return slot;
+      }
+      break;
+    }
+    if (2 * slots_.size() > memory_budget_ && level < AGGREGATE_MAX_LEVEL) return nullptr;
+    // twice the slots, the groups are placed again by their hash
+    std::vector<char> slots = std::move(slots_);
+    size_t capacity = capacity_;
+    reset_table(2 * capacity);
+    for (size_t i = 0; i < capacity; i++) {
+      const char *slot = slots.data() + i * slot_size_;
+      uint64_t slot_hash = MACH_READ_FROM(uint64_t, slot);
+      if (slot_hash == 0) continue;
+      size_t j = slot_hash & (capacity_ - 1);
+      while (MACH_READ_FROM(uint64_t, slots_.data() + j * slot_size_) != 0) j = (j + 1) & (capacity_ - 1);
+      memcpy(slots_.data() + j * slot_size_, slot, slot_size_);
+      groups_++;
+    }
+  }
+}
+
+void HashAggregateOperator::accumulate(char *slot, const Row &row) {
+  char buf[sizeof(int32_t)];
+  for (size_t i = 0; i < aggregates_.size(); i++) {
+    char *accumulator = slot + accumulator_offsets_[i];
+    char *value = accumulator + sizeof(uint64_t);
+    auto &aggregate = aggregates_[i];
+    if (aggregate.function == AggregateFunction::kCountAll) {
+      MACH_WRITE_TO(uint64_t, accumulator, MACH_READ_FROM(uint64_t, accumulator) + 1);
+      continue;
+    }
+    const Field *field = row.GetField(aggregate.column);
+    if (field->IsNull()) continue;
+    uint64_t count = MACH_READ_FROM(uint64_t, accumulator);
+    MACH_WRITE_TO(uint64_t, accumulator, count + 1);
+    if (aggregate.function == AggregateFunction::kCount) continue;
+    bool is_min = aggregate.function == AggregateFunction::kMin;
+    if (field->GetTypeId() == kTypeChar) {
+      char *chars = value + sizeof(uint64_t);
+      Field current(kTypeChar, chars + sizeof(uint16_t), MACH_READ_FROM(uint16_t, chars), false);
+      if (count != 0 && (is_min ? field->CompareLessThan(current) : field->CompareGreaterThan(current)) !=
+                            CmpBool::kTrue) {
+        continue;
+      }
+      MACH_WRITE_TO(uint16_t, chars, static_cast<uint16_t>(field->GetLength()));
+      memcpy(chars + sizeof(uint16_t), field->GetData(), field->GetLength());
+      continue;
+    }
+    field->SerializeTo(buf);
+    if (field->GetTypeId() == kTypeInt) {
+      int64_t integer = MACH_READ_FROM(int32_t, buf), current = MACH_READ_FROM(int64_t, value);
+      if (aggregate.function == AggregateFunction::kSum || aggregate.function == AggregateFunction::kAvg) {
+        integer += current;
+      } else if (count != 0 && (is_min ? current <= integer : current >= integer)) {
+        continue;
+      }
+      MACH_WRITE_TO(int64_t, value, integer);
+    } else {
+      double real = MACH_READ_FROM(float, buf), current = MACH_READ_FROM(double, value);
+      if (aggregate.function == AggregateFunction::kSum || aggregate.function == AggregateFunction::kAvg) {
+        real += current;
+      } else if (count != 0 && (is_min ? current <= real : current >= real)) {
+        continue;
+      }
+      MACH_WRITE_TO(double, value, real);
+    }
+  }
+}
+
+void HashAggregateOperator::add_batch(const VectorBatch &batch) {
+  const uint32_t *selection = batch.GetSelection();
+  uint32_t n = batch.GetSelectedCount();
+  if (keys_.empty()) {
+    // every tuple is of the single group
+    char *slot = find_slot(hash_finish(HASH_SEED), key_.data(), 0);
+    std::fill(batch_slots_.begin(), batch_slots_.begin() + n, slot);
+  } else {
+    encode_batch(batch);
+    for (uint32_t j = 0; j < n; j++) {
+      size_t capacity = capacity_;
+      batch_slots_[j] = find_slot(batch_hashes_[j], batch_keys_.data() + j * key_size_, 0);
+      if (batch_slots_[j] == nullptr) {
+        read_row_.CopyFields(batch, selection[j], columns_);
+        spill_row(read_row_, batch_hashes_[j], 0);
+        continue;
+      }
+      if (capacity_ == capacity) continue;
+      // the table grew and placed its groups again, those found before are looked up again
+      for (uint32_t k = 0; k < j; k++) {
+        if (batch_slots_[k] != nullptr) {
+          batch_slots_[k] = find_slot(batch_hashes_[k], batch_keys_.data() + k * key_size_, 0);
+        }
+      }
+    }
+  }
+  for (size_t i = 0; i < aggregates_.size(); i++) accumulate_batch(batch, i);
+}
+
+void HashAggregateOperator::encode_batch(const VectorBatch &batch) {
+  const uint32_t *selection = batch.GetSelection();
+  uint32_t n = batch.GetSelectedCount();
+  // the same bytes encode_keys writes for a row, a column at a time
+  memset(batch_keys_.data(), 0, n * key_size_);
+  for (size_t i = 0; i < keys_.size(); i++) {
+    auto &vector = batch.GetColumn(columns_[keys_[i]]);
+    const char *values = vector.GetValues();
+    uint32_t width = vector.GetWidth();
+    char *key = batch_keys_.data() + key_offsets_[i];
+    for (uint32_t j = 0; j < n; j++, key += key_size_) {
+      uint32_t slot = selection[j];
+      if (vector.IsNull(slot)) {
+        key[0] = 1;
+        continue;
+      }
+      const char *value = values + slot * width;
+      if (vector.GetType() == kTypeChar) {
+        // a char of the vector is its length and bytes already, like in a key
+        memcpy(key + 1, value, sizeof(uint16_t) + MACH_READ_FROM(uint16_t, value));
+      } else if (vector.GetType() == kTypeFloat && MACH_READ_FROM(float, value) == 0) {
+        MACH_WRITE_TO(float, key + 1, 0.0f);
+      } else {
+        memcpy(key + 1, value, sizeof(int32_t));
+      }
+    }
+  }
+  for (uint32_t j = 0; j < n; j++) {
+    uint64_t hash = hash_finish(hash_bytes(HASH_SEED, batch_keys_.data() + j * key_size_, key_size_));
+    batch_hashes_[j] = hash == 0 ? 1 : hash;
+  }
+}
+
+void HashAggregateOperator::accumulate_batch(const VectorBatch &batch, size_t i) {
+  const uint32_t *selection = batch.GetSelection();
+  uint32_t n = batch.GetSelectedCount();
+  uint32_t offset = accumulator_offsets_[i];
+  auto &aggregate = aggregates_[i];
+  if (aggregate.function == AggregateFunction::kCountAll) {
+    for (uint32_t j = 0; j < n; j++) {
+      if (batch_slots_[j] == nullptr) continue;
+      char *accumulator = batch_slots_[j] + offset;
+      MACH_WRITE_TO(uint64_t, accumulator, MACH_READ_FROM(uint64_t, accumulator) + 1);
+    }
+    return;
+  }
+  auto &vector = batch.GetColumn(columns_[aggregate.column]);
+  const char *values = vector.GetValues();
+  uint32_t width = vector.GetWidth();
+  bool is_count = aggregate.function == AggregateFunction::kCount;
+  bool is_sum = aggregate.function == AggregateFunction::kSum || aggregate.function == AggregateFunction::kAvg;
+  bool is_min = aggregate.function == AggregateFunction::kMin;
+  for (uint32_t j = 0; j < n; j++) {
+    uint32_t slot = selection[j];
+    if (batch_slots_[j] == nullptr || vector.IsNull(slot)) continue;
+    char *accumulator = batch_slots_[j] + offset;
+    char *value = accumulator + sizeof(uint64_t);
+    uint64_t count = MACH_READ_FROM(uint64_t, accumulator);
+    MACH_WRITE_TO(uint64_t, accumulator, count + 1);
+    if (is_count) continue;
+    if (vector.GetType() == kTypeInt) {
+      int64_t integer = MACH_READ_FROM(int32_t, values + slot * width), current = MACH_READ_FROM(int64_t, value);
+      if (is_sum) {
+        integer += current;
+      } else if (count != 0 && (is_min ? current <= integer : current >= integer)) {
+        continue;
+      }
+      MACH_WRITE_TO(int64_t, value, integer);
+    } else if (vector.GetType() == kTypeFloat) {
+      double real = MACH_READ_FROM(float, values + slot * width), current = MACH_READ_FROM(double, value);
+      if (is_sum) {
+        real += current;
+      } else if (count != 0 && (is_min ? current <= real : current >= real)) {
+        continue;
+      }
+      MACH_WRITE_TO(double, value, real);
+    } else {
+      Field field = vector.GetField(slot);
+      char *chars = value + sizeof(uint64_t);
+      Field current(kTypeChar, chars + sizeof(uint16_t), MACH_READ_FROM(uint16_t, chars), false);
+      if (count != 0 &&
+          (is_min ? field.CompareLessThan(current) : field.CompareGreaterThan(current)) != CmpBool::kTrue) {
+        continue;
+      }
+      MACH_WRITE_TO(uint16_t, chars, static_cast<uint16_t>(field.GetLength()));
+      memcpy(chars + sizeof(uint16_t), field.GetData(), field.GetLength());
+    }
+  }
+}
+
+void HashAggregateOperator::reset_table(size_t capacity) {
+  capacity_ = capacity;
+  groups_ = 0;
+  slots_.assign(capacity * slot_size_, 0);
+}
+
+void HashAggregateOperator::load_partition() {
+  Partition partition = partitions_.back();
+  partitions_.pop_back();
+  reset_table(AGGREGATE_INITIAL_SLOTS);
+  rewind(partition.file);
+  uint64_t hash;
+  uint32_t size;
+  while (fread(&hash, sizeof(uint64_t), 1, partition.file) == 1 &&
+         fread(&size, sizeof(uint32_t), 1, partition.file) == 1) {
+    buffer_.resize(size);
+    if (fread(buffer_.data(), 1, size, partition.file) != size) break;
+    read_row_.DeserializeFrom(buffer_.data(), schema_);
+    encode_keys(read_row_);
+    add_row(read_row_, hash, partition.level);
+  }
+  fclose(partition.file);
+  for (auto file : writing_) partitions_.push_back({file, partition.level + 1});
+  writing_.clear();
+}
+
+void HashAggregateOperator::close_partitions() {
+  for (auto &partition : partitions_) fclose(partition.file);
+  partitions_.clear();
+  for (auto file : writing_) fclose(file);
+  writing_.clear();
+}
+
+/** bytes of the arena of a sort with a limit before the rows dropped from it are cleared out */
+static constexpr size_t SORT_MIN_COMPACT = 64 << 10;
+
+/**
+ * @return the order of two normalized keys, one is never a proper prefix of another
+ */
+static int compare_keys(const char *lhs, uint32_t lhs_size, const char *rhs, uint32_t rhs_size) {
+  int result = memcmp(lhs, rhs, std::min(lhs_size, rhs_size));
+  if (result != 0) return result;
+  return lhs_size < rhs_size ? -1 : lhs_size > rhs_size;
+}
+
+void SortOperator::Init() {
+  close_runs();
+  entries_.clear();
+  arena_.clear();
+  dropped_ = 0;
+  heap_ = limit_ != SIZE_MAX;
+  spilled_ = false;
+  next_ = emitted_ = 0;
+  child_->Init();
+  if (limit_ == 0) return;
+  auto before = [this](const Entry &lhs, const Entry &rhs) { return less(lhs, rhs); };
+  const Row *row;
+  while (child_->Next(&row)) {
+    encode_keys(*row);
+    if (heap_ && entries_.size() == limit_) {
+      // the heap holds the least rows so far, its top the greatest of them
+      const Entry &top = entries_.front();
+      if (compare_keys(key_.data(), key_.size(), arena_.data() + top.offset, top.key_size) >= 0) continue;
+      std::pop_heap(entries_.begin(), entries_.end(), before);
+      dropped_ += entries_.back().size;
+      entries_.pop_back();
+    }
+    entries_.push_back(add_entry(*row));
+    if (heap_) std::push_heap(entries_.begin(), entries_.end(), before);
+    size_t used = arena_.size() - dropped_ + entries_.size() * sizeof(Entry);
+    if (heap_ && used > memory_budget_) {
+      // the rows of the limit do not fit, they are sorted like any others
+      heap_ = false;
+    } else if (heap_ && arena_.size() >= SORT_MIN_COMPACT && dropped_ > arena_.size() - dropped_) {
+      // the rows dropped take most of the arena, the ones left are moved to a new one
+      std::vector<char> arena;
+      arena.reserve(2 * (arena_.size() - dropped_));
+      for (auto &entry : entries_) {
+        arena.insert(arena.end(), arena_.data() + entry.offset, arena_.data() + entry.offset + entry.size);
+        entry.offset = static_cast<uint32_t>(arena.size() - entry.size);
+      }
+      arena_ = std::move(arena);
+      dropped_ = 0;
+    }
+    if (!heap_ && used > memory_budget_) spill();
+  }
+  if (!spilled_) {
+    std::sort(entries_.begin(), entries_.end(), before);
+    return;
+  }
+  if (!entries_.empty()) spill();
+  // the runs written last are merged first, into a run that is merged again with the ones before
+  while (runs_.size() > SORT_MERGE_WAYS) merge(runs_.size() - SORT_MERGE_WAYS);
+  open_runs(0);
+}
+
+bool SortOperator::Next(const Row **row) {
+  if (emitted_ == limit_) return false;
+  if (!spilled_) {
+    if (next_ == entries_.size()) return false;
+    const Entry &entry = entries_[next_++];
+    decode_row(arena_.data() + entry.offset + entry.key_size);
+  } else {
+    if (merging_.empty()) return false;
+    const Run &run = runs_[merging_.front()];
+    decode_row(run.row.data() + run.key_size);
+    pop_run();
+  }
+  emitted_++;
+  *row = &row_;
+  return true;
+}
+
+void SortOperator::encode_keys(const Row &row) {
+  key_.clear();
+  for (auto &key : keys_) {
+    size_t begin = key_.size();
+    const Field *field = row.GetField(key.column);
+    if (field->IsNull()) {
+      // a null is a flag less than that of any value, nothing follows it
+      key_.push_back(0);
+    } else if (field->GetTypeId() == kTypeChar) {
+      key_.push_back(1);
+      // a zero byte is escaped as 0 1, so the terminator 0 0 is less than any byte that may follow
+      for (uint32_t i = 0; i < field->GetLength(); i++) {
+        key_.push_back(field->GetData()[i]);
+        if (field->GetData()[i] == 0) key_.push_back(1);
+      }
+      key_.push_back(0);
+      key_.push_back(0);
+    } else {
+      key_.push_back(1);
+      char buf[sizeof(int32_t)];
+      field->SerializeTo(buf);
+      double value = field->GetTypeId() == kTypeInt ? MACH_READ_FROM(int32_t, buf) : MACH_READ_FROM(float, buf);
+      // 0 and -0 are the same number
+      if (value == 0) value = 0;
+      // the bits of a positive double are ordered like it and those of a negative one the other way round, with
+      // the sign flipped, or all bits of a negative one, they are ordered like the numbers, big endian
+      uint64_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      bits = (bits >> 63) != 0 ? ~bits : bits | (uint64_t(1) << 63);
+      for (int shift = 56; shift >= 0; shift -= 8) key_.push_back(static_cast<char>(bits >> shift));
+    }
+    if (key.descending) {
+      for (size_t i = begin; i < key_.size(); i++) key_[i] = static_cast<char>(~key_[i]);
+    }
+  }
+}
+
+SortOperator::Entry SortOperator::add_entry(const Row &row) {
+  // the fields follow the key as their count, then the type, a null flag and the value of each
+  uint32_t size = static_cast<uint32_t>(key_.size() + sizeof(uint32_t));
+  for (size_t i = 0; i < row.GetFieldCount(); i++) {
+    const Field *field = row.GetField(i);
+    size += 2 + (field->IsNull() ? 0 : field->GetSerializedSize());
+  }
+  Entry entry;
+  entry.offset = static_cast<uint32_t>(arena_.size());
+  entry.key_size = static_cast<uint32_t>(key_.size());
+  entry.size = size;
+  memset(entry.prefix, 0, SORT_PREFIX_SIZE);
+  memcpy(entry.prefix, key_.data(), std::min<size_t>(key_.size(), SORT_PREFIX_SIZE));
+  arena_.resize(arena_.size() + size);
+  char *data = arena_.data() + entry.offset;
+  memcpy(data, key_.data(), key_.size());
+  data += key_.size();
+  MACH_WRITE_UINT32(data, static_cast<uint32_t>(row.GetFieldCount()));
+  data += sizeof(uint32_t);
+  for (size_t i = 0; i < row.GetFieldCount(); i++) {
+    const Field *field = row.GetField(i);
+    data[0] = static_cast<char>(field->GetTypeId());
+    data[1] = field->IsNull();
+    data += 2;
+    if (!field->IsNull()) data += field->SerializeTo(data);
+  }
+  return entry;
+}
+
+bool SortOperator::less(const Entry &lhs, const Entry &rhs) const {
+  int result = memcmp(lhs.prefix, rhs.prefix, SORT_PREFIX_SIZE);
+  if (result != 0) return result < 0;
+  // keys no longer than the prefix are equal if their prefixes are
+  if (lhs.key_size <= SORT_PREFIX_SIZE && rhs.key_size <= SORT_PREFIX_SIZE) return false;
+  return compare_keys(arena_.data() + lhs.offset, lhs.key_size, arena_.data() + rhs.offset, rhs.key_size) < 0;
+}
+
+/**
+ * Append a row of a run to file, its normalized key and fields in data
+ */
+static void write_run_row(FILE *file, const char *data, uint32_t key_size, uint32_t size) {
+  fwrite(&key_size, sizeof(uint32_t), 1, file);
+  fwrite(&size, sizeof(uint32_t), 1, file);
+  fwrite(data, 1, size, file);
+}
+
+void SortOperator::spill() {
+  std::sort(entries_.begin(), entries_.end(), [this](const Entry &lhs, const Entry &rhs) { return less(lhs, rhs); });
+  FILE *file = std::tmpfile();
+  ASSERT(file != nullptr, "SortOperator : Temporary File Failed");
+  // no more than limit rows of a run are ever handed out
+  for (size_t i = 0; i < entries_.size() && i < limit_; i++) {
+    write_run_row(file, arena_.data() + entries_[i].offset, entries_[i].key_size, entries_[i].size);
+  }
+  runs_.push_back({file, {}, 0});
+  entries_.clear();
+  arena_.clear();
+  dropped_ = 0;
+  spilled_ = true;
+}
+
+void SortOperator::merge(size_t begin) {
+  FILE *file = std::tmpfile();
+  ASSERT(file != nullptr, "SortOperator : Temporary File Failed");
+  open_runs(begin);
+  for (size_t written = 0; !merging_.empty() && written < limit_; written++) {
+    const Run &run = runs_[merging_.front()];
+    write_run_row(file, run.row.data(), run.key_size, static_cast<uint32_t>(run.row.size()));
+    pop_run();
+  }
+  merging_.clear();
+  for (size_t i = begin; i < runs_.size(); i++) fclose(runs_[i].file);
+  runs_.resize(begin);
+  runs_.push_back({file, {}, 0});
+}
+
+bool SortOperator::run_after(uint32_t lhs, uint32_t rhs) const {
+  const Run &left = runs_[lhs], &right = runs_[rhs];
+  return compare_keys(right.row.data(), right.key_size, left.row.data(), left.key_size) < 0;
+}
+
+void SortOperator::open_runs(size_t begin) {
+  merging_.clear();
+  for (size_t i = begin; i < runs_.size(); i++) {
+    rewind(runs_[i].file);
+    if (read_run(runs_[i])) merging_.push_back(static_cast<uint32_t>(i));
+  }
+  std::make_heap(merging_.begin(), merging_.end(), [this](uint32_t lhs, uint32_t rhs) { return run_after(lhs, rhs); });
+}
+
+void SortOperator::pop_run() {
+  auto after = [this](uint32_t lhs, uint32_t rhs) { return run_after(lhs, rhs); };
+  std::pop_heap(merging_.begin(), merging_.end(), after);
+  if (read_run(runs_[merging_.back()])) {
+    std::push_heap(merging_.begin(), merging_.end(), after);
+  } else {
+    merging_.pop_back();
+  }
+}
+
+bool SortOperator::read_run(Run &run) {
+  uint32_t size;
+  if (fread(&run.key_size, sizeof(uint32_t), 1, run.file) != 1 || fread(&size, sizeof(uint32_t), 1, run.file) != 1) {
+    return false;
+  }
+  run.row.resize(size);
+  return fread(run.row.data(), 1, size, run.file) == size;
+}
+
+void SortOperator::decode_row(const char *data) {
+  uint32_t count = MACH_READ_UINT32(data);
+  data += sizeof(uint32_t);
+  fields_.clear();
+  fields_.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    auto type = static_cast<TypeId>(data[0]);
+    bool is_null = data[1] != 0;
+    data += 2;
+    if (is_null) {
+      fields_.emplace_back(type);
+    } else if (type == kTypeChar) {
+      uint32_t len = MACH_READ_UINT32(data);
+      fields_.emplace_back(type, const_cast<char *>(data + sizeof(uint32_t)), len, false);
+      data += sizeof(uint32_t) + len;
+    } else if (type == kTypeInt) {
+      fields_.emplace_back(type, MACH_READ_FROM(int32_t, data));
+      data += sizeof(int32_t);
+    } else {
+      fields_.emplace_back(type, MACH_READ_FROM(float, data));
+      data += sizeof(float);
+    }
+  }
+  row_.CopyFields(fields_);
+}
+
+void SortOperator::close_runs() {
+  merging_.clear();
+  for (auto &run : runs_) fclose(run.file);
+  runs_.clear();
+}
+
+VectorScanOperator::VectorScanOperator(TableHeap *table_heap, const std::vector<uint32_t> &columns,
+                                       std::unique_ptr<ScanPredicate> predicate)
+    : table_heap_(table_heap), predicate_(std::move(predicate)), batch_(table_heap->GetSchema(), columns) {}
+
+void VectorScanOperator::Init() {
+  pages_ = table_heap_->ScanPages(predicate_.get());
+  next_page_ = 0;
+  slot_ = 0;
+}
+
+bool VectorScanOperator::Next(VectorBatch **batch) {
+  batch_.Reset();
+  // the tuples of several pages fill a batch, a page that does not fit is gone on with in the next one
+  while (!batch_.IsFull() && next_page_ < pages_.size()) {
+    if (table_heap_->ReadBatch(pages_[next_page_], slot_, batch_, predicate_ != nullptr)) {
+      next_page_++;
+      slot_ = 0;
+    }
+  }
+  if (batch_.GetSize() == 0) return false;
+  if (predicate_ != nullptr) {
+    uint64_t sel[VECTOR_BATCH_WORDS];
+    auto &vector = batch_.GetColumn(predicate_->GetColumnIndex());
+    predicate_->EvaluateColumn(vector.GetValues(), vector.GetWidth(), vector.GetNulls(), batch_.GetSize(), sel);
+    batch_.Select(sel);
+  }
+  *batch = &batch_;
+  return true;
+}
+
+bool VectorFilterOperator::Next(VectorBatch **batch) {
+  uint64_t sel[VECTOR_BATCH_WORDS];
+  while (child_->Next(batch)) {
+    if ((*batch)->GetSelectedCount() == 0) continue;
+    condition_->EvaluateBatch(**batch, sel);
+    (*batch)->Select(sel);
+    if ((*batch)->GetSelectedCount() > 0) return true;
+  }
+  return false;
+}
+
+void VectorProjectionOperator::Init() {
+  batch_ = nullptr;
+  next_ = 0;
+  child_->Init();
+}
+
+bool VectorProjectionOperator::Next(const Row **row) {
+  while (batch_ == nullptr || next_ == batch_->GetSelectedCount()) {
+    if (!child_->Next(&batch_)) {
+      batch_ = nullptr;
+      return false;
+    }
+    next_ = 0;
+  }
+  row_.CopyFields(*batch_, batch_->GetSelection()[next_++], columns_);
+  *row = &row_;
+  return true;
+}
+
+void OutputOperator::Init() {
+  block_.clear();
+  printed_ = 0;
+  line_.clear();
+  child_->Init();
+}
+
+bool OutputOperator::Next(const Row **row) {
+  if (!child_->Next(row)) {
+    flush();
+    return false;
+  }
+  std::vector<std::string> texts;
+  texts.reserve((*row)->GetFieldCount());
+  for (uint32_t i = 0; i < (*row)->GetFieldCount(); i++) texts.push_back(FieldText(*(*row)->GetField(i)));
+  block_.push_back(std::move(texts));
+  if (block_.size() == OUTPUT_BLOCK_ROWS) flush();
+  return true;
+}
+
+size_t OutputOperator::Run() {
+  Init();
+  const Row *row;
+  while (Next(&row)) {
+  }
+  return printed_;
+}
+
+std::string OutputOperator::FieldText(const Field &field) {
+  if (field.IsNull()) return "null";
+  // chars are not null terminated
+  if (field.GetTypeId() == kTypeChar) return std::string(field.GetData(), field.GetLength());
+  std::stringstream text;
+  text << field;
+  return text.str();
+}
+
+void OutputOperator::flush() {
+  if (block_.empty()) return;
+  std::vector<std::size_t> max_length(block_[0].size() + 1);
+  max_length[0] = std::to_string(printed_ + block_.size() - 1).length();
+  for (auto &tuple : block_) {
+    for (std::size_t i = 0; i < tuple.size(); i++) max_length[i + 1] = std::max(max_length[i + 1], tuple[i].length());
+  }
+  std::string line = "+";
+  for (auto len : max_length) {
+    line.append(len, '-');
+    line += '+';
+  }
+  // a block as wide as the one before goes on below its last border
+  if (line != line_) out_ << line << '\n';
+  line_ = line;
+  auto pad = [&](std::size_t len, const std::string &text) { out_ << text << std::string(len - text.length(), ' '); };
+  for (auto &tuple : block_) {
+    out_ << '|';
+    pad(max_length[0], std::to_string(printed_++));
+    out_ << '|';
+    for (std::size_t j = 0; j < tuple.size(); j++) {
+      pad(max_length[j + 1], tuple[j]);
+      out_ << '|';
+    }
+    out_ << '\n' << line << '\n';
+  }
+  out_.flush();
+  block_.clear();
+}
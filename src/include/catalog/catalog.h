@@ -75,7 +75,12 @@ public:
 
   ~CatalogManager();
 
-  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info);
+  /**
+   * @param layout kColumn fails if not even one row of schema fits a column page
+   * @param cluster_key columns to cluster the rows on, only rows of a kRow layout are clustered
+   */
+  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info,
+                      TableLayout layout = TableLayout::kRow, const std::vector<uint32_t> &cluster_key = {});
 
   dberr_t GetTable(const std::string &table_name, TableInfo *&table_info);
 
@@ -91,6 +96,11 @@ public:
 
   dberr_t DropTable(const std::string &table_name);
 
+  /**
+   * Collect the statistics of a table and store them in its meta page, the ones collected before are replaced
+   */
+  dberr_t AnalyzeTable(const std::string &table_name, TableStatistics *&statistics);
+
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
 private:
@@ -98,6 +108,15 @@ private:
 
   dberr_t FlushCatalogMetaPage() const;
 
+  dberr_t FlushIndexFilters() const;
+
+  dberr_t FlushTableMetas() const;
+
+  /**
+   * Write the metadata of a table back to its meta page if its heap moved the pages the metadata records
+   */
+  dberr_t FlushTableMeta(const table_id_t table_id) const;
+
   dberr_t LoadTable(const table_id_t table_id, const page_id_t page_id);
 
   dberr_t LoadIndex(const index_id_t index_id, const page_id_t page_id);
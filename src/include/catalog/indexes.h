@@ -2,10 +2,12 @@
 #define MINISQL_INDEXES_H
 
 #include <memory>
+#include <vector>
 
 #include "catalog/table.h"
 #include "index/generic_key.h"
 #include "index/b_plus_tree_index.h"
+#include "index/bloom_filter.h"
 #include "index/index.h"
 #include "record/schema.h"
 
@@ -37,7 +39,8 @@ private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name,
-                         const table_id_t table_id, const std::vector<uint32_t> &key_map) {}
+                         const table_id_t table_id, const std::vector<uint32_t> &key_map)
+          : index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map) {}
 
 private:
   static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
@@ -51,6 +54,10 @@ private:
  * The IndexInfo class maintains metadata about a index.
  */
 class IndexInfo {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+
 public:
   static IndexInfo *Create(MemHeap *heap) {
     void *buf = heap->Allocate(sizeof(IndexInfo));
@@ -70,7 +77,8 @@ public:
     key_schema_ = Schema::ShallowCopySchema(table_info->GetSchema(), meta_data_->GetKeyMapping(), heap_);
     // Step3: call CreateIndex to create the index
     index_ = CreateIndex(buffer_pool_manager);
-    // ASSERT(false, "Not Implemented yet.");
+    // Step4: empty key filter, filled by LoadFilter/RebuildFilter on load
+    filter_ = BloomFilter::Create(heap_);
   }
 
   inline Index *GetIndex() { return index_; }
@@ -83,14 +91,65 @@ public:
 
   inline TableInfo *GetTableInfo() const { return table_info_; }
 
+  inline IndexMetadata *GetMetaData() const { return meta_data_; }
+
+  inline BloomFilter *GetFilter() const { return filter_; }
+
+  /**
+   * @return false if key is definitely not in the index, so the tree lookup can be skipped
+   */
+  bool MayContain(const Row &key) const {
+    INDEX_KEY_TYPE index_key;
+    index_key.SerializeFromKey(key, key_schema_);
+    return filter_->MayContain(index_key.data, sizeof(index_key.data));
+  }
+
+  /**
+   * Must be called for every key inserted into the index
+   */
+  void AddToFilter(const Row &key) {
+    INDEX_KEY_TYPE index_key;
+    index_key.SerializeFromKey(key, key_schema_);
+    filter_->Insert(index_key.data, sizeof(index_key.data));
+    if (filter_->IsFull()) {
+      RebuildFilter();
+    }
+  }
+
+  /**
+   * Read the filter persisted behind the index metadata
+   * @return false if the meta page holds no filter written back at a clean close
+   */
+  bool LoadFilter(char *buf, BufferPoolManager *buffer_pool_manager) {
+    return filter_->DeserializeFrom(buf, buffer_pool_manager) != 0;
+  }
+
+  /**
+   * Refill the filter from all keys currently in the index, sized for twice
+   * as many keys so that a growing index is rebuilt once per doubling
+   */
+  void RebuildFilter() {
+    std::vector<uint64_t> hashes;
+    auto index = reinterpret_cast<BP_TREE_INDEX *>(index_);
+    Row key(INVALID_ROWID);
+    INDEX_KEY_TYPE index_key;
+    for (auto it = index->GetBeginIterator(); it != index->GetEndIterator(); ++it) {
+      // keys written in the legacy row format are hashed the way new keys are serialized
+      (*it).first.DeserializeToKey(key, key_schema_);
+      index_key.SerializeFromKey(key, key_schema_);
+      hashes.push_back(BloomFilter::Hash(index_key.data, sizeof(index_key.data)));
+    }
+    filter_->Reset(static_cast<uint32_t>(hashes.size() * 2));
+    for (auto hash : hashes) {
+      filter_->InsertHash(hash);
+    }
+  }
+
 private:
   explicit IndexInfo() : meta_data_{nullptr}, index_{nullptr}, table_info_{nullptr},
-                         key_schema_{nullptr}, heap_(new SimpleMemHeap()) {}
+                         key_schema_{nullptr}, filter_{nullptr}, heap_(new SimpleMemHeap()) {}
 
   Index *CreateIndex(BufferPoolManager *buffer_pool_manager) {
-    using INDEX_KEY_TYPE = GenericKey<32>;
-    using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
-    using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
     auto index = new(heap_->Allocate(sizeof(BP_TREE_INDEX)))BP_TREE_INDEX(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager);
     //ASSERT(false, "Not Implemented yet.");
     return index;
@@ -101,6 +160,7 @@ private:
   Index *index_;
   TableInfo *table_info_;
   IndexSchema *key_schema_;
+  BloomFilter *filter_;
   MemHeap *heap_;
 };
 
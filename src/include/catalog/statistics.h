@@ -0,0 +1,173 @@
+#ifndef MINISQL_STATISTICS_H
+#define MINISQL_STATISTICS_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/config.h"
+#include "record/field.h"
+#include "record/filter_kernels.h"
+#include "storage/table_heap.h"
+#include "utils/mem_heap.h"
+
+/**
+ * Registers of a HyperLogLog sketch are 2^STATS_HLL_PRECISION, the error of an estimate is about 1.04 / sqrt(2^p)
+ */
+#define STATS_HLL_PRECISION 12
+
+/**
+ * Buckets of an equi-depth histogram, fewer when the statistics of a wide table do not fit its meta page
+ */
+#define STATS_HISTOGRAM_BUCKETS 32
+
+/**
+ * Values of a column the histogram is built from, a sample of the column for larger tables
+ */
+#define STATS_SAMPLE_SIZE 30000
+
+/**
+ * Costs of the access paths, in units of reading a heap page in a sequential scan. A tuple of a scan is
+ * checked in a batch, a tuple fetched by rid is built into a row alone, which costs about eight times more.
+ */
+#define SEQ_PAGE_COST 1.0
+#define SCAN_TUPLE_COST 0.01
+#define INDEX_PROBE_COST 4.0
+#define INDEX_TUPLE_COST 0.08
+#define FETCH_PAGE_COST 1.0
+
+/**
+ * Estimates the number of distinct values inserted into it from 2^STATS_HLL_PRECISION bytes,
+ * no matter how many there are.
+ */
+class HyperLogLog {
+public:
+  HyperLogLog() { memset(registers_, 0, sizeof(registers_)); }
+
+  void Insert(const char *key, uint32_t len);
+
+  double Estimate() const;
+
+private:
+  static uint64_t Hash(const char *key, uint32_t len);
+
+private:
+  static constexpr uint32_t NUM_REGISTERS = 1 << STATS_HLL_PRECISION;
+  uint8_t registers_[NUM_REGISTERS];
+};
+
+/**
+ * What ANALYZE found out about the tuples of a table: how many rows and pages
+ * it has and, for each column, how many of its values are null, how many are
+ * distinct and an equi-depth histogram of the others. A value is placed in the
+ * histogram by its key, the value itself for an int or a float and the first
+ * eight chars read as a big endian number for a char, so the keys are ordered
+ * like the values. Bounds[0] is the least key of a column and Bounds[B] the
+ * greatest, each of the B buckets between holds as many values.
+ *
+ * The statistics are stored right after the table metadata in the table meta page.
+ *
+ * Format (size in byte):
+ *  ------------------------------------------------------------------------------------
+ * | Magic (4) | RowCount (4) | PageCount (4) | ColumnCount (4) | Column (..) | ... |
+ *  ------------------------------------------------------------------------------------
+ * Column:
+ *  --------------------------------------------------------------------------
+ * | NullCount (4) | Distinct (4) | BucketCount (4) | Bounds (8 * (B + 1)) |
+ *  --------------------------------------------------------------------------
+ */
+class TableStatistics {
+public:
+  static TableStatistics *Create(MemHeap *heap) {
+    void *buf = heap->Allocate(sizeof(TableStatistics));
+    return new(buf)TableStatistics();
+  }
+
+  /**
+   * Read every tuple of table_heap, the statistics collected before are replaced
+   */
+  void Collect(TableHeap *table_heap);
+
+  /**
+   * @return estimated fraction of the rows whose column compares op to key
+   */
+  double Selectivity(uint32_t column, CompareOp op, const Field &key) const;
+
+  /**
+   * @return cost of reading every tuple of the table
+   */
+  inline double ScanCost() const { return page_count_ * SEQ_PAGE_COST + row_count_ * SCAN_TUPLE_COST; }
+
+  /**
+   * Rids an index returns are fetched sorted by page, so each page is read once however many of its tuples match
+   * @return cost of looking up rows tuples in an index and fetching them from the heap
+   */
+  inline double IndexScanCost(double rows) const { return LookupCost(1, rows); }
+
+  /**
+   * @return cost of probes lookups in an index finding rows tuples in all, fetched from the heap
+   */
+  double LookupCost(double probes, double rows) const;
+
+  inline uint32_t GetRowCount() const { return row_count_; }
+
+  inline uint32_t GetPageCount() const { return page_count_; }
+
+  inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  inline uint32_t GetNullCount(uint32_t column) const { return columns_[column].null_count; }
+
+  inline uint32_t GetDistinctCount(uint32_t column) const { return columns_[column].distinct; }
+
+  /**
+   * @return B + 1 bounds of the buckets of the histogram of column, empty if it has no value that is not null
+   */
+  inline const std::vector<double> &GetBounds(uint32_t column) const { return columns_[column].bounds; }
+
+  /**
+   * Merge pairs of buckets of every histogram until the statistics take at most size bytes
+   * @return false if they do not fit even with a single bucket for each column
+   */
+  bool Shrink(uint32_t size);
+
+  uint32_t SerializeTo(char *buf) const;
+
+  uint32_t GetSerializedSize() const;
+
+  /**
+   * @return bytes read, 0 if buf does not hold serialized statistics
+   */
+  uint32_t DeserializeFrom(char *buf);
+
+  /**
+   * @return key of a value of type, ordered like the values
+   */
+  static double KeyOf(TypeId type, const char *data, uint32_t len);
+
+private:
+  TableStatistics() = default;
+
+  /**
+   * @return estimated fraction of the values of column, nulls left out, whose key is less than key
+   */
+  double fraction_below(uint32_t column, double key) const;
+
+  /**
+   * @return estimated fraction of the values of column, nulls left out, whose key is key
+   */
+  double fraction_equal(uint32_t column, double key) const;
+
+private:
+  struct ColumnStatistics {
+    uint32_t null_count{0};
+    uint32_t distinct{0};
+    std::vector<double> bounds;
+  };
+
+  static constexpr uint32_t TABLE_STATISTICS_MAGIC_NUM = 520917;
+  uint32_t row_count_{0};
+  uint32_t page_count_{0};
+  std::vector<ColumnStatistics> columns_;
+};
+
+#endif  // MINISQL_STATISTICS_H
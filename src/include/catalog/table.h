@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "catalog/statistics.h"
 #include "glog/logging.h"
 #include "record/schema.h"
 #include "storage/table_heap.h"
@@ -18,7 +19,8 @@ public:
   static uint32_t DeserializeFrom(char *buf, TableMetadata *&table_meta, MemHeap *heap);
 
   static TableMetadata *Create(table_id_t table_id, std::string table_name,
-                               page_id_t root_page_id, TableSchema *schema, MemHeap *heap);
+                               page_id_t root_page_id, page_id_t fsm_page_id, TableSchema *schema, MemHeap *heap,
+                               TableLayout layout = TableLayout::kRow, const std::vector<uint32_t> &cluster_key = {});
 
   inline table_id_t GetTableId() const { return table_id_; }
 
@@ -26,20 +28,46 @@ public:
 
   inline uint32_t GetFirstPageId() const { return root_page_id_; }
 
+  inline page_id_t GetFsmPageId() const { return fsm_page_id_; }
+
+  inline TableLayout GetLayout() const { return layout_; }
+
+  /**
+   * @return columns of the key the rows are clustered on, empty if they are not
+   */
+  inline const std::vector<uint32_t> &GetClusterKey() const { return cluster_key_; }
+
+  /**
+   * Pick up page ids the table heap moved, e.g. a lazily built free space map
+   * @return true if the metadata changed and has to be written back
+   */
+  bool SyncWithHeap(const TableHeap *table_heap);
+
   inline Schema *GetSchema() const { return schema_; }
 
 
 private:
   TableMetadata() = delete;
 
-  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema);
+  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, page_id_t fsm_page_id,
+                TableSchema *schema, TableLayout layout, const std::vector<uint32_t> &cluster_key);
 
 private:
-  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  /**
+   * metadata written before free space maps has no fsm page id, before column pages no layout,
+   * before clustered tables no cluster key
+   */
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM_V1 = 344528;
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM_V2 = 344529;
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM_V3 = 344530;
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344531;
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
+  page_id_t fsm_page_id_;
   Schema *schema_;
+  TableLayout layout_;
+  std::vector<uint32_t> cluster_key_;
 };
 
 /**
@@ -63,6 +91,8 @@ public:
 
   inline TableHeap *GetTableHeap() const { return table_heap_; }
 
+  inline TableMetadata *GetMetaData() const { return table_meta_; }
+
   inline MemHeap *GetMemHeap() const { return heap_; }
 
   inline table_id_t GetTableId() const { return table_meta_->table_id_; }
@@ -73,12 +103,20 @@ public:
 
   inline page_id_t GetRootPageId() const { return table_meta_->root_page_id_; }
 
+  /**
+   * @return what the last ANALYZE of the table found, nullptr if it was never analyzed
+   */
+  inline TableStatistics *GetStatistics() const { return statistics_; }
+
+  inline void SetStatistics(TableStatistics *statistics) { statistics_ = statistics; }
+
 private:
   explicit TableInfo() : heap_(new SimpleMemHeap()) {};
 
 private:
   TableMetadata *table_meta_;
   TableHeap *table_heap_;
+  TableStatistics *statistics_{nullptr};
   MemHeap *heap_; /** store all objects allocated in table_meta and table heap */
 };
 
@@ -20,10 +20,12 @@ void set_or(std::unordered_set<RowId>& a, std::unordered_set<RowId>& b){
 void set_and(std::unordered_set<RowId>& a, std::unordered_set<RowId> &b) {
   if(a.size() > b.size())
     std::swap(a, b);
-  for(auto& rid : a){
-    if(b.find(rid) == b.end()) {
-      a.erase(rid);
-    }
+  // erasing invalidates the iterator of the erased element only, go on from the one erase returns
+  for(auto it = a.begin(); it != a.end();) {
+    if(b.find(*it) == b.end())
+      it = a.erase(it);
+    else
+      ++it;
   }
 }
 
@@ -0,0 +1,38 @@
+#ifndef MINISQL_CPU_FEATURES_H
+#define MINISQL_CPU_FEATURES_H
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MINISQL_SIMD_X86
+#endif
+
+namespace simd {
+
+/**
+ * The vector instruction sets of the running cpu, probed once per process.
+ * Kernels compiled with a target attribute may only be called when the cpu has their set.
+ */
+struct CpuFeatures {
+  bool sse2{false};
+  bool sse42{false};
+  bool avx2{false};
+
+  static const CpuFeatures &Get() {
+    static const CpuFeatures features;
+    return features;
+  }
+
+private:
+  CpuFeatures() {
+#ifdef MINISQL_SIMD_X86
+    __builtin_cpu_init();
+    sse2 = __builtin_cpu_supports("sse2");
+    sse42 = __builtin_cpu_supports("sse4.2");
+    avx2 = __builtin_cpu_supports("avx2");
+#endif
+  }
+};
+
+}  // namespace simd
+
+#endif  // MINISQL_CPU_FEATURES_H
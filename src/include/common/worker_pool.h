@@ -0,0 +1,116 @@
+#ifndef MINISQL_WORKER_POOL_H
+#define MINISQL_WORKER_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "macros.h"
+
+/**
+ * A fixed set of threads shared by every parallel operator of the process,
+ * so that a scan hands its morsels to threads that already exist instead of spawning its own.
+ */
+class WorkerPool {
+  using mutex_t = std::mutex;
+  using cond_t = std::condition_variable;
+
+public:
+  explicit WorkerPool(uint32_t num_threads) {
+    for (uint32_t i = 0; i < num_threads; i++) threads_.emplace_back([this] { work(); });
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<mutex_t> guard(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_all();
+    for (auto &thread : threads_) thread.join();
+  }
+
+  DISALLOW_COPY(WorkerPool);
+
+  /**
+   * The pool of the process, one thread per core besides the calling one
+   */
+  static WorkerPool &Shared() {
+    static WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+  }
+
+  /**
+   * Call task(i) for every i in [0, n) and return once all calls are done.
+   * The caller runs task(0) itself and, while it waits, any call the pool threads have not taken yet,
+   * so that a pool busy with other work, or with no threads at all, still gets through.
+   */
+  void Run(size_t n, const std::function<void(size_t)> &task) {
+    if (n == 0) return;
+    Job job{&task, n - 1};
+    {
+      std::lock_guard<mutex_t> guard(mutex_);
+      for (size_t i = 1; i < n; i++) queue_.push_back({&job, i});
+    }
+    if (n > 2) {
+      ready_.notify_all();
+    } else if (n == 2) {
+      ready_.notify_one();
+    }
+    task(0);
+    std::unique_lock<mutex_t> latch(mutex_);
+    while (job.pending > 0) {
+      auto it = std::find_if(queue_.begin(), queue_.end(), [&](const Item &item) { return item.job == &job; });
+      if (it == queue_.end()) {
+        done_.wait(latch);
+        continue;
+      }
+      auto item = *it;
+      queue_.erase(it);
+      latch.unlock();
+      run(item);
+      latch.lock();
+    }
+  }
+
+private:
+  struct Job {
+    const std::function<void(size_t)> *task;
+    size_t pending;
+  };
+
+  struct Item {
+    Job *job;
+    size_t index;
+  };
+
+  void work() {
+    std::unique_lock<mutex_t> latch(mutex_);
+    while (true) {
+      ready_.wait(latch, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+      auto item = queue_.front();
+      queue_.pop_front();
+      latch.unlock();
+      run(item);
+      latch.lock();
+    }
+  }
+
+  void run(const Item &item) {
+    (*item.job->task)(item.index);
+    std::lock_guard<mutex_t> guard(mutex_);
+    if (--item.job->pending == 0) done_.notify_all();
+  }
+
+  mutex_t mutex_;
+  cond_t ready_;
+  cond_t done_;
+  std::deque<Item> queue_;
+  std::vector<std::thread> threads_;
+  bool stop_{false};
+};
+
+#endif  // MINISQL_WORKER_POOL_H
@@ -0,0 +1,70 @@
+#ifndef MINISQL_CSV_READER_H
+#define MINISQL_CSV_READER_H
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Streaming reader of comma separated files, used by COPY.
+ *
+ * The file is read in chunks of CSV_READ_BUFFER_SIZE bytes and handed out one
+ * record at a time. Fields point into the read buffer and stay valid until the
+ * next call to NextRecord.
+ *
+ * Fields are separated by ',' and records by '\n' ("\r\n" is accepted). A field
+ * may be quoted with '"', a quote inside a quoted field is written twice. An
+ * empty unquoted field is NULL.
+ */
+#define CSV_READ_BUFFER_SIZE (1 << 20)
+
+struct CsvField {
+  std::string_view text;
+  bool is_null;
+};
+
+class CsvReader {
+public:
+  explicit CsvReader(const std::string &file_name);
+
+  ~CsvReader();
+
+  inline bool IsOpen() const { return file_ != nullptr; }
+
+  /**
+   * @return false at the end of the file or on a malformed record
+   */
+  bool NextRecord(std::vector<CsvField> &fields);
+
+  inline bool IsMalformed() const { return malformed_; }
+
+  /**
+   * @return line number of the last record handed out
+   */
+  inline uint32_t GetLineNo() const { return line_no_; }
+
+private:
+  /**
+   * Move the unread bytes to the front of the buffer and read more after them
+   * @return false if nothing could be read
+   */
+  bool Fill();
+
+  /**
+   * @return offset of the '\n' ending the record starting at begin_, or end_ if it is not in the buffer
+   */
+  size_t FindRecordEnd(uint32_t &newlines) const;
+
+  bool SplitRecord(size_t record_end, std::vector<CsvField> &fields);
+
+  FILE *file_{nullptr};
+  std::vector<char> buf_;
+  size_t begin_{0};
+  size_t end_{0};
+  bool eof_{false};
+  bool malformed_{false};
+  uint32_t line_no_{0};
+};
+
+#endif  // MINISQL_CSV_READER_H
@@ -2,11 +2,15 @@
 #define MINISQL_EXECUTE_ENGINE_H
 
 #include <iomanip>
+#include <limits>
 #include <string>
 #include <unordered_map>
 #include "common/dberr.h"
 #include "common/instance.h"
 #include "common/macros.h"
+#include "executor/csv_reader.h"
+#include "executor/operators.h"
+#include "utils/mem_heap.h"
 #include "transaction/transaction.h"
 
 extern "C" {
@@ -100,16 +104,27 @@ class ExecuteEngine {
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteCopy(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context);
+
  private:
   std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
   std::string current_db_;                                 /** current database */
+  ArenaMemHeap statement_heap_;                            /** rows of the running statement, reset after it */
   static PseudoDataBases database_structure;
 
+  dberr_t dispatch(pSyntaxNode ast, ExecuteContext *context);
+
   static bool generate_db_struct(const std::string &db_name, const DBStorageEngine *db);
 
   void make_db_tuple(pSyntaxNode head, const Schema &schema, std::unordered_map<std::string, std::size_t> &column_index,
                      std::vector<Field> &data_tup);
 
+  bool make_csv_tuple(const std::vector<CsvField> &record, const Schema &schema, std::vector<Field> &data_tup);
+
   bool check_index_constrains(const std::string &table_name, const std::vector<Field> &data_tuple,
                               std::unordered_map<std::string, std::size_t> &column_index);
 
@@ -119,9 +134,27 @@ class ExecuteEngine {
   void update_index(const std::string &table_name, const RowId &rid, const std::vector<Field *> &data_tuple,
                     std::unordered_map<std::string, std::size_t> &column_index, bool insert = true);
 
-  bool parse_column_definitions(const std::string &table_name, pSyntaxNode head);
+  /**
+   * @return callback that points the indexes of table_name at the new rid of a row its heap moved
+   */
+  TableHeap::MoveCallback reindex_moved(const std::string &table_name,
+                                        std::unordered_map<std::string, std::size_t> &column_index);
+
+  /**
+   * Create the table and the indexes of its keys, a clustered table has no index on its primary key
+   */
+  bool parse_column_definitions(const std::string &table_name, pSyntaxNode head, TableLayout layout, bool clustered);
+
+  /**
+   * Read the WITH (...) options of create table, only layout = row | column is known
+   */
+  bool parse_table_options(pSyntaxNode head, TableLayout &layout);
   Column *parse_single_column(pSyntaxNode ast, const int table_position, bool is_nullable, bool is_unique);
 
+  /**
+   * Collect the ids of the rows satisfying the condition ast: the rows the lookups of plan_access find, or
+   * those of a scan, are read and the rest of the condition is checked on them
+   */
   bool parse_condition(pSyntaxNode ast, const TableInfo *table_info, std::unordered_set<RowId> &ans_set);
 
   bool parse_compare(pSyntaxNode ast, const TableInfo *table_info, std::unordered_set<RowId> &ans_set);
@@ -130,8 +163,120 @@ class ExecuteEngine {
 
   Field get_field(pSyntaxNode ast, const TableInfo *table_info);
 
-  void pretty_print(TableInfo *table_info, std::vector<std::string> &used_columns,
-                    std::unordered_map<std::string, std::size_t> &column_index, std::unordered_set<RowId> &ans_set);
+  /**
+   * @return the value of val_node as a field of column, of type invalid if it is not one
+   */
+  static Field make_field(const Column *column, pSyntaxNode val_node);
+
+  /**
+   * Select from the tables the select ast joins, left to right. The compares of the on and where
+   * conditions, and-ed together, are sorted out: an equality of columns of two tables is a key of the join
+   * adding the later one, a compare of a single table is pushed down to its scan, any other is checked on
+   * the joined rows once all of its tables are in. A table is joined by looking its key up in an index when
+   * the rows joined before it are expected to be few enough for that to cost less than reading the table,
+   * otherwise by a hash join.
+   */
+  dberr_t select_join(pSyntaxNode ast);
+
+  /**
+   * Plan the scan of a select, the condition ast is evaluated by an index, on the pages or by a filter.
+   * A scan of the whole table runs vectorized, the rows an index finds are read one at a time.
+   * @param columns the columns of the rows the plan hands out, in that order
+   * @return nullptr if the condition is invalid
+   */
+  OperatorPtr plan_scan(pSyntaxNode ast, const TableInfo *table_info, std::vector<uint32_t> columns);
+
+  /**
+   * The vectorized scan of the whole table plan_scan plans when no index is looked up, the tuples condition
+   * holds for are selected in its batches
+   * @param read the columns the batches have values of, those condition reads included
+   * @param condition the condition ast parsed, nullptr if there is none
+   */
+  VectorOperatorPtr plan_batches(pSyntaxNode ast, const TableInfo *table_info, const std::vector<uint32_t> &read,
+                                 std::unique_ptr<RowCondition> condition);
+
+  /**
+   * Group the rows of plan by the group by columns of the select ast and compute the aggregates it selects,
+   * then hand out the columns selected in their order. A column selected has to be one grouped by.
+   * @param schema the columns of the rows of plan
+   * @param locate finds the position of a column named in the rows of plan, false if there is none
+   * @return nullptr if a column or an aggregate is invalid
+   */
+  OperatorPtr plan_aggregate(OperatorPtr plan, Schema *schema, pSyntaxNode ast,
+                             const std::function<bool(const char *, uint32_t &)> &locate);
+
+  /**
+   * plan_aggregate over the batches of a vectorized scan, aggregated without being turned into rows
+   * @param columns the column of the batches each column of schema is
+   */
+  OperatorPtr plan_aggregate(VectorOperatorPtr batches, std::vector<uint32_t> columns, Schema *schema,
+                             pSyntaxNode ast, const std::function<bool(const char *, uint32_t &)> &locate);
+
+  /**
+   * The group by keys and the aggregates plan_aggregate computes, and the output of each column selected: a key
+   * or an aggregate, counted from the first key
+   * @return false if a column or an aggregate is invalid
+   */
+  bool parse_aggregates(Schema *schema, pSyntaxNode ast, const std::function<bool(const char *, uint32_t &)> &locate,
+                        std::vector<uint32_t> &keys, std::vector<Aggregate> &aggregates,
+                        std::vector<uint32_t> &outputs);
+
+  /**
+   * Order the rows of plan by the keys of the order by of the select ast, then keep the rows its limit asks for,
+   * the sort holding no more of them than that
+   * @param locate finds the position in the rows of plan of the column or aggregate a key names, false if there
+   *   is none
+   * @return nullptr if a key is not found or the limit is invalid
+   */
+  OperatorPtr plan_order(OperatorPtr plan, pSyntaxNode ast, const std::function<bool(pSyntaxNode, uint32_t &)> &locate);
+
+  std::unique_ptr<RowCondition> parse_row_condition(pSyntaxNode ast, const TableInfo *table_info);
+
+  std::unique_ptr<ScanPredicate> parse_predicate(pSyntaxNode ast, const TableInfo *table_info);
+
+  /**
+   * How the rows of a condition are found without scanning the whole table
+   */
+  struct AccessPath {
+    /** adds the ids of rows that may satisfy the condition, nullptr if the table has to be scanned */
+    IndexScanOperator::Probe probe;
+    /** higher for a path expected to find fewer rows, see index_rank */
+    int rank{0};
+    /** estimated cost of the lookups and of fetching the rows they find, for an analyzed table */
+    double cost{std::numeric_limits<double>::infinity()};
+    /** set if the probe finds exactly the rows satisfying the condition */
+    bool exact{false};
+  };
+
+  /**
+   * Pick the lookups of the condition ast, if they are expected to be cheaper than a scan of the whole
+   * table. A table never analyzed is always looked up if it can be.
+   */
+  AccessPath plan_access(pSyntaxNode ast, const TableInfo *table_info);
+
+  /**
+   * Lookups of the condition ast: for an and the side expected to be cheapest, by cost if the table was
+   * analyzed and by rank if it was not, for an or the union of both sides if each has one
+   */
+  AccessPath plan_lookups(pSyntaxNode ast, const TableInfo *table_info);
+
+  /**
+   * @return the compare of the and of compares ast a scan evaluates on the pages, the most selective one if
+   *   the table was analyzed and the first one otherwise, nullptr if ast is no and
+   */
+  pSyntaxNode find_pushed(pSyntaxNode ast, const TableInfo *table_info);
+
+  /**
+   * @return estimated fraction of the rows of an analyzed table satisfying the condition ast, the compares
+   *   are taken to be independent
+   */
+  double estimate_selectivity(pSyntaxNode ast, const TableInfo *table_info);
+
+  /**
+   * @return 0 if parse_compare scans the table for the compare ast, otherwise how selective the index or
+   *   cluster key lookup it does is: 3 for a key of a unique column, 2 for another key, 1 for a range
+   */
+  int index_rank(pSyntaxNode ast, const TableInfo *table_info);
 
   void do_update(const TableInfo* table_info, map<string, Field> new_values, unordered_set<RowId> effected_rows,
                  unordered_map<string, size_t> column_index);
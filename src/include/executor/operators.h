@@ -0,0 +1,861 @@
+#ifndef MINISQL_OPERATORS_H
+#define MINISQL_OPERATORS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "record/row.h"
+#include "record/scan_predicate.h"
+#include "record/vector_batch.h"
+#include "storage/table_heap.h"
+
+/**
+ * Physical operators of a query plan, pulled one row at a time (the Volcano model).
+ *
+ * Init prepares an operator and its children, then every call to Next hands out
+ * the next row until it returns false. A row handed out is owned by the operator
+ * and only valid until the following Next, nothing is buffered between operators,
+ * so the rows of a scan go to the output while their page is still pinned.
+ */
+class PhysicalOperator {
+public:
+  virtual ~PhysicalOperator() = default;
+
+  virtual void Init() = 0;
+
+  /**
+   * @return false once there are no more rows
+   */
+  virtual bool Next(const Row **row) = 0;
+};
+
+using OperatorPtr = std::unique_ptr<PhysicalOperator>;
+
+/**
+ * Operators of the vectorized pipeline, pulled a batch of up to VECTOR_BATCH_SIZE
+ * tuples at a time instead of a row. The tuples stay split by column, so a filter
+ * is a loop over the typed values of a column and costs one virtual call per batch
+ * rather than one per row. A batch handed out is owned by the operator and only
+ * valid until the following Next, it may have no tuple selected.
+ */
+class VectorOperator {
+public:
+  virtual ~VectorOperator() = default;
+
+  virtual void Init() = 0;
+
+  /**
+   * @return false once there are no more batches
+   */
+  virtual bool Next(VectorBatch **batch) = 0;
+};
+
+using VectorOperatorPtr = std::unique_ptr<VectorOperator>;
+
+/**
+ * Condition of a where clause, a tree of and / or over compares, evaluated on whole rows
+ */
+class RowCondition {
+public:
+  explicit RowCondition(std::unique_ptr<ScanPredicate> compare) : compare_(std::move(compare)) {}
+
+  RowCondition(bool is_and, std::unique_ptr<RowCondition> lhs, std::unique_ptr<RowCondition> rhs)
+      : is_and_(is_and), lhs_(std::move(lhs)), rhs_(std::move(rhs)) {}
+
+  bool Evaluate(const Row &row) const;
+
+  /**
+   * Set bit i of sel if the tuple in slot i of batch satisfies the condition, whether it is selected or not
+   */
+  void EvaluateBatch(const VectorBatch &batch, uint64_t *sel) const;
+
+  /**
+   * Append the columns the condition reads to columns
+   */
+  void CollectColumns(std::vector<uint32_t> &columns) const;
+
+private:
+  /** set for a compare, the children are set otherwise */
+  std::unique_ptr<ScanPredicate> compare_;
+  bool is_and_{false};
+  std::unique_ptr<RowCondition> lhs_;
+  std::unique_ptr<RowCondition> rhs_;
+};
+
+/**
+ * Rows read from a table heap by a table iterator, the columns listed are the ones
+ * whose chars stored out of line are read
+ */
+class TableScanOperator : public PhysicalOperator {
+public:
+  bool Next(const Row **row) override;
+
+protected:
+  TableScanOperator(TableHeap *table_heap, std::vector<uint32_t> columns)
+      : table_heap_(table_heap), columns_(std::move(columns)) {}
+
+  TableHeap *table_heap_;
+  std::vector<uint32_t> columns_;
+  std::optional<TableIterator> iterator_;
+  bool started_{false};
+};
+
+/**
+ * Every row of the heap, or those a predicate pushed down to the pages selects
+ */
+class SeqScanOperator : public TableScanOperator {
+public:
+  SeqScanOperator(TableHeap *table_heap, std::vector<uint32_t> columns,
+                  std::unique_ptr<ScanPredicate> predicate = nullptr)
+      : TableScanOperator(table_heap, std::move(columns)), predicate_(std::move(predicate)) {}
+
+  void Init() override;
+
+private:
+  std::unique_ptr<ScanPredicate> predicate_;
+};
+
+/**
+ * The rows an index probe finds, read in page order
+ */
+class IndexScanOperator : public TableScanOperator {
+public:
+  /**
+   * Add the ids of the rows to read to rids
+   */
+  using Probe = std::function<void(std::unordered_set<RowId> &rids)>;
+
+  IndexScanOperator(TableHeap *table_heap, std::vector<uint32_t> columns, Probe probe)
+      : TableScanOperator(table_heap, std::move(columns)), probe_(std::move(probe)) {}
+
+  void Init() override;
+
+private:
+  Probe probe_;
+};
+
+/**
+ * Rows an ordered index scan reads at most at once
+ */
+#define INDEX_ORDER_BATCH 1024
+
+/**
+ * The rows of a table in the order an index holds their keys. The ids are taken a batch at a time, the rows
+ * of a batch are read in page order, so each page is fetched once for all of them, and handed out in the
+ * order of the ids. The first batch is small, a limit may need only a few rows, the next ones twice as large
+ * up to INDEX_ORDER_BATCH.
+ */
+class IndexOrderScanOperator : public PhysicalOperator {
+public:
+  /**
+   * Append the ids of the rows to read to rids, in the order the rows are handed out
+   */
+  using Scan = std::function<void(std::vector<RowId> &rids)>;
+
+  /**
+   * @param columns the columns whose chars stored out of line are read
+   */
+  IndexOrderScanOperator(TableHeap *table_heap, std::vector<uint32_t> columns, Scan scan)
+      : table_heap_(table_heap), columns_(std::move(columns)), scan_(std::move(scan)) {}
+
+  void Init() override;
+
+  bool Next(const Row **row) override;
+
+private:
+  /**
+   * Read the rows of the next batch of ids
+   * @return false once there are no more ids
+   */
+  bool next_batch();
+
+  TableHeap *table_heap_;
+  std::vector<uint32_t> columns_;
+  Scan scan_;
+  std::vector<RowId> rids_;
+  /** the ids of rids_ before it are read */
+  size_t read_{0};
+  size_t batch_size_{0};
+  /** the rows of the batch, copied to a heap emptied by the next batch, and where each one is */
+  ArenaMemHeap heap_;
+  std::deque<Row> rows_;
+  std::unordered_map<RowId, uint32_t> found_;
+  /** position in rids_ of the next row to hand out, and where the batch ends */
+  size_t next_{0};
+  size_t end_{0};
+};
+
+/**
+ * The rows of its child a condition holds for
+ */
+class FilterOperator : public PhysicalOperator {
+public:
+  FilterOperator(OperatorPtr child, std::unique_ptr<RowCondition> condition)
+      : child_(std::move(child)), condition_(std::move(condition)) {}
+
+  void Init() override { child_->Init(); }
+
+  bool Next(const Row **row) override;
+
+private:
+  OperatorPtr child_;
+  std::unique_ptr<RowCondition> condition_;
+};
+
+/**
+ * Rows made of the columns of its child's rows listed, in that order
+ */
+class ProjectionOperator : public PhysicalOperator {
+public:
+  ProjectionOperator(OperatorPtr child, std::vector<uint32_t> columns)
+      : child_(std::move(child)), columns_(std::move(columns)) {}
+
+  void Init() override { child_->Init(); }
+
+  bool Next(const Row **row) override;
+
+private:
+  OperatorPtr child_;
+  std::vector<uint32_t> columns_;
+  Row row_{INVALID_ROWID};
+};
+
+/**
+ * At most limit rows of its child after skipping the first offset ones
+ */
+class LimitOperator : public PhysicalOperator {
+public:
+  LimitOperator(OperatorPtr child, size_t limit, size_t offset = 0)
+      : child_(std::move(child)), limit_(limit), offset_(offset) {}
+
+  void Init() override;
+
+  bool Next(const Row **row) override;
+
+private:
+  OperatorPtr child_;
+  size_t limit_;
+  size_t offset_;
+  size_t skipped_{0};
+  size_t emitted_{0};
+};
+
+/**
+ * Bytes the serialized rows of the build side of a hash join may take, beyond them both sides are partitioned
+ */
+#define JOIN_MEMORY_BUDGET (16 << 20)
+
+/**
+ * Partitions a hash join writes both sides to once the build side does not fit in memory
+ */
+#define JOIN_PARTITIONS 32
+
+/**
+ * Times a partition whose build side is still larger than the budget is partitioned again by other bits of
+ * the hash, the build rows of the last level are read whole however many there are
+ */
+#define JOIN_MAX_LEVEL 4
+
+/**
+ * Rows of its left child joined to the rows of its right child with equal keys, made of the fields of the left
+ * row followed by those of the right one. The rows of the build side, the one expected to be smaller, are
+ * serialized into a hash table on their keys, then the rows of the other side look their keys up in it. A null
+ * key joins no row, no keys at all join every pair of rows.
+ *
+ * Once the build side takes more than memory_budget bytes, it and then the probe side are written to
+ * JOIN_PARTITIONS temporary files by the hash of their keys (a Grace hash join). Rows that join fall into
+ * the same partition, so the pairs of partitions are joined one after the other, each in memory. A partition
+ * whose build side does not fit either is split into JOIN_PARTITIONS more by other bits of the hash, up to
+ * JOIN_MAX_LEVEL times, since rows with equal keys cannot be told apart by their hash at any level.
+ */
+class HashJoinOperator : public PhysicalOperator {
+public:
+  /**
+   * @param left_schema, right_schema the columns of the rows of the children
+   */
+  HashJoinOperator(OperatorPtr left, OperatorPtr right, Schema *left_schema, Schema *right_schema,
+                   std::vector<uint32_t> left_keys, std::vector<uint32_t> right_keys, bool build_left,
+                   size_t memory_budget = JOIN_MEMORY_BUDGET);
+
+  ~HashJoinOperator() override { close_partitions(); }
+
+  /**
+   * Read the build side into the hash table, or into the partitions
+   */
+  void Init() override;
+
+  bool Next(const Row **row) override;
+
+  /**
+   * @return whether the sides did not fit in memory and were partitioned
+   */
+  inline bool IsSpilled() const { return !partitions_.empty(); }
+
+private:
+  struct Side {
+    OperatorPtr child;
+    Schema *schema;
+    std::vector<uint32_t> keys;
+  };
+
+  /** serialized build row at offset of the arena, chained to the next entry of its bucket */
+  struct Entry {
+    uint64_t hash;
+    uint32_t offset;
+    uint32_t next;
+  };
+
+  /** temporary files of a partition, rows written as their hash, size and serialized bytes */
+  struct Partition {
+    FILE *build{nullptr};
+    FILE *probe{nullptr};
+    /** times the rows were partitioned again, which bits of their hash picked this partition */
+    uint32_t level{0};
+  };
+
+  /**
+   * @return false if one of the keys of row is null
+   */
+  static bool hash_keys(const Row &row, const std::vector<uint32_t> &keys, uint64_t &hash);
+
+  void add_entry(const char *data, uint32_t size, uint64_t hash);
+
+  void build_buckets();
+
+  /**
+   * Move the rows in the hash table to the partitions, the rest of the build side goes there too
+   */
+  void spill();
+
+  void write_row(FILE *file, const Row &row, Schema *schema, uint64_t hash);
+
+  static void write_entry(FILE *file, uint64_t hash, const char *data, uint32_t size);
+
+  /**
+   * Read the next row written to file into buffer_
+   * @return false at the end of the file
+   */
+  bool read_entry(FILE *file, uint64_t &hash);
+
+  /**
+   * Read the build rows of partition_ into the hash table, splitting it first while they do not fit
+   */
+  void load_partition();
+
+  /**
+   * Move both sides of partition_ to JOIN_PARTITIONS new partitions of the next level right after it
+   */
+  void split_partition();
+
+  /**
+   * Move to the next probe row whose key may be in the hash table
+   * @return false once there are no more
+   */
+  bool next_probe();
+
+  void close_partitions();
+
+  Side build_;
+  Side probe_;
+  bool build_left_;
+  size_t memory_budget_;
+  std::vector<char> arena_;
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> buckets_;
+  std::vector<Partition> partitions_;
+  size_t partition_{0};
+  std::vector<char> buffer_;
+  /** the probe row the entries from match_ on are compared to */
+  const Row *probe_row_{nullptr};
+  uint64_t probe_hash_{0};
+  uint32_t match_;
+  Row read_row_{INVALID_ROWID};
+  Row build_row_{INVALID_ROWID};
+  Row row_{INVALID_ROWID};
+};
+
+/**
+ * Rows of the outer side an index join reads before looking their keys up
+ */
+#define INDEX_JOIN_BATCH 1024
+
+/**
+ * Rows of its child, the outer side, joined to the rows of a table with equal keys, found by looking the
+ * keys up in an index of the table instead of reading all of it. The outer rows are read a batch at a time
+ * and sorted by key, so each distinct key of a batch is looked up once and the lookups walk the tree in key
+ * order, then the rows found are read in page order. A row is made of the fields of the outer row followed
+ * by the columns listed of the row of the table. A null key joins no row.
+ */
+class IndexJoinOperator : public PhysicalOperator {
+public:
+  /**
+   * Append the ids of the rows of the table whose key is key to rids
+   */
+  using Lookup = std::function<void(const Field &key, std::vector<RowId> &rids)>;
+
+  /**
+   * @param read columns of the table whose chars stored out of line are read, those listed and those of
+   *   condition and of the keys among them
+   * @param outer_keys, inner_keys columns of the outer rows and of the table that have to be equal, the first
+   *   pair is the one looked up
+   * @param condition checked on the rows of the table, nullptr if there is none
+   */
+  IndexJoinOperator(OperatorPtr outer, TableHeap *table_heap, std::vector<uint32_t> columns,
+                    std::vector<uint32_t> read, std::vector<uint32_t> outer_keys, std::vector<uint32_t> inner_keys,
+                    Lookup lookup, std::unique_ptr<RowCondition> condition = nullptr);
+
+  void Init() override;
+
+  bool Next(const Row **row) override;
+
+private:
+  /**
+   * Read the next batch of outer rows and look their keys up
+   * @return false once the outer side has no more rows
+   */
+  bool next_batch();
+
+  OperatorPtr outer_;
+  TableHeap *table_heap_;
+  std::vector<uint32_t> columns_;
+  std::vector<uint32_t> read_;
+  std::vector<uint32_t> outer_keys_;
+  std::vector<uint32_t> inner_keys_;
+  Lookup lookup_;
+  std::unique_ptr<RowCondition> condition_;
+  /** the outer rows of the batch, copied to a heap emptied by the next batch */
+  ArenaMemHeap heap_;
+  std::deque<Row> rows_;
+  /** the rows of the batch sorted by key, a run of equal keys is a group */
+  std::vector<uint32_t> order_;
+  std::vector<std::pair<uint32_t, uint32_t>> groups_;
+  /** group of the key of each row of the table found */
+  std::unordered_map<RowId, uint32_t> found_;
+  std::optional<TableIterator> iterator_;
+  bool started_{false};
+  /** the row of the table read last and the range of order_ still to be joined to it */
+  Row inner_{INVALID_ROWID};
+  uint32_t next_{0};
+  uint32_t end_{0};
+  Row row_{INVALID_ROWID};
+};
+
+/**
+ * Bytes the hash table of an aggregation may take, beyond them the rows of new groups are partitioned
+ */
+#define AGGREGATE_MEMORY_BUDGET (16 << 20)
+
+/**
+ * Partitions an aggregation writes the rows of new groups to once its hash table is full
+ */
+#define AGGREGATE_PARTITIONS 16
+
+/**
+ * Times a partition that is still too large is partitioned again by other bits of the hash, the groups of
+ * the last level are kept in memory however many there are
+ */
+#define AGGREGATE_MAX_LEVEL 4
+
+enum class AggregateFunction { kCountAll, kCount, kSum, kAvg, kMin, kMax };
+
+/**
+ * A function computed over the values of a column of the rows of each group, the column is not read by kCountAll
+ */
+struct Aggregate {
+  AggregateFunction function;
+  uint32_t column;
+};
+
+/**
+ * One row for each group of rows of its child with equal keys, made of the keys followed by the aggregates
+ * of the rows of the group. Count counts the values that are not null, the others leave nulls out and are
+ * null for a group without any value. Sum and min and max are of the type of their column, an avg is a
+ * float. Null keys are equal to each other. Without keys all rows are one group, even if there are none.
+ *
+ * Each group is a slot of an open addressing hash table, probed linearly: the hash, the keys in fixed width
+ * and the accumulators of the aggregates one after the other, so a row looks up and updates its group in
+ * one place. Once the table would grow past memory_budget bytes the groups in it are still updated, but
+ * a row of a group not in it is written to one of AGGREGATE_PARTITIONS temporary files by its hash. The
+ * groups in memory are handed out first, then the partitions are aggregated one at a time the same way.
+ */
+class HashAggregateOperator : public PhysicalOperator {
+public:
+  /**
+   * @param schema the columns of the rows of child
+   */
+  HashAggregateOperator(OperatorPtr child, Schema *schema, std::vector<uint32_t> keys,
+                        std::vector<Aggregate> aggregates, size_t memory_budget = AGGREGATE_MEMORY_BUDGET);
+
+  /**
+   * Aggregate the selected tuples of the batches of child: the keys of a batch are encoded a column at a time,
+   * then each aggregate is updated by a loop over the values of its column
+   * @param columns the column of the batches each column of schema is
+   */
+  HashAggregateOperator(VectorOperatorPtr child, std::vector<uint32_t> columns, Schema *schema,
+                        std::vector<uint32_t> keys, std::vector<Aggregate> aggregates,
+                        size_t memory_budget = AGGREGATE_MEMORY_BUDGET);
+
+  ~HashAggregateOperator() override { close_partitions(); }
+
+  /**
+   * Read every row of child into the hash table, or into the partitions
+   */
+  void Init() override;
+
+  bool Next(const Row **row) override;
+
+  /**
+   * @return whether some groups did not fit in memory and were partitioned
+   */
+  inline bool IsSpilled() const { return spilled_; }
+
+private:
+  /** temporary file of the rows of a partition, written as their hash, size and serialized bytes */
+  struct Partition {
+    FILE *file;
+    uint32_t level;
+  };
+
+  /**
+   * Encode the keys of row into key_
+   * @return hash of the keys
+   */
+  uint64_t encode_keys(const Row &row);
+
+  /**
+   * Update the group of row, whose keys are encoded in key_, or write row to a partition of the level after
+   * level if the table is full
+   */
+  void add_row(const Row &row, uint64_t hash, uint32_t level);
+
+  /**
+   * Write row to a partition of the level after level
+   */
+  void spill_row(const Row &row, uint64_t hash, uint32_t level);
+
+  /**
+   * @return the slot of the group whose keys are key, a new one if there is none, nullptr if there is
+   *   none and the table is full
+   */
+  char *find_slot(uint64_t hash, const char *key, uint32_t level);
+
+  void accumulate(char *slot, const Row &row);
+
+  /**
+   * Update the groups of the selected tuples of batch, the tuples of groups not in the table are partitioned
+   */
+  void add_batch(const VectorBatch &batch);
+
+  /**
+   * Encode the keys of the selected tuples of batch into batch_keys_ and their hashes into batch_hashes_
+   */
+  void encode_batch(const VectorBatch &batch);
+
+  /**
+   * Update aggregate i of the groups in batch_slots_ with the selected tuples of batch
+   */
+  void accumulate_batch(const VectorBatch &batch, size_t i);
+
+  /**
+   * Empty the hash table, its slots included
+   */
+  void reset_table(size_t capacity);
+
+  /**
+   * Aggregate the rows of the last partition written
+   */
+  void load_partition();
+
+  void close_partitions();
+
+  OperatorPtr child_;
+  /** the child of an aggregation of batches, and the column of the batches each column of schema_ is */
+  VectorOperatorPtr vector_child_;
+  std::vector<uint32_t> columns_;
+  Schema *schema_;
+  std::vector<uint32_t> keys_;
+  std::vector<Aggregate> aggregates_;
+  size_t memory_budget_;
+  /** layout of a slot, the offset of each key and accumulator after the hash */
+  std::vector<uint32_t> key_offsets_;
+  std::vector<uint32_t> accumulator_offsets_;
+  uint32_t key_size_{0};
+  uint32_t slot_size_{0};
+  /** the slots of the table, a hash of 0 marks a free one */
+  std::vector<char> slots_;
+  size_t capacity_{0};
+  size_t groups_{0};
+  std::vector<char> key_;
+  /** the keys, hashes and groups of the selected tuples of a batch, nullptr for a tuple partitioned */
+  std::vector<char> batch_keys_;
+  std::vector<uint64_t> batch_hashes_;
+  std::vector<char *> batch_slots_;
+  /** partitions of rows still to aggregate, the last one is read next */
+  std::vector<Partition> partitions_;
+  std::vector<FILE *> writing_;
+  uint32_t writing_level_{0};
+  bool spilled_{false};
+  std::vector<char> buffer_;
+  Row read_row_{INVALID_ROWID};
+  size_t next_{0};
+  std::vector<Field> fields_;
+  Row row_{INVALID_ROWID};
+};
+
+/**
+ * Bytes the rows a sort holds in memory may take, beyond them they are sorted and written out as a run
+ */
+#define SORT_MEMORY_BUDGET (16 << 20)
+
+/**
+ * Bytes of the normalized key of a row kept next to its offset, most keys are told apart by them alone
+ */
+#define SORT_PREFIX_SIZE 16
+
+/**
+ * Runs merged at once, more runs are merged into fewer ones first
+ */
+#define SORT_MERGE_WAYS 64
+
+/**
+ * A column the rows are ordered by, the least value first unless descending
+ */
+struct SortKey {
+  uint32_t column;
+  bool descending;
+};
+
+/**
+ * The rows of its child ordered by the keys, the first key first, nulls before any value. Only the first limit
+ * rows are handed out, all of them by default.
+ *
+ * The keys of a row are normalized into bytes whose memcmp order is the order of the rows: a null flag and
+ * the value of each key, an int or a float as the bits of a double ordered like the numbers, a char with its
+ * zero bytes escaped and a terminator, each byte inverted for a descending key. The rows are serialized into
+ * an arena, each with the first SORT_PREFIX_SIZE bytes of its key, so the sort compares fixed bytes and only
+ * reads the rest of the keys that share them.
+ *
+ * Once the rows take more than memory_budget bytes they are sorted and written to a temporary file as a run,
+ * then the runs are merged, the next row being the least of their first ones. With a limit, the first limit
+ * rows are kept in a heap instead, a row greater than all of them is not even serialized, as long as they fit
+ * in memory.
+ */
+class SortOperator : public PhysicalOperator {
+public:
+  SortOperator(OperatorPtr child, std::vector<SortKey> keys, size_t limit = SIZE_MAX,
+               size_t memory_budget = SORT_MEMORY_BUDGET)
+      : child_(std::move(child)), keys_(std::move(keys)), limit_(limit), memory_budget_(memory_budget) {}
+
+  ~SortOperator() override { close_runs(); }
+
+  /**
+   * Read every row of child, into memory or into runs
+   */
+  void Init() override;
+
+  bool Next(const Row **row) override;
+
+  /**
+   * @return whether the rows did not fit in memory and were written out in runs
+   */
+  inline bool IsSpilled() const { return spilled_; }
+
+private:
+  /** a row of the arena, its normalized key followed by its fields */
+  struct Entry {
+    uint8_t prefix[SORT_PREFIX_SIZE];
+    uint32_t offset;
+    uint32_t key_size;
+    uint32_t size;
+  };
+
+  /** a run in a temporary file, rows written as their key size, size, key and fields */
+  struct Run {
+    FILE *file;
+    std::vector<char> row;
+    uint32_t key_size;
+  };
+
+  /**
+   * Normalize the keys of row into key_
+   */
+  void encode_keys(const Row &row);
+
+  /**
+   * Append the normalized key in key_ and the fields of row to the arena
+   */
+  Entry add_entry(const Row &row);
+
+  /**
+   * @return whether the row of lhs goes before the row of rhs
+   */
+  bool less(const Entry &lhs, const Entry &rhs) const;
+
+  /**
+   * Sort the rows in memory and write them to a new run
+   */
+  void spill();
+
+  /**
+   * Merge the runs from begin on into a single run in their place
+   */
+  void merge(size_t begin);
+
+  /**
+   * @return whether the row run lhs is on goes after the one run rhs is on
+   */
+  bool run_after(uint32_t lhs, uint32_t rhs) const;
+
+  /**
+   * Read the first row of each run from begin on, merging_ holds those that have one
+   */
+  void open_runs(size_t begin);
+
+  /**
+   * Move the run on the least row to its next one
+   */
+  void pop_run();
+
+  /**
+   * Read the next row of run into it
+   * @return false at the end of the run
+   */
+  bool read_run(Run &run);
+
+  /**
+   * Rebuild row_ from the fields serialized at data
+   */
+  void decode_row(const char *data);
+
+  void close_runs();
+
+  OperatorPtr child_;
+  std::vector<SortKey> keys_;
+  size_t limit_;
+  size_t memory_budget_;
+  std::vector<char> key_;
+  std::vector<char> arena_;
+  std::vector<Entry> entries_;
+  /** bytes of the arena rows dropped from the heap of a limit still take */
+  size_t dropped_{0};
+  bool heap_{false};
+  bool spilled_{false};
+  std::vector<Run> runs_;
+  /** the runs being merged, a heap whose top holds the least row */
+  std::vector<uint32_t> merging_;
+  size_t next_{0};
+  size_t emitted_{0};
+  std::vector<Field> fields_;
+  Row row_{INVALID_ROWID};
+};
+
+/**
+ * The tuples of a table heap, a batch at a time, with the values of the columns listed.
+ * Pages the zone map rules out a pushed down predicate for are not read, the batches
+ * read keep the tuples that satisfy it selected.
+ */
+class VectorScanOperator : public VectorOperator {
+public:
+  VectorScanOperator(TableHeap *table_heap, const std::vector<uint32_t> &columns,
+                     std::unique_ptr<ScanPredicate> predicate = nullptr);
+
+  void Init() override;
+
+  bool Next(VectorBatch **batch) override;
+
+private:
+  TableHeap *table_heap_;
+  std::unique_ptr<ScanPredicate> predicate_;
+  VectorBatch batch_;
+  std::vector<page_id_t> pages_;
+  size_t next_page_{0};
+  /** slot of pages_[next_page_] to go on from */
+  uint32_t slot_{0};
+};
+
+/**
+ * Narrows the selection of the batches of its child to the tuples a condition holds for
+ */
+class VectorFilterOperator : public VectorOperator {
+public:
+  VectorFilterOperator(VectorOperatorPtr child, std::unique_ptr<RowCondition> condition)
+      : child_(std::move(child)), condition_(std::move(condition)) {}
+
+  void Init() override { child_->Init(); }
+
+  bool Next(VectorBatch **batch) override;
+
+private:
+  VectorOperatorPtr child_;
+  std::unique_ptr<RowCondition> condition_;
+};
+
+/**
+ * Rows made of the columns listed of the selected tuples of its child's batches, where
+ * the vectorized pipeline hands over to row operators
+ */
+class VectorProjectionOperator : public PhysicalOperator {
+public:
+  VectorProjectionOperator(VectorOperatorPtr child, std::vector<uint32_t> columns)
+      : child_(std::move(child)), columns_(std::move(columns)) {}
+
+  void Init() override;
+
+  bool Next(const Row **row) override;
+
+private:
+  VectorOperatorPtr child_;
+  std::vector<uint32_t> columns_;
+  VectorBatch *batch_{nullptr};
+  /** position in the selection of batch_ of the next row */
+  uint32_t next_{0};
+  Row row_{INVALID_ROWID};
+};
+
+/**
+ * Prints the rows of its child as a table and hands them on. The rows are printed
+ * in blocks of OUTPUT_BLOCK_ROWS, each block padded to its own widest values, so
+ * the first rows show up before the rest are read and no more than a block is held.
+ */
+#define OUTPUT_BLOCK_ROWS 256
+
+class OutputOperator : public PhysicalOperator {
+public:
+  explicit OutputOperator(OperatorPtr child, std::ostream &out = std::cout) : child_(std::move(child)), out_(out) {}
+
+  void Init() override;
+
+  bool Next(const Row **row) override;
+
+  /**
+   * Pull every row through the plan
+   * @return number of rows printed
+   */
+  size_t Run();
+
+  /**
+   * @return text a field is printed as
+   */
+  static std::string FieldText(const Field &field);
+
+private:
+  void flush();
+
+  OperatorPtr child_;
+  std::ostream &out_;
+  std::vector<std::vector<std::string>> block_;
+  size_t printed_{0};
+  /** border of the last block printed */
+  std::string line_;
+};
+
+#endif  // MINISQL_OPERATORS_H
@@ -41,11 +41,18 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
+  // Build an empty tree bottom-up from pairs sorted by key without duplicates.
+  // Returns false and leaves the tree untouched if it is not empty.
+  bool BulkLoad(const std::vector<MappingType> &items);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
   void RangeScan(const KeyType& key, std::unordered_set<ValueType>& ans_set, bool to_left, bool key_included);
 
+  // Append the values of the first limit keys to result, walking the leaves from the leftmost one.
+  void ScanInOrder(std::vector<ValueType> &result, size_t limit);
+
 
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction = nullptr);
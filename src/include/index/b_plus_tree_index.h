@@ -21,6 +21,10 @@ public:
 
   void RangeScanKey(const Row& key, std::unordered_set<RowId>& ans_set, bool to_left, bool key_included) override;
 
+  void ScanInOrder(std::vector<RowId> &result, size_t limit = SIZE_MAX) override;
+
+  dberr_t BulkLoad(const std::deque<Row> &keys, const std::vector<RowId> &row_ids, Transaction *txn) override;
+
   dberr_t Destroy() override;
 
   INDEXITERATOR_TYPE GetBeginIterator();
@@ -0,0 +1,106 @@
+#ifndef MINISQL_BLOOM_FILTER_H
+#define MINISQL_BLOOM_FILTER_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/config.h"
+#include "utils/mem_heap.h"
+
+class BufferPoolManager;
+
+/**
+ * In-memory bloom filter over index keys, used to skip the B+ tree descent
+ * for keys that are definitely not in an index.
+ *
+ * The filter is sized from the number of keys it is built for, at about
+ * BLOOM_FILTER_BITS_PER_KEY bits per key. Once more keys than that were
+ * inserted IsFull() is true and the owner rebuilds it from the index.
+ *
+ * The header is stored right after the index metadata in the index meta page,
+ * the bits in a chain of overflow pages starting at BitsPageId. Closed is only
+ * set while the database is cleanly closed, a filter found open on load was not
+ * written back and misses the keys inserted since, so it is rebuilt.
+ *
+ * Format (size in byte):
+ *  -----------------------------------------------------------------------------------
+ * | Magic (4) | Closed (4) | NumHashes (4) | NumKeys (4) | NumBits (4) | BitsPageId (4) |
+ *  -----------------------------------------------------------------------------------
+ */
+#define BLOOM_FILTER_BITS_PER_KEY 10
+#define BLOOM_FILTER_MIN_KEYS 1024
+
+class BloomFilter {
+public:
+  static BloomFilter *Create(MemHeap *heap) {
+    void *buf = heap->Allocate(sizeof(BloomFilter));
+    return new(buf)BloomFilter(heap);
+  }
+
+  void Insert(const char *key, uint32_t len) { InsertHash(Hash(key, len)); }
+
+  void InsertHash(uint64_t hash);
+
+  /**
+   * @return false if the key was never inserted, true if it may have been
+   */
+  bool MayContain(const char *key, uint32_t len) const;
+
+  /**
+   * Drop all keys, keeping the size
+   */
+  void Clear();
+
+  /**
+   * Drop all keys and size the filter for expected_keys keys
+   */
+  void Reset(uint32_t expected_keys);
+
+  /**
+   * @return true once more keys were inserted than the filter is sized for
+   */
+  inline bool IsFull() const { return num_keys_ > num_bits_ / BLOOM_FILTER_BITS_PER_KEY; }
+
+  /**
+   * Write the header to buf and the bits to the page chain, reusing the chain
+   * the filter was read from
+   */
+  uint32_t SerializeTo(char *buf, BufferPoolManager *buffer_pool_manager);
+
+  uint32_t GetSerializedSize() const { return sizeof(uint32_t) * 6; }
+
+  /**
+   * Keeps the page chain of a filter that is not read so that it is reused
+   * by the next SerializeTo
+   * @return bytes read, 0 if buf does not hold a serialized filter or one that
+   * was not written back at a clean close
+   */
+  uint32_t DeserializeFrom(char *buf, BufferPoolManager *buffer_pool_manager);
+
+  /**
+   * Clear Closed of the filter serialized in buf, if any
+   */
+  static void MarkOpen(char *buf);
+
+  static uint64_t Hash(const char *key, uint32_t len);
+
+  inline uint32_t GetKeyCount() const { return num_keys_; }
+
+  inline uint32_t GetBitCount() const { return num_bits_; }
+
+private:
+  explicit BloomFilter(MemHeap *heap) : heap_(heap) { Reset(BLOOM_FILTER_MIN_KEYS); }
+
+private:
+  /** bumped when the bits moved to a page chain, older filters are rebuilt */
+  static constexpr uint32_t BLOOM_FILTER_MAGIC_NUM = 720533;
+  MemHeap *heap_;
+  uint32_t num_hashes_{0};
+  uint32_t num_keys_{0};
+  /** power of two, so that probes are masked instead of divided */
+  uint32_t num_bits_{0};
+  uint8_t *bits_{nullptr};
+  page_id_t bits_page_id_{INVALID_PAGE_ID};
+};
+
+#endif  // MINISQL_BLOOM_FILTER_H
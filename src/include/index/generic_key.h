@@ -5,6 +5,7 @@
 
 #include "record/row.h"
 #include "record/field.h"
+#include "record/row_view.h"
 
 template<size_t KeySize>
 class GenericKey {
@@ -53,35 +54,48 @@ class GenericComparator {
 public:
   inline int operator()(const GenericKey<KeySize> &lhs,
                         const GenericKey<KeySize> &rhs) const {
-    int column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    lhs.DeserializeToKey(lhs_key, key_schema_);
-    rhs.DeserializeToKey(rhs_key, key_schema_);
+    // compare the serialized keys in place, this runs on every step of a tree search
+    RowView lhs_key(lhs.data, key_schema_);
+    RowView rhs_key(rhs.data, key_schema_);
 
-    for (int i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue)
-        return -1;
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue)
-        return 1;
+    for (uint32_t i = 0; i < lhs_key.GetFieldCount(); i++) {
+      int cmp = lhs_key.CompareColumn(rhs_key, i);
+      if (cmp != 0) return cmp < 0 ? -1 : 1;
     }
     // equals
     return 0;
   }
 
+  /**
+   * A key of a single int or float column that is never null compares like its number, which is at the
+   * same offset of every key serialized in the compact format
+   * @return offset of the number in key.data, -1 if key has to be compared field by field
+   */
+  inline int GetNumberOffset(const GenericKey<KeySize> &key) const {
+    if (number_offset_ < 0 || static_cast<uint8_t>(key.data[0]) != ROW_COMPACT_FORMAT_TAG) return -1;
+    // a key searched for may still be null
+    return (key.data[1] & 1) == 0 ? number_offset_ : -1;
+  }
+
+  inline TypeId GetNumberType() const { return key_schema_->GetColumn(0)->GetType(); }
+
   GenericComparator(const GenericComparator &other) {
     this->key_schema_ = other.key_schema_;
+    this->number_offset_ = other.number_offset_;
   }
 
   // constructor
-  GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  GenericComparator(Schema *key_schema) : key_schema_(key_schema) {
+    if (key_schema->GetColumnCount() == 1 && !key_schema->GetColumn(0)->IsNullable() &&
+        key_schema->GetColumn(0)->GetType() != TypeId::kTypeChar) {
+      // tag, null bitmap, then the fixed-width fields
+      number_offset_ = static_cast<int>(1 + key_schema->GetNullBitmapSize() + key_schema->GetFieldSlot(0));
+    }
+  }
 
 private:
   Schema *key_schema_;
+  int number_offset_{-1};
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
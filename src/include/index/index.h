@@ -1,6 +1,8 @@
 #ifndef MINISQL_INDEX_H
 #define MINISQL_INDEX_H
 
+#include <cstdint>
+#include <deque>
 #include <memory>
 
 #include <unordered_set>
@@ -24,6 +26,17 @@ class Index {
 
   virtual void RangeScanKey(const Row &key, std::unordered_set<RowId> &ans_set, bool left, bool key_included) = 0;
 
+  /**
+   * Append the row ids of the first limit entries, all of them by default, to result in the order of their keys
+   */
+  virtual void ScanInOrder(std::vector<RowId> &result, size_t limit = SIZE_MAX) = 0;
+
+  /**
+   * Index a batch of keys at once, faster than one InsertEntry per key
+   * @return DB_FAILED if a key repeats or is already indexed, the index is unchanged then
+   */
+  virtual dberr_t BulkLoad(const std::deque<Row> &keys, const std::vector<RowId> &row_ids, Transaction *txn) = 0;
+
   virtual dberr_t Destroy() = 0;
 
  protected:
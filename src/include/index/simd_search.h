@@ -0,0 +1,87 @@
+#ifndef MINISQL_SIMD_SEARCH_H
+#define MINISQL_SIMD_SEARCH_H
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "index/basic_comparator.h"
+#include "index/generic_key.h"
+
+/**
+ * simd_search.h
+ *
+ * In-node key search for fixed-width (int/float) keys.
+ *
+ * B+ tree pages store keys interleaved with their values (std::pair<Key, Value>),
+ * so the keys of a node are laid out with a fixed stride of sizeof(MappingType)
+ * bytes. The number of a GenericKey of a single int or float column sits at the
+ * same offset of every key, so such a node is searched the same way. The search
+ * narrows the range with a branch-free binary search and then counts the keys
+ * that are still smaller than the target with AVX2 or SSE2 compares, loading
+ * keys 4 or 8 bytes apart a vector at a time and gathering those further apart. The implementation is chosen once at start up (CPUID), with a
+ * scalar fallback for other CPUs/architectures.
+ */
+namespace simd {
+
+/**
+ * @return the first index i in [0, n) so that keys[i * stride] >= key, or n.
+ * Keys must be sorted in ascending order. Stride is counted in 32-bit words
+ * and must be 1 or 2.
+ */
+int LowerBound(const int32_t *keys, int n, int stride, int32_t key);
+
+int LowerBound(const float *keys, int n, int stride, float key);
+
+/**
+ * Same as above with stride counted in bytes, any multiple of 4
+ */
+int LowerBound(const char *keys, int n, int stride, int32_t key);
+
+int LowerBound(const char *keys, int n, int stride, float key);
+
+/**
+ * Name of the implementation picked at runtime: "avx2", "sse2" or "scalar".
+ */
+const char *Implementation();
+
+/**
+ * True if a node of <KeyType, ValueType, KeyComparator> can be searched by LowerBound
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+struct NodeSearchable {
+  static constexpr bool value =
+      (std::is_same<KeyType, int32_t>::value || std::is_same<KeyType, float>::value) &&
+      std::is_same<KeyComparator, BasicComparator<KeyType>>::value && sizeof(ValueType) == 4 &&
+      sizeof(std::pair<KeyType, ValueType>) == 8;
+};
+
+/**
+ * True if the keys of a node of <KeyType, KeyComparator> may be searched by GenericLowerBound
+ */
+template <typename KeyType, typename KeyComparator>
+struct GenericSearchable : std::false_type {};
+
+template <size_t KeySize>
+struct GenericSearchable<GenericKey<KeySize>, GenericComparator<KeySize>> : std::true_type {};
+
+/**
+ * Search n keys spaced stride bytes apart, see GenericComparator::GetNumberOffset
+ * @return the first index i in [0, n) so that keys[i] >= key, or n; -1 if the keys have to be compared
+ *   field by field
+ */
+template <size_t KeySize>
+int GenericLowerBound(const GenericKey<KeySize> *keys, int n, int stride, const GenericKey<KeySize> &key,
+                      const GenericComparator<KeySize> &comparator) {
+  int offset = comparator.GetNumberOffset(key);
+  if (offset < 0) return -1;
+  const char *numbers = keys->data + offset;
+  if (comparator.GetNumberType() == TypeId::kTypeInt) {
+    return LowerBound(numbers, n, stride, MACH_READ_FROM(int32_t, key.data + offset));
+  }
+  return LowerBound(numbers, n, stride, MACH_READ_FROM(float, key.data + offset));
+}
+
+}  // namespace simd
+
+#endif  // MINISQL_SIMD_SEARCH_H
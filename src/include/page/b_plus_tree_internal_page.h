@@ -62,6 +62,9 @@ public:
   void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                          BufferPoolManager *buffer_pool_manager);
 
+  // append a child whose keys sort after every child already in this page, used by bulk loading
+  void AppendChild(const KeyType &key, const ValueType &child, BufferPoolManager *buffer_pool_manager);
+
 private:
   void CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
 
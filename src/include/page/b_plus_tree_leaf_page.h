@@ -71,6 +71,9 @@ public:
 
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
+  // append items that sort after every key already in this page, used by bulk loading
+  void AppendSorted(const MappingType *items, int size);
+
 
 
 private:
@@ -0,0 +1,204 @@
+#ifndef MINISQL_COLUMN_PAGE_H
+#define MINISQL_COLUMN_PAGE_H
+
+/**
+ * PAX (partition attributes across) page of a table created WITH (layout = column).
+ *
+ * The tuples of a page are split by column: every column has a minipage
+ * holding a null bitmap and the values of all tuples of the page in one
+ * array, so a scan only reads the bytes of the columns it looks at, and
+ * int/float values can be handed to the SIMD kernels as they are. Values
+ * are fixed width, a char column reserves its declared length behind a
+ * uint16 length. A tuple is identified by its slot, the same in every
+ * minipage, so RowId point reads work as on a TablePage.
+ *
+ * Format (size in byte, bitmaps are arrays of uint64, minipages are 8 byte aligned):
+ *  --------------------------------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | PrevPageId (4) | NextPageId (4) | SlotCount (4) | LiveCount (4) |
+ *  --------------------------------------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------------------
+ *  | LiveMap | DeleteMap | NullMap_1 | Values_1 | NullMap_2 | Values_2 | ... | NullMap_n | Values_n |
+ *  ---------------------------------------------------------------------------------------------
+ *
+ * The header matches the one of a TablePage up to NextPageId, the heap walks
+ * its page chain the same way for both layouts. LiveMap and DeleteMap have
+ * COLUMN_PAGE_MAX_TUPLES bits, the null maps one bit per tuple the page can
+ * hold. A slot below SlotCount is in use if its LiveMap bit is set, its
+ * DeleteMap bit marks a delete that is not applied yet. Slots freed by
+ * ApplyDelete are reused by later inserts.
+ *
+ * Unlike TablePage, the writes take no LogManager or LockManager, they are
+ * neither logged nor locked.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "page/page.h"
+#include "record/row.h"
+#include "record/scan_predicate.h"
+
+#define COLUMN_PAGE_MAX_TUPLES 1024
+#define COLUMN_PAGE_MAX_WORDS (COLUMN_PAGE_MAX_TUPLES / 64)
+
+/**
+ * Where the minipages of the column pages of a schema are, worked out once per table
+ */
+class ColumnPageLayout {
+public:
+  explicit ColumnPageLayout(Schema *schema);
+
+  inline Schema *GetSchema() const { return schema_; }
+
+  /**
+   * @return number of tuples a page holds, 0 if not even one fits
+   */
+  inline uint32_t GetCapacity() const { return capacity_; }
+
+  /**
+   * @return bytes a value of column i takes in its minipage
+   */
+  inline uint32_t GetWidth(uint32_t i) const { return widths_[i]; }
+
+  inline uint32_t GetNullsOffset(uint32_t i) const { return nulls_offsets_[i]; }
+
+  inline uint32_t GetValuesOffset(uint32_t i) const { return values_offsets_[i]; }
+
+  /**
+   * @return bytes a tuple takes over all minipages, what a free slot is worth in the free space map
+   */
+  inline uint32_t GetTupleSize() const { return tuple_size_; }
+
+  /**
+   * @return false if a char of row is longer than its column was declared, it does not fit the minipage
+   */
+  bool Fits(const Row &row) const;
+
+  static constexpr uint32_t SIZE_COLUMN_PAGE_HEADER = 24;
+
+private:
+  /**
+   * Lay out the bitmaps and minipages of pages holding capacity tuples
+   * @return bytes they take with the header
+   */
+  uint32_t place(uint32_t capacity);
+
+  Schema *schema_;
+  uint32_t capacity_{0};
+  uint32_t tuple_size_{0};
+  std::vector<uint32_t> widths_;
+  std::vector<uint32_t> nulls_offsets_;
+  std::vector<uint32_t> values_offsets_;
+};
+
+class ColumnPage : public Page {
+public:
+  void Init(page_id_t page_id, page_id_t prev_id);
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetPrevPageId(page_id_t prev_page_id) {
+    memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /**
+   * Store row in the first free slot, the rid of the slot is wrapped in row
+   * @return false if the page is full
+   */
+  bool InsertTuple(Row &row, const ColumnPageLayout &layout);
+
+  bool MarkDelete(const RowId &rid);
+
+  /**
+   * Overwrite the values of rid in place, a tuple always fits its slot
+   */
+  bool UpdateTuple(const Row &new_row, const RowId &rid, const ColumnPageLayout &layout);
+
+  void ApplyDelete(const RowId &rid);
+
+  void RollbackDelete(const RowId &rid);
+
+  /**
+   * Read the tuple whose rid is wrapped in row, its fields are copied out of the minipages
+   */
+  bool GetTuple(Row *row, const ColumnPageLayout &layout);
+
+  /**
+   * @return field of column i of the tuple in slot_num, chars point into the page
+   */
+  Field GetField(uint32_t slot_num, uint32_t i, const ColumnPageLayout &layout);
+
+  /**
+   * Append the ids of the tuples on this page that satisfy predicate, evaluated on the minipage of its column
+   */
+  void FilterTuples(const ScanPredicate &predicate, const ColumnPageLayout &layout, std::vector<RowId> &rids);
+
+  bool GetFirstTupleRid(RowId *first_rid);
+
+  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
+
+  int64_t GetRemain(const ColumnPageLayout &layout) {
+    return int64_t(0) - int64_t(layout.GetCapacity() - GetLiveCount()) * layout.GetTupleSize();
+  }
+
+  /**
+   * Slots [0, GetSlotCount()) may hold tuples, the ones still visible have their bit set in visible
+   */
+  void GetVisibleSlots(uint64_t *visible);
+
+  uint32_t GetSlotCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_SLOT_COUNT); }
+
+  inline const char *GetColumnValues(uint32_t i, const ColumnPageLayout &layout) {
+    return GetData() + layout.GetValuesOffset(i);
+  }
+
+  inline const uint64_t *GetColumnNulls(uint32_t i, const ColumnPageLayout &layout) {
+    return reinterpret_cast<const uint64_t *>(GetData() + layout.GetNullsOffset(i));
+  }
+
+private:
+  void SetSlotCount(uint32_t slot_count) { memcpy(GetData() + OFFSET_SLOT_COUNT, &slot_count, sizeof(uint32_t)); }
+
+  uint32_t GetLiveCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_LIVE_COUNT); }
+
+  void SetLiveCount(uint32_t live_count) { memcpy(GetData() + OFFSET_LIVE_COUNT, &live_count, sizeof(uint32_t)); }
+
+  inline uint64_t *live_map() { return reinterpret_cast<uint64_t *>(GetData() + OFFSET_LIVE_MAP); }
+
+  inline uint64_t *delete_map() { return live_map() + COLUMN_PAGE_MAX_WORDS; }
+
+  static inline bool test_bit(const uint64_t *map, uint32_t i) { return (map[i / 64] >> (i % 64)) & 1; }
+
+  static inline void set_bit(uint64_t *map, uint32_t i, bool value) {
+    if (value) {
+      map[i / 64] |= uint64_t(1) << (i % 64);
+    } else {
+      map[i / 64] &= ~(uint64_t(1) << (i % 64));
+    }
+  }
+
+  inline bool is_visible(uint32_t slot_num) {
+    return slot_num < GetSlotCount() && test_bit(live_map(), slot_num) && !test_bit(delete_map(), slot_num);
+  }
+
+  void write_tuple(const Row &row, uint32_t slot_num, const ColumnPageLayout &layout);
+
+  static_assert(sizeof(page_id_t) == 4);
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_SLOT_COUNT = 16;
+  static constexpr size_t OFFSET_LIVE_COUNT = 20;
+  static constexpr size_t OFFSET_LIVE_MAP = 24;
+};
+
+#endif  // MINISQL_COLUMN_PAGE_H
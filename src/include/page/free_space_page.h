@@ -0,0 +1,84 @@
+#ifndef MINISQL_FREE_SPACE_PAGE_H
+#define MINISQL_FREE_SPACE_PAGE_H
+
+#include "common/config.h"
+
+/**
+ * Free space map (FSM) page of a table heap. Records, for every page of the
+ * heap, how much room is left in it, so that the heap can pick an insertion
+ * target without reading its data pages. Free space is kept in coarse buckets
+ * of FSM_BUCKET_SIZE bytes, rounded down: a page in bucket b has at least
+ * b * FSM_BUCKET_SIZE bytes free.
+ *
+ * FSM pages of one heap are chained, the first one also records the last
+ * page of the heap so new pages can be appended without a walk. The entry
+ * of a page freed by VACUUM stays in place with an invalid heap page id
+ * until a new page of the heap takes the slot.
+ *
+ * Format (size in byte):
+ *  --------------------------------------------------------------------------------------
+ * | NextPageId (4) | HeapTailPageId (4) | Count (4) | HeapPageId_1 (4) | Bucket_1 (4) | ...
+ *  --------------------------------------------------------------------------------------
+ */
+#define FSM_BUCKET_SIZE 32
+
+class FreeSpacePage {
+public:
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    heap_tail_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  inline page_id_t GetNextPageId() const { return next_page_id_; }
+
+  inline void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  inline page_id_t GetHeapTailPageId() const { return heap_tail_page_id_; }
+
+  inline void SetHeapTailPageId(page_id_t page_id) { heap_tail_page_id_ = page_id; }
+
+  inline uint32_t GetCount() const { return count_; }
+
+  inline bool IsFull() const { return count_ >= MAX_ENTRY_COUNT; }
+
+  /**
+   * @return slot of the new entry
+   */
+  uint32_t Append(page_id_t heap_page_id, uint32_t bucket);
+
+  /**
+   * Fill a slot dropped by Remove with a new entry
+   */
+  void Reuse(uint32_t slot, page_id_t heap_page_id, uint32_t bucket);
+
+  page_id_t GetHeapPageId(uint32_t slot) const;
+
+  uint32_t GetBucket(uint32_t slot) const;
+
+  void SetBucket(uint32_t slot, uint32_t bucket);
+
+  /**
+   * Drop the entry in slot, the slots of the other entries stay as they are
+   */
+  void Remove(uint32_t slot);
+
+  static inline uint32_t ToBucket(uint32_t free_space) { return free_space / FSM_BUCKET_SIZE; }
+
+  static constexpr uint32_t MAX_ENTRY_COUNT = (PAGE_SIZE - 12) / 8;
+
+private:
+  struct Entry {
+    page_id_t heap_page_id;
+    uint32_t bucket;
+  };
+
+  page_id_t next_page_id_;
+  page_id_t heap_tail_page_id_;
+  uint32_t count_;
+  Entry entries_[MAX_ENTRY_COUNT];
+};
+
+static_assert(sizeof(FreeSpacePage) <= PAGE_SIZE, "FreeSpacePage must fit a page");
+
+#endif  // MINISQL_FREE_SPACE_PAGE_H
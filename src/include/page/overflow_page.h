@@ -0,0 +1,54 @@
+#ifndef MINISQL_OVERFLOW_PAGE_H
+#define MINISQL_OVERFLOW_PAGE_H
+
+#include <cstring>
+
+#include "common/config.h"
+
+/**
+ * Page of an overflow chain of a table heap. A char too long to be kept in its
+ * row is written to a chain of these pages, one after another, and the row only
+ * keeps the first page of the chain and the length of the chars. The bits of an
+ * index key filter are kept in such a chain as well.
+ *
+ * Format (size in byte):
+ *  ------------------------------------------
+ * | NextPageId (4) | Size (4) | Chars (Size) |
+ *  ------------------------------------------
+ */
+class OverflowPage {
+public:
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    size_ = 0;
+  }
+
+  inline page_id_t GetNextPageId() const { return next_page_id_; }
+
+  inline void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  inline uint32_t GetSize() const { return size_; }
+
+  inline const char *GetChars() const { return chars_; }
+
+  /**
+   * Fill the page with up to CAPACITY chars of data
+   * @return number of chars written
+   */
+  inline uint32_t Write(const char *data, uint32_t size) {
+    size_ = size < CAPACITY ? size : CAPACITY;
+    memcpy(chars_, data, size_);
+    return size_;
+  }
+
+  static constexpr uint32_t CAPACITY = PAGE_SIZE - 8;
+
+private:
+  page_id_t next_page_id_;
+  uint32_t size_;
+  char chars_[CAPACITY];
+};
+
+static_assert(sizeof(OverflowPage) == PAGE_SIZE, "OverflowPage must fill a page");
+
+#endif  // MINISQL_OVERFLOW_PAGE_H
@@ -22,6 +22,7 @@
 #include "common/rowid.h"
 #include "page/page.h"
 #include "record/row.h"
+#include "record/scan_predicate.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
@@ -57,14 +58,49 @@ class TablePage : public Page {
 
   bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * @return serialized bytes of the tuple in slot_num, nullptr if there is none,
+   * they stay valid as long as the page is pinned and not modified
+   */
+  const char *GetTupleData(uint32_t slot_num);
+
+  /**
+   * Like GetTupleData, but a tuple marked as deleted is returned as well
+   */
+  const char *GetStoredTupleData(uint32_t slot_num);
+
+  /**
+   * Append the ids of the tuples on this page that satisfy predicate, evaluated on the tuple bytes
+   */
+  void FilterTuples(const ScanPredicate &predicate, std::vector<RowId> &rids);
+
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
+  /**
+   * @return minus the free space of the page, holes left by deletes included
+   */
   int64_t GetRemain(){
-    return int64_t(0) - GetFreeSpaceRemaining();
+    return int64_t(0) - GetFreeSpace();
   }
 
+  /**
+   * Move the tuples next to each other at the end of the page, so that the holes
+   * deleted and shrunk tuples left join the free space. Slots and rids stay the same.
+   */
+  void Compact();
+
+  /**
+   * @return number of slots, empty slots at the end of the directory are dropped
+   */
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
+  /**
+   * @return true if a tuple is marked deleted and its delete is not applied yet
+   */
+  bool HasMarkedTuples();
+
  private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
@@ -72,14 +108,20 @@ class TablePage : public Page {
     memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
   }
 
-  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
-
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
+  /**
+   * @return bytes between the slot directory and the tuples, what can be used without compacting
+   */
   uint32_t GetFreeSpaceRemaining() {
     return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
   }
 
+  /**
+   * @return bytes not taken by the header, the slots and the tuples, the holes between tuples included
+   */
+  uint32_t GetFreeSpace();
+
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
   }
@@ -7,6 +7,8 @@
   int yyerror(char* error);
 %}
 
+%define api.header.include {"parser/minisql_yacc.h"}
+
 %union {
 	pSyntaxNode syntax_node;
 }
@@ -17,17 +19,23 @@
 %token <syntax_node> ON FROM WHERE INTO SET VALUES PRIMARY KEY UNIQUE
 %token <syntax_node> CHAR INT FLOAT AND OR NOT IS FLAGNULL
 %token <syntax_node> IDENTIFIER STRING NUMBER EQ NE LE GE
+%token <syntax_node> COPY WITH VACUUM CLUSTERED ANALYZE JOIN GROUP BY
+%token <syntax_node> ORDER ASC DESC LIMIT OFFSET
 
 %type <syntax_node> start sql
 %type <syntax_node> sql_create_database sql_drop_database sql_show_databases sql_use_database
 %type <syntax_node> sql_show_tables sql_create_table sql_drop_table
 %type <syntax_node> column_definition_list column_definition column_type column_list
+%type <syntax_node> table_options table_option
 %type <syntax_node> sql_create_index sql_drop_index sql_show_indexes
 %type <syntax_node> sql_trx_begin sql_trx_commit sql_trx_rollback
-%type <syntax_node> sql_select select_columns column_values column_value operator
+%type <syntax_node> sql_select select_columns select_column_list select_column column_name join_tables
+%type <syntax_node> select_tables select_where select_group_by group_column_list
+%type <syntax_node> select_order_by order_key_list order_key select_limit
+%type <syntax_node> column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_quit sql_exec_file sql_copy sql_vacuum sql_analyze
 
 %%
 
@@ -58,6 +66,9 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_copy { $$ = $1; }
+  | sql_vacuum { $$ = $1; }
+  | sql_analyze { $$ = $1; }
   ;
 
 sql_create_database:
@@ -101,6 +112,51 @@ sql_create_table:
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, list_node);
   }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' WITH '(' table_options ')' {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    pSyntaxNode options_node = CreateSyntaxNode(kNodeTableOptions, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren(options_node, $9);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    SyntaxNodeAddChildren($$, options_node);
+  }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' CLUSTERED {
+    $$ = CreateSyntaxNode(kNodeCreateTable, "clustered");
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+  }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' CLUSTERED WITH '(' table_options ')' {
+    $$ = CreateSyntaxNode(kNodeCreateTable, "clustered");
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    pSyntaxNode options_node = CreateSyntaxNode(kNodeTableOptions, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren(options_node, $10);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    SyntaxNodeAddChildren($$, options_node);
+  }
+  ;
+
+table_options:
+  table_option ',' table_options {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | table_option {
+    $$ = $1;
+  }
+  ;
+
+table_option:
+  IDENTIFIER EQ IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeTableOption, NULL);
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $3);
+  }
   ;
 
 column_list:
@@ -133,6 +189,11 @@ column_definition:
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $2);
   }
+  | IDENTIFIER column_type NOT FLAGNULL {
+    $$ = CreateSyntaxNode(kNodeColumnDefinition, "not null");
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $2);
+  }
   | IDENTIFIER column_type {
     $$ = CreateSyntaxNode(kNodeColumnDefinition, NULL);
     SyntaxNodeAddChildren($$, $1);
@@ -196,17 +257,129 @@ sql_show_indexes:
   ;
 
 sql_select:
-  SELECT select_columns FROM IDENTIFIER {
+  SELECT select_columns FROM select_tables select_where select_group_by select_order_by select_limit {
     $$ = CreateSyntaxNode(kNodeSelect, NULL);
     SyntaxNodeAddChildren($$, $2);
     SyntaxNodeAddChildren($$, $4);
+    if ($5 != NULL) SyntaxNodeAddChildren($$, $5);
+    if ($6 != NULL) SyntaxNodeAddChildren($$, $6);
+    if ($7 != NULL) SyntaxNodeAddChildren($$, $7);
+    if ($8 != NULL) SyntaxNodeAddChildren($$, $8);
   }
-  | SELECT select_columns FROM IDENTIFIER WHERE where_conditions {
-    $$ = CreateSyntaxNode(kNodeSelect, NULL);
+  ;
+
+select_tables:
+  IDENTIFIER {
+    $$ = $1;
+  }
+  | join_tables {
+    $$ = $1;
+  }
+  ;
+
+select_where:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | WHERE where_conditions {
+    $$ = CreateSyntaxNode(kNodeConditions, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
+select_group_by:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | GROUP BY group_column_list {
+    $$ = CreateSyntaxNode(kNodeGroupBy, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+group_column_list:
+  column_name ',' group_column_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | column_name {
+    $$ = $1;
+  }
+  ;
+
+select_order_by:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | ORDER BY order_key_list {
+    $$ = CreateSyntaxNode(kNodeOrderBy, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+order_key_list:
+  order_key ',' order_key_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | order_key {
+    $$ = $1;
+  }
+  ;
+
+order_key:
+  select_column {
+    $$ = CreateSyntaxNode(kNodeOrderKey, "asc");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  | select_column ASC {
+    $$ = CreateSyntaxNode(kNodeOrderKey, "asc");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  | select_column DESC {
+    $$ = CreateSyntaxNode(kNodeOrderKey, "desc");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  ;
+
+select_limit:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | LIMIT NUMBER {
+    $$ = CreateSyntaxNode(kNodeLimit, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | LIMIT NUMBER OFFSET NUMBER {
+    $$ = CreateSyntaxNode(kNodeLimit, NULL);
     SyntaxNodeAddChildren($$, $2);
     SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
+join_tables:
+  IDENTIFIER ',' IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeJoin, NULL);
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | IDENTIFIER JOIN IDENTIFIER ON where_conditions {
+    $$ = CreateSyntaxNode(kNodeJoin, NULL);
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $3);
     pSyntaxNode condition_node = CreateSyntaxNode(kNodeConditions, NULL);
-    SyntaxNodeAddChildren(condition_node, $6);
+    SyntaxNodeAddChildren(condition_node, $5);
+    SyntaxNodeAddChildren($$, condition_node);
+  }
+  | join_tables ',' IDENTIFIER {
+    $$ = $1;
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | join_tables JOIN IDENTIFIER ON where_conditions {
+    $$ = $1;
+    SyntaxNodeAddChildren($$, $3);
+    pSyntaxNode condition_node = CreateSyntaxNode(kNodeConditions, NULL);
+    SyntaxNodeAddChildren(condition_node, $5);
     SyntaxNodeAddChildren($$, condition_node);
   }
   ;
@@ -215,12 +388,47 @@ select_columns:
   '*' {
     $$ = CreateSyntaxNode(kNodeAllColumns, NULL);
   }
-  | column_list {
+  | select_column_list {
     $$ = CreateSyntaxNode(kNodeColumnList, "select columns");
     SyntaxNodeAddChildren($$, $1);
   }
   ;
 
+select_column_list:
+  select_column ',' select_column_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | select_column {
+    $$ = $1;
+  }
+  ;
+
+select_column:
+  column_name {
+    $$ = $1;
+  }
+  | IDENTIFIER '(' column_name ')' {
+    $$ = CreateSyntaxNode(kNodeAggregate, $1->val_);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | IDENTIFIER '(' '*' ')' {
+    $$ = CreateSyntaxNode(kNodeAggregate, $1->val_);
+    SyntaxNodeAddChildren($$, CreateSyntaxNode(kNodeAllColumns, NULL));
+  }
+  ;
+
+column_name:
+  IDENTIFIER {
+    $$ = $1;
+  }
+  | IDENTIFIER '.' IDENTIFIER {
+    char name[256] = {0};
+    snprintf(name, sizeof(name), "%s.%s", $1->val_, $3->val_);
+    $$ = CreateSyntaxNode(kNodeIdentifier, name);
+  }
+  ;
+
 where_conditions:
   where_conditions connector where_condition  {
     $$ = $2;
@@ -242,7 +450,12 @@ connector:
   ;
 
 where_condition:
-  IDENTIFIER operator column_value {
+  column_name operator column_value {
+    $$ = $2;
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | column_name operator column_name {
     $$ = $2;
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $3);
@@ -393,6 +606,28 @@ sql_exec_file:
   }
   ;
 
+sql_copy:
+  COPY IDENTIFIER FROM STRING {
+    $$ = CreateSyntaxNode(kNodeCopy, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
+sql_vacuum:
+  VACUUM IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeVacuum, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
+sql_analyze:
+  ANALYZE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeAnalyze, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
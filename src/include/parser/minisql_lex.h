@@ -321,9 +321,9 @@ extern int yylex(void);
 #undef YY_DECL
 #endif
 
-#line 296 "minisql.l"
+#line 366 "minisql.l"
 
 
-#line 318 "./minisql_lex.h"
+#line 328 "./minisql_lex.h"
 #undef yyIN_HEADER
 #endif /* yyHEADER_H */
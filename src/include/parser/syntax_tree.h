@@ -43,7 +43,18 @@ typedef enum {
   kNodeIndexType, /** type of index */
   kNodeTrxBegin, /** begin transaction command */
   kNodeTrxCommit, /** commit transaction command */
-  kNodeTrxRollback /** rollback transaction command */
+  kNodeTrxRollback, /** rollback transaction command */
+  kNodeCopy, /** copy command */
+  kNodeTableOptions, /** WITH (...) options of create table */
+  kNodeTableOption, /** table option, contains the option identifier and its value */
+  kNodeVacuum, /** vacuum command */
+  kNodeAnalyze, /** analyze command */
+  kNodeJoin, /** tables joined in select, each table may be followed by the conditions it is joined on */
+  kNodeAggregate, /** aggregate function of a select column, contains the column or '*' */
+  kNodeGroupBy, /** group by clause of select, contains the columns grouped by */
+  kNodeOrderBy, /** order by clause of select, contains the keys */
+  kNodeOrderKey, /** key of an order by, asc or desc, contains the column or aggregate */
+  kNodeLimit /** limit clause of select, contains the number of rows and the offset if there is one */
 } SyntaxNodeType;
 
 /**
@@ -62,11 +73,6 @@ typedef struct SyntaxNode *pSyntaxNode;
 
 pSyntaxNode CreateSyntaxNode(SyntaxNodeType type, char *val);
 
-/**
- * Free a syntax node and its attribute value, only called by DestroySyntaxTree
- */
-void FreeSyntaxNode(pSyntaxNode node);
-
 /**
  * Free all syntax tree, only called after parse
  */
@@ -79,13 +85,18 @@ void SyntaxNodeAddSibling(pSyntaxNode node, pSyntaxNode sib);
 const char *GetSyntaxNodeTypeStr(SyntaxNodeType type);
 
 /**
- * Linked list used to store all allocated syntax nodes
+ * Chunk of the arena all syntax nodes of a statement and their values are bump allocated from,
+ * the whole arena is released at once by DestroySyntaxTree
  */
-struct SyntaxNodeList {
-  struct SyntaxNodeList *next_;
-  pSyntaxNode node_;
+#define SYNTAX_ARENA_CHUNK_SIZE 4096
+
+struct SyntaxArenaChunk {
+  struct SyntaxArenaChunk *next_;
+  size_t size_; /** bytes of data_ */
+  size_t used_;
+  char data_[];
 };
-typedef struct SyntaxNodeList *pSyntaxNodeList;
+typedef struct SyntaxArenaChunk *pSyntaxArenaChunk;
 
 
 #endif //MINISQL_SYNTAX_TREE_H
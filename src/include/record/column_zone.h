@@ -0,0 +1,45 @@
+#ifndef MINISQL_COLUMN_ZONE_H
+#define MINISQL_COLUMN_ZONE_H
+
+#include <cstring>
+#include <string_view>
+
+#include "record/field.h"
+
+/**
+ * Chars are summarized by their first ZONE_CHARS_PREFIX bytes
+ */
+#define ZONE_CHARS_PREFIX 8
+
+/**
+ * Summary of the values one column takes on a heap page, what a zone map
+ * keeps per page to tell a scan the page cannot hold a match.
+ *
+ * The bounds are widened as values come in but never narrowed when they go,
+ * only once the last value is gone; the counts are exact. A char bound is the
+ * prefix of a value: the lower one is below every value of the page, the
+ * upper one stands for any string it is a prefix of if max_truncated is set.
+ */
+struct ColumnZone {
+  uint32_t null_count{0};
+  uint32_t value_count{0};
+  union {
+    int32_t int_;
+    float float_;
+  } min{0}, max{0};
+  uint8_t min_size{0};
+  uint8_t max_size{0};
+  bool max_truncated{false};
+  char min_chars[ZONE_CHARS_PREFIX];
+  char max_chars[ZONE_CHARS_PREFIX];
+
+  inline std::string_view GetMinChars() const { return std::string_view(min_chars, min_size); }
+
+  inline std::string_view GetMaxChars() const { return std::string_view(max_chars, max_size); }
+
+  void Add(const Field &field);
+
+  void Remove(const Field &field);
+};
+
+#endif  // MINISQL_COLUMN_ZONE_H
@@ -0,0 +1,42 @@
+#ifndef MINISQL_FILTER_KERNELS_H
+#define MINISQL_FILTER_KERNELS_H
+
+#include <cstdint>
+
+enum class CompareOp { kEq, kNe, kLt, kLe, kGt, kGe, kIsNull, kNotNull };
+
+/**
+ * Most values compared by one call of Filter, the tuples of a table page are
+ * filtered in batches of this size
+ */
+#define FILTER_BATCH_SIZE 256
+#define FILTER_BATCH_WORDS (FILTER_BATCH_SIZE / 64)
+
+/**
+ * filter_kernels.h
+ *
+ * Batch comparisons of fixed-width (int/float) column values against a
+ * constant. The values of a column are gathered into a contiguous array
+ * first, then compared 8 (AVX2) or 4 (SSE4.2) at a time and the results are
+ * packed into a selection bitmask. The implementation is chosen once at
+ * start up (CPUID), with a scalar fallback for other CPUs/architectures.
+ */
+namespace simd {
+
+/**
+ * Set bit i of sel (bit i % 64 of word i / 64) if values[i] op key holds,
+ * all other bits of the ceil(n / 64) words of sel are cleared.
+ * @param op one of kEq .. kGe, null checks are no value comparison
+ */
+void Filter(const int32_t *values, uint32_t n, CompareOp op, int32_t key, uint64_t *sel);
+
+void Filter(const float *values, uint32_t n, CompareOp op, float key, uint64_t *sel);
+
+/**
+ * Name of the implementation picked at runtime: "avx2", "sse4.2" or "scalar".
+ */
+const char *FilterImplementation();
+
+}  // namespace simd
+
+#endif  // MINISQL_FILTER_KERNELS_H
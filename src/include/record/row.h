@@ -9,8 +9,24 @@
 #include "record/schema.h"
 #include "utils/mem_heap.h"
 
+/** chunk size of the heap a row allocates for itself, enough for the fields of most rows */
+#define ROW_HEAP_CHUNK_SIZE 512
+
 /**
- *  Row format:
+ *  Row format (compact):
+ * ------------------------------------------------------------------------------------------
+ * | Tag (1) | Null bitmap | Fixed-width fields | Var end offsets (2 each) | Var-length data |
+ * ------------------------------------------------------------------------------------------
+ *  The null bitmap takes one bit per column, set for null. Int and float fields sit at the
+ *  offsets the Schema assigns them, a null one keeps its slot. The offset table holds, for
+ *  each char field in column order, where its bytes end in the var-length data; a field
+ *  starts where the one before it ends. A row without columns takes no bytes at all.
+ *
+ *  A char the table heap stores out of line takes ROW_OVERFLOW_REF_SIZE bytes in the var-length
+ *  data, the first page of its overflow chain and its length, and has ROW_VAR_OVERFLOW set in
+ *  its var end. A row fits a page, so its var ends never reach that bit.
+ *
+ *  Legacy format, still read:
  * -------------------------------------------
  * | Header | Field-1 | ... | Field-N |
  * -------------------------------------------
@@ -18,16 +34,34 @@
  * --------------------------------------------
  * | Field Nums | Null bitmap |
  * -------------------------------------------
- *  
- *
+ *  The field count is at most 64, so its first byte never equals the compact tag.
  */
+#define ROW_COMPACT_FORMAT_TAG 0x82
+
+#define ROW_VAR_OVERFLOW 0x8000
+#define ROW_VAR_END_MASK 0x7FFF
+#define ROW_OVERFLOW_REF_SIZE (sizeof(page_id_t) + sizeof(uint32_t))
+
+/**
+ * Where the chars of a field stored out of line are
+ */
+struct OverflowRef {
+  page_id_t page_id{INVALID_PAGE_ID};
+  uint32_t length{0};
+};
+
+class VectorBatch;
+
 class Row {
 public:
   /**
    * Row used for insert
    * Field integrity should check by upper level
+   * @param heap where the fields are placed, a heap of the row's own if nullptr,
+   *   a heap handed in must outlive the row
    */
-  explicit Row(std::vector<Field> &fields) : heap_(new SimpleMemHeap) {
+  explicit Row(std::vector<Field> &fields, MemHeap *heap = nullptr) : heap_(heap), owns_heap_(heap == nullptr) {
+    if (owns_heap_) heap_ = new ArenaMemHeap(ROW_HEAP_CHUNK_SIZE);
     // deep copy
     for (auto &field : fields) {
       void *buf = heap_->Allocate(sizeof(Field));
@@ -43,19 +77,16 @@ public:
   /**
    * Row used for deserialize and update
    */
-  Row(RowId rid) : rid_(rid), heap_(new SimpleMemHeap) {}
+  Row(RowId rid, MemHeap *heap = nullptr) : rid_(rid), heap_(heap), owns_heap_(heap == nullptr) {
+    if (owns_heap_) heap_ = new ArenaMemHeap(ROW_HEAP_CHUNK_SIZE);
+  }
 
   /**
-   * Row copy function
+   * Row copy function, the copy shares the heap of other unless other has one of its own
    */
-  Row(const Row &other) : heap_(new SimpleMemHeap) {
-    if (!fields_.empty()) {
-      for (auto &field : fields_) {
-        heap_->Free(field);
-      }
-      fields_.clear();
-    }
-    rid_ = other.rid_;
+  Row(const Row &other)
+      : rid_(other.rid_), overflow_(other.overflow_), heap_(other.heap_), owns_heap_(other.owns_heap_) {
+    if (owns_heap_) heap_ = new ArenaMemHeap(ROW_HEAP_CHUNK_SIZE);
     for (auto &field : other.fields_) {
       void *buf = heap_->Allocate(sizeof(Field));
       fields_.push_back(new(buf)Field(*field));
@@ -63,7 +94,8 @@ public:
   }
 
   virtual ~Row() {
-    delete heap_;
+    clear_fields();
+    if (owns_heap_) delete heap_;
   }
 
   /**
@@ -71,6 +103,9 @@ public:
    */
   uint32_t SerializeTo(char *buf, Schema *schema) const;
 
+  /**
+   * Read a row in either format
+   */
   uint32_t DeserializeFrom(char *buf, Schema *schema);
 
   /**
@@ -80,6 +115,27 @@ public:
    */
   uint32_t GetSerializedSize(Schema *schema) const;
 
+  /**
+   * Replace the fields of the row by copies of fields, chars included, for rows
+   * read from pages that do not keep them serialized
+   */
+  void CopyFields(const std::vector<Field> &fields);
+
+  /**
+   * Replace the fields of the row by copies of the fields of row listed in columns, in that order
+   */
+  void CopyFields(const Row &row, const std::vector<uint32_t> &columns);
+
+  /**
+   * Replace the fields of the row by copies of the values of the tuple in slot of batch, of the columns listed
+   */
+  void CopyFields(const VectorBatch &batch, uint32_t slot, const std::vector<uint32_t> &columns);
+
+  /**
+   * Replace the fields of the row by copies of the fields of left followed by those of right
+   */
+  void CopyFields(const Row &left, const Row &right);
+
   inline const RowId GetRowId() const { return rid_; }
 
   inline void SetRowId(RowId rid) { rid_ = rid; }
@@ -93,13 +149,58 @@ public:
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
+  /**
+   * @return true if field idx is stored out of line and its chars are not read into the row,
+   *   the field is an empty char then
+   */
+  inline bool IsOverflow(uint32_t idx) const {
+    return idx < overflow_.size() && overflow_[idx].page_id != INVALID_PAGE_ID;
+  }
+
+  inline bool HasOverflow() const { return !overflow_.empty(); }
+
+  inline const OverflowRef &GetOverflow(uint32_t idx) const {
+    ASSERT(IsOverflow(idx), "Row::GetOverflow : Field Not Out Of Line");
+    return overflow_[idx];
+  }
+
+  /**
+   * Serialize field idx as a reference to ref instead of its chars
+   */
+  void SetOverflow(uint32_t idx, const OverflowRef &ref);
+
+  /**
+   * Put the chars of field idx, read from its overflow chain, in place of the reference
+   */
+  void FillOverflow(uint32_t idx, const char *data);
+
+  /**
+   * Forget every reference, the fields serialize as their chars again
+   */
+  inline void ClearOverflow() { overflow_.clear(); }
+
 private:
   Row &operator=(const Row &other) = delete;
 
+  /**
+   * Destroy the fields and hand their memory back, all of it at once if the heap is the row's own
+   */
+  void clear_fields();
+
+  /**
+   * @return copy of field on the row's heap, chars included
+   */
+  Field *copy_field(const Field &field);
+
+  uint32_t deserialize_legacy(char *buf, Schema *schema);
+
 private:
   RowId rid_{};
   std::vector<Field *> fields_;   /** Make sure that all fields are created by mem heap */
+  /** field index -> its overflow chain, empty if every field is in line */
+  std::vector<OverflowRef> overflow_;
   MemHeap *heap_{nullptr};
+  bool owns_heap_{true};
 };
 
 #endif //MINISQL_TUPLE_H
@@ -0,0 +1,114 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <string_view>
+
+#include "common/macros.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Read-only view of a serialized row, used where a Row would only be built
+ * to look at a few of its fields.
+ *
+ * Nothing is copied: the view points at the serialized bytes, so it is only
+ * valid while they are, e.g. while the table page holding them stays pinned.
+ * In the compact format every field is found in O(1) from the layout of the
+ * schema; for a row in the legacy format the offsets of the fields are worked
+ * out once when the view is built. The chars of a field stored out of line are
+ * not in the viewed bytes, only the reference to them is.
+ */
+class RowView {
+public:
+  /**
+   * @param data begin of the serialized row, nullptr for a row without any field
+   */
+  explicit RowView(const char *data, const Schema *schema);
+
+  inline uint32_t GetFieldCount() const { return field_count_; }
+
+  inline bool IsNull(uint32_t i) const {
+    ASSERT(i < field_count_, "RowView::IsNull : Index Out Of Range");
+    if (compact_) return (null_map_[i / 8] >> (i % 8)) & 1;
+    return ((legacy_null_map_ >> i) & 1) == 0;
+  }
+
+  inline int32_t GetInt(uint32_t i) const {
+    ASSERT(!IsNull(i) && schema_->GetColumn(i)->GetType() == TypeId::kTypeInt, "RowView::GetInt : Not An Int");
+    return MACH_READ_FROM(int32_t, fixed_field(i));
+  }
+
+  inline float GetFloat(uint32_t i) const {
+    ASSERT(!IsNull(i) && schema_->GetColumn(i)->GetType() == TypeId::kTypeFloat, "RowView::GetFloat : Not A Float");
+    return MACH_READ_FROM(float, fixed_field(i));
+  }
+
+  /**
+   * @return true if the chars of column i are stored out of line
+   */
+  inline bool IsOverflow(uint32_t i) const {
+    if (!compact_ || IsNull(i) || schema_->GetColumn(i)->GetType() != TypeId::kTypeChar) return false;
+    return MACH_READ_FROM(uint16_t, var_ends_ + sizeof(uint16_t) * schema_->GetFieldSlot(i)) & ROW_VAR_OVERFLOW;
+  }
+
+  inline OverflowRef GetOverflow(uint32_t i) const {
+    ASSERT(IsOverflow(i), "RowView::GetOverflow : Field Not Out Of Line");
+    uint32_t slot = schema_->GetFieldSlot(i);
+    const char *ref = var_data_ + (slot == 0 ? 0 : var_end(slot - 1));
+    return OverflowRef{MACH_READ_FROM(page_id_t, ref), MACH_READ_UINT32(ref + sizeof(page_id_t))};
+  }
+
+  inline std::string_view GetChars(uint32_t i) const {
+    ASSERT(!IsNull(i) && schema_->GetColumn(i)->GetType() == TypeId::kTypeChar, "RowView::GetChars : Not A Char");
+    ASSERT(!IsOverflow(i), "RowView::GetChars : Chars Out Of Line");
+    if (compact_) {
+      uint32_t slot = schema_->GetFieldSlot(i);
+      uint32_t begin = slot == 0 ? 0 : var_end(slot - 1);
+      return std::string_view(var_data_ + begin, var_end(slot) - begin);
+    }
+    const char *field = data_ + offsets_[i];
+    return std::string_view(field + sizeof(uint32_t), MACH_READ_UINT32(field));
+  }
+
+  /**
+   * Field of column i that does not own its data, chars point into the viewed bytes
+   */
+  Field GetField(uint32_t i) const;
+
+  /**
+   * Compare column i with the same column of other, a null never orders before or after anything
+   * @return <0, 0 or >0 like memcmp
+   */
+  int CompareColumn(const RowView &other, uint32_t i) const;
+
+  /**
+   * @return number of bytes the serialized row takes
+   */
+  uint32_t GetSerializedSize() const;
+
+private:
+  inline const char *fixed_field(uint32_t i) const {
+    return compact_ ? fixed_ + schema_->GetFieldSlot(i) : data_ + offsets_[i];
+  }
+
+  inline uint32_t var_end(uint32_t slot) const {
+    return MACH_READ_FROM(uint16_t, var_ends_ + sizeof(uint16_t) * slot) & ROW_VAR_END_MASK;
+  }
+
+  const char *data_;
+  const Schema *schema_;
+  uint32_t field_count_{0};
+  bool compact_{false};
+  /** compact format */
+  const char *null_map_{nullptr};
+  const char *fixed_{nullptr};
+  const char *var_ends_{nullptr};
+  const char *var_data_{nullptr};
+  /** legacy format, which caps a row at 64 fields */
+  uint64_t legacy_null_map_{0};
+  uint32_t legacy_size_{0};
+  uint32_t offsets_[64];
+};
+
+#endif  // MINISQL_ROW_VIEW_H
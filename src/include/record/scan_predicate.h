@@ -0,0 +1,279 @@
+#ifndef MINISQL_SCAN_PREDICATE_H
+#define MINISQL_SCAN_PREDICATE_H
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "record/column_zone.h"
+#include "record/field.h"
+#include "record/filter_kernels.h"
+#include "record/row.h"
+#include "record/row_view.h"
+#include "record/schema.h"
+
+/**
+ * Condition "column op key" evaluated straight on serialized rows, used to
+ * filter tuples while scanning table pages without building a Row for each.
+ *
+ * Create picks an implementation specialized on the column type and the
+ * operator, so evaluating a tuple is a null bit test, a load at an offset
+ * fixed when the predicate is built and a single typed comparison. Rows in
+ * the legacy format are read through a RowView. A null field matches only
+ * IS NULL, a null key matches nothing. A char the table heap stored out of
+ * line matches no comparison, its chars are not in the row: the heap reads
+ * them from the overflow chain and checks them with EvaluateField.
+ *
+ * EvaluateBatch filters many rows at once: for an int or float column the
+ * values are gathered into an array and compared by the SIMD kernels of
+ * filter_kernels.h. EvaluateColumn does the same on the minipage of a
+ * column page, whose values are contiguous already. MayMatch tells from the
+ * zone of a page whether the page has to be read at all.
+ */
+class ScanPredicate {
+public:
+  virtual ~ScanPredicate() = default;
+
+  /**
+   * @param data serialized row of the schema the predicate was built for
+   */
+  virtual bool Evaluate(const char *data) const = 0;
+
+  /**
+   * @param field value of the column
+   */
+  virtual bool EvaluateField(const Field &field) const = 0;
+
+  /**
+   * Set bit i of sel if rows[i] matches, like simd::Filter
+   * @param n at most FILTER_BATCH_SIZE
+   */
+  virtual void EvaluateBatch(const char *const *rows, uint32_t n, uint64_t *sel) const;
+
+  /**
+   * Set bit i of sel if value i of the column matches, for a column stored apart from the rest of its row
+   * @param values n values of width bytes, a char is its uint16 length followed by the chars
+   * @param nulls bit i is set if value i is null
+   */
+  virtual void EvaluateColumn(const char *values, uint32_t width, const uint64_t *nulls, uint32_t n,
+                              uint64_t *sel) const = 0;
+
+  /**
+   * @return false if none of the values zone summarizes can match, the page it belongs to is skipped
+   */
+  virtual bool MayMatch(const ColumnZone &zone) const = 0;
+
+  inline uint32_t GetColumnIndex() const { return column_index_; }
+
+  inline CompareOp GetOp() const { return op_; }
+
+  /**
+   * @param key compared against, of the type of the column, not used by IS NULL and IS NOT NULL
+   */
+  static std::unique_ptr<ScanPredicate> Create(const Schema *schema, uint32_t column_index, CompareOp op,
+                                               const Field &key);
+
+  /**
+   * @return false if token is no comparison of the where clause
+   */
+  static bool ParseOp(const std::string &token, CompareOp &op);
+
+protected:
+  ScanPredicate(const Schema *schema, uint32_t column_index, CompareOp op);
+
+  inline bool is_compact(const char *data) const {
+    return static_cast<uint8_t>(data[0]) == ROW_COMPACT_FORMAT_TAG;
+  }
+
+  /**
+   * @return true if the chars of a char column are stored out of line
+   */
+  inline bool is_overflow(const char *data) const {
+    return is_compact(data) && (MACH_READ_FROM(uint16_t, data + value_offset_) & ROW_VAR_OVERFLOW);
+  }
+
+  inline bool is_null(const char *data) const {
+    if (is_compact(data)) return data[null_byte_] & null_mask_;
+    return RowView(data, schema_).IsNull(column_index_);
+  }
+
+  const Schema *schema_;
+  uint32_t column_index_;
+  CompareOp op_;
+  /** position of the column in a row of the compact format */
+  uint32_t null_byte_;
+  uint8_t null_mask_;
+  /** offset of the value, or for a char column of the entry of the offset table where it ends */
+  uint32_t value_offset_;
+  /** a char column that is not the first one starts where the one before it ends */
+  bool has_prev_var_;
+  uint32_t var_data_offset_;
+};
+
+template <typename T, CompareOp Op>
+class TypedScanPredicate : public ScanPredicate {
+public:
+  using KeyType = std::conditional_t<std::is_same_v<T, std::string_view>, std::string, T>;
+
+  TypedScanPredicate(const Schema *schema, uint32_t column_index, KeyType key)
+      : ScanPredicate(schema, column_index, Op), key_(std::move(key)) {}
+
+  bool Evaluate(const char *data) const override {
+    if (is_null(data)) return Op == CompareOp::kIsNull;
+    if constexpr (Op == CompareOp::kIsNull || Op == CompareOp::kNotNull) {
+      return Op == CompareOp::kNotNull;
+    } else {
+      if constexpr (std::is_same_v<T, std::string_view>) {
+        if (is_overflow(data)) return false;
+      }
+      return compare(read(data));
+    }
+  }
+
+  bool EvaluateField(const Field &field) const override {
+    if (field.IsNull()) return Op == CompareOp::kIsNull;
+    if constexpr (Op == CompareOp::kIsNull || Op == CompareOp::kNotNull) {
+      return Op == CompareOp::kNotNull;
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+      return compare(std::string_view(field.GetData(), field.GetLength()));
+    } else {
+      char buf[sizeof(T)];
+      field.SerializeTo(buf);
+      return compare(MACH_READ_FROM(T, buf));
+    }
+  }
+
+  void EvaluateBatch(const char *const *rows, uint32_t n, uint64_t *sel) const override {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      ScanPredicate::EvaluateBatch(rows, n, sel);
+    } else {
+      ASSERT(n <= FILTER_BATCH_SIZE, "TypedScanPredicate::EvaluateBatch : Batch Too Large");
+      uint32_t words = (n + 63) / 64;
+      uint64_t nulls[FILTER_BATCH_WORDS] = {0};
+      T values[FILTER_BATCH_SIZE];
+      // the slot of a null keeps its place in the compact format, whatever is read there is masked out
+      for (uint32_t i = 0; i < n; i++) {
+        bool null = is_null(rows[i]);
+        nulls[i / 64] |= uint64_t(null) << (i % 64);
+        values[i] = null ? T() : read(rows[i]);
+      }
+      if constexpr (Op == CompareOp::kIsNull) {
+        for (uint32_t w = 0; w < words; w++) sel[w] = nulls[w];
+      } else if constexpr (Op == CompareOp::kNotNull) {
+        for (uint32_t w = 0; w < words; w++) sel[w] = ~nulls[w];
+        if (n % 64 != 0) sel[words - 1] &= (uint64_t(1) << (n % 64)) - 1;
+      } else {
+        simd::Filter(values, n, Op, key_, sel);
+        for (uint32_t w = 0; w < words; w++) sel[w] &= ~nulls[w];
+      }
+    }
+  }
+
+  void EvaluateColumn(const char *values, uint32_t width, const uint64_t *nulls, uint32_t n,
+                      uint64_t *sel) const override {
+    uint32_t words = (n + 63) / 64;
+    if constexpr (Op == CompareOp::kIsNull || Op == CompareOp::kNotNull) {
+      for (uint32_t w = 0; w < words; w++) sel[w] = Op == CompareOp::kIsNull ? nulls[w] : ~nulls[w];
+      if (n % 64 != 0) sel[words - 1] &= (uint64_t(1) << (n % 64)) - 1;
+    } else {
+      if constexpr (std::is_same_v<T, std::string_view>) {
+        memset(sel, 0, sizeof(uint64_t) * words);
+        for (uint32_t i = 0; i < n; i++, values += width) {
+          std::string_view value(values + sizeof(uint16_t), MACH_READ_FROM(uint16_t, values));
+          sel[i / 64] |= uint64_t(compare(value)) << (i % 64);
+        }
+      } else {
+        ASSERT(width == sizeof(T), "TypedScanPredicate::EvaluateColumn : Width Not Match");
+        simd::Filter(reinterpret_cast<const T *>(values), n, Op, key_, sel);
+      }
+      for (uint32_t w = 0; w < words; w++) sel[w] &= ~nulls[w];
+    }
+  }
+
+  bool MayMatch(const ColumnZone &zone) const override {
+    if constexpr (Op == CompareOp::kIsNull) {
+      return zone.null_count > 0;
+    } else if constexpr (Op == CompareOp::kNotNull) {
+      return zone.value_count > 0;
+    } else {
+      if (zone.value_count == 0) return false;
+      if constexpr (std::is_same_v<T, std::string_view>) {
+        // the upper bound may be truncated, compare on as many chars as it kept
+        std::string_view key(key_), min = zone.GetMinChars(), max = zone.GetMaxChars();
+        std::string_view key_prefix = zone.max_truncated ? key.substr(0, max.size()) : key;
+        if constexpr (Op == CompareOp::kEq) {
+          return min <= key && key_prefix <= max;
+        } else if constexpr (Op == CompareOp::kNe) {
+          return true;
+        } else if constexpr (Op == CompareOp::kLt) {
+          return min < key;
+        } else if constexpr (Op == CompareOp::kLe) {
+          return min <= key;
+        } else if constexpr (Op == CompareOp::kGt) {
+          return zone.max_truncated ? key_prefix <= max : key < max;
+        } else {
+          return key_prefix <= max;
+        }
+      } else {
+        T min, max;
+        if constexpr (std::is_same_v<T, int32_t>) {
+          min = zone.min.int_, max = zone.max.int_;
+        } else {
+          min = zone.min.float_, max = zone.max.float_;
+        }
+        if constexpr (Op == CompareOp::kEq) {
+          return min <= key_ && key_ <= max;
+        } else if constexpr (Op == CompareOp::kNe) {
+          return !(min == key_ && max == key_);
+        } else if constexpr (Op == CompareOp::kLt) {
+          return min < key_;
+        } else if constexpr (Op == CompareOp::kLe) {
+          return min <= key_;
+        } else if constexpr (Op == CompareOp::kGt) {
+          return max > key_;
+        } else {
+          return max >= key_;
+        }
+      }
+    }
+  }
+
+private:
+  inline bool compare(T value) const {
+    if constexpr (Op == CompareOp::kEq) {
+      return value == T(key_);
+    } else if constexpr (Op == CompareOp::kNe) {
+      return value != T(key_);
+    } else if constexpr (Op == CompareOp::kLt) {
+      return value < T(key_);
+    } else if constexpr (Op == CompareOp::kLe) {
+      return value <= T(key_);
+    } else if constexpr (Op == CompareOp::kGt) {
+      return value > T(key_);
+    } else {
+      return value >= T(key_);
+    }
+  }
+
+  inline T read(const char *data) const {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      if (!is_compact(data)) return RowView(data, schema_).GetChars(column_index_);
+      uint32_t begin =
+          has_prev_var_ ? MACH_READ_FROM(uint16_t, data + value_offset_ - sizeof(uint16_t)) & ROW_VAR_END_MASK : 0;
+      uint32_t end = MACH_READ_FROM(uint16_t, data + value_offset_) & ROW_VAR_END_MASK;
+      return std::string_view(data + var_data_offset_ + begin, end - begin);
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+      if (!is_compact(data)) return RowView(data, schema_).GetInt(column_index_);
+      return MACH_READ_FROM(int32_t, data + value_offset_);
+    } else {
+      if (!is_compact(data)) return RowView(data, schema_).GetFloat(column_index_);
+      return MACH_READ_FROM(float, data + value_offset_);
+    }
+  }
+
+  KeyType key_;
+};
+
+#endif  // MINISQL_SCAN_PREDICATE_H
@@ -10,7 +10,7 @@
 
 class Schema {
 public:
-  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {}
+  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) { init_layout(); }
 
   inline const std::vector<Column *> &GetColumns() const { return columns_; }
 
@@ -28,6 +28,27 @@ public:
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * Where column i lives in a row of the compact format: the byte offset among the fixed-width fields,
+   * or for a char column its entry in the offset table of the variable-length fields
+   */
+  inline uint32_t GetFieldSlot(const uint32_t column_index) const { return field_slots_[column_index]; }
+
+  /**
+   * @return bytes of the null bitmap of a row in the compact format
+   */
+  inline uint32_t GetNullBitmapSize() const { return (GetColumnCount() + 7) / 8; }
+
+  /**
+   * @return bytes taken by all fixed-width fields of a row in the compact format
+   */
+  inline uint32_t GetFixedSize() const { return fixed_size_; }
+
+  /**
+   * @return number of variable-length (char) columns
+   */
+  inline uint32_t GetVarCount() const { return var_count_; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -73,8 +94,16 @@ public:
   static uint32_t DeserializeFrom(char *buf, Schema *&schema, MemHeap *heap);
 
 private:
+  /**
+   * Lay the columns out for the compact row format, done once per schema
+   */
+  void init_layout();
+
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;   /** don't need to delete pointer to column */
+  std::vector<uint32_t> field_slots_;
+  uint32_t fixed_size_{0};
+  uint32_t var_count_{0};
 };
 
 using IndexSchema = Schema;
@@ -0,0 +1,150 @@
+#ifndef MINISQL_VECTOR_BATCH_H
+#define MINISQL_VECTOR_BATCH_H
+
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "common/macros.h"
+#include "record/field.h"
+#include "record/schema.h"
+
+/**
+ * Most tuples a batch of the vectorized operators holds
+ */
+#define VECTOR_BATCH_SIZE 1024
+#define VECTOR_BATCH_WORDS (VECTOR_BATCH_SIZE / 64)
+
+/**
+ * Values of one column for the tuples of a batch, kept like the minipage of a
+ * column page: a null bitmap and an array of fixed width values, a char is its
+ * uint16 length followed by as many bytes as the column was declared with. The
+ * vector can be handed to ScanPredicate::EvaluateColumn as it is.
+ */
+class ColumnVector {
+public:
+  explicit ColumnVector(const Column *column);
+
+  inline TypeId GetType() const { return type_; }
+
+  /**
+   * @return bytes a value takes in the array
+   */
+  inline uint32_t GetWidth() const { return width_; }
+
+  inline const char *GetValues() const { return values_.data(); }
+
+  inline const uint64_t *GetNulls() const { return nulls_; }
+
+  inline bool IsNull(uint32_t i) const { return (nulls_[i / 64] >> (i % 64)) & 1; }
+
+  inline void SetNull(uint32_t i) { nulls_[i / 64] |= uint64_t(1) << (i % 64); }
+
+  inline void SetInt(uint32_t i, int32_t value) { MACH_WRITE_TO(int32_t, value_at(i), value); }
+
+  inline void SetFloat(uint32_t i, float value) { MACH_WRITE_TO(float, value_at(i), value); }
+
+  inline void SetChars(uint32_t i, std::string_view chars) {
+    ASSERT(sizeof(uint16_t) + chars.size() <= width_, "ColumnVector::SetChars : Chars Too Long");
+    MACH_WRITE_TO(uint16_t, value_at(i), static_cast<uint16_t>(chars.size()));
+    memcpy(value_at(i) + sizeof(uint16_t), chars.data(), chars.size());
+  }
+
+  /**
+   * Copy n values and their null bits from the minipage of a column page, to slots [first, first + n)
+   * @param slots slots of the minipage to copy
+   */
+  void Gather(uint32_t first, const char *values, const uint64_t *nulls, const uint32_t *slots, uint32_t n);
+
+  /**
+   * Field of value i that does not own its data, chars point into the vector
+   */
+  Field GetField(uint32_t i) const;
+
+  /**
+   * Forget the null bits, the vector is filled again from its first slot
+   */
+  inline void Clear() { memset(nulls_, 0, sizeof(nulls_)); }
+
+private:
+  inline char *value_at(uint32_t i) { return values_.data() + i * width_; }
+
+  TypeId type_;
+  uint32_t width_;
+  std::vector<char> values_;
+  uint64_t nulls_[VECTOR_BATCH_WORDS];
+};
+
+/**
+ * Up to VECTOR_BATCH_SIZE tuples of a table, split into a ColumnVector for each
+ * column that is read, plus a selection vector: the slots of the tuples still in
+ * the batch, in increasing order. A filter narrows the selection rather than
+ * moving the values, the operators after it only look at the selected slots.
+ */
+class VectorBatch {
+public:
+  /**
+   * @param columns columns of schema that get a vector, the others are not read
+   */
+  VectorBatch(const Schema *schema, const std::vector<uint32_t> &columns);
+
+  /**
+   * @return number of tuples in the vectors, selected or not
+   */
+  inline uint32_t GetSize() const { return size_; }
+
+  inline bool IsFull() const { return size_ == VECTOR_BATCH_SIZE; }
+
+  inline bool HasColumn(uint32_t i) const { return i < vectors_.size() && vectors_[i] != nullptr; }
+
+  inline ColumnVector &GetColumn(uint32_t i) {
+    ASSERT(HasColumn(i), "VectorBatch::GetColumn : Column Not Read");
+    return *vectors_[i];
+  }
+
+  inline const ColumnVector &GetColumn(uint32_t i) const {
+    ASSERT(HasColumn(i), "VectorBatch::GetColumn : Column Not Read");
+    return *vectors_[i];
+  }
+
+  /**
+   * @return columns that have a vector, in increasing order
+   */
+  inline const std::vector<uint32_t> &GetColumns() const { return columns_; }
+
+  inline const uint32_t *GetSelection() const { return selection_; }
+
+  inline uint32_t GetSelectedCount() const { return selected_; }
+
+  /**
+   * Add n tuples at the end, selected, their values are written to slots [GetSize() - n, GetSize())
+   * @return slot of the first of them
+   */
+  inline uint32_t Append(uint32_t n) {
+    ASSERT(size_ + n <= VECTOR_BATCH_SIZE, "VectorBatch::Append : Batch Full");
+    for (uint32_t i = 0; i < n; i++) selection_[selected_++] = size_ + i;
+    size_ += n;
+    return size_ - n;
+  }
+
+  /**
+   * Keep the selected tuples whose bit is set in sel, one bit for each slot like ScanPredicate::EvaluateColumn
+   */
+  void Select(const uint64_t *sel);
+
+  /**
+   * Empty the batch so that it can be filled again
+   */
+  void Reset();
+
+private:
+  /** indexed by column, nullptr for a column that is not read */
+  std::vector<std::unique_ptr<ColumnVector>> vectors_;
+  std::vector<uint32_t> columns_;
+  uint32_t size_{0};
+  uint32_t selection_[VECTOR_BATCH_SIZE];
+  uint32_t selected_{0};
+};
+
+#endif  // MINISQL_VECTOR_BATCH_H
@@ -0,0 +1,96 @@
+#ifndef MINISQL_CLUSTER_DIRECTORY_H
+#define MINISQL_CLUSTER_DIRECTORY_H
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/row_view.h"
+
+/**
+ * Key of a clustered heap, the fields of its key columns in key order
+ */
+using ClusterKey = std::vector<Field>;
+
+/**
+ * Orders cluster keys field by field. Keys are compared on the fields both have,
+ * so a prefix of a key is equivalent to every key that starts with it.
+ */
+struct ClusterKeyLess {
+  bool operator()(const ClusterKey &lhs, const ClusterKey &rhs) const;
+};
+
+/**
+ * Directory of a clustered heap. The pages of the heap hold key ranges that follow
+ * each other along the page chain: a page holds the keys from its separator up to
+ * the separator of the page after it, the first page has none and holds every key
+ * below the second one. The directory maps the separators to their pages, so a key
+ * is placed on and looked up from its page without reading any other page, and a
+ * range of keys is read from the pages holding it.
+ *
+ * Like the zone map the directory lives in memory only, a heap read from disk builds
+ * it on first use with the smallest key of each page as its separator. Pages without
+ * a tuple then are left out, no key is placed on them.
+ */
+class ClusterDirectory {
+public:
+  /**
+   * Copy the key columns of a row, chars included, so that the key outlives the row
+   */
+  static ClusterKey MakeKey(const Row &row, const std::vector<uint32_t> &columns);
+
+  static ClusterKey MakeKey(const RowView &view, const std::vector<uint32_t> &columns);
+
+  static inline bool Equals(const ClusterKey &lhs, const ClusterKey &rhs) {
+    return !ClusterKeyLess()(lhs, rhs) && !ClusterKeyLess()(rhs, lhs);
+  }
+
+  /**
+   * Forget every separator, first_page_id holds all keys from now on
+   */
+  void Reset(page_id_t first_page_id);
+
+  /**
+   * @return the page holding key
+   */
+  page_id_t Locate(const ClusterKey &key) const;
+
+  /**
+   * Append the pages that may hold a key within the bounds in key order, the bounds
+   * may be prefixes of keys, nullptr for no bound
+   * @param lower_strict the range leaves out the keys equivalent to lower
+   * @param upper_strict the range leaves out the keys equivalent to upper
+   */
+  void Range(const ClusterKey *lower, bool lower_strict, const ClusterKey *upper, bool upper_strict,
+             std::vector<page_id_t> &pages) const;
+
+  /**
+   * @return pages of the heap that hold a key range, in key order
+   */
+  std::vector<page_id_t> GetPages() const;
+
+  inline bool HasSeparator(const ClusterKey &separator) const { return separators_.count(separator) > 0; }
+
+  /**
+   * Let page_id hold the keys from separator on, the separator must not be taken
+   */
+  void Add(const ClusterKey &separator, page_id_t page_id);
+
+  /**
+   * Hand the key range of page_id to the page before it
+   */
+  void Remove(page_id_t page_id);
+
+private:
+  using Separators = std::map<ClusterKey, page_id_t, ClusterKeyLess>;
+
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  Separators separators_;
+  /** page id -> its separator */
+  std::unordered_map<page_id_t, Separators::iterator> entries_;
+};
+
+#endif  // MINISQL_CLUSTER_DIRECTORY_H
@@ -1,52 +1,102 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <algorithm>
 #include <map>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include "buffer/buffer_pool_manager.h"
+#include "page/column_page.h"
+#include "page/free_space_page.h"
+#include "page/overflow_page.h"
 #include "page/table_page.h"
+#include "record/vector_batch.h"
+#include "storage/cluster_directory.h"
 #include "storage/table_iterator.h"
+#include "storage/zone_map.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 #include <functional>
-#define INSERT(C, P)                                                               \
-  do {                                                                             \
-    ASSERT(C[P->GetRemain()].count(P->GetTablePageId()) == 0, "Duplicate insert"); \
-    C[P->GetRemain()].insert(P->GetTablePageId());                                 \
-  } while (0)
-
-#define ERASE(C, P)                                                              \
-  do {                                                                           \
-    ASSERT(C[P->GetRemain()].count(P->GetTablePageId()) != 0, "Invalid Delete"); \
-    erase_page(P);                                \
-  } while (0)
-#define HAS(C, P) C[P->GetRemain()].count(P->GetTablePageId()) != 0
+
+/**
+ * Parallel scans hand pages to their workers SCAN_MORSEL_SIZE at a time,
+ * heaps smaller than PARALLEL_SCAN_MIN_PAGES are scanned by the caller alone
+ */
+#define SCAN_MORSEL_SIZE 16
+#define PARALLEL_SCAN_MIN_PAGES 64
+
+/**
+ * VACUUM merges the pages filled below VACUUM_FILL_PERCENT percent
+ */
+#define VACUUM_FILL_PERCENT 50
+
+/**
+ * A char longer than TABLE_OVERFLOW_THRESHOLD bytes is stored out of line in a chain of overflow pages
+ * and its row keeps a reference to the chain, so that long values do not crowd the rows out of the pages.
+ * Only heaps of row pages do so, and never for a column of the cluster key.
+ */
+#define TABLE_OVERFLOW_THRESHOLD 128
+
+/**
+ * How the pages of a heap store their tuples: whole rows in slotted TablePages,
+ * or split by column in the minipages of ColumnPages
+ */
+enum class TableLayout : uint32_t { kRow, kColumn };
+
+/**
+ * Location and value of a heap page's entry in the free space map
+ */
+struct FsmEntry {
+  page_id_t fsm_page_id;
+  uint32_t slot;
+  uint32_t bucket;
+};
 
 class TableHeap {
   friend class TableIterator;
 
  public:
+  /**
+   * Called for every tuple a heap moves to another page, with the row at its new rid and its old rid
+   */
+  using MoveCallback = std::function<void(Row &row, const RowId &old_rid)>;
+
+  /**
+   * Called whenever the first page or the first free space map page of the heap changes
+   */
+  using RootCallback = std::function<void(const TableHeap *heap)>;
+
+  /**
+   * @param cluster_key columns of the key the rows are clustered on, empty for a heap that keeps rows anywhere
+   */
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
+                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap,
+                           TableLayout layout = TableLayout::kRow, const std::vector<uint32_t> &cluster_key = {}) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new (buf) TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
+    return new (buf) TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager, layout, cluster_key);
   }
 
-  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
+  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, page_id_t fsm_page_id,
+                           Schema *schema, LogManager *log_manager, LockManager *lock_manager, MemHeap *heap,
+                           TableLayout layout = TableLayout::kRow, const std::vector<uint32_t> &cluster_key = {}) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new (buf) TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+    return new (buf) TableHeap(buffer_pool_manager, first_page_id, fsm_page_id, schema, log_manager, lock_manager,
+                               layout, cluster_key);
   }
 
   ~TableHeap() {}
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * A clustered heap places the tuple on the page of its key and splits the page if it is full.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The transaction performing the insert
+   * @param[in] moved called for the tuples a page split moves, only a clustered heap moves any
    * @return true iff the insert is successful
    */
-  bool InsertTuple(Row &row, Transaction *txn);
+  bool InsertTuple(Row &row, Transaction *txn, const MoveCallback &moved = nullptr);
 
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
@@ -57,7 +107,8 @@ class TableHeap {
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * if the new tuple is too large to fit in the old page, or changes the cluster key, return false
+   * (will delete and insert)
    * @param[in] row Tuple of new row
    * @param[in] rid Rid of the old tuple
    * @param[in] txn Transaction performing the update
@@ -79,19 +130,63 @@ class TableHeap {
    */
   void RollbackDelete(const RowId &rid, Transaction *txn);
 
+  /**
+   * Collect the ids of all rows, the pages are scanned in parallel
+   */
   void FetchAllIds(std::unordered_set<RowId> &ans_set);
 
-  void FetchId(std::unordered_set<RowId> &ans_set, std::size_t column_index, Schema *schema, const Field &key,
-               const std::function<bool(const Field &, const Field &)> &filter);
+  /**
+   * Collect the ids of the rows satisfying predicate, which is evaluated on the tuple bytes in the pages,
+   * pages whose zone rules out predicate are not read
+   */
+  void FetchId(std::unordered_set<RowId> &ans_set, const ScanPredicate &predicate);
+
+  /**
+   * Collect the ids of the rows whose field of the leading cluster key column compares to key by op,
+   * only the pages holding that key range are read
+   * @return false if the heap is not clustered or op is not a comparison a key range answers
+   */
+  bool FetchKeyRange(std::unordered_set<RowId> &ans_set, CompareOp op, const Field &key);
+
+  /**
+   * Find the visible tuple with the cluster key of row, only the page of that key is read
+   */
+  bool FindKey(const Row &row, RowId *rid);
+
+  /**
+   * Limit the number of threads of a parallel scan, defaults to the number of cores
+   */
+  inline void SetScanWorkers(uint32_t scan_workers) { scan_workers_ = std::max(1u, scan_workers); }
 
   /**
-   * Read a tuple from the table.
+   * Move the tuples of sparse pages into other sparse pages and give the pages left empty back to the
+   * disk manager, the first page always stays. A tuple that moves gets a new rid. A clustered heap
+   * merges a page into the one before it, so that the key ranges stay in order.
+   * @param moved called for every tuple moved, with the row at its new rid and its old rid
+   * @return number of pages freed
+   */
+  uint32_t Vacuum(Transaction *txn, const MoveCallback &moved);
+
+  /**
+   * Read a tuple from the table, the chars stored out of line included.
    * @param[in/out] row Output variable for the tuple, row id of the tuple is wrapped in row
    * @param[in] txn transaction performing the read
    * @return true if the read was successful (i.e. the tuple exists)
    */
   bool GetTuple(Row *row, Transaction *txn);
 
+  /**
+   * Read a tuple from the table, of the chars stored out of line only those of columns
+   * are read, the other ones are left as Row::IsOverflow fields
+   */
+  bool GetTuple(Row *row, Transaction *txn, const std::vector<uint32_t> &columns);
+
+  /**
+   * Read the chars of the fields of row stored out of line from their overflow chains
+   * @param columns only the fields of these columns, all of them if nullptr
+   */
+  void ReadOverflow(Row &row, const std::vector<uint32_t> *columns = nullptr);
+
   /**
    * Free table heap and release storage in disk file
    */
@@ -102,68 +197,320 @@ class TableHeap {
    */
   TableIterator Begin(Transaction *txn);
 
+  /**
+   * @return the begin iterator of this table, of the chars stored out of line it reads those of columns only
+   */
+  TableIterator Begin(Transaction *txn, const std::vector<uint32_t> &columns);
+
+  /**
+   * @return iterator over the rows satisfying predicate, read page by page like FetchId does,
+   *   predicate has to outlive the iterator
+   */
+  TableIterator Begin(Transaction *txn, const std::vector<uint32_t> &columns, const ScanPredicate &predicate);
+
+  /**
+   * @return iterator over the rows of rids in page order, each page is fetched once
+   */
+  TableIterator Begin(Transaction *txn, const std::vector<uint32_t> &columns, std::vector<RowId> rids);
+
   /**
    * @return the end iterator of this table
    */
   TableIterator End();
 
+  /**
+   * @return pages a scan for predicate has to read, every heap page if nullptr, the zone map rules out
+   *   the others. They come in key order for a clustered heap, in page id order otherwise.
+   */
+  std::vector<page_id_t> ScanPages(const ScanPredicate *predicate);
+
+  /**
+   * Append the visible tuples of a page to batch, the values of its columns are gathered into their
+   * vectors, chars stored out of line included. Stops once batch is full.
+   * @param[in/out] slot first slot of the page to read, then the one to go on from
+   * @param summarize give the page its zones if it has none yet
+   * @return true if every tuple of the page has been read
+   */
+  bool ReadBatch(page_id_t page_id, uint32_t &slot, VectorBatch &batch, bool summarize = false);
+
   /**
    * @return the id of the first page of this table
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * Keep the insertion target pinned across the inserts that follow, until ReleaseInsertPage. Meant for a
+   * COPY or a bulk load: while the target is pinned its entry in the free space map is out of date.
+   */
+  inline void HoldInsertPage() { hold_insert_page_ = true; }
+
+  /**
+   * Unpin the insertion target, write its free space back to the free space map and end HoldInsertPage.
+   * Must be called before the heap is dropped or the buffer pool is shut down.
+   */
+  void ReleaseInsertPage();
+
+  /**
+   * @return the id of the first free space map page, INVALID_PAGE_ID if the map is not built yet
+   */
+  inline page_id_t GetFsmPageId() const { return fsm_page_id_; }
+
+  /**
+   * Let the owner of the metadata recording GetFirstPageId and GetFsmPageId write it back when they change
+   */
+  inline void SetRootCallback(RootCallback root_changed) { root_changed_ = std::move(root_changed); }
+
+  inline Schema *GetSchema() const { return schema_; }
+
+  inline TableLayout GetLayout() const { return column_layout_ ? TableLayout::kColumn : TableLayout::kRow; }
+
+  /**
+   * @return where the minipages of the heap's column pages are, nullptr for a heap of row pages
+   */
+  inline const ColumnPageLayout *GetColumnLayout() const { return column_layout_ ? &*column_layout_ : nullptr; }
+
+  inline const ZoneMap &GetZoneMap() const { return zone_map_; }
+
+  inline bool IsClustered() const { return !cluster_key_.empty(); }
+
+  /**
+   * @return columns of the key the rows are clustered on, empty if they are not
+   */
+  inline const std::vector<uint32_t> &GetClusterKey() const { return cluster_key_; }
+
  private:
   /**
    * create table heap and initialize first page
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn, LogManager *log_manager,
-                     LockManager *lock_manager)
-      : buffer_pool_manager_(buffer_pool_manager),
-        schema_(schema),
-        log_manager_(log_manager),
-        lock_manager_(lock_manager) {
-    auto FirstPage = reinterpret_cast<TablePage *>(buffer_pool_manager->NewPage(first_page_id_));
-    ASSERT(FirstPage != nullptr, "TableHeap : First Page Allocation failed");
-    FirstPage->Init(first_page_id_, INVALID_PAGE_ID, log_manager, txn);
-    FirstPage->SetNextPageId(INVALID_PAGE_ID);
-    INSERT(Pages, FirstPage);
-  };
+                     LockManager *lock_manager, TableLayout layout, const std::vector<uint32_t> &cluster_key);
 
   /**
-   * load existing table heap by first_page_id
+   * load existing table heap by first_page_id, the pages of the free space map are read as they are needed
    */
-  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, page_id_t fsm_page_id,
+                     Schema *schema, LogManager *log_manager, LockManager *lock_manager, TableLayout layout,
+                     const std::vector<uint32_t> &cluster_key)
       : buffer_pool_manager_(buffer_pool_manager),
         first_page_id_(first_page_id),
+        fsm_page_id_(fsm_page_id),
         schema_(schema),
+        fsm_next_page_id_(fsm_page_id),
+        zone_map_(schema->GetColumnCount()),
+        cluster_key_(cluster_key),
+        may_overflow_(can_overflow(schema, layout, cluster_key)),
         log_manager_(log_manager),
         lock_manager_(lock_manager) {
-    // This constructor is like copy constructor
-    // Push every page into <Pages> for access.
-    auto cur_page_id = first_page_id_;
-    TablePage *cur_page = nullptr;
-    while (cur_page_id != INVALID_PAGE_ID) {
-      cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(cur_page_id));
-      ASSERT(cur_page != nullptr, "NULL page encountered");
-      INSERT(Pages, cur_page);
-      cur_page_id = cur_page->GetNextPageId();
-    }
+    ASSERT(cluster_key.empty() || layout == TableLayout::kRow, "TableHeap : Only Rows Are Clustered");
+    if (layout == TableLayout::kColumn) column_layout_.emplace(schema);
   }
 
  private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
+  page_id_t fsm_page_id_;
   Schema *schema_;
 
+  /** in memory copy of the free space map, its pages up to fsm_next_page_id_ are read, all of them once
+   *  fsm_loaded_ is set */
+  bool fsm_loaded_{false};
+  page_id_t fsm_next_page_id_{INVALID_PAGE_ID};
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  page_id_t fsm_last_page_id_{INVALID_PAGE_ID};
+  /** -bucket -> heap pages, pages with the most free space come first */
   std::map<int64_t, std::unordered_set<page_id_t>> Pages;
+  std::unordered_map<page_id_t, FsmEntry> fsm_entries_;
+  /** (map page, slot) of the read map entries dropped by VACUUM, taken by the next pages registered */
+  std::vector<std::pair<page_id_t, uint32_t>> fsm_free_slots_;
+  /** insertion target, stays pinned across consecutive inserts while hold_insert_page_ is set */
+  TablePage *insert_page_{nullptr};
+  bool hold_insert_page_{false};
+  uint32_t scan_workers_{std::max(1u, std::thread::hardware_concurrency())};
+  /** set for a heap of column pages, which are handled as TablePage * and cast where their formats differ */
+  std::optional<ColumnPageLayout> column_layout_;
+  ZoneMap zone_map_;
+  std::vector<uint32_t> cluster_key_;
+  /** key ranges of the pages of a clustered heap, valid once directory_loaded_ is set */
+  bool directory_loaded_{false};
+  ClusterDirectory directory_;
+  /** set if a column of the heap may have chars stored out of line */
+  bool may_overflow_;
+
+  /**
+   * @return true if a column of schema may have chars stored out of line
+   */
+  static bool can_overflow(const Schema *schema, TableLayout layout, const std::vector<uint32_t> &cluster_key);
+
+  /**
+   * @return true if column may have chars stored out of line
+   */
+  bool is_overflow_column(uint32_t column) const;
+
+  bool insert_row(Row &row, Transaction *txn, const MoveCallback &moved);
+
+  /**
+   * Unpin the insertion target and write its free space back to the free space map
+   */
+  void unpin_insert_page();
+
+  /**
+   * Write the long chars of row to overflow chains and let the row refer to them
+   */
+  void store_overflow(Row &row);
+
+  /**
+   * Free the overflow chains row refers to
+   */
+  void free_overflow(const Row &row);
+
+  /**
+   * Append the overflow chains of the tuple in slot to chains, its delete may be applied or not
+   */
+  void collect_overflow(TablePage *page, uint32_t slot, std::vector<page_id_t> &chains);
+
+  /**
+   * @return first page of a new overflow chain holding the size chars of data
+   */
+  page_id_t write_chain(const char *data, uint32_t size);
+
+  std::string read_chain(const OverflowRef &ref);
+
+  void free_chain(page_id_t page_id);
+
+  /**
+   * Add the tuples of page whose chars of the predicate's column are stored out of line and match to rids
+   */
+  void filter_overflow(TablePage *page, const ScanPredicate &predicate, std::vector<RowId> &rids);
+
+  /**
+   * Read the whole free space map
+   */
+  void load_free_space_map();
+
+  /**
+   * Read the next page of the free space map, or build the map of a heap that has none
+   * @return false if the whole map was read already
+   */
+  bool load_fsm_page();
+
+  void build_free_space_map();
+
+  /**
+   * @param tail page is the last one of the chain
+   */
+  void register_page(TablePage *page, bool tail = true);
+
+  /**
+   * Add the entry of page_id to the last map page, chaining a new one behind it if it is full
+   */
+  void append_fsm_entry(page_id_t page_id, uint32_t bucket);
+
+  /**
+   * Link a new page into the chain behind prev_id, or make it the first page if prev_id is invalid
+   * @return the new page, pinned
+   */
+  TablePage *new_page_after(page_id_t prev_id, Transaction *txn);
+
+  void load_directory();
+
+  bool insert_clustered(Row &row, Transaction *txn, const MoveCallback &moved);
+
+  /**
+   * Move the upper part of the key range of a full page to a new page behind it, to make room for key
+   * @return false if the page cannot be split
+   */
+  bool split_page(page_id_t page_id, const ClusterKey &key, Transaction *txn, const MoveCallback &moved);
+
+  uint32_t vacuum_clustered(Transaction *txn, const MoveCallback &moved);
+
+  /**
+   * Move the tuples at rids from page to target, false if one does not fit
+   */
+  bool move_tuples(TablePage *page, const std::vector<RowId> &rids, TablePage *target, Transaction *txn,
+                   const MoveCallback &moved);
+
+  void update_free_space(TablePage *page);
+
+  inline ColumnPage *as_column_page(Page *page) const { return reinterpret_cast<ColumnPage *>(page); }
+
+  void init_page(TablePage *page, page_id_t page_id, page_id_t prev_id, Transaction *txn);
+
+  bool insert_into(TablePage *page, Row &row, Transaction *txn);
+
+  /**
+   * Read the tuple whose rid is wrapped in row from page, false if it is not visible
+   */
+  bool read_tuple(TablePage *page, Row *row, Transaction *txn);
+
+  /**
+   * read_tuple, with the chars stored out of line read into the fields while their references stay,
+   * so that the row is written to another page as it was and the zone map sees its real values
+   */
+  bool read_moved_tuple(TablePage *page, Row *row, Transaction *txn);
+
+  /**
+   * Fill the zones of a page that has none yet from its visible tuples
+   */
+  void summarize_page(TablePage *page);
+
+  /**
+   * @return minus the free space of page, like TablePage::GetRemain
+   */
+  int64_t remain_of(TablePage *page);
+
+  /**
+   * @return free space of an empty page
+   */
+  uint32_t page_room() const;
+
+  /**
+   * @return true if no tuple is stored in page, not even one whose delete is not applied yet
+   */
+  bool is_empty(TablePage *page);
+
+  /**
+   * Unlink an empty page from the chain and the free space map and delete it
+   */
+  void free_page(page_id_t page_id);
+
+  /**
+   * Call visit on every heap page from up to scan_workers_ workers of the shared WorkerPool, each worker claims
+   * a morsel of pages at a time and collects row ids into its own buffer, the buffers are merged into ans_set
+   * at the end.
+   * Pages the zone map rules out predicate for are not fetched, pages read without a summary get one.
+   * @param candidates pages to scan, every heap page if nullptr
+   */
+  void scan_pages(std::unordered_set<RowId> &ans_set,
+                  const std::function<void(TablePage *, std::vector<RowId> &)> &visit,
+                  const ScanPredicate *predicate = nullptr, const std::vector<page_id_t> *candidates = nullptr);
+
+  /**
+   * @return the pages of candidates, every heap page in page id order if nullptr, that the zone map
+   *   does not rule out predicate for
+   */
+  std::vector<page_id_t> scan_candidates(const ScanPredicate *predicate, const std::vector<page_id_t> *candidates);
+
+  /**
+   * @return the heap pages in chain order, read off the pages themselves
+   */
+  std::vector<page_id_t> chain_page_ids();
+
+  /**
+   * Add the tuples of page that satisfy predicate to rids
+   */
+  void filter_page(TablePage *page, const ScanPredicate &predicate, std::vector<RowId> &rids);
+
+  void erase_page(page_id_t page_id, uint32_t bucket) {
+    auto key = int64_t(0) - bucket;
+    Pages[key].erase(page_id);
+    if (Pages[key].size() == 0) Pages.erase(key);
+  }
 
-  void erase_page(TablePage *page) {
-    auto rem = page->GetRemain();
-    Pages[rem].erase(page->GetTablePageId());
-    if (Pages[rem].size() == 0) Pages.erase(rem);
+  void notify_root() const {
+    if (root_changed_) root_changed_(this);
   }
 
+  RootCallback root_changed_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
 };
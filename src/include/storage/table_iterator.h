@@ -1,84 +1,109 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include <functional>
+#include <optional>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "common/rowid.h"
 #include "record/row.h"
 #include "transaction/transaction.h"
-#include <map>
 
+class ColumnPageLayout;
 class TableHeap;
 class TablePage;
 
+/**
+ * Forward iterator over the rows of a table heap.
+ *
+ * The page of the current row stays pinned until the iterator moves past it,
+ * and every row is read into the same row buffer, so a reference to *it is
+ * only valid until the next increment. The chars a row keeps out of line are read
+ * for the projected columns only, the others are left as references.
+ *
+ * An iterator may also visit a list of pages instead of the whole page chain,
+ * then only the rows a filter selects from each page are read.
+ */
 class TableIterator {
  public:
-  // you may define your own constructor based on your member variables
+  /**
+   * Append the ids of the rows to read from a pinned page
+   */
+  using PageFilter = std::function<void(TablePage *page, std::vector<RowId> &rids)>;
+
+  /**
+   * End iterator
+   */
   explicit TableIterator();
 
-  explicit TableIterator(BufferPoolManager *_bpm, TablePage *_tp, Schema *_s, const RowId &rid);
+  /**
+   * Iterator on the first row stored in page_id or in one of the pages chained after it
+   * @param columns the columns read out of line, every column if nullptr
+   */
+  explicit TableIterator(TableHeap *table_heap, page_id_t page_id, const std::vector<uint32_t> *columns = nullptr);
 
-  explicit TableIterator(BufferPoolManager *_bpm, TablePage *_tp, Schema *_s);
+  /**
+   * Iterator on the rows select picks from pages, visited in the order given
+   */
+  explicit TableIterator(TableHeap *table_heap, std::vector<page_id_t> pages, PageFilter select,
+                         const std::vector<uint32_t> *columns = nullptr);
 
   TableIterator(const TableIterator &other);
 
   virtual ~TableIterator();
 
-  inline bool operator==(const TableIterator &itr) const;
+  inline bool operator==(const TableIterator &itr) const { return row_.GetRowId() == itr.row_.GetRowId(); }
 
-  inline bool operator!=(const TableIterator &itr) const;
+  inline bool operator!=(const TableIterator &itr) const { return !(*this == itr); }
 
-  const Row &operator*();
+  inline const Row &operator*() const { return row_; }
 
-  Row *operator->();
+  inline Row *operator->() { return &row_; }
 
   TableIterator &operator++();
 
   TableIterator operator++(int);
 
-  static Row* INVALID_ROW;
-
  private:
-  // add your own private member variables here
-
-  static std::map<Row *, uint32_t> ptr_refs;
-
-
-
-  BufferPoolManager *ThisManager;
-  TablePage *ThisPage;
-  Schema *ThisSchema;
-  Row *ThisRow = nullptr;
-
-  Row *alloc_row(const RowId &rid) {
-    Row *row = new Row(rid);
-    ptr_refs.insert(std::make_pair(row, 1));
-    return row;
-  }
-
-  void destroy_row(Row *ptr) {
-    if (ptr == nullptr || ptr == INVALID_ROW) return;
-
-    ASSERT(ptr_refs.count(ptr) != 0, "TableIterator::destroy_row: Invalid ptr");
-    --ptr_refs[ptr];
-    if (ptr_refs[ptr] == 0) {
-      delete ptr;
-      ptr_refs.erase(ptr);
-    }
-  }
-
-  Row *copy_row(Row *ptr) {
-    if (ptr && ptr != INVALID_ROW) {
-      ASSERT(ptr_refs.count(ptr) != 0, "TableIterator::copy_row: Invalid ptr");
-      ++ptr_refs[ptr];
-    }
-
-    return ptr;
-  }
+  TableIterator &operator=(const TableIterator &other) = delete;
+
+  /**
+   * Unpin the current page and move to the first row of page_id or of the pages after it
+   */
+  void seek_page(page_id_t page_id);
+
+  /**
+   * @return page after the current one, the next one of the list if there is a list
+   */
+  page_id_t next_page_id();
+
+  bool first_rid(RowId *rid);
+
+  bool next_rid(const RowId &cur_rid, RowId *rid);
+
+  /**
+   * Read the row whose id is in row_ from the current page
+   */
+  void read_row();
+
+  TableHeap *table_heap_{nullptr};
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  Schema *schema_{nullptr};
+  /** set if the heap is made of column pages, page_ is one of those then */
+  const ColumnPageLayout *column_layout_{nullptr};
+  /** page of the current row, pinned, nullptr at the end */
+  TablePage *page_{nullptr};
+  /** pages left to visit and the rows picked from the current one, for an iterator over a list of pages */
+  std::optional<std::vector<page_id_t>> pages_;
+  size_t next_page_{0};
+  PageFilter select_;
+  std::vector<RowId> selected_;
+  size_t next_selected_{0};
+  /** projected columns, unset for all of them */
+  std::optional<std::vector<uint32_t>> columns_;
+  /** row buffer, read into again at every step */
+  Row row_{INVALID_ROWID};
 };
 
-
-
-
-
-
 #endif  // MINISQL_TABLE_ITERATOR_H
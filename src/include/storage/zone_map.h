@@ -0,0 +1,80 @@
+#ifndef MINISQL_ZONE_MAP_H
+#define MINISQL_ZONE_MAP_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "record/column_zone.h"
+#include "record/row.h"
+#include "record/scan_predicate.h"
+
+/**
+ * Zone map of a table heap: for every page the ColumnZone of each column,
+ * so a predicate scan passes over the pages that cannot hold a match
+ * without fetching them. For data appended in the order of a column, a
+ * range on that column is answered from a handful of pages.
+ *
+ * The map lives in memory only. Pages the heap creates are summarized from
+ * their first insert on, the pages of a heap read from disk are summarized
+ * the first time a scan reads them. A page without a summary is always read.
+ * Summaries cover the visible tuples of a page: the heap adds a tuple when it
+ * is inserted or its delete is rolled back, and removes it when it is marked
+ * deleted or its insert is undone.
+ */
+class ZoneMap {
+public:
+  explicit ZoneMap(uint32_t column_count) : column_count_(column_count) {}
+
+  /**
+   * Make room for the zones of page_id
+   * @param summarized the page holds no tuple yet, its zones are exact from now on
+   */
+  void Track(page_id_t page_id, bool summarized);
+
+  inline bool IsTracked(page_id_t page_id) const { return entries_.count(page_id) > 0; }
+
+  inline bool IsSummarized(page_id_t page_id) const {
+    auto it = entries_.find(page_id);
+    return it != entries_.end() && summarized_[it->second];
+  }
+
+  /**
+   * Zones of the columns of a tracked page, for whoever summarizes it. Pages are
+   * only tracked while no scan runs, so scan workers may each fill their own pages.
+   */
+  inline ColumnZone *GetZones(page_id_t page_id) { return &zones_[entries_.at(page_id) * column_count_]; }
+
+  inline void SetSummarized(page_id_t page_id) { summarized_[entries_.at(page_id)] = 1; }
+
+  /**
+   * Account for a tuple that became visible on page_id, nothing happens to a page not summarized
+   */
+  void Insert(page_id_t page_id, const Row &row);
+
+  void Remove(page_id_t page_id, const Row &row);
+
+  /**
+   * @return false if the zone of page_id rules out predicate
+   */
+  bool MayMatch(page_id_t page_id, const ScanPredicate &predicate) const;
+
+  /**
+   * Drop the zones of a page that left the heap
+   */
+  void Forget(page_id_t page_id);
+
+  void Clear();
+
+private:
+  uint32_t column_count_;
+  /** page id -> number of its entry, the zones of entry e are [e * column_count_, (e + 1) * column_count_) */
+  std::unordered_map<page_id_t, uint32_t> entries_;
+  /** entry -> page id, to move the last entry into the place of a forgotten one */
+  std::vector<page_id_t> pages_;
+  /** not a vector<bool>, workers set the flags of different pages at once */
+  std::vector<uint8_t> summarized_;
+  std::vector<ColumnZone> zones_;
+};
+
+#endif  // MINISQL_ZONE_MAP_H
@@ -1,10 +1,14 @@
 #ifndef MINISQL_MEM_HEAP_H
 #define MINISQL_MEM_HEAP_H
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <unordered_set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "common/macros.h"
 using raw_ptr = int64_t;
 #define RAW(ptr) (reinterpret_cast<raw_ptr>(ptr))
@@ -111,4 +115,59 @@ class SimpleMemHeap : public MemHeap {
   std::unordered_map<void *, size_t> allocated_;
 };
 
+/**
+ * Bump pointer heap for objects that all die together, e.g. those built while running one statement.
+ *
+ * Memory is carved out of chunks of chunk_size bytes, a request larger than a chunk gets a chunk of its own.
+ * Free does nothing, everything is handed back at once by Reset or when the heap is destroyed. Destructors
+ * of the objects placed in the heap are not run by it.
+ */
+#define ARENA_CHUNK_SIZE (16 * 1024)
+#define ARENA_ALIGNMENT alignof(std::max_align_t)
+
+class ArenaMemHeap : public MemHeap {
+ public:
+  explicit ArenaMemHeap(size_t chunk_size = ARENA_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  ~ArenaMemHeap() override {
+    for (auto &chunk : chunks_) free(chunk.first);
+  }
+
+  void *Allocate(size_t size) override {
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    if (size > static_cast<size_t>(end_ - cur_)) NewChunk(size);
+    void *buf = cur_;
+    cur_ += size;
+    return buf;
+  }
+
+  void Free(void *ptr) override {}
+
+  /**
+   * Hand back everything allocated so far, the first chunk is kept for what comes next
+   */
+  void Reset() {
+    if (chunks_.empty()) return;
+    for (size_t i = 1; i < chunks_.size(); i++) free(chunks_[i].first);
+    chunks_.resize(1);
+    cur_ = chunks_[0].first;
+    end_ = cur_ + chunks_[0].second;
+  }
+
+ private:
+  void NewChunk(size_t size) {
+    size_t chunk_size = std::max(size, chunk_size_);
+    char *chunk = static_cast<char *>(malloc(chunk_size));
+    ASSERT(chunk != nullptr, "Out of memory exception");
+    chunks_.emplace_back(chunk, chunk_size);
+    cur_ = chunk;
+    end_ = chunk + chunk_size;
+  }
+
+  size_t chunk_size_;
+  std::vector<std::pair<char *, size_t>> chunks_;
+  char *cur_{nullptr};
+  char *end_{nullptr};
+};
+
 #endif  // MINISQL_MEM_HEAP_H
@@ -21,24 +21,28 @@ BPLUSTREE_TYPE::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_ma
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size) {
+  // pick up the root of an index that already exists on disk
+  auto page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  if (page != nullptr) {
+    auto index_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+    if (!index_page->GetRootId(index_id_, &root_page_id_)) root_page_id_ = INVALID_PAGE_ID;
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Destroy(BPlusTreePage *node) {
-  if (node->IsLeafPage()) {
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
-    buffer_pool_manager_->DeletePage(node->GetPageId());
-    return;
-  } else {
-    BPlusTreePage *target;
+  if (!node->IsLeafPage()) {
     for (int i = 0; i < node->GetSize(); i++) {
       auto next_page_id = reinterpret_cast<InternalPage *>(node)->ValueAt(i);
-      target = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(next_page_id)->GetData());
-      Destroy(target);
-      buffer_pool_manager_->UnpinPage(next_page_id, false);
-      buffer_pool_manager_->DeletePage(next_page_id);
+      Destroy(reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(next_page_id)->GetData()));
     }
   }
+  // every node is deleted once, by the call it was fetched for
+  auto page_id = node->GetPageId();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  buffer_pool_manager_->DeletePage(page_id);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -46,6 +50,8 @@ void BPLUSTREE_TYPE::Destroy() {
   if (IsEmpty()) return;
   auto root_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
   Destroy(root_page);
+  root_page_id_ = INVALID_PAGE_ID;
+  UpdateRootPageId();
 }
 
 /*
@@ -57,24 +63,33 @@ bool BPLUSTREE_TYPE::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID;
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::RangeScan(const KeyType &key, std::unordered_set<ValueType> &ans_set, bool to_left,
                                bool key_included) {
-  auto leaf = FindLeafPage(key);
-  ASSERT(leaf != nullptr, "Invalid Fetch");
-  auto target_leaf = TO_TYPE(LeafPage *, leaf->GetData());
-  target_leaf->FetchValues(key, to_left, key_included, ans_set, comparator_);
-  auto id = target_leaf->GetNextPageId();
-  LeafPage *leafPage = nullptr;
-  if (to_left) {
-    leafPage = TO_TYPE(LeafPage *, FindLeafPage(key, true)->GetData());
-    ASSERT(leafPage != nullptr, "Invalid Fetch");
+  if (IsEmpty()) return;
+  // the leaves are linked from left to right, a range to the left of the key starts at the leftmost one
+  auto page = FindLeafPage(key, to_left);
+  while (page != nullptr) {
+    auto leaf = TO_TYPE(LeafPage *, page->GetData());
+    leaf->FetchValues(key, to_left, key_included, ans_set, comparator_);
+    auto id = leaf->GetNextPageId();
+    // the leaves after one ending with a greater key hold only greater keys
+    bool done = to_left && leaf->GetSize() > 0 && comparator_(leaf->KeyAt(leaf->GetSize() - 1), key) > 0;
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    page = done || id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(id);
+    ASSERT(done || id == INVALID_PAGE_ID || page != nullptr, "Invalid Fetch");
+  }
+}
 
-  } else {
-    while (id != INVALID_PAGE_ID) {
-      leafPage = TO_TYPE(LeafPage *, buffer_pool_manager_->FetchPage(id)->GetData());
-      ASSERT(leafPage != nullptr, "Invalid Fetch");
-      leafPage->FetchAllValues(ans_set);
-      id = leafPage->GetNextPageId();
-      buffer_pool_manager_->UnpinPage(leafPage->GetPageId(), false);
-    }
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ScanInOrder(std::vector<ValueType> &result, size_t limit) {
+  if (IsEmpty() || limit == 0) return;
+  auto page = FindLeafPage(KeyType{}, true);
+  size_t found = 0;
+  while (page != nullptr) {
+    auto leaf = TO_TYPE(LeafPage *, page->GetData());
+    for (int i = 0; i < leaf->GetSize() && found < limit; i++, found++) result.push_back(leaf->GetItem(i).second);
+    auto id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    page = found == limit || id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(id);
+    ASSERT(found == limit || id == INVALID_PAGE_ID || page != nullptr, "Invalid Fetch");
   }
 }
 
@@ -132,6 +147,72 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   } else
     return InsertIntoLeaf(key, value, transaction);
 }
+/*
+ * Leaves are filled from left to right and chained, then each level of
+ * internal pages is built over the first keys of the level below until a
+ * single root remains. Entries are spread evenly over the pages of a level
+ * so no page ends up below its minimum size.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &items) {
+  if (!IsEmpty()) return false;
+  if (items.empty()) return true;
+
+  // size of the i-th of n pages sharing total entries
+  auto chunk_size = [](size_t total, size_t n, size_t i) { return total / n + (i < total % n ? 1 : 0); };
+
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  size_t n_pages = (items.size() + leaf_max_size_ - 1) / leaf_max_size_;
+  LeafPage *prev_leaf = nullptr;
+  for (size_t i = 0, offset = 0; i < n_pages; i++) {
+    auto page_id = INVALID_PAGE_ID;
+    auto page = buffer_pool_manager_->NewPage(page_id);
+    if (page == nullptr) {
+      LOG(ERROR) << "Null Page";
+      throw std::bad_alloc();
+    }
+    auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    auto size = chunk_size(items.size(), n_pages, i);
+    leaf->AppendSorted(&items[offset], size);
+    level.emplace_back(items[offset].first, page_id);
+    offset += size;
+    if (prev_leaf != nullptr) {
+      prev_leaf->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+    prev_leaf = leaf;
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> upper;
+    n_pages = (level.size() + internal_max_size_ - 1) / internal_max_size_;
+    for (size_t i = 0, offset = 0; i < n_pages; i++) {
+      auto page_id = INVALID_PAGE_ID;
+      auto page = buffer_pool_manager_->NewPage(page_id);
+      if (page == nullptr) {
+        LOG(ERROR) << "Null Page";
+        throw std::bad_alloc();
+      }
+      auto node = reinterpret_cast<InternalPage *>(page->GetData());
+      node->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+      auto size = chunk_size(level.size(), n_pages, i);
+      for (size_t j = offset; j < offset + size; j++) {
+        node->AppendChild(level[j].first, level[j].second, buffer_pool_manager_);
+      }
+      upper.emplace_back(level[offset].first, page_id);
+      offset += size;
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    }
+    level.swap(upper);
+  }
+
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(true);
+  return true;
+}
+
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -587,11 +668,13 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
-  auto page = buffer_pool_manager_->FetchPage(0);
+  auto page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
   ASSERT(page != nullptr, "BPLUSTREE_TYPE::UpdateRootPageId : Invalid Root Index Id");
   auto index_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
   if (insert_record) {
-    ASSERT(index_page->Insert(index_id_, root_page_id_), "BPLUSTREE_TYPE::UpdateRootPageId : Insert Failed");
+    // the record survives a Destroy(), reuse it for the new tree
+    [[maybe_unused]] bool inserted = index_page->Insert(index_id_, root_page_id_) || index_page->Update(index_id_, root_page_id_);
+    ASSERT(inserted, "BPLUSTREE_TYPE::UpdateRootPageId : Insert Failed");
   } else {
     ASSERT(index_page->Update(index_id_, root_page_id_), "BPLUSTREE_TYPE::UpdateRootPageId : Update Failed");
   }
@@ -775,6 +858,8 @@ void BPlusTree<KeyType, ValueType, KeyComparator>::printOut(bool All) {
 
 template class BPlusTree<int, int, BasicComparator<int>>;
 
+template class BPlusTree<float, int, BasicComparator<float>>;
+
 template class BPlusTree<GenericKey<4>, RowId, GenericComparator<4>>;
 
 template class BPlusTree<GenericKey<8>, RowId, GenericComparator<8>>;
@@ -1,4 +1,7 @@
 #include "index/b_plus_tree_index.h"
+
+#include <algorithm>
+
 #include "index/generic_key.h"
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -49,6 +52,48 @@ dberr_t BPLUSTREE_INDEX_TYPE::ScanKey(const Row &key, std::unordered_set<RowId>
   return DB_KEY_NOT_FOUND;
 }
 
+/*
+ * Keys are sorted first: an empty tree is then built bottom-up, otherwise
+ * they go in one by one in key order, which keeps the tree descents cache
+ * friendly.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::BulkLoad(const std::deque<Row> &keys, const std::vector<RowId> &row_ids,
+                                       Transaction *txn) {
+  ASSERT(keys.size() == row_ids.size(), "BPLUSTREE_INDEX_TYPE::BulkLoad : Keys And Row Ids Unmatched");
+  // sort on the fields of the rows, comparing serialized keys would deserialize them on every call
+  auto compare = [](const Row &lhs, const Row &rhs) {
+    for (size_t i = 0; i < lhs.GetFieldCount(); i++) {
+      if (lhs.GetField(i)->CompareLessThan(*rhs.GetField(i)) == CmpBool::kTrue) return -1;
+      if (lhs.GetField(i)->CompareGreaterThan(*rhs.GetField(i)) == CmpBool::kTrue) return 1;
+    }
+    return 0;
+  };
+  std::vector<uint32_t> order(keys.size());
+  for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return compare(keys[a], keys[b]) < 0; });
+  for (size_t i = 1; i < order.size(); i++) {
+    if (compare(keys[order[i - 1]], keys[order[i]]) == 0) return DB_FAILED;
+  }
+  std::vector<MappingType> entries(keys.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    entries[i].first.SerializeFromKey(keys[order[i]], key_schema_);
+    entries[i].second = row_ids[order[i]];
+  }
+
+  if (container_.IsEmpty()) {
+    return container_.BulkLoad(entries) ? DB_SUCCESS : DB_FAILED;
+  }
+  std::vector<RowId> result;
+  for (auto &entry : entries) {
+    if (container_.GetValue(entry.first, result, txn)) return DB_FAILED;
+  }
+  for (auto &entry : entries) {
+    container_.Insert(entry.first, entry.second, txn);
+  }
+  return DB_SUCCESS;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::RangeScanKey(const Row &key, std::unordered_set<RowId> &ans_set, bool left,
                                         bool key_included) {
@@ -57,6 +102,11 @@ void BPLUSTREE_INDEX_TYPE::RangeScanKey(const Row &key, std::unordered_set<RowId
   container_.RangeScan(index_key, ans_set, left, key_included);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanInOrder(std::vector<RowId> &result, size_t limit) {
+  container_.ScanInOrder(result, limit);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::Destroy() {
   container_.Destroy();
@@ -0,0 +1,169 @@
+#include "index/bloom_filter.h"
+
+#include <algorithm>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/overflow_page.h"
+
+/** ln 2 * BLOOM_FILTER_BITS_PER_KEY probes give the fewest false positives once the filter is full */
+static constexpr uint32_t BLOOM_FILTER_NUM_HASHES = 7;
+
+/*
+ * FNV-1a over the key bytes. The two halves are used for double hashing:
+ * probe i hits bit (h1 + i * h2) mod num_bits_.
+ */
+uint64_t BloomFilter::Hash(const char *key, uint32_t len) {
+  uint64_t h = 14695981039346656037ULL;
+  for (uint32_t i = 0; i < len; i++) {
+    h ^= static_cast<uint8_t>(key[i]);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+void BloomFilter::InsertHash(uint64_t hash) {
+  uint32_t h1 = static_cast<uint32_t>(hash), h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  for (uint32_t i = 0; i < num_hashes_; i++) {
+    uint32_t bit = (h1 + i * h2) & (num_bits_ - 1);
+    bits_[bit >> 3] |= static_cast<uint8_t>(1 << (bit & 7));
+  }
+  num_keys_++;
+}
+
+bool BloomFilter::MayContain(const char *key, uint32_t len) const {
+  uint64_t h = Hash(key, len);
+  uint32_t h1 = static_cast<uint32_t>(h), h2 = static_cast<uint32_t>(h >> 32) | 1;
+  for (uint32_t i = 0; i < num_hashes_; i++) {
+    uint32_t bit = (h1 + i * h2) & (num_bits_ - 1);
+    if ((bits_[bit >> 3] & (1 << (bit & 7))) == 0) return false;
+  }
+  return true;
+}
+
+void BloomFilter::Clear() {
+  num_keys_ = 0;
+  memset(bits_, 0, num_bits_ / 8);
+}
+
+void BloomFilter::Reset(uint32_t expected_keys) {
+  uint64_t wanted = static_cast<uint64_t>(std::max<uint32_t>(expected_keys, BLOOM_FILTER_MIN_KEYS)) *
+                    BLOOM_FILTER_BITS_PER_KEY;
+  uint32_t num_bits = 1;
+  while (num_bits < wanted && num_bits < (1u << 31)) num_bits <<= 1;
+  if (num_bits != num_bits_) {
+    if (bits_ != nullptr) heap_->Free(bits_);
+    num_bits_ = num_bits;
+    bits_ = reinterpret_cast<uint8_t *>(heap_->Allocate(num_bits_ / 8));
+  }
+  num_hashes_ = BLOOM_FILTER_NUM_HASHES;
+  Clear();
+}
+
+uint32_t BloomFilter::SerializeTo(char *buf, BufferPoolManager *buffer_pool_manager) {
+  // write the bits over the old chain, growing it or dropping its tail as needed
+  uint32_t size = num_bits_ / 8, offset = 0;
+  page_id_t page_id = bits_page_id_;
+  OverflowPage *prev = nullptr;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  while (offset < size) {
+    bool fresh = page_id == INVALID_PAGE_ID;
+    Page *page = fresh ? buffer_pool_manager->NewPage(page_id) : buffer_pool_manager->FetchPage(page_id);
+    ASSERT(page != nullptr, "BloomFilter::SerializeTo : Out of pages");
+    auto overflow_page = reinterpret_cast<OverflowPage *>(page->GetData());
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    if (fresh) {
+      overflow_page->Init();
+    } else {
+      next_page_id = overflow_page->GetNextPageId();
+    }
+    if (prev == nullptr) {
+      bits_page_id_ = page_id;
+    } else {
+      prev->SetNextPageId(page_id);
+      buffer_pool_manager->UnpinPage(prev_page_id, true);
+    }
+    offset += overflow_page->Write(reinterpret_cast<char *>(bits_) + offset, size - offset);
+    prev = overflow_page;
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  prev->SetNextPageId(INVALID_PAGE_ID);
+  buffer_pool_manager->UnpinPage(prev_page_id, true);
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager->FetchPage(page_id);
+    page_id_t next_page_id = reinterpret_cast<OverflowPage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    buffer_pool_manager->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+
+  uint32_t ser_size = 0;
+
+  MACH_WRITE_UINT32(buf, BLOOM_FILTER_MAGIC_NUM);
+  MOVE_FORWARD(buf, ser_size, uint32_t);
+
+  MACH_WRITE_UINT32(buf, 1);
+  MOVE_FORWARD(buf, ser_size, uint32_t);
+
+  MACH_WRITE_UINT32(buf, num_hashes_);
+  MOVE_FORWARD(buf, ser_size, uint32_t);
+
+  MACH_WRITE_UINT32(buf, num_keys_);
+  MOVE_FORWARD(buf, ser_size, uint32_t);
+
+  MACH_WRITE_UINT32(buf, num_bits_);
+  MOVE_FORWARD(buf, ser_size, uint32_t);
+
+  MACH_WRITE_TO(page_id_t, buf, bits_page_id_);
+  MOVE_FORWARD(buf, ser_size, page_id_t);
+
+  return ser_size;
+}
+
+uint32_t BloomFilter::DeserializeFrom(char *buf, BufferPoolManager *buffer_pool_manager) {
+  ASSERT(buf != nullptr, "BloomFilter::DeserializeFrom : Null buf");
+  uint32_t ser_cnt = 0;
+
+  // meta pages written before filters were persisted have nothing here
+  if (MACH_READ_UINT32(buf) != BLOOM_FILTER_MAGIC_NUM) return 0;
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  bool closed = MACH_READ_UINT32(buf) != 0;
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  uint32_t num_hashes = MACH_READ_UINT32(buf);
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  uint32_t num_keys = MACH_READ_UINT32(buf);
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  uint32_t num_bits = MACH_READ_UINT32(buf);
+  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+
+  bits_page_id_ = MACH_READ_FROM(page_id_t, buf);
+  MOVE_FORWARD(buf, ser_cnt, page_id_t);
+
+  if (!closed) return 0;
+  Reset(num_bits / BLOOM_FILTER_BITS_PER_KEY);
+  ASSERT(num_bits_ == num_bits, "BloomFilter::DeserializeFrom : Bad bit count");
+  num_hashes_ = num_hashes;
+  num_keys_ = num_keys;
+  uint32_t size = num_bits_ / 8, offset = 0;
+  for (page_id_t page_id = bits_page_id_; page_id != INVALID_PAGE_ID && offset < size;) {
+    Page *page = buffer_pool_manager->FetchPage(page_id);
+    auto overflow_page = reinterpret_cast<const OverflowPage *>(page->GetData());
+    memcpy(bits_ + offset, overflow_page->GetChars(), overflow_page->GetSize());
+    offset += overflow_page->GetSize();
+    page_id_t next_page_id = overflow_page->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT(offset == size, "BloomFilter::DeserializeFrom : Short bit chain");
+
+  return ser_cnt;
+}
+
+void BloomFilter::MarkOpen(char *buf) {
+  if (MACH_READ_UINT32(buf) != BLOOM_FILTER_MAGIC_NUM) return;
+  MACH_WRITE_UINT32(buf + sizeof(uint32_t), 0);
+}
@@ -85,6 +85,8 @@ bool INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const { return !(*
 
 template class IndexIterator<int, int, BasicComparator<int>>;
 
+template class IndexIterator<float, int, BasicComparator<float>>;
+
 template class IndexIterator<GenericKey<4>, RowId, GenericComparator<4>>;
 
 template class IndexIterator<GenericKey<8>, RowId, GenericComparator<8>>;
@@ -0,0 +1,178 @@
+#include "index/simd_search.h"
+
+#include <cstring>
+
+#include "common/cpu_features.h"
+
+namespace simd {
+
+namespace {
+
+/**
+ * Below this many keys the remaining range is scanned with vector compares
+ * instead of being halved further. 32 int keys are 2 cache lines when stored
+ * interleaved with 4 byte values.
+ */
+constexpr int kLinearWindow = 32;
+
+template <typename T>
+using CountLessFunc = int (*)(const char *keys, int len, int stride, T key);
+
+template <typename T>
+inline T KeyAt(const char *keys, int i, int stride) {
+  T key;
+  memcpy(&key, keys + i * stride, sizeof(T));
+  return key;
+}
+
+template <typename T>
+int CountLessScalar(const char *keys, int len, int stride, T key) {
+  int cnt = 0;
+  for (int i = 0; i < len; i++) cnt += KeyAt<T>(keys, i, stride) < key;
+  return cnt;
+}
+
+#ifdef MINISQL_SIMD_X86
+/*
+ * Keys 4 or 8 bytes apart are loaded a vector at a time, with 8 bytes only the
+ * even lanes hold keys, the odd lanes are values and are masked out of the
+ * movemask result. Keys further apart are gathered.
+ */
+inline int LaneMask(int lanes, int stride) { return stride == 4 ? (1 << lanes) - 1 : (lanes == 8 ? 0x55 : 0x5); }
+
+__attribute__((target("avx2"))) inline __m256i GatherAvx2(const char *keys, int stride) {
+  const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+  return _mm256_i32gather_epi32(reinterpret_cast<const int *>(keys), offsets, 1);
+}
+
+__attribute__((target("avx2"))) int CountLessAvx2(const char *keys, int len, int stride, int32_t key) {
+  const __m256i target = _mm256_set1_epi32(key);
+  int cnt = 0, i = 0;
+  if (stride == 4 || stride == 8) {
+    const int per_vec = 32 / stride, mask = LaneMask(8, stride);
+    for (; i + per_vec <= len; i += per_vec) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * stride));
+      cnt += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target, v))) & mask);
+    }
+  } else {
+    for (; i + 8 <= len; i += 8) {
+      __m256i v = GatherAvx2(keys + i * stride, stride);
+      cnt += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target, v))));
+    }
+  }
+  return cnt + CountLessScalar(keys + i * stride, len - i, stride, key);
+}
+
+__attribute__((target("avx2"))) int CountLessAvx2(const char *keys, int len, int stride, float key) {
+  const __m256 target = _mm256_set1_ps(key);
+  int cnt = 0, i = 0;
+  if (stride == 4 || stride == 8) {
+    const int per_vec = 32 / stride, mask = LaneMask(8, stride);
+    for (; i + per_vec <= len; i += per_vec) {
+      __m256 v = _mm256_loadu_ps(reinterpret_cast<const float *>(keys + i * stride));
+      cnt += __builtin_popcount(_mm256_movemask_ps(_mm256_cmp_ps(v, target, _CMP_LT_OQ)) & mask);
+    }
+  } else {
+    for (; i + 8 <= len; i += 8) {
+      __m256 v = _mm256_castsi256_ps(GatherAvx2(keys + i * stride, stride));
+      cnt += __builtin_popcount(_mm256_movemask_ps(_mm256_cmp_ps(v, target, _CMP_LT_OQ)));
+    }
+  }
+  return cnt + CountLessScalar(keys + i * stride, len - i, stride, key);
+}
+
+/*
+ * SSE2 has no gather, keys further apart are put into a vector one by one.
+ */
+__attribute__((target("sse2"))) inline __m128i LoadSse2(const char *keys, int stride) {
+  if (stride == 4 || stride == 8) return _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys));
+  return _mm_setr_epi32(KeyAt<int32_t>(keys, 0, stride), KeyAt<int32_t>(keys, 1, stride),
+                        KeyAt<int32_t>(keys, 2, stride), KeyAt<int32_t>(keys, 3, stride));
+}
+
+__attribute__((target("sse2"))) int CountLessSse2(const char *keys, int len, int stride, int32_t key) {
+  const __m128i target = _mm_set1_epi32(key);
+  const bool packed = stride == 4 || stride == 8;
+  const int per_vec = packed ? 16 / stride : 4, mask = packed ? LaneMask(4, stride) : 0xF;
+  int cnt = 0, i = 0;
+  for (; i + per_vec <= len; i += per_vec) {
+    __m128i v = LoadSse2(keys + i * stride, stride);
+    cnt += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, target))) & mask);
+  }
+  return cnt + CountLessScalar(keys + i * stride, len - i, stride, key);
+}
+
+__attribute__((target("sse2"))) int CountLessSse2(const char *keys, int len, int stride, float key) {
+  const __m128 target = _mm_set1_ps(key);
+  const bool packed = stride == 4 || stride == 8;
+  const int per_vec = packed ? 16 / stride : 4, mask = packed ? LaneMask(4, stride) : 0xF;
+  int cnt = 0, i = 0;
+  for (; i + per_vec <= len; i += per_vec) {
+    __m128 v = _mm_castsi128_ps(LoadSse2(keys + i * stride, stride));
+    cnt += __builtin_popcount(_mm_movemask_ps(_mm_cmplt_ps(v, target)) & mask);
+  }
+  return cnt + CountLessScalar(keys + i * stride, len - i, stride, key);
+}
+#endif
+
+struct Dispatch {
+  CountLessFunc<int32_t> count_int;
+  CountLessFunc<float> count_float;
+  const char *name;
+
+  Dispatch() : count_int(CountLessScalar<int32_t>), count_float(CountLessScalar<float>), name("scalar") {
+#ifdef MINISQL_SIMD_X86
+    auto &cpu = CpuFeatures::Get();
+    if (cpu.avx2) {
+      count_int = CountLessAvx2;
+      count_float = CountLessAvx2;
+      name = "avx2";
+    } else if (cpu.sse2) {
+      count_int = CountLessSse2;
+      count_float = CountLessSse2;
+      name = "sse2";
+    }
+#endif
+  }
+};
+
+const Dispatch &GetDispatch() {
+  static const Dispatch dispatch;
+  return dispatch;
+}
+
+template <typename T>
+int Search(const char *keys, int n, int stride, T key, CountLessFunc<T> count_less) {
+  int lo = 0, len = n;
+  while (len > kLinearWindow) {
+    int half = len >> 1;
+    if (KeyAt<T>(keys, lo + half, stride) < key) {
+      lo += half + 1;
+      len -= half + 1;
+    } else
+      len = half;
+  }
+  return lo + count_less(keys + lo * stride, len, stride, key);
+}
+
+}  // namespace
+
+int LowerBound(const char *keys, int n, int stride, int32_t key) {
+  return Search(keys, n, stride, key, GetDispatch().count_int);
+}
+
+int LowerBound(const char *keys, int n, int stride, float key) {
+  return Search(keys, n, stride, key, GetDispatch().count_float);
+}
+
+int LowerBound(const int32_t *keys, int n, int stride, int32_t key) {
+  return LowerBound(reinterpret_cast<const char *>(keys), n, stride * 4, key);
+}
+
+int LowerBound(const float *keys, int n, int stride, float key) {
+  return LowerBound(reinterpret_cast<const char *>(keys), n, stride * 4, key);
+}
+
+const char *Implementation() { return GetDispatch().name; }
+
+}  // namespace simd
@@ -91,12 +91,11 @@ int main(int argc, char **argv) {
 
     if (res == DB_SUCCESS)
       printf("\033[1;32m[Succeeded] \033[0m in %llu ms\n",
-             std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+             static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
     else
       printf("\033[1;31m[Failed] \033[0m in %llu ms, code: %d\n",
-             std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(), res);
-
-    sleep(1);
+             static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()),
+             res);
 
     // clean memory after parse
     MinisqlParserFinish();
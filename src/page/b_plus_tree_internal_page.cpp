@@ -1,6 +1,7 @@
 #include "page/b_plus_tree_internal_page.h"
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/simd_search.h"
 
 // THE FIRST KEY IS ALWAYS INVALID
 
@@ -256,6 +257,13 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, Buffe
     buffer_pool_manager->UnpinPage(pair.second, true);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::AppendChild(const KeyType &key, const ValueType &child,
+                                                 BufferPoolManager *buffer_pool_manager) {
+  ASSERT(GetSize() < GetMaxSize(), "B_PLUS_TREE_INTERNAL_PAGE_TYPE::AppendChild : Page Overflow");
+  CopyLastFrom(std::make_pair(key, child), buffer_pool_manager);
+}
+
 /*
  * Remove the last key & value pair from this page to head of "recipient" page.
  * You need to handle the original dummy key properly, e.g. updating recipient’s array to position the middle_key at the
@@ -296,6 +304,13 @@ INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_INTERNAL_PAGE_TYPE::BinarySearchNode(const KeyType &key, const KeyComparator &comparator) const {
   if (GetSize() <= 1)
     return 0;
+  if constexpr (simd::NodeSearchable<KeyType, ValueType, KeyComparator>::value) {
+    // the first key is invalid, search from the second pair on
+    return 1 + simd::LowerBound(&array_[1].first, GetSize() - 1, 2, key);
+  } else if constexpr (simd::GenericSearchable<KeyType, KeyComparator>::value) {
+    int index = simd::GenericLowerBound(&array_[1].first, GetSize() - 1, sizeof(MappingType), key, comparator);
+    if (index >= 0) return 1 + index;
+  }
 //  if(GetSize() == 2) {
 //    return comparator(key, array_[1].first)>=0 ? 1 : 0;
 //  }
@@ -324,6 +339,8 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::BinarySearchNode(const KeyType &key, const K
 
 template class BPlusTreeInternalPage<int, int, BasicComparator<int>>;
 
+template class BPlusTreeInternalPage<float, int, BasicComparator<float>>;
+
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
 
 template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
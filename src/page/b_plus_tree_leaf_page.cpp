@@ -2,6 +2,7 @@
 #include <algorithm>
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/simd_search.h"
 
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
@@ -123,6 +124,14 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
   }
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::AppendSorted(const MappingType *items, int size) {
+  ASSERT(GetSize() + size <= GetMaxSize(), "B_PLUS_TREE_LEAF_PAGE_TYPE::AppendSorted : Page Overflow");
+  for (int i = 0; i < size; i++) {
+    CopyLastFrom(items[i]);
+  }
+}
+
 /*****************************************************************************
  * LOOKUP
  *****************************************************************************/
@@ -154,7 +163,7 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, co
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
   auto del_pos = BinarySearch(key, comparator);
-  if (del_pos < GetSize() && array_[del_pos].first == key) {
+  if (del_pos < GetSize() && comparator(array_[del_pos].first, key) == 0) {
     for (int i = del_pos; i < GetSize() - 1; i++) {
       array_[i] = array_[i + 1];
     }
@@ -233,6 +242,13 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType &item) {
 
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::BinarySearch(const KeyType &key, const KeyComparator &comparator) const {
+  if constexpr (simd::NodeSearchable<KeyType, ValueType, KeyComparator>::value) {
+    // keys are every other 32-bit word of the pair array
+    return simd::LowerBound(&array_[0].first, GetSize(), 2, key);
+  } else if constexpr (simd::GenericSearchable<KeyType, KeyComparator>::value) {
+    int index = simd::GenericLowerBound(&array_[0].first, GetSize(), sizeof(MappingType), key, comparator);
+    if (index >= 0) return index;
+  }
   int left = 0, right = GetSize() - 1;
   while (left <= right) {
     int mid = (left + right) >> 1;
@@ -251,16 +267,13 @@ void BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>::FetchValues(const Key
                                                                         unordered_set<ValueType> &ans_set,
                                                                         const KeyComparator &comparator) {
   auto key_index = BinarySearch(key, comparator);
-  // key index is the first value that v >= key
+  // key index is the first value that v >= key, it is in the range only if it is the key and that is included
+  bool equal = key_index < GetSize() && comparator(key, array_[key_index].first) == 0;
   if (left) {
-    if(key_included && key_index < GetSize() && comparator(key, array_[key_index].first) == 0)
-      ans_set.insert(array_[key_index].second);
-    for(int i=0; i<key_index; i++)
-      ans_set.insert(array_[key_index].second);
+    for (int i = 0; i < key_index; i++) ans_set.insert(array_[i].second);
+    if (equal && key_included) ans_set.insert(array_[key_index].second);
   } else {
-    if (key_included && comparator(key, array_[key_index].first) == 0 && key_index < GetSize())
-      ans_set.insert(array_[key_index].second);
-    for (int i = key_index; i < GetSize(); i++) ans_set.insert(array_[i].second);
+    for (int i = key_index + (equal && !key_included); i < GetSize(); i++) ans_set.insert(array_[i].second);
   }
 }
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -270,6 +283,8 @@ void BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>::FetchAllValues(unorde
 
 template class BPlusTreeLeafPage<int, int, BasicComparator<int>>;
 
+template class BPlusTreeLeafPage<float, int, BasicComparator<float>>;
+
 template class BPlusTreeLeafPage<GenericKey<4>, RowId, GenericComparator<4>>;
 
 template class BPlusTreeLeafPage<GenericKey<8>, RowId, GenericComparator<8>>;
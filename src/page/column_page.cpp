@@ -0,0 +1,194 @@
+#include "page/column_page.h"
+
+#include <algorithm>
+
+static inline uint32_t align8(uint32_t size) { return (size + 7) & ~7u; }
+
+ColumnPageLayout::ColumnPageLayout(Schema *schema) : schema_(schema) {
+  uint32_t column_count = schema->GetColumnCount();
+  widths_.resize(column_count);
+  nulls_offsets_.resize(column_count);
+  values_offsets_.resize(column_count);
+  for (uint32_t i = 0; i < column_count; i++) {
+    const Column *column = schema->GetColumn(i);
+    widths_[i] = column->GetType() == TypeId::kTypeChar ? sizeof(uint16_t) + column->GetLength()
+                                                         : Type::GetTypeSize(column->GetType());
+    tuple_size_ += widths_[i];
+  }
+  if (column_count == 0) return;
+
+  // every tuple costs its values and a null bit per column, start from that and give back what the padding takes
+  uint32_t room = PAGE_SIZE - SIZE_COLUMN_PAGE_HEADER - 2 * COLUMN_PAGE_MAX_WORDS * sizeof(uint64_t);
+  uint32_t capacity = std::min<uint32_t>(COLUMN_PAGE_MAX_TUPLES, room * 8 / (8 * tuple_size_ + column_count));
+  while (capacity > 0 && place(capacity) > PAGE_SIZE) capacity--;
+  capacity_ = capacity;
+  place(capacity_);
+}
+
+uint32_t ColumnPageLayout::place(uint32_t capacity) {
+  uint32_t offset = SIZE_COLUMN_PAGE_HEADER + 2 * COLUMN_PAGE_MAX_WORDS * sizeof(uint64_t);
+  uint32_t null_map_size = (capacity + 63) / 64 * sizeof(uint64_t);
+  for (uint32_t i = 0; i < widths_.size(); i++) {
+    nulls_offsets_[i] = offset;
+    offset += null_map_size;
+    values_offsets_[i] = offset;
+    offset += align8(capacity * widths_[i]);
+  }
+  return offset;
+}
+
+bool ColumnPageLayout::Fits(const Row &row) const {
+  for (uint32_t i = 0; i < widths_.size(); i++) {
+    const Field *field = row.GetField(i);
+    if (schema_->GetColumn(i)->GetType() != TypeId::kTypeChar || field->IsNull()) continue;
+    if (sizeof(uint16_t) + field->GetLength() > widths_[i]) return false;
+  }
+  return true;
+}
+
+void ColumnPage::Init(page_id_t page_id, page_id_t prev_id) {
+  memset(GetData(), 0, PAGE_SIZE);
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetPrevPageId(prev_id);
+  SetNextPageId(INVALID_PAGE_ID);
+}
+
+void ColumnPage::write_tuple(const Row &row, uint32_t slot_num, const ColumnPageLayout &layout) {
+  Schema *schema = layout.GetSchema();
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    const Field *field = row.GetField(i);
+    uint64_t *nulls = reinterpret_cast<uint64_t *>(GetData() + layout.GetNullsOffset(i));
+    char *value = GetData() + layout.GetValuesOffset(i) + slot_num * layout.GetWidth(i);
+    set_bit(nulls, slot_num, field->IsNull());
+    if (field->IsNull()) {
+      ASSERT(schema->GetColumn(i)->IsNullable(), "ColumnPage::write_tuple : Null Value Against Non-null Column");
+      memset(value, 0, layout.GetWidth(i));
+    } else if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar) {
+      MACH_WRITE_TO(uint16_t, value, static_cast<uint16_t>(field->GetLength()));
+      memcpy(value + sizeof(uint16_t), field->GetData(), field->GetLength());
+    } else {
+      field->SerializeTo(value);
+    }
+  }
+}
+
+bool ColumnPage::InsertTuple(Row &row, const ColumnPageLayout &layout) {
+  uint32_t capacity = layout.GetCapacity();
+  uint64_t *live = live_map();
+  uint32_t slot_num = capacity;
+  for (uint32_t w = 0; w * 64 < capacity; w++) {
+    uint64_t free_slots = ~live[w];
+    if (capacity - w * 64 < 64) free_slots &= (uint64_t(1) << (capacity - w * 64)) - 1;
+    if (free_slots != 0) {
+      slot_num = w * 64 + __builtin_ctzll(free_slots);
+      break;
+    }
+  }
+  if (slot_num == capacity) return false;
+
+  write_tuple(row, slot_num, layout);
+  set_bit(live, slot_num, true);
+  if (slot_num >= GetSlotCount()) SetSlotCount(slot_num + 1);
+  SetLiveCount(GetLiveCount() + 1);
+  row.SetRowId(RowId(GetTablePageId(), slot_num));
+  return true;
+}
+
+bool ColumnPage::MarkDelete(const RowId &rid) {
+  if (!is_visible(rid.GetSlotNum())) return false;
+  set_bit(delete_map(), rid.GetSlotNum(), true);
+  return true;
+}
+
+bool ColumnPage::UpdateTuple(const Row &new_row, const RowId &rid, const ColumnPageLayout &layout) {
+  if (!is_visible(rid.GetSlotNum())) return false;
+  write_tuple(new_row, rid.GetSlotNum(), layout);
+  return true;
+}
+
+void ColumnPage::ApplyDelete(const RowId &rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetSlotCount() && test_bit(live_map(), slot_num), "ColumnPage::ApplyDelete : No Such Tuple");
+  set_bit(live_map(), slot_num, false);
+  set_bit(delete_map(), slot_num, false);
+  SetLiveCount(GetLiveCount() - 1);
+  // keep scans from walking over a free tail
+  uint32_t slot_count = GetSlotCount();
+  while (slot_count > 0 && !test_bit(live_map(), slot_count - 1)) slot_count--;
+  SetSlotCount(slot_count);
+}
+
+void ColumnPage::RollbackDelete(const RowId &rid) { set_bit(delete_map(), rid.GetSlotNum(), false); }
+
+Field ColumnPage::GetField(uint32_t slot_num, uint32_t i, const ColumnPageLayout &layout) {
+  TypeId type = layout.GetSchema()->GetColumn(i)->GetType();
+  if (test_bit(GetColumnNulls(i, layout), slot_num)) return Field(type);
+  const char *value = GetColumnValues(i, layout) + slot_num * layout.GetWidth(i);
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, MACH_READ_FROM(int32_t, value));
+    case TypeId::kTypeFloat:
+      return Field(type, MACH_READ_FROM(float, value));
+    default:
+      return Field(type, const_cast<char *>(value) + sizeof(uint16_t), MACH_READ_FROM(uint16_t, value), false);
+  }
+}
+
+bool ColumnPage::GetTuple(Row *row, const ColumnPageLayout &layout) {
+  uint32_t slot_num = row->GetRowId().GetSlotNum();
+  if (!is_visible(slot_num)) return false;
+  std::vector<Field> fields;
+  fields.reserve(layout.GetSchema()->GetColumnCount());
+  for (uint32_t i = 0; i < layout.GetSchema()->GetColumnCount(); i++) fields.push_back(GetField(slot_num, i, layout));
+  row->CopyFields(fields);
+  return true;
+}
+
+void ColumnPage::GetVisibleSlots(uint64_t *visible) {
+  const uint64_t *live = live_map(), *deleted = delete_map();
+  for (uint32_t w = 0; w * 64 < GetSlotCount(); w++) visible[w] = live[w] & ~deleted[w];
+}
+
+void ColumnPage::FilterTuples(const ScanPredicate &predicate, const ColumnPageLayout &layout,
+                              std::vector<RowId> &rids) {
+  uint32_t slot_count = GetSlotCount();
+  if (slot_count == 0) return;
+  uint64_t visible[COLUMN_PAGE_MAX_WORDS], sel[COLUMN_PAGE_MAX_WORDS];
+  GetVisibleSlots(visible);
+  uint32_t i = predicate.GetColumnIndex();
+  predicate.EvaluateColumn(GetColumnValues(i, layout), layout.GetWidth(i), GetColumnNulls(i, layout), slot_count,
+                           sel);
+  page_id_t page_id = GetTablePageId();
+  for (uint32_t w = 0; w * 64 < slot_count; w++) {
+    for (uint64_t bits = sel[w] & visible[w]; bits != 0; bits &= bits - 1) {
+      rids.emplace_back(page_id, w * 64 + __builtin_ctzll(bits));
+    }
+  }
+}
+
+bool ColumnPage::GetFirstTupleRid(RowId *first_rid) {
+  RowId before(GetTablePageId(), 0);
+  if (is_visible(0)) {
+    *first_rid = before;
+    return true;
+  }
+  if (GetNextTupleRid(before, first_rid)) return true;
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+bool ColumnPage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
+  ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  uint32_t slot_count = GetSlotCount();
+  const uint64_t *live = live_map(), *deleted = delete_map();
+  for (uint32_t i = cur_rid.GetSlotNum() + 1; i < slot_count; i = (i / 64 + 1) * 64) {
+    uint64_t bits = (live[i / 64] & ~deleted[i / 64]) >> (i % 64);
+    if (bits != 0) {
+      uint32_t slot_num = i + __builtin_ctzll(bits);
+      if (slot_num >= slot_count) return false;
+      next_rid->Set(GetTablePageId(), slot_num);
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,36 @@
+#include "page/free_space_page.h"
+#include "common/macros.h"
+
+uint32_t FreeSpacePage::Append(page_id_t heap_page_id, uint32_t bucket) {
+  ASSERT(!IsFull(), "FreeSpacePage::Append : Page Full");
+  entries_[count_].heap_page_id = heap_page_id;
+  entries_[count_].bucket = bucket;
+  return count_++;
+}
+
+void FreeSpacePage::Reuse(uint32_t slot, page_id_t heap_page_id, uint32_t bucket) {
+  ASSERT(slot < count_ && entries_[slot].heap_page_id == INVALID_PAGE_ID, "FreeSpacePage::Reuse : Slot In Use");
+  entries_[slot].heap_page_id = heap_page_id;
+  entries_[slot].bucket = bucket;
+}
+
+page_id_t FreeSpacePage::GetHeapPageId(uint32_t slot) const {
+  ASSERT(slot < count_, "FreeSpacePage::GetHeapPageId : Invalid Slot");
+  return entries_[slot].heap_page_id;
+}
+
+uint32_t FreeSpacePage::GetBucket(uint32_t slot) const {
+  ASSERT(slot < count_, "FreeSpacePage::GetBucket : Invalid Slot");
+  return entries_[slot].bucket;
+}
+
+void FreeSpacePage::SetBucket(uint32_t slot, uint32_t bucket) {
+  ASSERT(slot < count_, "FreeSpacePage::SetBucket : Invalid Slot");
+  entries_[slot].bucket = bucket;
+}
+
+void FreeSpacePage::Remove(uint32_t slot) {
+  ASSERT(slot < count_, "FreeSpacePage::Remove : Invalid Slot");
+  entries_[slot].heap_page_id = INVALID_PAGE_ID;
+  entries_[slot].bucket = 0;
+}
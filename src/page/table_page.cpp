@@ -12,10 +12,7 @@ bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn,
                             LockManager *lock_manager, LogManager *log_manager) {
   uint32_t serialized_size = row.GetSerializedSize(schema);
   ASSERT(serialized_size > 0, "Can not have empty row.");
-  if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
-    return false;
-  }
-  // Try to find a free slot to reuse.
+  // Try to find a free slot to reuse, only a new slot takes room in the directory.
   uint32_t i;
   for (i = 0; i < GetTupleCount(); i++) {
     // If the slot is empty, i.e. its tuple has size 0,
@@ -24,13 +21,18 @@ bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn,
       break;
     }
   }
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
-    return false;
+  uint32_t needed = serialized_size + (i == GetTupleCount() ? SIZE_TUPLE : 0);
+  if (GetFreeSpaceRemaining() < needed) {
+    // the holes deleted tuples left may add up to enough
+    if (GetFreeSpace() < needed) {
+      return false;
+    }
+    Compact();
   }
   // Otherwise, we claim available free space..
   SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
   uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
-  ASSERT(write_bytes = serialized_size, "Unexpected behavior in row serialize.");
+  ASSERT(write_bytes == serialized_size, "Unexpected behavior in row serialize.");
 
   // Set the tuple.
   SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
@@ -77,58 +79,77 @@ bool TablePage::UpdateTuple(const Row &new_row, Row *old_row, Schema *schema,
     return false;
   }
   // If there is not enough space to update, we need to update via delete followed by an insert (not enough space).
-  if (GetFreeSpaceRemaining() + tuple_size < serialized_size) {
+  if (GetFreeSpace() + tuple_size < serialized_size) {
     return false;
   }
   // Copy out the old value.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
-  memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
-  new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
-  SetTupleSize(slot_num, serialized_size);
 
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
+  if (serialized_size > tuple_size) {
+    // a grown tuple moves to the free space, compacted first if only the holes leave room for it
+    SetTupleSize(slot_num, 0);
+    if (GetFreeSpaceRemaining() < serialized_size) {
+      Compact();
     }
+    tuple_offset = GetFreeSpacePointer() - serialized_size;
+    SetFreeSpacePointer(tuple_offset);
+    SetTupleOffsetAtSlot(slot_num, tuple_offset);
   }
+  // a tuple that shrinks stays where it is, what it gives back is a hole until the next compaction
+  new_row.SerializeTo(GetData() + tuple_offset, schema);
+  SetTupleSize(slot_num, serialized_size);
   return true;
 }
 
 void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
   uint32_t slot_num = rid.GetSlotNum();
   ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+  ASSERT(GetTupleSize(slot_num) != 0, "Cannot delete an empty slot.");
 
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t tuple_size = GetTupleSize(slot_num);
-  // Check if this is a delete operation, i.e. commit a delete.
-  if (IsDeleted(tuple_size)) {
-    tuple_size = UnsetDeletedFlag(tuple_size);
-  }
-
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  ASSERT(tuple_offset >= free_space_pointer, "Free space appears before tuples.");
-
-  memmove(GetData() + free_space_pointer + tuple_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size);
+  // The bytes of the tuple are left as a hole, they are reclaimed by Compact once an insert or update runs short.
   SetTupleSize(slot_num, 0);
   SetTupleOffsetAtSlot(slot_num, 0);
 
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) != 0 && tuple_offset_i < tuple_offset) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size);
+  // Keep the slot directory dense, empty slots at its end are dropped.
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && GetTupleSize(tuple_count - 1) == 0) {
+    tuple_count--;
+  }
+  SetTupleCount(tuple_count);
+}
+
+void TablePage::Compact() {
+  // copy the tuples to the end of a scratch page one after another, then copy the packed bytes back
+  char packed[PAGE_SIZE];
+  uint32_t free_space_pointer = PAGE_SIZE;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    uint32_t tuple_size = UnsetDeletedFlag(GetTupleSize(i));
+    if (tuple_size == 0) {
+      continue;
     }
+    free_space_pointer -= tuple_size;
+    memcpy(packed + free_space_pointer, GetData() + GetTupleOffsetAtSlot(i), tuple_size);
+    SetTupleOffsetAtSlot(i, free_space_pointer);
+  }
+  memcpy(GetData() + free_space_pointer, packed + free_space_pointer, PAGE_SIZE - free_space_pointer);
+  SetFreeSpacePointer(free_space_pointer);
+}
+
+uint32_t TablePage::GetFreeSpace() {
+  uint32_t used = SIZE_TABLE_PAGE_HEADER + SIZE_TUPLE * GetTupleCount();
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    used += UnsetDeletedFlag(GetTupleSize(i));
   }
+  return PAGE_SIZE - used;
+}
+
+bool TablePage::HasMarkedTuples() {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) & DELETE_MASK) return true;
+  }
+  return false;
 }
 
 void TablePage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
@@ -163,6 +184,44 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   return true;
 }
 
+const char *TablePage::GetTupleData(uint32_t slot_num) {
+  if (slot_num >= GetTupleCount() || IsDeleted(GetTupleSize(slot_num))) {
+    return nullptr;
+  }
+  return GetData() + GetTupleOffsetAtSlot(slot_num);
+}
+
+const char *TablePage::GetStoredTupleData(uint32_t slot_num) {
+  if (slot_num >= GetTupleCount() || GetTupleSize(slot_num) == 0) {
+    return nullptr;
+  }
+  return GetData() + GetTupleOffsetAtSlot(slot_num);
+}
+
+void TablePage::FilterTuples(const ScanPredicate &predicate, std::vector<RowId> &rids) {
+  uint32_t tuple_count = GetTupleCount();
+  page_id_t page_id = GetTablePageId();
+  const char *rows[FILTER_BATCH_SIZE];
+  uint32_t slots[FILTER_BATCH_SIZE];
+  uint64_t sel[FILTER_BATCH_WORDS];
+  for (uint32_t i = 0; i < tuple_count;) {
+    // the live tuples are evaluated a batch at a time, so fixed-width columns go through the SIMD kernels
+    uint32_t n = 0;
+    for (; i < tuple_count && n < FILTER_BATCH_SIZE; i++) {
+      if (IsDeleted(GetTupleSize(i))) continue;
+      rows[n] = GetData() + GetTupleOffsetAtSlot(i);
+      slots[n++] = i;
+    }
+    if (n == 0) break;
+    predicate.EvaluateBatch(rows, n, sel);
+    for (uint32_t w = 0; w < (n + 63) / 64; w++) {
+      for (uint64_t bits = sel[w]; bits != 0; bits &= bits - 1) {
+        rids.emplace_back(page_id, slots[w * 64 + __builtin_ctzll(bits)]);
+      }
+    }
+  }
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
@@ -389,35 +389,41 @@ static void yy_fatal_error(yyconst char msg[]);
   *yy_cp = '\0'; \
   (yy_c_buf_p) = yy_cp;
 
-#define YY_NUM_RULES 56
-#define YY_END_OF_BUFFER 57
+#define YY_NUM_RULES 70
+#define YY_END_OF_BUFFER 71
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info {
   flex_int32_t yy_verify;
   flex_int32_t yy_nxt;
 };
-static yyconst flex_int16_t yy_accept[175] =
+static yyconst flex_int16_t yy_accept[222] =
         {0,
-         41, 41, 57, 55, 54, 54, 55, 49, 52, 53,
-         47, 46, 41, 55, 41, 48, 50, 42, 51, 39,
-         39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
-         39, 39, 39, 39, 39, 39, 39, 39, 0, 1,
-         0, 0, 41, 40, 44, 43, 45, 39, 39, 39,
-         39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
-         37, 39, 39, 39, 22, 35, 39, 39, 39, 39,
-         39, 39, 39, 39, 39, 39, 39, 34, 39, 39,
-         39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
-         32, 29, 36, 39, 39, 39, 39, 39, 26, 39,
-
-         39, 39, 39, 14, 39, 39, 39, 39, 31, 39,
-         39, 39, 39, 3, 39, 39, 23, 39, 39, 25,
-         38, 39, 11, 39, 39, 13, 39, 39, 39, 39,
-         39, 39, 8, 39, 39, 39, 39, 39, 33, 20,
-         39, 39, 39, 39, 18, 39, 39, 15, 39, 24,
-         9, 2, 39, 6, 39, 39, 5, 39, 39, 4,
-         19, 30, 7, 27, 39, 39, 21, 28, 39, 16,
-         12, 10, 17, 0
+         54, 54, 52, 69, 52, 52, 52, 52, 52, 52,
+         52, 52, 52, 52, 52, 52, 52, 52, 52, 52,
+         52, 52, 52, 52, 52, 63, 54, 60, 55, 64,
+         65, 59, 61, 62, 66, 67, 68, 69, 52, 22,
+         35, 0, 0, 1, 52, 52, 52, 46, 52, 52,
+         52, 52, 52, 52, 52, 52, 52, 52, 52, 52,
+         37, 52, 52, 52, 52, 52, 52, 52, 52, 52,
+         52, 52, 52, 52, 52, 52, 52, 52, 0, 0,
+         0, 53, 56, 57, 58, 52, 52, 48, 52, 34,
+         52, 52, 52, 52, 52, 52, 52, 52, 52, 52,
+
+         52, 52, 52, 52, 52, 52, 32, 52, 29, 52,
+         52, 36, 52, 52, 52, 52, 26, 52, 52, 52,
+         52, 14, 52, 52, 52, 52, 52, 52, 52, 52,
+         52, 52, 39, 31, 52, 52, 52, 52, 49, 3,
+         52, 52, 23, 52, 52, 52, 25, 44, 52, 38,
+         52, 11, 52, 13, 52, 52, 52, 52, 52, 52,
+         52, 52, 40, 52, 47, 52, 8, 52, 52, 52,
+         52, 52, 52, 33, 45, 52, 20, 50, 52, 52,
+         52, 18, 52, 52, 15, 52, 52, 24, 51, 52,
+         9, 52, 2, 52, 6, 52, 5, 52, 52, 52,
+
+         4, 19, 30, 7, 41, 27, 43, 52, 52, 52,
+         21, 28, 52, 52, 16, 12, 10, 42, 17, 71,
+         0
         };
 
 static yyconst flex_int32_t yy_ec[256] =
@@ -433,9 +439,9 @@ static yyconst flex_int32_t yy_ec[256] =
          17, 17, 17, 17, 17, 17, 17, 17, 17, 17,
          1, 18, 1, 1, 17, 1, 19, 20, 21, 22,
 
-         23, 24, 25, 26, 27, 17, 28, 29, 30, 31,
-         32, 33, 34, 35, 36, 37, 38, 39, 40, 41,
-         42, 17, 1, 1, 1, 1, 1, 1, 1, 1,
+         23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+         33, 34, 35, 36, 37, 38, 39, 40, 41, 42,
+         43, 44, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
@@ -452,127 +458,172 @@ static yyconst flex_int32_t yy_ec[256] =
          1, 1, 1, 1, 1
         };
 
-static yyconst flex_int32_t yy_meta[43] =
+static yyconst flex_int32_t yy_meta[45] =
         {0,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-         1, 2, 1, 1, 1, 1, 2, 1, 2, 2,
-         2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-         2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-         2, 2
+         1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+         1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+         1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+         1, 1, 1, 1
         };
 
-static yyconst flex_int16_t yy_base[177] =
+static yyconst flex_int16_t yy_base[222] =
         {0,
-         0, 0, 188, 189, 189, 189, 39, 189, 189, 189,
-         189, 189, 33, 175, 35, 189, 33, 189, 171, 0,
-         154, 161, 24, 32, 142, 23, 29, 159, 30, 35,
-         146, 142, 147, 38, 159, 38, 158, 150, 59, 189,
-         172, 162, 42, 161, 189, 189, 189, 0, 150, 146,
-         151, 139, 145, 130, 137, 133, 141, 131, 130, 50,
-         0, 119, 123, 130, 0, 0, 131, 130, 127, 44,
-         123, 134, 126, 130, 52, 122, 127, 0, 122, 113,
-         117, 127, 126, 121, 110, 121, 122, 110, 116, 115,
-         105, 0, 0, 107, 105, 97, 104, 109, 0, 91,
-
-         101, 95, 109, 0, 96, 88, 90, 93, 0, 96,
-         85, 101, 83, 0, 95, 81, 0, 76, 81, 0,
-         0, 96, 0, 94, 92, 0, 89, 73, 73, 84,
-         85, 84, 0, 69, 82, 85, 80, 75, 0, 78,
-         63, 64, 79, 60, 60, 72, 71, 0, 57, 0,
-         0, 0, 56, 0, 62, 54, 0, 43, 63, 0,
-         0, 0, 0, 0, 60, 59, 0, 0, 52, 42,
-         0, 0, 0, 189, 87, 74
+         0, 0, 33, 77, 98, 14, 100, 99, 105, 5,
+         97, 12, 94, 16, 113, 110, 105, 103, 101, 109,
+         122, 127, 115, 131, 127, 154, 188, 139, 0, 186,
+         188, 0, 0, 0, 0, 0, 0, 0, 180, 0,
+         183, 203, 0, 0, 187, 190, 185, 0, 180, 194,
+         176, 193, 179, 188, 186, 197, 189, 190, 191, 204,
+         0, 200, 185, 198, 200, 193, 205, 206, 204, 202,
+         206, 217, 211, 217, 220, 219, 222, 208, 245, 0,
+         0, 0, 0, 0, 0, 214, 229, 0, 223, 0,
+         227, 224, 213, 221, 221, 240, 241, 238, 241, 230,
+
+         244, 247, 236, 229, 246, 247, 238, 240, 0, 246,
+         244, 0, 244, 238, 247, 237, 0, 256, 250, 246,
+         263, 0, 251, 245, 246, 250, 261, 265, 253, 247,
+         259, 265, 0, 0, 255, 256, 275, 258, 0, 0,
+         273, 260, 0, 265, 264, 259, 0, 0, 264, 0,
+         284, 0, 284, 0, 284, 283, 268, 270, 284, 271,
+         288, 289, 0, 275, 0, 270, 0, 277, 293, 294,
+         299, 296, 293, 0, 0, 283, 299, 0, 287, 305,
+         287, 289, 304, 305, 0, 298, 293, 0, 0, 308,
+         0, 296, 0, 296, 0, 304, 0, 298, 293, 316,
+
+         0, 0, 0, 0, 0, 0, 0, 315, 316, 317,
+         0, 0, 312, 320, 306, 0, 0, 0, 0, 0,
+         344
         };
 
-static yyconst flex_int16_t yy_def[177] =
+static yyconst flex_int16_t yy_def[222] =
         {0,
-         174, 1, 174, 174, 174, 174, 175, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 175, 174,
-         175, 174, 174, 174, 174, 174, 174, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 0, 174, 174
+         221, 1, 221, 221, 3, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 221, 221, 221, 221, 221,
+         221, 221, 221, 221, 221, 221, 221, 221, 5, 5,
+         5, 4, 4, 221, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 26, 26,
+         28, 28, 221, 221, 221, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         5, 5, 5, 5, 5, 5, 5, 5, 5, 221,
+         0
         };
 
-static yyconst flex_int16_t yy_nxt[232] =
-        {0,
-         4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
-         14, 15, 16, 17, 18, 19, 20, 4, 21, 22,
-         23, 24, 25, 26, 20, 20, 27, 28, 20, 20,
-         29, 30, 31, 32, 33, 34, 35, 36, 37, 38,
-         20, 20, 40, 42, 43, 42, 43, 45, 46, 51,
-         54, 58, 42, 43, 55, 52, 41, 59, 53, 60,
-         70, 63, 40, 71, 61, 65, 56, 64, 73, 66,
-         74, 89, 98, 75, 104, 48, 41, 173, 105, 172,
-         99, 171, 170, 169, 168, 90, 91, 39, 39, 167,
-         166, 165, 164, 163, 162, 161, 160, 159, 158, 157,
-
-         156, 155, 154, 153, 152, 151, 150, 149, 148, 147,
-         146, 145, 144, 143, 142, 141, 140, 139, 138, 137,
-         136, 135, 134, 133, 132, 131, 130, 129, 128, 127,
-         126, 125, 124, 123, 122, 121, 120, 119, 118, 117,
-         116, 115, 114, 113, 112, 111, 110, 109, 108, 107,
-         106, 103, 102, 101, 100, 97, 96, 95, 94, 93,
-         92, 88, 87, 86, 85, 84, 83, 82, 81, 80,
-         79, 78, 44, 44, 174, 77, 76, 72, 69, 68,
-         67, 62, 57, 50, 49, 47, 44, 174, 3, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174
+static yyconst flex_int16_t yy_nxt[389] =
+        {221,
+         38, 37, 37, 4, 26, 35, 36, 33, 32, 27,
+         28, 27, 34, 30, 29, 31, 5, 38, 6, 7,
+         8, 9, 10, 11, 12, 5, 13, 14, 15, 16,
+         5, 17, 3, 18, 19, 20, 21, 22, 23, 24,
+         25, 5, 5, 5, 5, 46, 56, 59, 62, 5,
+         45, 5, 5, 5, 5, 5, 39, 5, 5, 5,
+         5, 5, 5, 5, 40, 5, 5, 5, 41, 5,
+         5, 5, 5, 5, 5, 5, 5, 43, 43, 43,
+         44, 43, 43, 43, 43, 43, 43, 43, 43, 43,
+         43, 43, 43, 43, 42, 43, 43, 43, 43, 43,
+
+         43, 43, 43, 43, 43, 43, 43, 43, 43, 43,
+         43, 43, 43, 43, 43, 43, 43, 43, 43, 43,
+         43, 5, 47, 53, 50, 60, 57, 54, 51, 5,
+         61, 49, 58, 5, 52, 63, 64, 66, 67, 68,
+         55, 69, 48, 65, 71, 72, 73, 70, 74, 76,
+         82, 75, 77, 78, 80, 80, 80, 80, 44, 80,
+         80, 80, 80, 80, 80, 80, 80, 80, 80, 80,
+         80, 79, 80, 80, 80, 80, 80, 80, 80, 80,
+         80, 80, 80, 80, 80, 80, 80, 80, 80, 80,
+         80, 80, 80, 80, 80, 80, 80, 80, 81, 27,
+
+         84, 83, 85, 86, 87, 221, 43, 88, 89, 91,
+         92, 90, 94, 93, 95, 96, 97, 98, 100, 101,
+         43, 102, 103, 104, 99, 106, 108, 109, 110, 111,
+         112, 113, 114, 115, 116, 118, 119, 120, 121, 124,
+         105, 107, 122, 117, 126, 127, 123, 221, 125, 80,
+         128, 129, 130, 131, 132, 133, 134, 135, 136, 137,
+         138, 139, 80, 140, 141, 142, 143, 144, 145, 146,
+         147, 148, 149, 150, 151, 152, 153, 154, 155, 156,
+         157, 158, 159, 160, 161, 162, 163, 164, 165, 166,
+         167, 168, 169, 170, 171, 172, 173, 174, 175, 176,
+
+         177, 178, 179, 180, 181, 182, 183, 184, 185, 186,
+         187, 188, 189, 190, 191, 192, 193, 194, 195, 196,
+         197, 198, 199, 200, 201, 202, 203, 204, 205, 206,
+         207, 208, 209, 210, 211, 212, 213, 214, 215, 216,
+         217, 218, 219, 220, 221, 221, 221, 221, 221, 221,
+         221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+         221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+         221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+         221, 221, 221, 221, 221, 221, 221, 221
         };
 
-static yyconst flex_int16_t yy_chk[232] =
-        {0,
+static yyconst flex_int16_t yy_chk[389] =
+        {220,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-         1, 1, 7, 13, 13, 15, 15, 17, 17, 23,
-         24, 26, 43, 43, 24, 23, 7, 26, 23, 27,
-         34, 29, 39, 34, 27, 30, 24, 29, 36, 30,
-         36, 60, 70, 36, 75, 176, 39, 170, 75, 169,
-         70, 166, 165, 159, 158, 60, 60, 175, 175, 156,
-         155, 153, 149, 147, 146, 145, 144, 143, 142, 141,
-
-         140, 138, 137, 136, 135, 134, 132, 131, 130, 129,
-         128, 127, 125, 124, 122, 119, 118, 116, 115, 113,
-         112, 111, 110, 108, 107, 106, 105, 103, 102, 101,
-         100, 98, 97, 96, 95, 94, 91, 90, 89, 88,
-         87, 86, 85, 84, 83, 82, 81, 80, 79, 77,
-         76, 74, 73, 72, 71, 69, 68, 67, 64, 63,
-         62, 59, 58, 57, 56, 55, 54, 53, 52, 51,
-         50, 49, 44, 42, 41, 38, 37, 35, 33, 32,
-         31, 28, 25, 22, 21, 19, 14, 3, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174
+         1, 1, 1, 1, 3, 6, 10, 12, 14, 3,
+         6, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+         3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+         3, 3, 3, 3, 3, 3, 3, 4, 4, 4,
+         4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+         4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+
+         4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+         4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+         4, 5, 7, 9, 8, 13, 11, 9, 8, 5,
+         13, 8, 11, 5, 8, 15, 16, 17, 18, 19,
+         9, 20, 7, 17, 21, 22, 23, 21, 23, 24,
+         28, 23, 25, 25, 26, 26, 26, 26, 26, 26,
+         26, 26, 26, 26, 26, 26, 26, 26, 26, 26,
+         26, 26, 26, 26, 26, 26, 26, 26, 26, 26,
+         26, 26, 26, 26, 26, 26, 26, 26, 26, 26,
+         26, 26, 26, 26, 26, 26, 26, 26, 27, 27,
+
+         30, 30, 31, 39, 41, 42, 42, 45, 46, 47,
+         49, 46, 50, 49, 51, 52, 53, 54, 55, 56,
+         42, 57, 58, 59, 54, 60, 62, 63, 64, 65,
+         66, 67, 68, 69, 70, 71, 72, 73, 74, 76,
+         60, 60, 75, 71, 77, 78, 75, 79, 76, 79,
+         86, 87, 89, 91, 92, 93, 94, 95, 96, 97,
+         98, 99, 79, 100, 101, 102, 103, 104, 105, 106,
+         107, 108, 110, 111, 113, 114, 115, 116, 118, 119,
+         120, 121, 123, 124, 125, 126, 127, 128, 129, 130,
+         131, 132, 135, 136, 137, 138, 141, 142, 144, 145,
+
+         146, 149, 151, 153, 155, 156, 157, 158, 159, 160,
+         161, 162, 164, 166, 168, 169, 170, 171, 172, 173,
+         176, 177, 179, 180, 181, 182, 183, 184, 186, 187,
+         190, 192, 194, 196, 198, 199, 200, 208, 209, 210,
+         213, 214, 215, 221, 221, 221, 221, 221, 221, 221,
+         221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+         221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+         221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+         221, 221, 221, 221, 221, 221, 221, 221
         };
 
 /* Table of booleans, true if rule could match eol. */
-static yyconst flex_int32_t yy_rule_can_match_eol[57] =
+static yyconst flex_int32_t yy_rule_can_match_eol[71] =
         {0,
-         1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,};
+         0, 0, 0, 0, 0, 0, 0, 1, 0, 0,};
 
 static yy_state_type yy_last_accepting_state;
 static char *yy_last_accepting_cpos;
@@ -594,11 +645,9 @@ char *yytext;
 #include <stdio.h>
 #include "parser/parser.h"
 #include "parser/minisql_yacc.h"
-
 int yywrap();
-
 extern YYSTYPE yylval;
-#line 585 "../../parser/minisql_lex.c"
+#line 651 "../../parser/minisql_lex.c"
 
 #define INITIAL 0
 
@@ -787,7 +836,7 @@ YY_DECL {
 #line 15 "minisql.l"
 
 
-#line 770 "../../parser/minisql_lex.c"
+#line 840 "../../parser/minisql_lex.c"
 
   if (!(yy_init)) {
     (yy_init) = 1;
@@ -836,12 +885,12 @@ YY_DECL {
       }
       while (yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
         yy_current_state = (int) yy_def[yy_current_state];
-        if (yy_current_state >= 175)
+        if (yy_current_state >= 222)
           yy_c = yy_meta[(unsigned int) yy_c];
       }
       yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
       ++yy_cp;
-    } while (yy_base[yy_current_state] != 189);
+    } while (yy_base[yy_current_state] != 344);
 
     yy_find_action:
     yy_act = yy_accept[yy_current_state];
@@ -1180,149 +1229,261 @@ YY_DECL {
       case 39:
         YY_RULE_SETUP
 #line 208 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return COPY;
+      }
+        YY_BREAK
+      case 40:
+        YY_RULE_SETUP
+#line 213 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return WITH;
+      }
+        YY_BREAK
+      case 41:
+        YY_RULE_SETUP
+#line 218 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return VACUUM;
+      }
+        YY_BREAK
+      case 42:
+        YY_RULE_SETUP
+#line 223 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return CLUSTERED;
+      }
+        YY_BREAK
+      case 43:
+        YY_RULE_SETUP
+#line 228 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return ANALYZE;
+      }
+        YY_BREAK
+      case 44:
+        YY_RULE_SETUP
+#line 233 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return JOIN;
+      }
+        YY_BREAK
+      case 45:
+        YY_RULE_SETUP
+#line 238 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return GROUP;
+      }
+        YY_BREAK
+      case 46:
+        YY_RULE_SETUP
+#line 243 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return BY;
+      }
+        YY_BREAK
+      case 47:
+        YY_RULE_SETUP
+#line 248 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return ORDER;
+      }
+        YY_BREAK
+      case 48:
+        YY_RULE_SETUP
+#line 253 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return ASC;
+      }
+        YY_BREAK
+      case 49:
+        YY_RULE_SETUP
+#line 258 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return DESC;
+      }
+        YY_BREAK
+      case 50:
+        YY_RULE_SETUP
+#line 263 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return LIMIT;
+      }
+        YY_BREAK
+      case 51:
+        YY_RULE_SETUP
+#line 268 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return OFFSET;
+      }
+        YY_BREAK
+      case 52:
+        YY_RULE_SETUP
+#line 273 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
         return IDENTIFIER;
       }
         YY_BREAK
-      case 40:
+      case 53:
         YY_RULE_SETUP
-#line 214 "minisql.l"
+#line 279 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
         return NUMBER;
       }
         YY_BREAK
-      case 41:
+      case 54:
         YY_RULE_SETUP
-#line 220 "minisql.l"
+#line 285 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
         return NUMBER;
       }
         YY_BREAK
-      case 42:
+      case 55:
         YY_RULE_SETUP
-#line 226 "minisql.l"
+#line 291 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return EQ;
       }
         YY_BREAK
-      case 43:
+      case 56:
         YY_RULE_SETUP
-#line 231 "minisql.l"
+#line 296 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return NE;
       }
         YY_BREAK
-      case 44:
+      case 57:
         YY_RULE_SETUP
-#line 236 "minisql.l"
+#line 301 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return LE;
       }
         YY_BREAK
-      case 45:
+      case 58:
         YY_RULE_SETUP
-#line 241 "minisql.l"
+#line 306 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return GE;
       }
         YY_BREAK
-      case 46:
+      case 59:
         YY_RULE_SETUP
-#line 246 "minisql.l"
+#line 311 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return (',');
       }
         YY_BREAK
-      case 47:
+      case 60:
         YY_RULE_SETUP
-#line 251 "minisql.l"
+#line 316 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return ('.');
+      }
+        YY_BREAK
+      case 61:
+        YY_RULE_SETUP
+#line 321 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('*');
       }
         YY_BREAK
-      case 48:
+      case 62:
         YY_RULE_SETUP
-#line 256 "minisql.l"
+#line 326 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return (';');
       }
         YY_BREAK
-      case 49:
+      case 63:
         YY_RULE_SETUP
-#line 261 "minisql.l"
+#line 331 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('\'');
       }
         YY_BREAK
-      case 50:
+      case 64:
         YY_RULE_SETUP
-#line 266 "minisql.l"
+#line 336 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('<');
       }
         YY_BREAK
-      case 51:
+      case 65:
         YY_RULE_SETUP
-#line 271 "minisql.l"
+#line 341 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('>');
       }
         YY_BREAK
-      case 52:
+      case 66:
         YY_RULE_SETUP
-#line 276 "minisql.l"
+#line 346 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('(');
       }
         YY_BREAK
-      case 53:
+      case 67:
         YY_RULE_SETUP
-#line 281 "minisql.l"
+#line 351 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return (')');
       }
         YY_BREAK
-      case 54:
-/* rule 54 can match eol */
+      case 68:
+/* rule 68 can match eol */
         YY_RULE_SETUP
-#line 286 "minisql.l"
+#line 356 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
       }
         YY_BREAK
-      case 55:
+      case 69:
         YY_RULE_SETUP
-#line 290 "minisql.l"
+#line 360 "minisql.l"
       {
         char str[128] = {0};
         sprintf(str, "Unrecognized token [%s] in input sql.", yytext);
         MinisqlParserSetError(str);
       }
         YY_BREAK
-      case 56:
+      case 70:
         YY_RULE_SETUP
-#line 296 "minisql.l"
+#line 366 "minisql.l"
         ECHO;
         YY_BREAK
-#line 1314 "../../parser/minisql_lex.c"
+#line 1487 "../../parser/minisql_lex.c"
       case YY_STATE_EOF(INITIAL):
         yyterminate();
 
@@ -1579,7 +1740,7 @@ static yy_state_type yy_get_previous_state(void) {
     }
     while (yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
       yy_current_state = (int) yy_def[yy_current_state];
-      if (yy_current_state >= 175)
+      if (yy_current_state >= 222)
         yy_c = yy_meta[(unsigned int) yy_c];
     }
     yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
@@ -1604,11 +1765,11 @@ static yy_state_type yy_try_NUL_trans(yy_state_type yy_current_state) {
   }
   while (yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
     yy_current_state = (int) yy_def[yy_current_state];
-    if (yy_current_state >= 175)
+    if (yy_current_state >= 222)
       yy_c = yy_meta[(unsigned int) yy_c];
   }
   yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-  yy_is_jam = (yy_current_state == 174);
+  yy_is_jam = (yy_current_state == 221);
 
   return yy_is_jam ? 0 : yy_current_state;
 }
@@ -2258,9 +2419,8 @@ void yyfree(void *ptr) {
 
 #define YYTABLES_NAME "yytables"
 
-#line 296 "minisql.l"
-
+#line 366 "minisql.l"
 
 int yywrap() {
   return 1;
-}
+}
\ No newline at end of file
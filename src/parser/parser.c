@@ -3,7 +3,7 @@
 #include "parser/syntax_tree.h"
 
 pSyntaxNode minisql_parser_root_node_ = NULL;
-pSyntaxNodeList minisql_parser_syntax_node_list_ = NULL;
+pSyntaxArenaChunk minisql_parser_syntax_arena_ = NULL;
 int minisql_parser_line_no_ = 0;
 int minisql_parser_column_no_ = 0;
 int minisql_parser_error_ = 0;
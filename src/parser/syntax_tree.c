@@ -4,10 +4,27 @@
 extern int minisql_parser_line_no_;
 extern int minisql_parser_column_no_;
 extern int minisql_parser_debug_node_count_;
-extern pSyntaxNodeList minisql_parser_syntax_node_list_;
+extern pSyntaxArenaChunk minisql_parser_syntax_arena_;
+
+static void *SyntaxArenaAllocate(size_t size) {
+  // keep every block aligned for a syntax node
+  size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+  pSyntaxArenaChunk chunk = minisql_parser_syntax_arena_;
+  if (chunk == NULL || chunk->size_ - chunk->used_ < size) {
+    size_t chunk_size = size > SYNTAX_ARENA_CHUNK_SIZE ? size : SYNTAX_ARENA_CHUNK_SIZE;
+    chunk = (pSyntaxArenaChunk) malloc(sizeof(struct SyntaxArenaChunk) + chunk_size);
+    chunk->next_ = minisql_parser_syntax_arena_;
+    chunk->size_ = chunk_size;
+    chunk->used_ = 0;
+    minisql_parser_syntax_arena_ = chunk;
+  }
+  void *buf = chunk->data_ + chunk->used_;
+  chunk->used_ += size;
+  return buf;
+}
 
 pSyntaxNode CreateSyntaxNode(SyntaxNodeType type, char *val) {
-  pSyntaxNode node = (pSyntaxNode) malloc(sizeof(struct SyntaxNode));
+  pSyntaxNode node = (pSyntaxNode) SyntaxArenaAllocate(sizeof(struct SyntaxNode));
   node->id_ = minisql_parser_debug_node_count_++;
   node->type_ = type;
   node->line_no_ = minisql_parser_line_no_;
@@ -19,28 +36,18 @@ pSyntaxNode CreateSyntaxNode(SyntaxNodeType type, char *val) {
     // special for string, remove ""
     if (type == kNodeString) {
       size_t len = strlen(val) - 1;   // -2 + 1
-      node->val_ = (char *) malloc(len);
+      node->val_ = (char *) SyntaxArenaAllocate(len);
       strncpy(node->val_, val + 1, len - 1);
       node->val_[len-1] = '\0';
     } else {
       size_t len = strlen(val) + 1;
-      node->val_ = (char *) malloc(len);
+      node->val_ = (char *) SyntaxArenaAllocate(len);
       strcpy(node->val_, val);
       node->val_[len-1] = '\0';
     }
   } else {
     node->val_ = NULL;
   }
-  // linked to syntax node list
-  pSyntaxNodeList list_node = (pSyntaxNodeList) malloc(sizeof(struct SyntaxNodeList));
-  list_node->node_ = node;
-  if (minisql_parser_syntax_node_list_ == NULL) {
-    minisql_parser_syntax_node_list_ = list_node;
-    list_node->next_ = NULL;
-  } else {
-    list_node->next_ = minisql_parser_syntax_node_list_;
-    minisql_parser_syntax_node_list_ = list_node;
-  }
 #ifdef ENABLE_PARSER_DEBUG
   printf("Create syntax node: node_id = %d, type = %s, line = %d, col = %d\n", node->id_,
          GetSyntaxNodeTypeStr(node->type_), node->line_no_, node->col_no_);
@@ -48,26 +55,20 @@ pSyntaxNode CreateSyntaxNode(SyntaxNodeType type, char *val) {
   return node;
 }
 
-void FreeSyntaxNode(pSyntaxNode node) {
-  if (node != NULL) {
-#ifdef ENABLE_PARSER_DEBUG
-    printf("Free syntax node: node_id = %d\n", node->id_);
-#endif
-    if (node->val_ != NULL) {
-      free(node->val_);
-    }
-    free(node);
-  }
-}
-
 void DestroySyntaxTree() {
-  pSyntaxNodeList p = minisql_parser_syntax_node_list_;
+  pSyntaxArenaChunk chunk = minisql_parser_syntax_arena_;
+  if (chunk == NULL) {
+    return;
+  }
+  // the newest chunk is kept for the next statement, the ones before it are freed
+  pSyntaxArenaChunk p = chunk->next_;
   while (p != NULL) {
-    pSyntaxNodeList next = p->next_;
-    FreeSyntaxNode(p->node_);
+    pSyntaxArenaChunk next = p->next_;
+    free(p);
     p = next;
   }
-  minisql_parser_syntax_node_list_ = NULL;
+  chunk->next_ = NULL;
+  chunk->used_ = 0;
 }
 
 void SyntaxNodeAddChildren(pSyntaxNode parent, pSyntaxNode child) {
@@ -169,6 +170,28 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeCopy:
+      return "kNodeCopy";
+    case kNodeTableOptions:
+      return "kNodeTableOptions";
+    case kNodeTableOption:
+      return "kNodeTableOption";
+    case kNodeVacuum:
+      return "kNodeVacuum";
+    case kNodeAnalyze:
+      return "kNodeAnalyze";
+    case kNodeJoin:
+      return "kNodeJoin";
+    case kNodeAggregate:
+      return "kNodeAggregate";
+    case kNodeGroupBy:
+      return "kNodeGroupBy";
+    case kNodeOrderBy:
+      return "kNodeOrderBy";
+    case kNodeOrderKey:
+      return "kNodeOrderKey";
+    case kNodeLimit:
+      return "kNodeLimit";
     default:
       return "error type";
   }
@@ -0,0 +1,59 @@
+#include "record/column_zone.h"
+
+#include <algorithm>
+
+void ColumnZone::Add(const Field &field) {
+  if (field.IsNull()) {
+    null_count++;
+    return;
+  }
+  bool first = value_count++ == 0;
+  switch (field.GetTypeId()) {
+    case TypeId::kTypeInt:
+    case TypeId::kTypeFloat: {
+      char buf[sizeof(int32_t)];
+      field.SerializeTo(buf);
+      if (field.GetTypeId() == TypeId::kTypeInt) {
+        int32_t value = MACH_READ_INT32(buf);
+        if (first || value < min.int_) min.int_ = value;
+        if (first || value > max.int_) max.int_ = value;
+      } else {
+        float value = MACH_READ_FROM(float, buf);
+        if (first || value < min.float_) min.float_ = value;
+        if (first || value > max.float_) max.float_ = value;
+      }
+      break;
+    }
+    default: {
+      std::string_view value(field.GetData(), field.GetLength());
+      auto prefix = value.substr(0, ZONE_CHARS_PREFIX);
+      // a prefix is never above the value, it stays a lower bound
+      if (first || value < GetMinChars()) {
+        min_size = static_cast<uint8_t>(prefix.size());
+        memcpy(min_chars, prefix.data(), prefix.size());
+      }
+      // a truncated upper bound covers every value it is a prefix of, only one with a greater prefix moves it
+      if (first || (max_truncated ? prefix > GetMaxChars() : value > GetMaxChars())) {
+        max_size = static_cast<uint8_t>(prefix.size());
+        memcpy(max_chars, prefix.data(), prefix.size());
+        max_truncated = value.size() > prefix.size();
+      }
+      break;
+    }
+  }
+}
+
+void ColumnZone::Remove(const Field &field) {
+  if (field.IsNull()) {
+    ASSERT(null_count > 0, "ColumnZone::Remove : No Null To Remove");
+    null_count--;
+    return;
+  }
+  ASSERT(value_count > 0, "ColumnZone::Remove : No Value To Remove");
+  if (--value_count == 0) {
+    // the bounds are only tightened once the last value is gone
+    min.int_ = max.int_ = 0;
+    min_size = max_size = 0;
+    max_truncated = false;
+  }
+}
@@ -0,0 +1,203 @@
+#include "record/filter_kernels.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "common/cpu_features.h"
+#include "common/macros.h"
+
+namespace simd {
+
+namespace {
+
+/** kEq .. kGe, the operators that compare values */
+constexpr int kValueOps = 6;
+
+template <typename T>
+using FilterFunc = void (*)(const T *values, uint32_t n, T key, uint64_t *sel);
+
+template <typename T, CompareOp Op>
+inline bool Compare(T value, T key) {
+  if constexpr (Op == CompareOp::kEq) {
+    return value == key;
+  } else if constexpr (Op == CompareOp::kNe) {
+    return value != key;
+  } else if constexpr (Op == CompareOp::kLt) {
+    return value < key;
+  } else if constexpr (Op == CompareOp::kLe) {
+    return value <= key;
+  } else if constexpr (Op == CompareOp::kGt) {
+    return value > key;
+  } else {
+    return value >= key;
+  }
+}
+
+/*
+ * Compare values [begin, n), sel has to be cleared before
+ */
+template <typename T, CompareOp Op>
+inline void FilterTail(const T *values, uint32_t begin, uint32_t n, T key, uint64_t *sel) {
+  for (uint32_t i = begin; i < n; i++) sel[i / 64] |= uint64_t(Compare<T, Op>(values[i], key)) << (i % 64);
+}
+
+template <typename T, CompareOp Op>
+void FilterScalar(const T *values, uint32_t n, T key, uint64_t *sel) {
+  FilterTail<T, Op>(values, 0, n, key, sel);
+}
+
+#ifdef MINISQL_SIMD_X86
+/*
+ * <>, <= and >= are the complements of =, > and <, for floats the ordered
+ * compare predicates give the same results as the scalar operators.
+ */
+template <CompareOp Op>
+constexpr bool kInverted = Op == CompareOp::kNe || Op == CompareOp::kLe || Op == CompareOp::kGe;
+
+template <typename T, CompareOp Op>
+__attribute__((target("avx2"))) void FilterAvx2(const T *values, uint32_t n, T key, uint64_t *sel) {
+  uint32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint32_t bits;
+    if constexpr (std::is_same_v<T, int32_t>) {
+      const __m256i target = _mm256_set1_epi32(key);
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i)), mask;
+      if constexpr (Op == CompareOp::kEq || Op == CompareOp::kNe) {
+        mask = _mm256_cmpeq_epi32(v, target);
+      } else if constexpr (Op == CompareOp::kLt || Op == CompareOp::kGe) {
+        mask = _mm256_cmpgt_epi32(target, v);
+      } else {
+        mask = _mm256_cmpgt_epi32(v, target);
+      }
+      bits = _mm256_movemask_ps(_mm256_castsi256_ps(mask));
+      if constexpr (kInverted<Op>) bits ^= 0xff;
+    } else {
+      const __m256 target = _mm256_set1_ps(key);
+      __m256 v = _mm256_loadu_ps(values + i), mask;
+      if constexpr (Op == CompareOp::kEq) {
+        mask = _mm256_cmp_ps(v, target, _CMP_EQ_OQ);
+      } else if constexpr (Op == CompareOp::kNe) {
+        mask = _mm256_cmp_ps(v, target, _CMP_NEQ_UQ);
+      } else if constexpr (Op == CompareOp::kLt) {
+        mask = _mm256_cmp_ps(v, target, _CMP_LT_OQ);
+      } else if constexpr (Op == CompareOp::kLe) {
+        mask = _mm256_cmp_ps(v, target, _CMP_LE_OQ);
+      } else if constexpr (Op == CompareOp::kGt) {
+        mask = _mm256_cmp_ps(v, target, _CMP_GT_OQ);
+      } else {
+        mask = _mm256_cmp_ps(v, target, _CMP_GE_OQ);
+      }
+      bits = _mm256_movemask_ps(mask);
+    }
+    // i is a multiple of 8, the 8 bits never straddle two words
+    sel[i / 64] |= uint64_t(bits) << (i % 64);
+  }
+  FilterTail<T, Op>(values, i, n, key, sel);
+}
+
+template <typename T, CompareOp Op>
+__attribute__((target("sse4.2"))) void FilterSse42(const T *values, uint32_t n, T key, uint64_t *sel) {
+  uint32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    uint32_t bits;
+    if constexpr (std::is_same_v<T, int32_t>) {
+      const __m128i target = _mm_set1_epi32(key);
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i)), mask;
+      if constexpr (Op == CompareOp::kEq || Op == CompareOp::kNe) {
+        mask = _mm_cmpeq_epi32(v, target);
+      } else if constexpr (Op == CompareOp::kLt || Op == CompareOp::kGe) {
+        mask = _mm_cmplt_epi32(v, target);
+      } else {
+        mask = _mm_cmpgt_epi32(v, target);
+      }
+      bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+      if constexpr (kInverted<Op>) bits ^= 0xf;
+    } else {
+      const __m128 target = _mm_set1_ps(key);
+      __m128 v = _mm_loadu_ps(values + i), mask;
+      if constexpr (Op == CompareOp::kEq) {
+        mask = _mm_cmpeq_ps(v, target);
+      } else if constexpr (Op == CompareOp::kNe) {
+        mask = _mm_cmpneq_ps(v, target);
+      } else if constexpr (Op == CompareOp::kLt) {
+        mask = _mm_cmplt_ps(v, target);
+      } else if constexpr (Op == CompareOp::kLe) {
+        mask = _mm_cmple_ps(v, target);
+      } else if constexpr (Op == CompareOp::kGt) {
+        mask = _mm_cmpgt_ps(v, target);
+      } else {
+        mask = _mm_cmpge_ps(v, target);
+      }
+      bits = _mm_movemask_ps(mask);
+    }
+    sel[i / 64] |= uint64_t(bits) << (i % 64);
+  }
+  FilterTail<T, Op>(values, i, n, key, sel);
+}
+#endif
+
+/*
+ * One kernel for each of the value comparisons, indexed by CompareOp
+ */
+template <typename T>
+struct FilterTable {
+  FilterFunc<T> funcs[kValueOps];
+};
+
+#define FILTER_TABLE(kernel, T)                                                                                    \
+  FilterTable<T> {                                                                                                 \
+    {                                                                                                              \
+      kernel<T, CompareOp::kEq>, kernel<T, CompareOp::kNe>, kernel<T, CompareOp::kLt>, kernel<T, CompareOp::kLe>, \
+          kernel<T, CompareOp::kGt>, kernel<T, CompareOp::kGe>                                                     \
+    }                                                                                                              \
+  }
+
+struct Dispatch {
+  FilterTable<int32_t> filter_int;
+  FilterTable<float> filter_float;
+  const char *name;
+
+  Dispatch()
+      : filter_int(FILTER_TABLE(FilterScalar, int32_t)),
+        filter_float(FILTER_TABLE(FilterScalar, float)),
+        name("scalar") {
+#ifdef MINISQL_SIMD_X86
+    auto &cpu = CpuFeatures::Get();
+    if (cpu.avx2) {
+      filter_int = FILTER_TABLE(FilterAvx2, int32_t);
+      filter_float = FILTER_TABLE(FilterAvx2, float);
+      name = "avx2";
+    } else if (cpu.sse42) {
+      filter_int = FILTER_TABLE(FilterSse42, int32_t);
+      filter_float = FILTER_TABLE(FilterSse42, float);
+      name = "sse4.2";
+    }
+#endif
+  }
+};
+
+const Dispatch &GetDispatch() {
+  static const Dispatch dispatch;
+  return dispatch;
+}
+
+template <typename T>
+void Run(const FilterTable<T> &table, const T *values, uint32_t n, CompareOp op, T key, uint64_t *sel) {
+  ASSERT(static_cast<int>(op) < kValueOps, "simd::Filter : Not A Value Comparison");
+  memset(sel, 0, sizeof(uint64_t) * ((n + 63) / 64));
+  table.funcs[static_cast<int>(op)](values, n, key, sel);
+}
+
+}  // namespace
+
+void Filter(const int32_t *values, uint32_t n, CompareOp op, int32_t key, uint64_t *sel) {
+  Run(GetDispatch().filter_int, values, n, op, key, sel);
+}
+
+void Filter(const float *values, uint32_t n, CompareOp op, float key, uint64_t *sel) {
+  Run(GetDispatch().filter_float, values, n, op, key, sel);
+}
+
+const char *FilterImplementation() { return GetDispatch().name; }
+
+}  // namespace simd
@@ -1,55 +1,153 @@
 #include "record/row.h"
 
-#define setTrue(bytes, bit) bytes |= (uint64_t(1) << (bit) )
+#include "record/vector_batch.h"
+
 #define getBit(bytes, bit) (((bytes) >> (bit)) & 1)
 
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
-  // replace with your code here
   uint32_t field_num = schema->GetColumnCount();
-  uint32_t ser_cnt = 0;
-
-  ASSERT(field_num <= 64, "Row::SerializeTo : Schema Too Long");
-  ASSERT(schema->GetColumnCount() == GetFieldCount(), "Row::SerializeTo : Schema Not Match");
-
-  if(field_num == 0) {
+  ASSERT(field_num == GetFieldCount(), "Row::SerializeTo : Schema Not Match");
+  if (field_num == 0) {
     //empty fields, write Nothing
     return 0;
   }
 
-  uint64_t NullMap = 0;
-
+  char *null_map = buf + 1;
+  char *fixed = null_map + schema->GetNullBitmapSize();
+  char *var_ends = fixed + schema->GetFixedSize();
+  char *var_data = var_ends + sizeof(uint16_t) * schema->GetVarCount();
+  buf[0] = static_cast<char>(ROW_COMPACT_FORMAT_TAG);
+  memset(null_map, 0, schema->GetNullBitmapSize());
+
+  uint32_t var_len = 0;
+  for (uint32_t i = 0; i < field_num; i++) {
+    Field *field = fields_[i];
+    uint32_t slot = schema->GetFieldSlot(i);
+    bool is_char = schema->GetColumn(i)->GetType() == TypeId::kTypeChar;
+    if (field->IsNull()) {
+      ASSERT(schema->GetColumn(i)->IsNullable(), "Row::SerializeTo : Null Value Against Non-null Column");
+      null_map[i / 8] |= static_cast<char>(1 << (i % 8));
+      if (!is_char) memset(fixed + slot, 0, Type::GetTypeSize(field->GetTypeId()));
+    } else if (IsOverflow(i)) {
+      MACH_WRITE_TO(page_id_t, var_data + var_len, overflow_[i].page_id);
+      MACH_WRITE_UINT32(var_data + var_len + sizeof(page_id_t), overflow_[i].length);
+      var_len += ROW_OVERFLOW_REF_SIZE;
+    } else if (is_char) {
+      memcpy(var_data + var_len, field->GetData(), field->GetLength());
+      var_len += field->GetLength();
+    } else {
+      field->SerializeTo(fixed + slot);
+    }
+    if (is_char) {
+      ASSERT(var_len <= ROW_VAR_END_MASK, "Row::SerializeTo : Row Too Large");
+      uint32_t var_end = IsOverflow(i) ? var_len | ROW_VAR_OVERFLOW : var_len;
+      MACH_WRITE_TO(uint16_t, var_ends + sizeof(uint16_t) * slot, static_cast<uint16_t>(var_end));
+    }
+  }
 
+  return static_cast<uint32_t>(var_data - buf) + var_len;
+}
 
-  MACH_WRITE_UINT32(buf, field_num);
-  MOVE_FORWARD(buf, ser_cnt, uint32_t);
+void Row::SetOverflow(uint32_t idx, const OverflowRef &ref) {
+  ASSERT(idx < fields_.size() && fields_[idx]->GetTypeId() == TypeId::kTypeChar, "Row::SetOverflow : Not A Char");
+  if (overflow_.empty()) overflow_.resize(fields_.size());
+  overflow_[idx] = ref;
+}
 
-  //skip null map
-  char* null_buf_begin = buf;
-  MOVE_FORWARD(buf, ser_cnt, uint64_t);
+void Row::FillOverflow(uint32_t idx, const char *data) {
+  uint32_t length = GetOverflow(idx).length;
+  fields_[idx]->~Field();
+  heap_->Free(fields_[idx]);
+  fields_[idx] = ALLOC_P(heap_, Field)(TypeId::kTypeChar, const_cast<char *>(data), length, true);
+  overflow_[idx] = OverflowRef();
+  // once the last reference is read the row is in line again
+  for (uint32_t i = 0; i < overflow_.size(); i++) {
+    if (IsOverflow(i)) return;
+  }
+  overflow_.clear();
+}
 
-  auto columns = schema->GetColumns();
+void Row::CopyFields(const std::vector<Field> &fields) {
+  clear_fields();
+  fields_.resize(fields.size());
+  for (uint32_t i = 0; i < fields.size(); i++) fields_[i] = copy_field(fields[i]);
+}
 
-  for(uint32_t i=0; i<fields_.size(); i++) {
-    if(fields_[i]->IsNull()) {
-      ASSERT(columns[i]->IsNullable(), "Row::SerializeTo : Null Value Against Non-null Column");
-      continue;
-    }
+void Row::CopyFields(const Row &row, const std::vector<uint32_t> &columns) {
+  clear_fields();
+  fields_.resize(columns.size());
+  for (uint32_t i = 0; i < columns.size(); i++) fields_[i] = copy_field(*row.GetField(columns[i]));
+}
 
-    setTrue(NullMap, i);
-    fields_[i]->SerializeTo(buf);
-    STEP_FORWARD(buf, ser_cnt, fields_[i]->GetSerializedSize());
-  }
+void Row::CopyFields(const VectorBatch &batch, uint32_t slot, const std::vector<uint32_t> &columns) {
+  clear_fields();
+  fields_.resize(columns.size());
+  for (uint32_t i = 0; i < columns.size(); i++) fields_[i] = copy_field(batch.GetColumn(columns[i]).GetField(slot));
+}
 
-  //write NullMap
-  MACH_WRITE_UINT64(null_buf_begin, NullMap);
+void Row::CopyFields(const Row &left, const Row &right) {
+  clear_fields();
+  fields_.reserve(left.GetFieldCount() + right.GetFieldCount());
+  for (auto field : left.fields_) fields_.push_back(copy_field(*field));
+  for (auto field : right.fields_) fields_.push_back(copy_field(*field));
+}
 
-  return ser_cnt;
+Field *Row::copy_field(const Field &field) {
+  if (field.GetTypeId() == TypeId::kTypeChar && !field.IsNull()) {
+    // the source may point into a page that is unpinned soon
+    return ALLOC_P(heap_, Field)(field.GetTypeId(), const_cast<char *>(field.GetData()), field.GetLength(), true);
+  }
+  return ALLOC_P(heap_, Field)(field);
 }
 
 uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
   if(schema->GetColumnCount() == 0)
     return 0;
+  ASSERT(heap_, "Row::DeserializeFrom : Null Heap");
+  if (static_cast<uint8_t>(buf[0]) != ROW_COMPACT_FORMAT_TAG) return deserialize_legacy(buf, schema);
+
+  uint32_t field_num = schema->GetColumnCount();
+  const char *null_map = buf + 1;
+  char *fixed = buf + 1 + schema->GetNullBitmapSize();
+  char *var_ends = fixed + schema->GetFixedSize();
+  char *var_data = var_ends + sizeof(uint16_t) * schema->GetVarCount();
+
+  // a row read into again hands the memory of its old fields back to the heap
+  clear_fields();
+  fields_.resize(field_num);
+
+  uint32_t var_end = 0;
+  for (uint32_t i = 0; i < field_num; i++) {
+    TypeId type = schema->GetColumn(i)->GetType();
+    uint32_t slot = schema->GetFieldSlot(i);
+    bool is_null = (null_map[i / 8] >> (i % 8)) & 1;
+    if (type == TypeId::kTypeChar) {
+      uint32_t var_begin =
+          slot == 0 ? 0 : MACH_READ_FROM(uint16_t, var_ends + sizeof(uint16_t) * (slot - 1)) & ROW_VAR_END_MASK;
+      var_end = MACH_READ_FROM(uint16_t, var_ends + sizeof(uint16_t) * slot);
+      bool is_overflow = var_end & ROW_VAR_OVERFLOW;
+      var_end &= ROW_VAR_END_MASK;
+      if (is_null) {
+        fields_[i] = ALLOC_P(heap_, Field)(type);
+      } else if (is_overflow) {
+        // the chars are read from the chain by the table heap, only if they are asked for
+        fields_[i] = ALLOC_P(heap_, Field)(type, var_data + var_begin, 0, false);
+        OverflowRef ref{MACH_READ_FROM(page_id_t, var_data + var_begin),
+                        MACH_READ_UINT32(var_data + var_begin + sizeof(page_id_t))};
+        if (overflow_.empty()) overflow_.resize(field_num);
+        overflow_[i] = ref;
+      } else {
+        fields_[i] = ALLOC_P(heap_, Field)(type, var_data + var_begin, var_end - var_begin, true);
+      }
+    } else {
+      Field::DeserializeFrom(fixed + slot, type, &fields_[i], is_null, heap_);
+    }
+  }
 
+  return static_cast<uint32_t>(var_data - buf) + var_end;
+}
+
+uint32_t Row::deserialize_legacy(char *buf, Schema *schema) {
   uint32_t ser_cnt = 0;
   uint32_t schema_size;
   uint64_t NullMap;
@@ -60,8 +158,9 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
 
   ASSERT(schema_size == schema->GetColumnCount(), "Row::DeserializeFrom : Schema Size Not Match");
   ASSERT(schema_size <= 64, "Row::DeserializeFrom : Schema Size Too Large");
-  ASSERT(heap_, "Row::DeserializeFrom : Null Heap");
 
+  // a row read into again hands the memory of its old fields back to the heap
+  clear_fields();
   fields_.resize(schema_size);
 
   //read NullMap
@@ -92,17 +191,24 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
 
 }
 
-uint32_t Row::GetSerializedSize(Schema *schema) const {
-if(fields_.empty())
-  return 0;
-
-//header:
-auto ser_cnt = sizeof (uint32_t) + sizeof (uint64_t);
-
-for(auto field : fields_) {
-  ser_cnt += field->GetSerializedSize();
+void Row::clear_fields() {
+  for (auto field : fields_) {
+    field->~Field();
+    heap_->Free(field);
+  }
+  fields_.clear();
+  overflow_.clear();
+  // nothing else lives in a heap of the row's own
+  if (owns_heap_) static_cast<ArenaMemHeap *>(heap_)->Reset();
 }
 
-return ser_cnt;
+uint32_t Row::GetSerializedSize(Schema *schema) const {
+  if (fields_.empty()) return 0;
 
+  uint32_t ser_cnt = 1 + schema->GetNullBitmapSize() + schema->GetFixedSize() + sizeof(uint16_t) * schema->GetVarCount();
+  for (uint32_t i = 0; i < fields_.size(); i++) {
+    if (fields_[i]->IsNull() || schema->GetColumn(i)->GetType() != TypeId::kTypeChar) continue;
+    ser_cnt += IsOverflow(i) ? ROW_OVERFLOW_REF_SIZE : fields_[i]->GetLength();
+  }
+  return ser_cnt;
 }
@@ -0,0 +1,67 @@
+#include "record/row_view.h"
+
+RowView::RowView(const char *data, const Schema *schema) : data_(data), schema_(schema) {
+  if (schema->GetColumnCount() == 0) {
+    // an empty row is serialized as nothing at all
+    return;
+  }
+  field_count_ = schema->GetColumnCount();
+  if (static_cast<uint8_t>(data[0]) == ROW_COMPACT_FORMAT_TAG) {
+    compact_ = true;
+    null_map_ = data + 1;
+    fixed_ = null_map_ + schema->GetNullBitmapSize();
+    var_ends_ = fixed_ + schema->GetFixedSize();
+    var_data_ = var_ends_ + sizeof(uint16_t) * schema->GetVarCount();
+    return;
+  }
+  ASSERT(MACH_READ_UINT32(data) == field_count_, "RowView : Schema Not Match");
+  legacy_null_map_ = MACH_READ_UINT64(data + sizeof(uint32_t));
+  uint32_t offset = sizeof(uint32_t) + sizeof(uint64_t);
+  for (uint32_t i = 0; i < field_count_; i++) {
+    offsets_[i] = offset;
+    if (IsNull(i)) continue;
+    if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar) {
+      offset += sizeof(uint32_t) + MACH_READ_UINT32(data + offset);
+    } else {
+      offset += Type::GetTypeSize(schema->GetColumn(i)->GetType());
+    }
+  }
+  legacy_size_ = offset;
+}
+
+uint32_t RowView::GetSerializedSize() const {
+  if (!compact_) return legacy_size_;
+  uint32_t var_len = schema_->GetVarCount() == 0 ? 0 : var_end(schema_->GetVarCount() - 1);
+  return static_cast<uint32_t>(var_data_ - data_) + var_len;
+}
+
+Field RowView::GetField(uint32_t i) const {
+  TypeId type = schema_->GetColumn(i)->GetType();
+  if (IsNull(i)) return Field(type);
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, GetInt(i));
+    case TypeId::kTypeFloat:
+      return Field(type, GetFloat(i));
+    default: {
+      std::string_view chars = GetChars(i);
+      return Field(type, const_cast<char *>(chars.data()), chars.size(), false);
+    }
+  }
+}
+
+int RowView::CompareColumn(const RowView &other, uint32_t i) const {
+  if (IsNull(i) || other.IsNull(i)) return 0;
+  switch (schema_->GetColumn(i)->GetType()) {
+    case TypeId::kTypeInt: {
+      int32_t lhs = GetInt(i), rhs = other.GetInt(i);
+      return (lhs > rhs) - (lhs < rhs);
+    }
+    case TypeId::kTypeFloat: {
+      float lhs = GetFloat(i), rhs = other.GetFloat(i);
+      return (lhs > rhs) - (lhs < rhs);
+    }
+    default:
+      return GetChars(i).compare(other.GetChars(i));
+  }
+}
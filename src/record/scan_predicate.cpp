@@ -0,0 +1,104 @@
+#include "record/scan_predicate.h"
+
+#include <cstring>
+#include <unordered_map>
+
+/**
+ * Comparison against a null key, nothing compares equal, less or greater than null
+ */
+class EmptyScanPredicate : public ScanPredicate {
+public:
+  EmptyScanPredicate(const Schema *schema, uint32_t column_index, CompareOp op)
+      : ScanPredicate(schema, column_index, op) {}
+
+  bool Evaluate(const char *data) const override { return false; }
+
+  bool EvaluateField(const Field &field) const override { return false; }
+
+  void EvaluateColumn(const char *values, uint32_t width, const uint64_t *nulls, uint32_t n,
+                      uint64_t *sel) const override {
+    memset(sel, 0, sizeof(uint64_t) * ((n + 63) / 64));
+  }
+
+  bool MayMatch(const ColumnZone &zone) const override { return false; }
+};
+
+ScanPredicate::ScanPredicate(const Schema *schema, uint32_t column_index, CompareOp op)
+    : schema_(schema), column_index_(column_index), op_(op) {
+  uint32_t slot = schema->GetFieldSlot(column_index);
+  uint32_t fixed_begin = 1 + schema->GetNullBitmapSize();
+  uint32_t var_ends_begin = fixed_begin + schema->GetFixedSize();
+  null_byte_ = 1 + column_index / 8;
+  null_mask_ = static_cast<uint8_t>(1 << (column_index % 8));
+  if (schema->GetColumn(column_index)->GetType() == TypeId::kTypeChar) {
+    value_offset_ = var_ends_begin + sizeof(uint16_t) * slot;
+    has_prev_var_ = slot > 0;
+  } else {
+    value_offset_ = fixed_begin + slot;
+    has_prev_var_ = false;
+  }
+  var_data_offset_ = var_ends_begin + sizeof(uint16_t) * schema->GetVarCount();
+}
+
+void ScanPredicate::EvaluateBatch(const char *const *rows, uint32_t n, uint64_t *sel) const {
+  memset(sel, 0, sizeof(uint64_t) * ((n + 63) / 64));
+  for (uint32_t i = 0; i < n; i++) sel[i / 64] |= uint64_t(Evaluate(rows[i])) << (i % 64);
+}
+
+template <typename T>
+static std::unique_ptr<ScanPredicate> create_typed(const Schema *schema, uint32_t column_index, CompareOp op,
+                                                   typename TypedScanPredicate<T, CompareOp::kEq>::KeyType key) {
+  switch (op) {
+    case CompareOp::kEq:
+      return std::make_unique<TypedScanPredicate<T, CompareOp::kEq>>(schema, column_index, std::move(key));
+    case CompareOp::kNe:
+      return std::make_unique<TypedScanPredicate<T, CompareOp::kNe>>(schema, column_index, std::move(key));
+    case CompareOp::kLt:
+      return std::make_unique<TypedScanPredicate<T, CompareOp::kLt>>(schema, column_index, std::move(key));
+    case CompareOp::kLe:
+      return std::make_unique<TypedScanPredicate<T, CompareOp::kLe>>(schema, column_index, std::move(key));
+    case CompareOp::kGt:
+      return std::make_unique<TypedScanPredicate<T, CompareOp::kGt>>(schema, column_index, std::move(key));
+    default:
+      return std::make_unique<TypedScanPredicate<T, CompareOp::kGe>>(schema, column_index, std::move(key));
+  }
+}
+
+std::unique_ptr<ScanPredicate> ScanPredicate::Create(const Schema *schema, uint32_t column_index, CompareOp op,
+                                                     const Field &key) {
+  // only the null bit is looked at, the type does not matter
+  if (op == CompareOp::kIsNull) {
+    return std::make_unique<TypedScanPredicate<int32_t, CompareOp::kIsNull>>(schema, column_index, 0);
+  }
+  if (op == CompareOp::kNotNull) {
+    return std::make_unique<TypedScanPredicate<int32_t, CompareOp::kNotNull>>(schema, column_index, 0);
+  }
+  if (key.IsNull()) return std::make_unique<EmptyScanPredicate>(schema, column_index, op);
+
+  TypeId type = schema->GetColumn(column_index)->GetType();
+  ASSERT(key.GetTypeId() == type, "ScanPredicate::Create : Key Type Not Match");
+  switch (type) {
+    case TypeId::kTypeInt: {
+      char buf[sizeof(int32_t)];
+      key.SerializeTo(buf);
+      return create_typed<int32_t>(schema, column_index, op, MACH_READ_INT32(buf));
+    }
+    case TypeId::kTypeFloat: {
+      char buf[sizeof(float)];
+      key.SerializeTo(buf);
+      return create_typed<float>(schema, column_index, op, MACH_READ_FROM(float, buf));
+    }
+    default:
+      return create_typed<std::string_view>(schema, column_index, op, std::string(key.GetData(), key.GetLength()));
+  }
+}
+
+bool ScanPredicate::ParseOp(const std::string &token, CompareOp &op) {
+  static const std::unordered_map<std::string, CompareOp> ops{
+      {"=", CompareOp::kEq},  {"<>", CompareOp::kNe}, {"<", CompareOp::kLt},      {"<=", CompareOp::kLe},
+      {">", CompareOp::kGt},  {">=", CompareOp::kGe}, {"is", CompareOp::kIsNull}, {"not", CompareOp::kNotNull}};
+  auto it = ops.find(token);
+  if (it == ops.end()) return false;
+  op = it->second;
+  return true;
+}
@@ -1,6 +1,18 @@
 #include "record/schema.h"
 #include <iostream>
 
+void Schema::init_layout() {
+  field_slots_.resize(columns_.size());
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i]->GetType() == TypeId::kTypeChar) {
+      field_slots_[i] = var_count_++;
+    } else {
+      field_slots_[i] = fixed_size_;
+      fixed_size_ += Type::GetTypeSize(columns_[i]->GetType());
+    }
+  }
+}
+
 uint32_t Schema::SerializeTo(char *buf) const {
   // replace with your code here
   uint32_t ser_cnt = 0;
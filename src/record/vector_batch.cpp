@@ -0,0 +1,64 @@
+#include "record/vector_batch.h"
+
+#include <algorithm>
+
+ColumnVector::ColumnVector(const Column *column)
+    : type_(column->GetType()),
+      width_(type_ == TypeId::kTypeChar ? sizeof(uint16_t) + column->GetLength() : sizeof(int32_t)),
+      values_(static_cast<size_t>(width_) * VECTOR_BATCH_SIZE) {
+  Clear();
+}
+
+void ColumnVector::Gather(uint32_t first, const char *values, const uint64_t *nulls, const uint32_t *slots,
+                          uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t slot = slots[i];
+    if ((nulls[slot / 64] >> (slot % 64)) & 1) {
+      SetNull(first + i);
+      continue;
+    }
+    const char *value = values + slot * width_;
+    // only the chars in use are copied, the rest of a char slot is never read
+    uint32_t size = type_ == TypeId::kTypeChar ? sizeof(uint16_t) + MACH_READ_FROM(uint16_t, value) : width_;
+    memcpy(value_at(first + i), value, size);
+  }
+}
+
+Field ColumnVector::GetField(uint32_t i) const {
+  if (IsNull(i)) return Field(type_);
+  const char *value = values_.data() + i * width_;
+  switch (type_) {
+    case TypeId::kTypeInt:
+      return Field(type_, MACH_READ_FROM(int32_t, value));
+    case TypeId::kTypeFloat:
+      return Field(type_, MACH_READ_FROM(float, value));
+    default:
+      return Field(type_, const_cast<char *>(value) + sizeof(uint16_t), MACH_READ_FROM(uint16_t, value), false);
+  }
+}
+
+VectorBatch::VectorBatch(const Schema *schema, const std::vector<uint32_t> &columns)
+    : vectors_(schema->GetColumnCount()) {
+  for (auto i : columns) {
+    if (vectors_[i] != nullptr) continue;
+    vectors_[i] = std::make_unique<ColumnVector>(schema->GetColumn(i));
+    columns_.push_back(i);
+  }
+  std::sort(columns_.begin(), columns_.end());
+}
+
+void VectorBatch::Select(const uint64_t *sel) {
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < selected_; i++) {
+    uint32_t slot = selection_[i];
+    // written unconditionally, the loop has no branch to mispredict
+    selection_[kept] = slot;
+    kept += (sel[slot / 64] >> (slot % 64)) & 1;
+  }
+  selected_ = kept;
+}
+
+void VectorBatch::Reset() {
+  for (auto i : columns_) vectors_[i]->Clear();
+  size_ = selected_ = 0;
+}
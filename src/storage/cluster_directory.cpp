@@ -0,0 +1,74 @@
+#include "storage/cluster_directory.h"
+
+#include <algorithm>
+#include <iterator>
+
+bool ClusterKeyLess::operator()(const ClusterKey &lhs, const ClusterKey &rhs) const {
+  for (size_t i = 0; i < std::min(lhs.size(), rhs.size()); i++) {
+    if (lhs[i].CompareLessThan(rhs[i]) == CmpBool::kTrue) return true;
+    if (rhs[i].CompareLessThan(lhs[i]) == CmpBool::kTrue) return false;
+  }
+  return false;
+}
+
+static Field OwnedField(const Field &field) {
+  if (field.GetTypeId() != TypeId::kTypeChar || field.IsNull()) return Field(field);
+  return Field(TypeId::kTypeChar, const_cast<char *>(field.GetData()), field.GetLength(), true);
+}
+
+ClusterKey ClusterDirectory::MakeKey(const Row &row, const std::vector<uint32_t> &columns) {
+  ClusterKey key;
+  key.reserve(columns.size());
+  for (auto column : columns) key.push_back(OwnedField(*row.GetField(column)));
+  return key;
+}
+
+ClusterKey ClusterDirectory::MakeKey(const RowView &view, const std::vector<uint32_t> &columns) {
+  ClusterKey key;
+  key.reserve(columns.size());
+  for (auto column : columns) key.push_back(OwnedField(view.GetField(column)));
+  return key;
+}
+
+void ClusterDirectory::Reset(page_id_t first_page_id) {
+  first_page_id_ = first_page_id;
+  separators_.clear();
+  entries_.clear();
+}
+
+page_id_t ClusterDirectory::Locate(const ClusterKey &key) const {
+  auto it = separators_.upper_bound(key);
+  return it == separators_.begin() ? first_page_id_ : std::prev(it)->second;
+}
+
+void ClusterDirectory::Range(const ClusterKey *lower, bool lower_strict, const ClusterKey *upper, bool upper_strict,
+                             std::vector<page_id_t> &pages) const {
+  if (lower != nullptr && upper != nullptr && ClusterKeyLess()(*upper, *lower)) return;
+  auto begin = lower == nullptr ? separators_.begin()
+                                : lower_strict ? separators_.upper_bound(*lower) : separators_.lower_bound(*lower);
+  auto end = upper == nullptr ? separators_.end()
+                              : upper_strict ? separators_.lower_bound(*upper) : separators_.upper_bound(*upper);
+  // the keys of the range start on the page before the first separator within it
+  auto first = begin == separators_.begin() ? first_page_id_ : std::prev(begin)->second;
+  if (first != INVALID_PAGE_ID) pages.push_back(first);
+  for (auto it = begin; it != end; ++it) pages.push_back(it->second);
+}
+
+std::vector<page_id_t> ClusterDirectory::GetPages() const {
+  std::vector<page_id_t> pages;
+  Range(nullptr, false, nullptr, false, pages);
+  return pages;
+}
+
+void ClusterDirectory::Add(const ClusterKey &separator, page_id_t page_id) {
+  auto it = separators_.emplace(separator, page_id);
+  ASSERT(it.second, "ClusterDirectory::Add : Separator Taken");
+  entries_[page_id] = it.first;
+}
+
+void ClusterDirectory::Remove(page_id_t page_id) {
+  auto it = entries_.find(page_id);
+  if (it == entries_.end()) return;
+  separators_.erase(it->second);
+  entries_.erase(it);
+}
@@ -17,8 +17,8 @@ page_id_t DiskManager::GetBlockId(page_id_t logical_page_id) { return logical_pa
 page_id_t DiskManager::GetLocalId(page_id_t logical_page_id) { return logical_page_id % BITMAP_SIZE; }
 
 page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
-  auto n_block = GetLocalId(logical_page_id);
-  auto n_local = GetBlockId(logical_page_id);
+  auto n_block = GetBlockId(logical_page_id);
+  auto n_local = GetLocalId(logical_page_id);
   return n_block * (1 + BITMAP_SIZE) + 1 + n_local + 1;
 }
 
@@ -124,7 +124,8 @@ void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
   auto *bit_map = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(buf);
   auto *dMeta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
 
-  ASSERT(bit_map->DeAllocatePage(local_id), "Free NULL page id");
+  [[maybe_unused]] bool is_freed = bit_map->DeAllocatePage(local_id);
+  ASSERT(is_freed, "Free NULL page id");
 
   dMeta->num_allocated_pages_ -= 1;
   dMeta->extent_used_page_[block_id] -= 1;
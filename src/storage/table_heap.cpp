@@ -1,45 +1,444 @@
 #include "storage/table_heap.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "common/worker_pool.h"
+#include "record/row_view.h"
+
 #define TUPLE_SIZE 8
 
-bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
+TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
+                     LogManager *log_manager, LockManager *lock_manager, TableLayout layout,
+                     const std::vector<uint32_t> &cluster_key)
+    : buffer_pool_manager_(buffer_pool_manager),
+      schema_(schema),
+      zone_map_(schema->GetColumnCount()),
+      cluster_key_(cluster_key),
+      may_overflow_(can_overflow(schema, layout, cluster_key)),
+      log_manager_(log_manager),
+      lock_manager_(lock_manager) {
+  ASSERT(cluster_key.empty() || layout == TableLayout::kRow, "TableHeap : Only Rows Are Clustered");
+  if (layout == TableLayout::kColumn) column_layout_.emplace(schema);
+  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(first_page_id_));
+  ASSERT(first_page != nullptr, "TableHeap : First Page Allocation failed");
+  init_page(first_page, first_page_id_, INVALID_PAGE_ID, txn);
+
+  auto fsm_page = buffer_pool_manager_->NewPage(fsm_page_id_);
+  ASSERT(fsm_page != nullptr, "TableHeap : Free Space Map Allocation failed");
+  reinterpret_cast<FreeSpacePage *>(fsm_page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(fsm_page_id_, true);
+
+  // a new heap has an empty map, nothing to read back
+  fsm_loaded_ = true;
+  fsm_last_page_id_ = fsm_page_id_;
+  register_page(first_page);
+  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  directory_loaded_ = true;
+  directory_.Reset(first_page_id_);
+}
+
+void TableHeap::init_page(TablePage *page, page_id_t page_id, page_id_t prev_id, Transaction *txn) {
+  // an empty page is summarized from the start
+  zone_map_.Track(page_id, true);
+  if (column_layout_) {
+    // writes to a column page skip log_manager_ and lock_manager_: TablePage only passes them on and neither
+    // records anything yet, a column page needs log records and tuple locks of its own once they do
+    as_column_page(page)->Init(page_id, prev_id);
+    return;
+  }
+  page->Init(page_id, prev_id, log_manager_, txn);
+  page->SetNextPageId(INVALID_PAGE_ID);
+}
+
+bool TableHeap::insert_into(TablePage *page, Row &row, Transaction *txn) {
+  // not logged or locked on a column page, see init_page
+  bool is_inserted = column_layout_ ? as_column_page(page)->InsertTuple(row, *column_layout_)
+                                    : page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+  if (is_inserted) zone_map_.Insert(page->GetTablePageId(), row);
+  return is_inserted;
+}
+
+bool TableHeap::read_tuple(TablePage *page, Row *row, Transaction *txn) {
+  return column_layout_ ? as_column_page(page)->GetTuple(row, *column_layout_)
+                        : page->GetTuple(row, schema_, txn, lock_manager_);
+}
+
+bool TableHeap::read_moved_tuple(TablePage *page, Row *row, Transaction *txn) {
+  if (!read_tuple(page, row, txn)) return false;
+  if (!row->HasOverflow()) return true;
+  std::vector<std::pair<uint32_t, OverflowRef>> refs;
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    if (row->IsOverflow(i)) refs.emplace_back(i, row->GetOverflow(i));
+  }
+  ReadOverflow(*row);
+  for (auto &ref : refs) row->SetOverflow(ref.first, ref.second);
+  return true;
+}
+
+void TableHeap::summarize_page(TablePage *page) {
+  auto page_id = page->GetTablePageId();
+  ColumnZone *zones = zone_map_.GetZones(page_id);
+  RowId rid;
+  if (column_layout_) {
+    auto column_page = as_column_page(page);
+    if (column_page->GetFirstTupleRid(&rid)) {
+      do {
+        for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+          zones[i].Add(column_page->GetField(rid.GetSlotNum(), i, *column_layout_));
+        }
+      } while (column_page->GetNextTupleRid(rid, &rid));
+    }
+  } else if (page->GetFirstTupleRid(&rid)) {
+    do {
+      RowView view(page->GetTupleData(rid.GetSlotNum()), schema_);
+      for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+        if (!view.IsOverflow(i)) {
+          zones[i].Add(view.GetField(i));
+          continue;
+        }
+        std::string chars = read_chain(view.GetOverflow(i));
+        zones[i].Add(Field(TypeId::kTypeChar, chars.data(), chars.size(), false));
+      }
+    } while (page->GetNextTupleRid(rid, &rid));
+  }
+  zone_map_.SetSummarized(page_id);
+}
+
+int64_t TableHeap::remain_of(TablePage *page) {
+  return column_layout_ ? as_column_page(page)->GetRemain(*column_layout_) : page->GetRemain();
+}
+
+uint32_t TableHeap::page_room() const {
+  return column_layout_ ? column_layout_->GetCapacity() * column_layout_->GetTupleSize()
+                        : TablePage::SIZE_MAX_ROW + TUPLE_SIZE;
+}
+
+bool TableHeap::is_empty(TablePage *page) {
+  return column_layout_ ? as_column_page(page)->GetSlotCount() == 0 : page->GetTupleCount() == 0;
+}
+
+void TableHeap::load_free_space_map() {
+  while (load_fsm_page()) {
+  }
+}
+
+bool TableHeap::load_fsm_page() {
+  if (fsm_loaded_) return false;
+  if (fsm_page_id_ == INVALID_PAGE_ID) {
+    // heap written before free space maps existed
+    fsm_loaded_ = true;
+    build_free_space_map();
+    return true;
+  }
+  auto cur_page_id = fsm_next_page_id_;
+  auto page = buffer_pool_manager_->FetchPage(cur_page_id);
+  ASSERT(page != nullptr, "TableHeap::load_fsm_page : NULL page encountered");
+  auto fsm_page = reinterpret_cast<FreeSpacePage *>(page->GetData());
+  if (cur_page_id == fsm_page_id_) last_page_id_ = fsm_page->GetHeapTailPageId();
+  for (uint32_t slot = 0; slot < fsm_page->GetCount(); slot++) {
+    auto heap_page_id = fsm_page->GetHeapPageId(slot);
+    // the entry of a page freed by VACUUM
+    if (heap_page_id == INVALID_PAGE_ID) {
+      fsm_free_slots_.emplace_back(cur_page_id, slot);
+      continue;
+    }
+    auto bucket = fsm_page->GetBucket(slot);
+    fsm_entries_[heap_page_id] = {cur_page_id, slot, bucket};
+    Pages[int64_t(0) - bucket].insert(heap_page_id);
+  }
+  fsm_last_page_id_ = cur_page_id;
+  fsm_next_page_id_ = fsm_page->GetNextPageId();
+  buffer_pool_manager_->UnpinPage(cur_page_id, false);
+  fsm_loaded_ = fsm_next_page_id_ == INVALID_PAGE_ID;
+  return true;
+}
+
+void TableHeap::build_free_space_map() {
+  auto fsm_page = buffer_pool_manager_->NewPage(fsm_page_id_);
+  ASSERT(fsm_page != nullptr, "TableHeap::build_free_space_map : Free Space Map Allocation failed");
+  reinterpret_cast<FreeSpacePage *>(fsm_page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(fsm_page_id_, true);
+  fsm_last_page_id_ = fsm_page_id_;
+  notify_root();
+
+  auto cur_page_id = first_page_id_;
+  while (cur_page_id != INVALID_PAGE_ID) {
+    auto cur_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(cur_page_id));
+    ASSERT(cur_page != nullptr, "TableHeap::build_free_space_map : NULL page encountered");
+    register_page(cur_page);
+    auto next_page_id = cur_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(cur_page_id, false);
+    cur_page_id = next_page_id;
+  }
+}
+
+void TableHeap::register_page(TablePage *page, bool tail) {
+  auto page_id = page->GetTablePageId();
+  auto bucket = FreeSpacePage::ToBucket(0 - remain_of(page));
+
+  if (!fsm_free_slots_.empty()) {
+    // take the slot of a page freed by VACUUM before growing the map
+    auto [fsm_page_id, slot] = fsm_free_slots_.back();
+    fsm_free_slots_.pop_back();
+    auto fsm_page = reinterpret_cast<FreeSpacePage *>(buffer_pool_manager_->FetchPage(fsm_page_id)->GetData());
+    fsm_page->Reuse(slot, page_id, bucket);
+    buffer_pool_manager_->UnpinPage(fsm_page_id, true);
+    fsm_entries_[page_id] = {fsm_page_id, slot, bucket};
+  } else {
+    append_fsm_entry(page_id, bucket);
+  }
+  Pages[int64_t(0) - bucket].insert(page_id);
+  if (!tail) return;
+
+  // the heap tail lives in the first map page
+  last_page_id_ = page_id;
+  auto root_page = reinterpret_cast<FreeSpacePage *>(buffer_pool_manager_->FetchPage(fsm_page_id_)->GetData());
+  root_page->SetHeapTailPageId(page_id);
+  buffer_pool_manager_->UnpinPage(fsm_page_id_, true);
+}
+
+void TableHeap::append_fsm_entry(page_id_t page_id, uint32_t bucket) {
+  auto fsm_page = reinterpret_cast<FreeSpacePage *>(buffer_pool_manager_->FetchPage(fsm_last_page_id_)->GetData());
+  if (fsm_page->IsFull()) {
+    // chain a new map page behind the last one
+    page_id_t new_fsm_page_id = INVALID_PAGE_ID;
+    auto new_page = buffer_pool_manager_->NewPage(new_fsm_page_id);
+    ASSERT(new_page != nullptr, "TableHeap::register_page : Free Space Map Allocation failed");
+    fsm_page->SetNextPageId(new_fsm_page_id);
+    buffer_pool_manager_->UnpinPage(fsm_last_page_id_, true);
+    fsm_last_page_id_ = new_fsm_page_id;
+    fsm_page = reinterpret_cast<FreeSpacePage *>(new_page->GetData());
+    fsm_page->Init();
+  }
+  auto slot = fsm_page->Append(page_id, bucket);
+  buffer_pool_manager_->UnpinPage(fsm_last_page_id_, true);
+  fsm_entries_[page_id] = {fsm_last_page_id_, slot, bucket};
+}
+
+void TableHeap::update_free_space(TablePage *page) {
+  auto page_id = page->GetTablePageId();
+  auto it = fsm_entries_.find(page_id);
+  while (it == fsm_entries_.end() && load_fsm_page()) it = fsm_entries_.find(page_id);
+  ASSERT(it != fsm_entries_.end(), "TableHeap::update_free_space : Page not in free space map");
+  auto &entry = it->second;
+  auto bucket = FreeSpacePage::ToBucket(0 - remain_of(page));
+  if (bucket == entry.bucket) return;
+
+  erase_page(page_id, entry.bucket);
+  Pages[int64_t(0) - bucket].insert(page_id);
+  entry.bucket = bucket;
+
+  auto fsm_page = reinterpret_cast<FreeSpacePage *>(buffer_pool_manager_->FetchPage(entry.fsm_page_id)->GetData());
+  fsm_page->SetBucket(entry.slot, bucket);
+  buffer_pool_manager_->UnpinPage(entry.fsm_page_id, true);
+}
+
+bool TableHeap::InsertTuple(Row &row, Transaction *txn, const MoveCallback &moved) {
+  // the long chars go to overflow chains first, what is left of the row has to fit a page
+  if (may_overflow_) store_overflow(row);
+  bool is_inserted = insert_row(row, txn, moved);
+  if (!hold_insert_page_) unpin_insert_page();
+  if (row.HasOverflow()) {
+    if (!is_inserted) free_overflow(row);
+    row.ClearOverflow();
+  }
+  return is_inserted;
+}
+
+bool TableHeap::insert_row(Row &row, Transaction *txn, const MoveCallback &moved) {
   // too large to be stored inside.
-  auto row_size = row.GetSerializedSize(schema_) + TUPLE_SIZE;
+  uint32_t row_size;
+  if (column_layout_) {
+    // a slot of a column page holds any row whose chars keep to their declared lengths
+    if (!column_layout_->Fits(row)) return false;
+    row_size = column_layout_->GetTupleSize();
+  } else {
+    row_size = row.GetSerializedSize(schema_) + TUPLE_SIZE;
+  }
   if (row_size >= PAGE_SIZE) {
-    LOG(INFO) <<"Wrong !!!";
+    LOG(WARNING) << "TableHeap::InsertTuple : Row of " << row_size << " bytes does not fit a page";
     return false;
   }
-  bool isInsertSuccess = false;
-  if (row_size > 0 - Pages.begin()->first) {
-//    LOG(INFO) << Pages.begin()->first;
-    // No page is enough for insertion
-    page_id_t new_page_id = INVALID_PAGE_ID;
-    auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id));
-    auto old_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-
-    ASSERT(new_page != nullptr && old_page != nullptr, "TableHeap::InsertTuple : Null While Allocating New Page");
-
-    // set this page to the front of the list.
-    new_page->Init(new_page_id, INVALID_PAGE_ID, log_manager_, txn);
-    new_page->SetNextPageId(first_page_id_);
-    old_page->SetPrevPageId(new_page_id);
-
-    first_page_id_ = new_page->GetTablePageId();
-    isInsertSuccess = new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-    INSERT(Pages, new_page);
-    buffer_pool_manager_->UnpinPage(new_page->GetTablePageId(), true);
-    buffer_pool_manager_->UnpinPage(old_page->GetTablePageId(), true);
-  } else {
+  if (IsClustered()) return insert_clustered(row, txn, moved);
+  // keep filling the held target, its map entry is brought up to date once it is released
+  if (insert_page_ != nullptr && insert_into(insert_page_, row, txn)) {
+    return true;
+  }
+  unpin_insert_page();
+
+  // the page with the most free space, if its bucket guarantees room for the row. The map is read
+  // a page at a time, until one of the pages it lists has room.
+  auto has_room = [&]() { return !Pages.empty() && row_size <= (0 - Pages.begin()->first) * FSM_BUCKET_SIZE; };
+  while (!has_room() && load_fsm_page()) {
+  }
+  if (has_room()) {
     auto that_page_id = *(Pages.begin()->second.begin());
-    auto that_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(that_page_id));
-    ASSERT(that_page != nullptr, "TableHeap::InsertTuple : Null While Fetching Page");
-    ERASE(Pages, that_page);
-    isInsertSuccess = that_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-    INSERT(Pages, that_page);
-    buffer_pool_manager_->UnpinPage(that_page->GetTablePageId(), true);
+    insert_page_ = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(that_page_id));
+    ASSERT(insert_page_ != nullptr, "TableHeap::InsertTuple : Null While Fetching Page");
+    if (insert_into(insert_page_, row, txn)) return true;
+    unpin_insert_page();
+  }
+
+  // No page is enough for insertion, append a new page to the tail so that first_page_id_ stays put,
+  // the new tail stays pinned as the insertion target
+  insert_page_ = new_page_after(last_page_id_, txn);
+  return insert_into(insert_page_, row, txn);
+}
+
+TablePage *TableHeap::new_page_after(page_id_t prev_id, Transaction *txn) {
+  // the entry of the new page goes behind the last map page
+  load_free_space_map();
+  page_id_t new_page_id = INVALID_PAGE_ID;
+  auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id));
+  ASSERT(new_page != nullptr, "TableHeap::new_page_after : Null While Allocating New Page");
+  init_page(new_page, new_page_id, prev_id, txn);
+
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  if (prev_id == INVALID_PAGE_ID) {
+    // the heap was emptied by FreeHeap
+    first_page_id_ = new_page_id;
+  } else {
+    auto prev_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_id));
+    ASSERT(prev_page != nullptr, "TableHeap::new_page_after : Null While Fetching Page");
+    next_page_id = prev_page->GetNextPageId();
+    prev_page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(prev_id, true);
+  }
+  if (next_page_id != INVALID_PAGE_ID) {
+    auto next_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    ASSERT(next_page != nullptr, "TableHeap::new_page_after : Null While Fetching Page");
+    next_page->SetPrevPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(next_page_id, true);
+    new_page->SetNextPageId(next_page_id);
+  }
+  register_page(new_page, next_page_id == INVALID_PAGE_ID);
+  if (prev_id == INVALID_PAGE_ID) notify_root();
+  return new_page;
+}
+
+void TableHeap::load_directory() {
+  if (directory_loaded_) return;
+  directory_loaded_ = true;
+  directory_.Reset(first_page_id_);
+  if (first_page_id_ == INVALID_PAGE_ID) return;
+  auto cur_page_id = first_page_id_;
+  while (cur_page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(cur_page_id));
+    ASSERT(page != nullptr, "TableHeap::load_directory : NULL page encountered");
+    // the smallest key of a page separates it from the page before
+    std::optional<ClusterKey> separator;
+    RowId rid;
+    if (cur_page_id != first_page_id_ && page->GetFirstTupleRid(&rid)) {
+      do {
+        auto key = ClusterDirectory::MakeKey(RowView(page->GetTupleData(rid.GetSlotNum()), schema_), cluster_key_);
+        if (!separator || ClusterKeyLess()(key, *separator)) separator.emplace(std::move(key));
+      } while (page->GetNextTupleRid(rid, &rid));
+    }
+    if (separator) directory_.Add(*separator, cur_page_id);
+    auto next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(cur_page_id, false);
+    cur_page_id = next_page_id;
+  }
+}
+
+bool TableHeap::insert_clustered(Row &row, Transaction *txn, const MoveCallback &moved) {
+  load_directory();
+  if (first_page_id_ == INVALID_PAGE_ID) {
+    // the heap was emptied by FreeHeap
+    auto page = new_page_after(INVALID_PAGE_ID, txn);
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+    directory_.Reset(first_page_id_);
+  }
+  auto key = ClusterDirectory::MakeKey(row, cluster_key_);
+  // every split leaves fewer tuples on the page of the key, until the row fits
+  while (true) {
+    auto page_id = directory_.Locate(key);
+    // the page of the key is the insertion target, while it is held keys that follow each other keep filling it
+    if (insert_page_ == nullptr || insert_page_->GetTablePageId() != page_id) {
+      unpin_insert_page();
+      insert_page_ = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+      ASSERT(insert_page_ != nullptr, "TableHeap::insert_clustered : Invalid Fetch");
+    }
+    if (insert_into(insert_page_, row, txn)) return true;
+    unpin_insert_page();
+    if (!split_page(page_id, key, txn, moved)) return false;
+  }
+}
+
+bool TableHeap::split_page(page_id_t page_id, const ClusterKey &key, Transaction *txn, const MoveCallback &moved) {
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "TableHeap::split_page : Invalid Fetch");
+  std::vector<std::pair<ClusterKey, RowId>> tuples;
+  RowId rid;
+  if (page->GetFirstTupleRid(&rid)) {
+    do {
+      tuples.emplace_back(ClusterDirectory::MakeKey(RowView(page->GetTupleData(rid.GetSlotNum()), schema_),
+                                                    cluster_key_),
+                          rid);
+    } while (page->GetNextTupleRid(rid, &rid));
+  }
+  auto less = [](const std::pair<ClusterKey, RowId> &lhs, const std::pair<ClusterKey, RowId> &rhs) {
+    return ClusterKeyLess()(lhs.first, rhs.first);
+  };
+  std::sort(tuples.begin(), tuples.end(), less);
+
+  // the tuples and key in key order are split in half, a key above all others starts the new page by itself
+  // so that keys inserted in ascending order fill their pages
+  size_t rank = 0;
+  while (rank < tuples.size() && ClusterKeyLess()(tuples[rank].first, key)) rank++;
+  size_t split = rank == tuples.size() ? rank : (tuples.size() + 1) / 2;
+  const ClusterKey &separator = split == rank ? key : split < rank ? tuples[split].first : tuples[split - 1].first;
+  // only tuples whose delete is not applied yet are left to move, key cannot go anywhere else
+  if (directory_.HasSeparator(separator)) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return false;
+  }
+
+  auto new_page = new_page_after(page_id, txn);
+  std::vector<RowId> rids;
+  for (auto &tuple : tuples) {
+    if (!ClusterKeyLess()(tuple.first, separator)) rids.push_back(tuple.second);
   }
+  [[maybe_unused]] bool is_moved = move_tuples(page, rids, new_page, txn, moved);
+  ASSERT(is_moved, "TableHeap::split_page : Tuples Do Not Fit An Empty Page");
+  directory_.Add(separator, new_page->GetTablePageId());
+  update_free_space(page);
+  update_free_space(new_page);
+  buffer_pool_manager_->UnpinPage(new_page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  return true;
+}
+
+bool TableHeap::move_tuples(TablePage *page, const std::vector<RowId> &rids, TablePage *target, Transaction *txn,
+                            const MoveCallback &moved) {
+  auto page_id = page->GetTablePageId();
+  for (auto &old_rid : rids) {
+    Row row(old_rid);
+    [[maybe_unused]] bool is_read = read_moved_tuple(page, &row, txn);
+    ASSERT(is_read, "TableHeap::move_tuples : Invalid Tuple");
+    if (!insert_into(target, row, txn)) return false;
+    zone_map_.Remove(page_id, row);
+    page->ApplyDelete(old_rid, txn, log_manager_);
+    if (!moved) continue;
+    // the overflow chains move along with their references, the callback sees the whole row
+    row.ClearOverflow();
+    moved(row, old_rid);
+  }
+  return true;
+}
 
-  return isInsertSuccess;
+void TableHeap::ReleaseInsertPage() {
+  hold_insert_page_ = false;
+  unpin_insert_page();
+}
+
+void TableHeap::unpin_insert_page() {
+  if (insert_page_ == nullptr) return;
+  update_free_space(insert_page_);
+  buffer_pool_manager_->UnpinPage(insert_page_->GetTablePageId(), true);
+  insert_page_ = nullptr;
 }
 
 bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
@@ -50,34 +449,75 @@ bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
     return false;
   }
 
-  ERASE(Pages, page);
-  // Otherwise, mark the tuple as deleted.
+  // Otherwise, mark the tuple as deleted. The space is only reclaimed by ApplyDelete.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  // the zones only cover visible tuples, the old values are needed to take the tuple out
+  Row old_row(rid);
+  bool in_zone = zone_map_.IsSummarized(rid.GetPageId()) && read_tuple(page, &old_row, txn);
+  // not logged or locked on a column page, see init_page
+  bool is_marked = column_layout_ ? as_column_page(page)->MarkDelete(rid)
+                                  : page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  if (in_zone && is_marked) zone_map_.Remove(rid.GetPageId(), old_row);
   page->WUnlatch();
-  INSERT(Pages, page);
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
   return true;
 }
 
-bool TableHeap::UpdateTuple(const Row &row, const RowId &rid, Transaction *txn) {
-  if (row.GetSerializedSize(schema_) > PAGE_SIZE) return false;
+bool TableHeap::UpdateTuple(const Row &new_row, const RowId &rid, Transaction *txn) {
+  // the long chars of the new row go to chains of their own, those of the old tuple are freed once it is replaced
+  std::optional<Row> stored;
+  if (may_overflow_) {
+    stored.emplace(new_row);
+    store_overflow(*stored);
+  }
+  const Row &row = stored ? *stored : new_row;
+  auto release = [&](bool is_updated) {
+    if (!is_updated && stored) free_overflow(*stored);
+    return is_updated;
+  };
+  if (row.GetSerializedSize(schema_) > PAGE_SIZE) return release(false);
 
   auto that_page_id = rid.GetPageId();
   auto that_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(that_page_id));
 
   ASSERT(that_page != nullptr, "TableHeap::UpdateTuple : Fetching Null Tuple");
-  ASSERT(HAS(Pages, that_page), "TableHeap::UpdateTuple : Fetching Null Tuple");
-
-  ERASE(Pages, that_page);
+  std::vector<page_id_t> old_chains;
+  if (may_overflow_) collect_overflow(that_page, rid.GetSlotNum(), old_chains);
 
-  Row old_row_slot(rid);
-  bool isUpdateSuccess = that_page->UpdateTuple(row, &old_row_slot, schema_, txn, lock_manager_, log_manager_);
-  INSERT(Pages, that_page);
+  Row old_row(rid);
+  bool in_zone = zone_map_.IsSummarized(that_page_id) && read_tuple(that_page, &old_row, txn);
+  if (IsClustered()) {
+    // a new key may belong on another page
+    Row current_row(rid);
+    if (!read_tuple(that_page, &current_row, txn) ||
+        !ClusterDirectory::Equals(ClusterDirectory::MakeKey(current_row, cluster_key_),
+                                  ClusterDirectory::MakeKey(row, cluster_key_))) {
+      buffer_pool_manager_->UnpinPage(that_page_id, false);
+      return release(false);
+    }
+  }
+  bool isUpdateSuccess;
+  if (column_layout_) {
+    // not logged or locked, see init_page
+    isUpdateSuccess = column_layout_->Fits(row) && as_column_page(that_page)->UpdateTuple(row, rid, *column_layout_);
+  } else {
+    Row old_row_slot(rid);
+    isUpdateSuccess = that_page->UpdateTuple(row, &old_row_slot, schema_, txn, lock_manager_, log_manager_);
+  }
+  if (isUpdateSuccess) {
+    update_free_space(that_page);
+    if (in_zone) {
+      zone_map_.Remove(that_page_id, old_row);
+      zone_map_.Insert(that_page_id, row);
+    }
+  }
 
   buffer_pool_manager_->UnpinPage(that_page_id, isUpdateSuccess);
+  if (isUpdateSuccess) {
+    for (auto chain : old_chains) free_chain(chain);
+  }
 
-  return isUpdateSuccess;
+  return release(isUpdateSuccess);
 }
 
 void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
@@ -87,9 +527,19 @@ void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
 
   ASSERT(page != nullptr, "TableHeap::ApplyDelete : Page dose not exist");
-  ERASE(Pages, page);
-  page->ApplyDelete(rid, txn, log_manager_);
-  INSERT(Pages, page);
+  // a tuple still visible is an insert undone, a marked one has left the zones already
+  Row old_row(rid);
+  if (zone_map_.IsSummarized(page_id) && read_tuple(page, &old_row, txn)) zone_map_.Remove(page_id, old_row);
+  if (column_layout_) {
+    // not logged, see init_page
+    as_column_page(page)->ApplyDelete(rid);
+  } else {
+    std::vector<page_id_t> chains;
+    if (may_overflow_) collect_overflow(page, rid.GetSlotNum(), chains);
+    page->ApplyDelete(rid, txn, log_manager_);
+    for (auto chain : chains) free_chain(chain);
+  }
+  update_free_space(page);
   buffer_pool_manager_->UnpinPage(page_id, true);
 }
 
@@ -99,55 +549,327 @@ void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
   assert(page != nullptr);
   // Rollback the delete.
   page->WLatch();
-  ERASE(Pages, page);
-  page->RollbackDelete(rid, txn, log_manager_);
-  INSERT(Pages, page);
+  Row restored_row(rid);
+  bool was_visible = !zone_map_.IsSummarized(rid.GetPageId()) || read_tuple(page, &restored_row, txn);
+  if (column_layout_) {
+    // not logged, see init_page
+    as_column_page(page)->RollbackDelete(rid);
+  } else {
+    page->RollbackDelete(rid, txn, log_manager_);
+  }
+  if (!was_visible && read_tuple(page, &restored_row, txn)) {
+    if (restored_row.HasOverflow()) ReadOverflow(restored_row);
+    zone_map_.Insert(rid.GetPageId(), restored_row);
+  }
+  update_free_space(page);
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
 void TableHeap::FreeHeap() {
-  for (auto &page_batch : Pages) {
-    for (auto &page : page_batch.second) buffer_pool_manager_->DeletePage(page);
+  unpin_insert_page();
+  auto cur_page_id = first_page_id_;
+  while (cur_page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(cur_page_id));
+    ASSERT(page != nullptr, "TableHeap::FreeHeap : NULL page encountered");
+    auto next_page_id = page->GetNextPageId();
+    std::vector<page_id_t> chains;
+    for (uint32_t slot = 0; may_overflow_ && slot < page->GetTupleCount(); slot++) {
+      collect_overflow(page, slot, chains);
+    }
+    buffer_pool_manager_->UnpinPage(cur_page_id, false);
+    for (auto chain : chains) free_chain(chain);
+    buffer_pool_manager_->DeletePage(cur_page_id);
+    cur_page_id = next_page_id;
   }
+  cur_page_id = fsm_page_id_;
+  while (cur_page_id != INVALID_PAGE_ID) {
+    auto page = buffer_pool_manager_->FetchPage(cur_page_id);
+    ASSERT(page != nullptr, "TableHeap::FreeHeap : NULL page encountered");
+    auto next_page_id = reinterpret_cast<FreeSpacePage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(cur_page_id, false);
+    buffer_pool_manager_->DeletePage(cur_page_id);
+    cur_page_id = next_page_id;
+  }
+  Pages.clear();
+  fsm_entries_.clear();
+  fsm_free_slots_.clear();
+  zone_map_.Clear();
+  directory_.Reset(INVALID_PAGE_ID);
   first_page_id_ = INVALID_PAGE_ID;
+  fsm_page_id_ = INVALID_PAGE_ID;
+  last_page_id_ = fsm_last_page_id_ = fsm_next_page_id_ = INVALID_PAGE_ID;
+  fsm_loaded_ = false;
+  notify_root();
 }
 
-void TableHeap::FetchAllIds(std::unordered_set<RowId> &ans_set) {
-  for (auto &page_group : Pages) {
-    for (auto &page_id : page_group.second) {
-      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-      ASSERT(page != nullptr, "Invalid Fetch");
-      RowId rid;
-      page->GetFirstTupleRid(&rid);
-      while (!(INVALID_ROWID == rid)) {
-        ans_set.insert(rid);
-        page->GetNextTupleRid(rid, &rid);
+uint32_t TableHeap::Vacuum(Transaction *txn, const MoveCallback &moved) {
+  unpin_insert_page();
+  load_free_space_map();
+  if (IsClustered()) return vacuum_clustered(txn, moved);
+  // the sparse pages, emptiest first
+  std::vector<std::pair<int64_t, page_id_t>> sparse;
+  for (auto &it : fsm_entries_) {
+    if (it.first == first_page_id_) continue;
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(it.first));
+    ASSERT(page != nullptr, "TableHeap::Vacuum : Invalid Fetch");
+    int64_t free_space = 0 - remain_of(page);
+    buffer_pool_manager_->UnpinPage(it.first, false);
+    if (free_space * 100 > int64_t(page_room()) * (100 - VACUUM_FILL_PERCENT)) sparse.emplace_back(free_space, it.first);
+  }
+  std::sort(sparse.begin(), sparse.end(), std::greater<>());
+
+  // tuples move from the emptiest pages to the fullest ones of the sparse pages, until the two meet
+  uint32_t freed = 0;
+  size_t source = 0, target = sparse.size();
+  TablePage *target_page = nullptr;
+  auto next_target = [&]() {
+    if (target_page != nullptr) {
+      update_free_space(target_page);
+      buffer_pool_manager_->UnpinPage(target_page->GetTablePageId(), true);
+    }
+    target_page = --target > source
+                      ? reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(sparse[target].second))
+                      : nullptr;
+  };
+  next_target();
+  for (; target_page != nullptr && source < target; source++) {
+    auto page_id = sparse[source].second;
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "TableHeap::Vacuum : Invalid Fetch");
+    RowId rid, next_rid;
+    bool has_next = column_layout_ ? as_column_page(page)->GetFirstTupleRid(&rid) : page->GetFirstTupleRid(&rid);
+    while (has_next && target_page != nullptr) {
+      Row row(rid);
+      [[maybe_unused]] bool is_read = read_moved_tuple(page, &row, txn);
+      ASSERT(is_read, "TableHeap::Vacuum : Invalid Tuple");
+      if (!insert_into(target_page, row, txn)) {
+        next_target();
+        continue;
+      }
+      has_next = column_layout_ ? as_column_page(page)->GetNextTupleRid(rid, &next_rid)
+                                : page->GetNextTupleRid(rid, &next_rid);
+      zone_map_.Remove(page_id, row);
+      if (column_layout_) {
+        // not logged, see init_page
+        as_column_page(page)->ApplyDelete(rid);
+      } else {
+        page->ApplyDelete(rid, txn, log_manager_);
       }
-      buffer_pool_manager_->UnpinPage(page_id, false);
+      row.ClearOverflow();
+      moved(row, rid);
+      rid = next_rid;
     }
+    // tuples whose delete is not applied yet keep their page
+    bool empty = is_empty(page);
+    if (!empty) update_free_space(page);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    if (empty) {
+      free_page(page_id);
+      freed++;
+    }
+  }
+  if (target_page != nullptr) {
+    update_free_space(target_page);
+    buffer_pool_manager_->UnpinPage(target_page->GetTablePageId(), true);
   }
+  return freed;
 }
 
-void TableHeap::FetchId(std::unordered_set<RowId> &ans_set, std::size_t column_index, Schema *schema, const Field &key,
-                        const std::function<bool(const Field &, const Field &)> &filter) {
-  for (auto &page_group : Pages) {
-    for (auto &page_id : page_group.second) {
-      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-      ASSERT(page != nullptr, "Invalid Fetch");
+uint32_t TableHeap::vacuum_clustered(Transaction *txn, const MoveCallback &moved) {
+  load_directory();
+  uint32_t freed = 0;
+  auto pages = directory_.GetPages();
+  // merge the following pages into a page while their tuples fit it
+  for (size_t i = 0, next = 1; next < pages.size(); i = next++) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(pages[i]));
+    ASSERT(page != nullptr, "TableHeap::vacuum_clustered : Invalid Fetch");
+    for (; next < pages.size(); next++) {
+      auto next_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(pages[next]));
+      ASSERT(next_page != nullptr, "TableHeap::vacuum_clustered : Invalid Fetch");
+      // a tuple whose delete is rolled back must find its page where its key is
+      bool fits =
+          !next_page->HasMarkedTuples() && int64_t(page_room()) + remain_of(next_page) <= 0 - remain_of(page);
+      std::vector<RowId> rids;
       RowId rid;
-      page->GetFirstTupleRid(&rid);
-      while (!(INVALID_ROWID == rid)) {
-        Row row(rid);
-        page->GetTuple(&row, schema, nullptr, nullptr);
+      if (fits && next_page->GetFirstTupleRid(&rid)) {
+        do {
+          rids.push_back(rid);
+        } while (next_page->GetNextTupleRid(rid, &rid));
+      }
+      [[maybe_unused]] bool is_moved = fits && move_tuples(next_page, rids, page, txn, moved);
+      ASSERT(!fits || is_moved, "TableHeap::vacuum_clustered : Tuples Do Not Fit");
+      buffer_pool_manager_->UnpinPage(pages[next], fits);
+      if (!fits) break;
+      directory_.Remove(pages[next]);
+      free_page(pages[next]);
+      freed++;
+    }
+    update_free_space(page);
+    buffer_pool_manager_->UnpinPage(pages[i], true);
+  }
+  return freed;
+}
 
-        if (filter(*row.GetField(column_index), key)) ans_set.insert(rid);
+void TableHeap::free_page(page_id_t page_id) {
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "TableHeap::free_page : Invalid Fetch");
+  auto prev_page_id = page->GetPrevPageId(), next_page_id = page->GetNextPageId();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  // the first page is never freed, there is always a page before
+  auto prev_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_page_id));
+  ASSERT(prev_page != nullptr, "TableHeap::free_page : Invalid Fetch");
+  prev_page->SetNextPageId(next_page_id);
+  buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  if (next_page_id != INVALID_PAGE_ID) {
+    auto next_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    ASSERT(next_page != nullptr, "TableHeap::free_page : Invalid Fetch");
+    next_page->SetPrevPageId(prev_page_id);
+    buffer_pool_manager_->UnpinPage(next_page_id, true);
+  } else {
+    last_page_id_ = prev_page_id;
+    auto root_page = reinterpret_cast<FreeSpacePage *>(buffer_pool_manager_->FetchPage(fsm_page_id_)->GetData());
+    root_page->SetHeapTailPageId(prev_page_id);
+    buffer_pool_manager_->UnpinPage(fsm_page_id_, true);
+  }
 
-        page->GetNextTupleRid(rid, &rid);
+  auto &entry = fsm_entries_.at(page_id);
+  auto fsm_page = reinterpret_cast<FreeSpacePage *>(buffer_pool_manager_->FetchPage(entry.fsm_page_id)->GetData());
+  fsm_page->Remove(entry.slot);
+  buffer_pool_manager_->UnpinPage(entry.fsm_page_id, true);
+  fsm_free_slots_.emplace_back(entry.fsm_page_id, entry.slot);
+  erase_page(page_id, entry.bucket);
+  fsm_entries_.erase(page_id);
+  zone_map_.Forget(page_id);
+  buffer_pool_manager_->DeletePage(page_id);
+}
+
+void TableHeap::FetchAllIds(std::unordered_set<RowId> &ans_set) {
+  scan_pages(ans_set, [&](TablePage *page, std::vector<RowId> &rids) {
+    if (column_layout_) {
+      uint64_t visible[COLUMN_PAGE_MAX_WORDS];
+      auto column_page = as_column_page(page);
+      column_page->GetVisibleSlots(visible);
+      for (uint32_t w = 0; w * 64 < column_page->GetSlotCount(); w++) {
+        for (uint64_t bits = visible[w]; bits != 0; bits &= bits - 1) {
+          rids.emplace_back(page->GetTablePageId(), w * 64 + __builtin_ctzll(bits));
+        }
       }
-      buffer_pool_manager_->UnpinPage(page_id, false);
+      return;
+    }
+    RowId rid;
+    if (page->GetFirstTupleRid(&rid)) {
+      do {
+        rids.push_back(rid);
+      } while (page->GetNextTupleRid(rid, &rid));
+    }
+  });
+}
+
+void TableHeap::FetchId(std::unordered_set<RowId> &ans_set, const ScanPredicate &predicate) {
+  scan_pages(
+      ans_set, [&](TablePage *page, std::vector<RowId> &rids) { filter_page(page, predicate, rids); }, &predicate);
+}
+
+void TableHeap::filter_page(TablePage *page, const ScanPredicate &predicate, std::vector<RowId> &rids) {
+  if (column_layout_) {
+    as_column_page(page)->FilterTuples(predicate, *column_layout_, rids);
+    return;
+  }
+  page->FilterTuples(predicate, rids);
+  // a comparison leaves out the chars stored out of line, they are read and compared on their own
+  if (is_overflow_column(predicate.GetColumnIndex()) && predicate.GetOp() != CompareOp::kIsNull &&
+      predicate.GetOp() != CompareOp::kNotNull) {
+    filter_overflow(page, predicate, rids);
+  }
+}
+
+bool TableHeap::FetchKeyRange(std::unordered_set<RowId> &ans_set, CompareOp op, const Field &key) {
+  if (!IsClustered() || key.IsNull()) return false;
+  ClusterKey bound;
+  bound.emplace_back(key);
+  const ClusterKey *lower = nullptr, *upper = nullptr;
+  switch (op) {
+    case CompareOp::kEq:
+      lower = upper = &bound;
+      break;
+    case CompareOp::kLt:
+    case CompareOp::kLe:
+      upper = &bound;
+      break;
+    case CompareOp::kGt:
+    case CompareOp::kGe:
+      lower = &bound;
+      break;
+    default:
+      return false;
+  }
+  load_directory();
+  std::vector<page_id_t> page_ids;
+  directory_.Range(lower, op == CompareOp::kGt, upper, op == CompareOp::kLt, page_ids);
+  auto predicate = ScanPredicate::Create(schema_, cluster_key_[0], op, key);
+  scan_pages(
+      ans_set, [&](TablePage *page, std::vector<RowId> &rids) { page->FilterTuples(*predicate, rids); },
+      predicate.get(), &page_ids);
+  return true;
+}
+
+bool TableHeap::FindKey(const Row &row, RowId *rid) {
+  ASSERT(IsClustered(), "TableHeap::FindKey : Heap Not Clustered");
+  load_directory();
+  if (first_page_id_ == INVALID_PAGE_ID) return false;
+  auto key = ClusterDirectory::MakeKey(row, cluster_key_);
+  auto page_id = directory_.Locate(key);
+  // the pinned insertion target is read in place, the next key of a run of inserts is looked up on it
+  bool is_target = insert_page_ != nullptr && insert_page_->GetTablePageId() == page_id;
+  auto page = is_target ? insert_page_ : reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "TableHeap::FindKey : Invalid Fetch");
+  // the leading key column is matched on the tuple bytes, the rest only on the tuples that pass it
+  std::vector<RowId> candidates;
+  page->FilterTuples(*ScanPredicate::Create(schema_, cluster_key_[0], CompareOp::kEq, key[0]), candidates);
+  bool found = false;
+  for (auto &candidate : candidates) {
+    RowView view(page->GetTupleData(candidate.GetSlotNum()), schema_);
+    found = true;
+    for (uint32_t i = 1; found && i < cluster_key_.size(); i++) {
+      found = view.GetField(cluster_key_[i]).CompareEquals(key[i]) == CmpBool::kTrue;
+    }
+    if (found) {
+      if (rid != nullptr) *rid = candidate;
+      break;
     }
   }
+  if (!is_target) buffer_pool_manager_->UnpinPage(page_id, false);
+  return found;
+}
+
+void TableHeap::scan_pages(std::unordered_set<RowId> &ans_set,
+                           const std::function<void(TablePage *, std::vector<RowId> &)> &visit,
+                           const ScanPredicate *predicate, const std::vector<page_id_t> *candidates) {
+  std::vector<page_id_t> page_ids = scan_candidates(predicate, candidates);
+  size_t n_morsels = (page_ids.size() + SCAN_MORSEL_SIZE - 1) / SCAN_MORSEL_SIZE;
+  size_t n_workers = page_ids.size() < PARALLEL_SCAN_MIN_PAGES ? 1 : std::min<size_t>(scan_workers_, n_morsels);
+  std::atomic<size_t> next_morsel{0};
+  std::vector<std::vector<RowId>> buffers(n_workers);
+  auto work = [&](size_t worker) {
+    auto &buffer = buffers[worker];
+    for (size_t morsel = next_morsel++; morsel < n_morsels; morsel = next_morsel++) {
+      auto end = std::min(page_ids.size(), (morsel + 1) * SCAN_MORSEL_SIZE);
+      for (auto i = morsel * SCAN_MORSEL_SIZE; i < end; i++) {
+        auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_ids[i]));
+        ASSERT(page != nullptr, "TableHeap::scan_pages : Invalid Fetch");
+        visit(page, buffer);
+        if (!zone_map_.IsSummarized(page_ids[i])) summarize_page(page);
+        buffer_pool_manager_->UnpinPage(page_ids[i], false);
+      }
+    }
+  };
+  WorkerPool::Shared().Run(n_workers, work);
+
+  size_t total = ans_set.size();
+  for (auto &buffer : buffers) total += buffer.size();
+  ans_set.reserve(total);
+  for (auto &buffer : buffers) ans_set.insert(buffer.begin(), buffer.end());
 }
 
 bool TableHeap::GetTuple(Row *row, Transaction *txn) {
@@ -156,22 +878,262 @@ bool TableHeap::GetTuple(Row *row, Transaction *txn) {
 
   ASSERT(page != nullptr, "TableHeap::GetTuple : Row ID Dose Not Exist");
 
-  bool isGet = page->GetTuple(row, schema_, txn, lock_manager_);
+  bool isGet = read_tuple(page, row, txn);
   buffer_pool_manager_->UnpinPage(page_id, false);
   ASSERT(isGet, "xxx");
+  if (isGet && row->HasOverflow()) ReadOverflow(*row);
   return isGet;
 }
 
-TableIterator TableHeap::Begin(Transaction *txn) {
-  auto FirstPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (FirstPage == nullptr)
-    // first page is empty
-    return End();
-  auto row_id = INVALID_ROWID;
-  if (FirstPage->GetFirstTupleRid(&row_id)) {
-    return TableIterator(buffer_pool_manager_, FirstPage, schema_, row_id);
-  } else
-    return End();  // First tuple is empty,
+bool TableHeap::GetTuple(Row *row, Transaction *txn, const std::vector<uint32_t> &columns) {
+  auto page_id = row->GetRowId().GetPageId();
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "TableHeap::GetTuple : Row ID Dose Not Exist");
+  bool is_read = read_tuple(page, row, txn);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  if (is_read && row->HasOverflow()) ReadOverflow(*row, &columns);
+  return is_read;
+}
+
+void TableHeap::ReadOverflow(Row &row, const std::vector<uint32_t> *columns) {
+  auto read = [&](uint32_t column) {
+    if (!row.IsOverflow(column)) return;
+    row.FillOverflow(column, read_chain(row.GetOverflow(column)).data());
+  };
+  if (columns != nullptr) {
+    for (auto column : *columns) read(column);
+  } else {
+    for (uint32_t column = 0; column < row.GetFieldCount(); column++) read(column);
+  }
+}
+
+bool TableHeap::can_overflow(const Schema *schema, TableLayout layout, const std::vector<uint32_t> &cluster_key) {
+  if (layout != TableLayout::kRow) return false;
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    auto column = schema->GetColumn(i);
+    if (column->GetType() == TypeId::kTypeChar && column->GetLength() > TABLE_OVERFLOW_THRESHOLD &&
+        std::find(cluster_key.begin(), cluster_key.end(), i) == cluster_key.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TableHeap::is_overflow_column(uint32_t column) const {
+  return may_overflow_ && schema_->GetColumn(column)->GetType() == TypeId::kTypeChar &&
+         schema_->GetColumn(column)->GetLength() > TABLE_OVERFLOW_THRESHOLD &&
+         std::find(cluster_key_.begin(), cluster_key_.end(), column) == cluster_key_.end();
+}
+
+void TableHeap::store_overflow(Row &row) {
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    auto field = row.GetField(i);
+    if (row.IsOverflow(i) || field->IsNull() || field->GetTypeId() != TypeId::kTypeChar ||
+        field->GetLength() <= TABLE_OVERFLOW_THRESHOLD || !is_overflow_column(i)) {
+      continue;
+    }
+    row.SetOverflow(i, OverflowRef{write_chain(field->GetData(), field->GetLength()), field->GetLength()});
+  }
+}
+
+void TableHeap::free_overflow(const Row &row) {
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    if (row.IsOverflow(i)) free_chain(row.GetOverflow(i).page_id);
+  }
+}
+
+void TableHeap::collect_overflow(TablePage *page, uint32_t slot, std::vector<page_id_t> &chains) {
+  auto data = page->GetStoredTupleData(slot);
+  if (data == nullptr) return;
+  RowView view(data, schema_);
+  for (uint32_t i = 0; i < view.GetFieldCount(); i++) {
+    if (view.IsOverflow(i)) chains.push_back(view.GetOverflow(i).page_id);
+  }
+}
+
+page_id_t TableHeap::write_chain(const char *data, uint32_t size) {
+  // the pages are allocated back to front, so each one knows its successor when it is written
+  uint32_t page_count = std::max<uint32_t>(1, (size + OverflowPage::CAPACITY - 1) / OverflowPage::CAPACITY);
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  for (uint32_t i = page_count; i-- > 0;) {
+    page_id_t page_id = INVALID_PAGE_ID;
+    auto page = buffer_pool_manager_->NewPage(page_id);
+    ASSERT(page != nullptr, "TableHeap::write_chain : Overflow Page Allocation Failed");
+    auto overflow_page = reinterpret_cast<OverflowPage *>(page->GetData());
+    overflow_page->Init();
+    overflow_page->SetNextPageId(next_page_id);
+    uint32_t offset = i * OverflowPage::CAPACITY;
+    overflow_page->Write(data + offset, size - offset);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    next_page_id = page_id;
+  }
+  return next_page_id;
+}
+
+std::string TableHeap::read_chain(const OverflowRef &ref) {
+  std::string chars;
+  chars.reserve(ref.length);
+  for (auto page_id = ref.page_id; page_id != INVALID_PAGE_ID;) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    ASSERT(page != nullptr, "TableHeap::read_chain : Invalid Fetch");
+    auto overflow_page = reinterpret_cast<OverflowPage *>(page->GetData());
+    chars.append(overflow_page->GetChars(), overflow_page->GetSize());
+    auto next_page_id = overflow_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT(chars.size() == ref.length, "TableHeap::read_chain : Chain Length Not Match");
+  return chars;
+}
+
+void TableHeap::free_chain(page_id_t page_id) {
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    ASSERT(page != nullptr, "TableHeap::free_chain : Invalid Fetch");
+    auto next_page_id = reinterpret_cast<OverflowPage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::filter_overflow(TablePage *page, const ScanPredicate &predicate, std::vector<RowId> &rids) {
+  auto column = predicate.GetColumnIndex();
+  RowId rid;
+  if (!page->GetFirstTupleRid(&rid)) return;
+  do {
+    RowView view(page->GetTupleData(rid.GetSlotNum()), schema_);
+    if (!view.IsOverflow(column)) continue;
+    std::string chars = read_chain(view.GetOverflow(column));
+    if (predicate.EvaluateField(Field(TypeId::kTypeChar, chars.data(), chars.size(), false))) rids.push_back(rid);
+  } while (page->GetNextTupleRid(rid, &rid));
+}
+
+TableIterator TableHeap::Begin(Transaction *txn) { return TableIterator(this, first_page_id_); }
+
+TableIterator TableHeap::Begin(Transaction *txn, const std::vector<uint32_t> &columns) {
+  return TableIterator(this, first_page_id_, &columns);
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, const std::vector<uint32_t> &columns,
+                               const ScanPredicate &predicate) {
+  auto select = [this, &predicate](TablePage *page, std::vector<RowId> &rids) {
+    filter_page(page, predicate, rids);
+    if (!zone_map_.IsSummarized(page->GetTablePageId())) summarize_page(page);
+  };
+  return TableIterator(this, scan_candidates(&predicate, nullptr), select, &columns);
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, const std::vector<uint32_t> &columns, std::vector<RowId> rids) {
+  // ordered by page, the rows of a page follow each other
+  std::sort(rids.begin(), rids.end(), [](const RowId &lhs, const RowId &rhs) { return lhs.Get() < rhs.Get(); });
+  std::vector<page_id_t> pages;
+  for (auto &rid : rids) {
+    if (pages.empty() || pages.back() != rid.GetPageId()) pages.push_back(rid.GetPageId());
+  }
+  auto sorted = std::make_shared<std::vector<RowId>>(std::move(rids));
+  auto select = [sorted](TablePage *page, std::vector<RowId> &rids) {
+    auto by_page = [](const RowId &lhs, const RowId &rhs) { return lhs.GetPageId() < rhs.GetPageId(); };
+    auto range = std::equal_range(sorted->begin(), sorted->end(), RowId(page->GetTablePageId(), 0), by_page);
+    rids.insert(rids.end(), range.first, range.second);
+  };
+  return TableIterator(this, std::move(pages), select, &columns);
+}
+
+std::vector<page_id_t> TableHeap::ScanPages(const ScanPredicate *predicate) {
+  if (!IsClustered()) return scan_candidates(predicate, nullptr);
+  load_directory();
+  auto pages = directory_.GetPages();
+  return scan_candidates(predicate, &pages);
+}
+
+bool TableHeap::ReadBatch(page_id_t page_id, uint32_t &slot, VectorBatch &batch, bool summarize) {
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "TableHeap::ReadBatch : Invalid Fetch");
+  if (summarize && !zone_map_.IsSummarized(page_id)) summarize_page(page);
+  uint32_t room = VECTOR_BATCH_SIZE - batch.GetSize(), n = 0;
+  bool done;
+  if (column_layout_) {
+    // the minipages are copied a column at a time
+    auto column_page = as_column_page(page);
+    uint32_t slot_count = column_page->GetSlotCount(), slots[VECTOR_BATCH_SIZE];
+    uint64_t visible[COLUMN_PAGE_MAX_WORDS];
+    column_page->GetVisibleSlots(visible);
+    for (; slot < slot_count && n < room; slot++) {
+      if ((visible[slot / 64] >> (slot % 64)) & 1) slots[n++] = slot;
+    }
+    done = slot == slot_count;
+    uint32_t first = batch.Append(n);
+    for (auto i : batch.GetColumns()) {
+      batch.GetColumn(i).Gather(first, column_page->GetColumnValues(i, *column_layout_),
+                                column_page->GetColumnNulls(i, *column_layout_), slots, n);
+    }
+  } else {
+    const char *rows[VECTOR_BATCH_SIZE];
+    uint32_t tuple_count = page->GetTupleCount();
+    for (; slot < tuple_count && n < room; slot++) {
+      const char *data = page->GetTupleData(slot);
+      if (data != nullptr) rows[n++] = data;
+    }
+    done = slot == tuple_count;
+    uint32_t first = batch.Append(n);
+    for (uint32_t j = 0; j < n; j++) {
+      RowView view(rows[j], schema_);
+      for (auto i : batch.GetColumns()) {
+        auto &vector = batch.GetColumn(i);
+        if (view.IsNull(i)) {
+          vector.SetNull(first + j);
+        } else if (vector.GetType() == TypeId::kTypeInt) {
+          vector.SetInt(first + j, view.GetInt(i));
+        } else if (vector.GetType() == TypeId::kTypeFloat) {
+          vector.SetFloat(first + j, view.GetFloat(i));
+        } else if (view.IsOverflow(i)) {
+          vector.SetChars(first + j, read_chain(view.GetOverflow(i)));
+        } else {
+          vector.SetChars(first + j, view.GetChars(i));
+        }
+      }
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return done;
+}
+
+std::vector<page_id_t> TableHeap::scan_candidates(const ScanPredicate *predicate,
+                                                  const std::vector<page_id_t> *candidates) {
+  std::vector<page_id_t> page_ids;
+  auto consider = [&](page_id_t page_id) {
+    // entries are made before the workers start, they only fill in the zones of their own pages
+    if (!zone_map_.IsTracked(page_id)) zone_map_.Track(page_id, false);
+    if (predicate == nullptr || zone_map_.MayMatch(page_id, *predicate)) page_ids.push_back(page_id);
+  };
+  if (candidates != nullptr) {
+    for (auto page_id : *candidates) consider(page_id);
+  } else if (fsm_page_id_ == INVALID_PAGE_ID) {
+    // a heap written before free space maps existed is walked down its chain, a scan does not build the map
+    for (auto page_id : chain_page_ids()) consider(page_id);
+  } else {
+    // the free space map lists every heap page, no need to walk the chain to split it
+    load_free_space_map();
+    page_ids.reserve(fsm_entries_.size());
+    for (auto &it : fsm_entries_) consider(it.first);
+    std::sort(page_ids.begin(), page_ids.end());
+  }
+  return page_ids;
+}
+
+std::vector<page_id_t> TableHeap::chain_page_ids() {
+  std::vector<page_id_t> page_ids;
+  auto cur_page_id = first_page_id_;
+  while (cur_page_id != INVALID_PAGE_ID) {
+    page_ids.push_back(cur_page_id);
+    auto cur_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(cur_page_id));
+    ASSERT(cur_page != nullptr, "TableHeap::chain_page_ids : NULL page encountered");
+    auto next_page_id = cur_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(cur_page_id, false);
+    cur_page_id = next_page_id;
+  }
+  return page_ids;
 }
 
-TableIterator TableHeap::End() { return TableIterator(buffer_pool_manager_, nullptr, schema_); }
+TableIterator TableHeap::End() { return TableIterator(); }
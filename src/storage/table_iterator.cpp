@@ -2,76 +2,122 @@
 #include "common/macros.h"
 #include "storage/table_heap.h"
 
-Row *TableIterator::INVALID_ROW = new Row(INVALID_ROWID);
-std::map<Row *, uint32_t> TableIterator::ptr_refs = {};
+TableIterator::TableIterator() {}
 
-TableIterator::TableIterator()
-    : ThisManager(nullptr), ThisPage(nullptr), ThisSchema(nullptr), ThisRow(TableIterator::INVALID_ROW) {}
-
-TableIterator::TableIterator(BufferPoolManager *_bpm, TablePage *_tp, Schema *_s, const RowId &rid)
-    : ThisManager(_bpm), ThisPage(_tp), ThisSchema(_s), ThisRow(alloc_row(rid)) {}
-TableIterator::TableIterator(BufferPoolManager *_bpm, TablePage *_tp, Schema *_s)
-    : ThisManager(_bpm), ThisPage(_tp), ThisSchema(_s), ThisRow(TableIterator::INVALID_ROW) {}
-
-TableIterator::TableIterator(const TableIterator &other)
-    : ThisManager(other.ThisManager),
-      ThisPage(other.ThisPage),
-      ThisSchema(other.ThisSchema),
-      ThisRow(copy_row(other.ThisRow)) {}
-
-TableIterator::~TableIterator() { destroy_row(ThisRow); }
-
-bool TableIterator::operator==(const TableIterator &itr) const {
-  return itr.ThisRow->GetRowId() == ThisRow->GetRowId();
+TableIterator::TableIterator(TableHeap *table_heap, page_id_t page_id, const std::vector<uint32_t> *columns)
+    : table_heap_(table_heap),
+      buffer_pool_manager_(table_heap->buffer_pool_manager_),
+      schema_(table_heap->schema_),
+      column_layout_(table_heap->GetColumnLayout()) {
+  if (columns != nullptr) columns_ = *columns;
+  seek_page(page_id);
 }
 
-bool TableIterator::operator!=(const TableIterator &itr) const { return !(*this == itr); }
+TableIterator::TableIterator(TableHeap *table_heap, std::vector<page_id_t> pages, PageFilter select,
+                             const std::vector<uint32_t> *columns)
+    : table_heap_(table_heap),
+      buffer_pool_manager_(table_heap->buffer_pool_manager_),
+      schema_(table_heap->schema_),
+      column_layout_(table_heap->GetColumnLayout()),
+      pages_(std::move(pages)),
+      select_(std::move(select)) {
+  if (columns != nullptr) columns_ = *columns;
+  seek_page(next_page_id());
+}
 
-const Row &TableIterator::operator*() {
-  ASSERT(ThisPage->GetTuple(ThisRow, ThisSchema, nullptr, nullptr), "TableIterator::operator* : Invalid Fetch");
-  return *ThisRow;
+TableIterator::TableIterator(const TableIterator &other)
+    : table_heap_(other.table_heap_),
+      buffer_pool_manager_(other.buffer_pool_manager_),
+      schema_(other.schema_),
+      column_layout_(other.column_layout_),
+      pages_(other.pages_),
+      next_page_(other.next_page_),
+      select_(other.select_),
+      selected_(other.selected_),
+      next_selected_(other.next_selected_),
+      columns_(other.columns_),
+      row_(other.row_) {
+  if (other.page_ != nullptr) {
+    // each copy holds a pin of its own
+    page_ = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(other.page_->GetTablePageId()));
+    ASSERT(page_ != nullptr, "TableIterator : Invalid Fetch");
+  }
 }
 
-Row *TableIterator::operator->() {
-  ASSERT(ThisPage->GetTuple(ThisRow, ThisSchema, nullptr, nullptr), "TableIterator::operator* : Invalid Fetch");
-  return ThisRow;
+TableIterator::~TableIterator() {
+  if (page_ != nullptr) buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
 }
 
 TableIterator &TableIterator::operator++() {
-  auto next_rid = INVALID_ROWID;
-//  auto old_page_id =ThisPage->GetTablePageId(), next_page_id = ThisPage->GetNextPageId();
-  destroy_row(ThisRow);
-  if (!ThisPage->GetNextTupleRid(ThisRow->GetRowId(), &next_rid)) {
-    // this tuple is the last of this page;
-    ThisManager->UnpinPage(ThisPage->GetTablePageId(), ThisPage->IsDirty());
-    ThisPage = static_cast<TablePage *>(ThisManager->FetchPage(ThisPage->GetNextPageId()));
-    if (ThisPage) {
-      ThisPage->GetFirstTupleRid(&next_rid);
-      ThisRow = alloc_row(next_rid);
-    } else
-      ThisRow = TableIterator::INVALID_ROW;
-  } else  // this tuple is not the last tuple
-    ThisRow = alloc_row(next_rid);
-
+  ASSERT(page_ != nullptr, "TableIterator::operator++ : Iterator At End");
+  RowId rid;
+  if (next_rid(row_.GetRowId(), &rid)) {
+    row_.SetRowId(rid);
+    read_row();
+    return *this;
+  }
+  // the rest of this page is empty
+  seek_page(next_page_id());
   return *this;
 }
 
 TableIterator TableIterator::operator++(int) {
-  TableIterator itr = TableIterator(*this);
+  TableIterator itr(*this);
+  ++(*this);
+  return itr;
+}
 
-  auto next_rid = INVALID_ROWID;
-  destroy_row(ThisRow);
-  if (!ThisPage->GetNextTupleRid(ThisRow->GetRowId(), &next_rid)) {
-    // this tuple is the last of this page;
-    ThisPage = static_cast<TablePage *>(ThisManager->FetchPage(ThisPage->GetNextPageId()));
-    if (ThisPage) {
-      ThisPage->GetFirstTupleRid(&next_rid);
-      ThisRow = alloc_row(next_rid);
-    } else
-      ThisRow = TableIterator::INVALID_ROW;
+void TableIterator::seek_page(page_id_t page_id) {
+  while (true) {
+    if (page_ != nullptr) buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+    page_ = nullptr;
+    if (page_id == INVALID_PAGE_ID) {
+      row_.SetRowId(INVALID_ROWID);
+      return;
+    }
+    page_ = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page_ != nullptr, "TableIterator::seek_page : Invalid Fetch");
+    if (pages_) {
+      selected_.clear();
+      next_selected_ = 0;
+      select_(page_, selected_);
+    }
+    RowId rid;
+    if (first_rid(&rid)) {
+      row_.SetRowId(rid);
+      read_row();
+      return;
+    }
+    // skip pages emptied by deletes
+    page_id = next_page_id();
+  }
+}
 
-  } else  // this tuple is not the last tuple
-    ThisRow = alloc_row(next_rid);
+page_id_t TableIterator::next_page_id() {
+  if (!pages_) return page_->GetNextPageId();
+  return next_page_ < pages_->size() ? (*pages_)[next_page_++] : INVALID_PAGE_ID;
+}
 
-  return itr;
+bool TableIterator::first_rid(RowId *rid) {
+  if (pages_) return next_rid(INVALID_ROWID, rid);
+  if (column_layout_ != nullptr) return reinterpret_cast<ColumnPage *>(page_)->GetFirstTupleRid(rid);
+  return page_->GetFirstTupleRid(rid);
+}
+
+bool TableIterator::next_rid(const RowId &cur_rid, RowId *rid) {
+  if (pages_) {
+    if (next_selected_ == selected_.size()) return false;
+    *rid = selected_[next_selected_++];
+    return true;
+  }
+  if (column_layout_ != nullptr) return reinterpret_cast<ColumnPage *>(page_)->GetNextTupleRid(cur_rid, rid);
+  return page_->GetNextTupleRid(cur_rid, rid);
+}
+
+void TableIterator::read_row() {
+  [[maybe_unused]] bool is_read = column_layout_ != nullptr
+                                      ? reinterpret_cast<ColumnPage *>(page_)->GetTuple(&row_, *column_layout_)
+                                      : page_->GetTuple(&row_, schema_, nullptr, nullptr);
+  ASSERT(is_read, "TableIterator::read_row : Invalid Tuple");
+  if (row_.HasOverflow()) table_heap_->ReadOverflow(row_, columns_ ? &*columns_ : nullptr);
 }
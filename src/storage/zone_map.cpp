@@ -0,0 +1,58 @@
+#include "storage/zone_map.h"
+
+#include <algorithm>
+
+void ZoneMap::Track(page_id_t page_id, bool summarized) {
+  auto it = entries_.find(page_id);
+  if (it == entries_.end()) {
+    it = entries_.emplace(page_id, static_cast<uint32_t>(summarized_.size())).first;
+    summarized_.push_back(0);
+    pages_.push_back(page_id);
+    zones_.resize(zones_.size() + column_count_);
+  } else {
+    // a page id handed out again, forget what was on the page before
+    std::fill_n(zones_.begin() + it->second * column_count_, column_count_, ColumnZone());
+  }
+  summarized_[it->second] = summarized;
+}
+
+void ZoneMap::Insert(page_id_t page_id, const Row &row) {
+  if (!IsSummarized(page_id)) return;
+  ColumnZone *zones = GetZones(page_id);
+  for (uint32_t i = 0; i < column_count_; i++) zones[i].Add(*row.GetField(i));
+}
+
+void ZoneMap::Remove(page_id_t page_id, const Row &row) {
+  if (!IsSummarized(page_id)) return;
+  ColumnZone *zones = GetZones(page_id);
+  for (uint32_t i = 0; i < column_count_; i++) zones[i].Remove(*row.GetField(i));
+}
+
+bool ZoneMap::MayMatch(page_id_t page_id, const ScanPredicate &predicate) const {
+  auto it = entries_.find(page_id);
+  if (it == entries_.end() || !summarized_[it->second]) return true;
+  return predicate.MayMatch(zones_[it->second * column_count_ + predicate.GetColumnIndex()]);
+}
+
+void ZoneMap::Forget(page_id_t page_id) {
+  auto it = entries_.find(page_id);
+  if (it == entries_.end()) return;
+  uint32_t entry = it->second, last = static_cast<uint32_t>(pages_.size()) - 1;
+  entries_.erase(it);
+  if (entry != last) {
+    std::copy_n(zones_.begin() + last * column_count_, column_count_, zones_.begin() + entry * column_count_);
+    summarized_[entry] = summarized_[last];
+    pages_[entry] = pages_[last];
+    entries_[pages_[entry]] = entry;
+  }
+  pages_.pop_back();
+  summarized_.pop_back();
+  zones_.resize(zones_.size() - column_count_);
+}
+
+void ZoneMap::Clear() {
+  entries_.clear();
+  pages_.clear();
+  summarized_.clear();
+  zones_.clear();
+}
@@ -70,4 +70,33 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+
+TEST(BufferPoolManagerTest, DeletePageTest) {
+  const std::string db_name = "bpm_test.db";
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(2, disk_manager);
+
+  page_id_t page_ids[3];
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+  // a pinned page stays, a buffered one and one only on disk are both given back to the disk manager
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[2]));
+  EXPECT_FALSE(bpm->DeletePage(page_ids[2]));
+  EXPECT_FALSE(bpm->IsPageFree(page_ids[2]));
+  bpm->UnpinPage(page_ids[2], false);
+  EXPECT_TRUE(bpm->DeletePage(page_ids[2]));
+  EXPECT_TRUE(bpm->IsPageFree(page_ids[2]));
+  EXPECT_TRUE(bpm->DeletePage(page_ids[0]));
+  EXPECT_TRUE(bpm->IsPageFree(page_ids[0]));
+  EXPECT_FALSE(bpm->IsPageFree(page_ids[1]));
+
+  disk_manager->Close();
+  remove(db_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
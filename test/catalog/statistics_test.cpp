@@ -0,0 +1,174 @@
+#include "catalog/statistics.h"
+
+#include "catalog/catalog.h"
+#include "common/instance.h"
+#include "gtest/gtest.h"
+
+static string db_file_name = "statistics_test.db";
+using Fields = std::vector<Field>;
+
+TEST(StatisticsTest, HyperLogLogTest) {
+  HyperLogLog many;
+  for (int32_t i = 0; i < 100000; i++) many.Insert(reinterpret_cast<const char *>(&i), sizeof(i));
+  EXPECT_NEAR(100000, many.Estimate(), 100000 * 0.05);
+  // repeated values are counted once, few values are counted almost exactly
+  HyperLogLog few;
+  for (int32_t i = 0; i < 100000; i++) {
+    int32_t value = i % 100;
+    few.Insert(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+  EXPECT_NEAR(100, few.Estimate(), 3);
+  EXPECT_EQ(0, HyperLogLog().Estimate());
+}
+
+TEST(StatisticsTest, CollectTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 20000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  for (auto layout : {TableLayout::kRow, TableLayout::kColumn}) {
+    TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap, layout);
+    // every fourth name is null, the others repeat 50 names, nine scores out of ten are 0
+    for (int i = 0; i < row_nums; i++) {
+      std::string name = "name" + std::to_string(i % 50);
+      Fields fields;
+      fields.reserve(3);
+      fields.emplace_back(TypeId::kTypeInt, i);
+      if (i % 4 == 0) {
+        fields.emplace_back(TypeId::kTypeChar);
+      } else {
+        fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true);
+      }
+      fields.emplace_back(TypeId::kTypeFloat, i % 10 == 0 ? static_cast<float>(i) : 0.0f);
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+    table_heap->ReleaseInsertPage();
+
+    auto *statistics = TableStatistics::Create(&heap);
+    statistics->Collect(table_heap);
+    ASSERT_EQ(static_cast<uint32_t>(row_nums), statistics->GetRowCount());
+    ASSERT_EQ(table_heap->ScanPages(nullptr).size(), statistics->GetPageCount());
+    ASSERT_EQ(3u, statistics->GetColumnCount());
+    EXPECT_EQ(0u, statistics->GetNullCount(0));
+    EXPECT_EQ(static_cast<uint32_t>(row_nums / 4), statistics->GetNullCount(1));
+    EXPECT_NEAR(row_nums, statistics->GetDistinctCount(0), row_nums * 0.05);
+    EXPECT_NEAR(50, statistics->GetDistinctCount(1), 2);
+    auto &bounds = statistics->GetBounds(0);
+    ASSERT_EQ(static_cast<size_t>(STATS_HISTOGRAM_BUCKETS + 1), bounds.size());
+    EXPECT_EQ(0, bounds.front());
+    EXPECT_EQ(row_nums - 1, bounds.back());
+
+    // ranges are read off the histogram, keys out of it match nothing
+    EXPECT_NEAR(0.25, statistics->Selectivity(0, CompareOp::kLt, Field(TypeId::kTypeInt, row_nums / 4)), 0.02);
+    EXPECT_NEAR(0.75, statistics->Selectivity(0, CompareOp::kGe, Field(TypeId::kTypeInt, row_nums / 4)), 0.02);
+    EXPECT_NEAR(1.0 / row_nums, statistics->Selectivity(0, CompareOp::kEq, Field(TypeId::kTypeInt, 7)), 1e-4);
+    EXPECT_EQ(0, statistics->Selectivity(0, CompareOp::kEq, Field(TypeId::kTypeInt, row_nums)));
+    EXPECT_EQ(0, statistics->Selectivity(0, CompareOp::kGt, Field(TypeId::kTypeInt, row_nums)));
+    EXPECT_EQ(0, statistics->Selectivity(0, CompareOp::kLt, Field(TypeId::kTypeInt, -1)));
+    EXPECT_EQ(0, statistics->Selectivity(0, CompareOp::kEq, Field(TypeId::kTypeInt)));
+    // nulls match neither side of a compare
+    char name[] = "name7";
+    double equal = statistics->Selectivity(1, CompareOp::kEq, Field(TypeId::kTypeChar, name, 5, false));
+    EXPECT_NEAR(0.75 / 50, equal, 0.002);
+    EXPECT_NEAR(0.75 - equal, statistics->Selectivity(1, CompareOp::kNe, Field(TypeId::kTypeChar, name, 5, false)),
+                1e-9);
+    EXPECT_DOUBLE_EQ(0.25, statistics->Selectivity(1, CompareOp::kIsNull, Field(TypeId::kTypeChar)));
+    EXPECT_DOUBLE_EQ(0.75, statistics->Selectivity(1, CompareOp::kNotNull, Field(TypeId::kTypeChar)));
+    // a value filling most of the histogram is known to be frequent, though there are many distinct values
+    EXPECT_NEAR(0.9, statistics->Selectivity(2, CompareOp::kEq, Field(TypeId::kTypeFloat, 0.0f)), 0.05);
+    EXPECT_NEAR(0.1, statistics->Selectivity(2, CompareOp::kGt, Field(TypeId::kTypeFloat, 0.0f)), 0.05);
+
+    // a few rows are cheaper to look up, most of the table cheaper to scan
+    EXPECT_LT(statistics->IndexScanCost(10), statistics->ScanCost());
+    EXPECT_GT(statistics->IndexScanCost(row_nums * 0.9), statistics->ScanCost());
+    // so are a few keys of a join, while a key for each row costs more than the scan
+    EXPECT_LT(statistics->LookupCost(10, 10), statistics->ScanCost());
+    EXPECT_GT(statistics->LookupCost(row_nums, row_nums), statistics->ScanCost());
+  }
+}
+
+TEST(StatisticsTest, SerializeTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("note", TypeId::kTypeChar, 16, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  for (int i = 0; i < 1000; i++) {
+    Fields fields;
+    fields.reserve(2);
+    fields.emplace_back(TypeId::kTypeInt, i * 3);
+    fields.emplace_back(TypeId::kTypeChar);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  table_heap->ReleaseInsertPage();
+  auto *statistics = TableStatistics::Create(&heap);
+  statistics->Collect(table_heap);
+  // a column of nulls has no histogram
+  ASSERT_TRUE(statistics->GetBounds(1).empty());
+
+  char buf[PAGE_SIZE];
+  memset(buf, 0, sizeof(buf));
+  auto *other = TableStatistics::Create(&heap);
+  ASSERT_EQ(0u, other->DeserializeFrom(buf));
+  uint32_t size = statistics->SerializeTo(buf);
+  ASSERT_EQ(statistics->GetSerializedSize(), size);
+  ASSERT_EQ(size, other->DeserializeFrom(buf));
+  ASSERT_EQ(statistics->GetRowCount(), other->GetRowCount());
+  ASSERT_EQ(statistics->GetPageCount(), other->GetPageCount());
+  for (uint32_t i = 0; i < 2; i++) {
+    EXPECT_EQ(statistics->GetNullCount(i), other->GetNullCount(i));
+    EXPECT_EQ(statistics->GetDistinctCount(i), other->GetDistinctCount(i));
+    EXPECT_EQ(statistics->GetBounds(i), other->GetBounds(i));
+  }
+
+  // shrinking merges buckets but keeps the least and the greatest key
+  ASSERT_TRUE(statistics->Shrink(size - 1));
+  EXPECT_LE(statistics->GetSerializedSize(), size - 1);
+  EXPECT_EQ(static_cast<size_t>(STATS_HISTOGRAM_BUCKETS / 2 + 1), statistics->GetBounds(0).size());
+  EXPECT_EQ(0, statistics->GetBounds(0).front());
+  EXPECT_EQ(2997, statistics->GetBounds(0).back());
+  ASSERT_FALSE(statistics->Shrink(16));
+}
+
+TEST(StatisticsTest, AnalyzeTableTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), &txn, table_info));
+  ASSERT_EQ(nullptr, table_info->GetStatistics());
+  for (int i = 0; i < 500; i++) {
+    Fields fields;
+    fields.reserve(2);
+    fields.emplace_back(TypeId::kTypeInt, i);
+    fields.emplace_back(TypeId::kTypeFloat, i * 0.5f);
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  TableStatistics *statistics = nullptr;
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_01->AnalyzeTable("table-0", statistics));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1", statistics));
+  ASSERT_EQ(statistics, table_info->GetStatistics());
+  ASSERT_EQ(500u, statistics->GetRowCount());
+  auto bounds = statistics->GetBounds(1);
+  delete db_01;
+
+  // the statistics are loaded with the table
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  TableInfo *table_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info_02));
+  ASSERT_NE(nullptr, table_info_02->GetStatistics());
+  EXPECT_EQ(500u, table_info_02->GetStatistics()->GetRowCount());
+  EXPECT_EQ(bounds, table_info_02->GetStatistics()->GetBounds(1));
+  delete db_02;
+}
@@ -0,0 +1,79 @@
+#include <cstdio>
+#include <string>
+
+#include "executor/csv_reader.h"
+#include "gtest/gtest.h"
+
+static const std::string file_name = "csv_reader_test.csv";
+
+static void WriteFile(const std::string &content) {
+  FILE *file = fopen(file_name.c_str(), "wb");
+  fwrite(content.data(), 1, content.size(), file);
+  fclose(file);
+}
+
+TEST(CsvReaderTest, FieldTest) {
+  WriteFile("1,abc,2.5\r\n\n2,\"a,\"\"b\"\"\nc\",\n3,\"\",-1");
+  CsvReader reader(file_name);
+  ASSERT_TRUE(reader.IsOpen());
+  std::vector<CsvField> fields;
+
+  ASSERT_TRUE(reader.NextRecord(fields));
+  ASSERT_EQ(3, fields.size());
+  ASSERT_EQ("1", fields[0].text);
+  ASSERT_EQ("abc", fields[1].text);
+  ASSERT_EQ("2.5", fields[2].text);
+  ASSERT_EQ(1, reader.GetLineNo());
+
+  // blank line skipped, quoted field with a comma, quotes and a newline, empty field is null
+  ASSERT_TRUE(reader.NextRecord(fields));
+  ASSERT_EQ(3, fields.size());
+  ASSERT_EQ("a,\"b\"\nc", fields[1].text);
+  ASSERT_FALSE(fields[1].is_null);
+  ASSERT_TRUE(fields[2].is_null);
+  ASSERT_EQ(4, reader.GetLineNo());
+
+  // quoted empty string is not null, last record without a newline
+  ASSERT_TRUE(reader.NextRecord(fields));
+  ASSERT_EQ(3, fields.size());
+  ASSERT_EQ("", fields[1].text);
+  ASSERT_FALSE(fields[1].is_null);
+  ASSERT_EQ("-1", fields[2].text);
+  ASSERT_EQ(5, reader.GetLineNo());
+
+  ASSERT_FALSE(reader.NextRecord(fields));
+  ASSERT_FALSE(reader.IsMalformed());
+  remove(file_name.c_str());
+}
+
+TEST(CsvReaderTest, LargeFileTest) {
+  // records cross the read buffer boundary
+  const int n = 200000;
+  std::string content;
+  for (int i = 0; i < n; i++) content += std::to_string(i) + ",\"name " + std::to_string(i) + "\"\n";
+  ASSERT_GT(content.size(), CSV_READ_BUFFER_SIZE);
+  WriteFile(content);
+  CsvReader reader(file_name);
+  std::vector<CsvField> fields;
+  int i = 0;
+  while (reader.NextRecord(fields)) {
+    ASSERT_EQ(2, fields.size());
+    ASSERT_EQ(std::to_string(i), fields[0].text);
+    ASSERT_EQ("name " + std::to_string(i), fields[1].text);
+    i++;
+  }
+  ASSERT_EQ(n, i);
+  ASSERT_FALSE(reader.IsMalformed());
+  remove(file_name.c_str());
+}
+
+TEST(CsvReaderTest, MalformedTest) {
+  WriteFile("1,a\n2,\"b\"c\n3,d\n");
+  CsvReader reader(file_name);
+  std::vector<CsvField> fields;
+  ASSERT_TRUE(reader.NextRecord(fields));
+  ASSERT_FALSE(reader.NextRecord(fields));
+  ASSERT_TRUE(reader.IsMalformed());
+  ASSERT_EQ(2, reader.GetLineNo());
+  remove(file_name.c_str());
+}
@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "executor/execute_engine.h"
+#include "index/generic_key.h"
+#include "gtest/gtest.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+static const std::string db_name = "execute_engine_test";
+
+/**
+ * Parse and execute one statement
+ */
+static dberr_t Execute(ExecuteEngine &engine, const std::string &sql) {
+  YY_BUFFER_STATE bp = yy_scan_string(sql.c_str());
+  yy_switch_to_buffer(bp);
+  MinisqlParserInit();
+  yyparse();
+  dberr_t res = DB_FAILED;
+  if (!MinisqlParserGetError()) {
+    ExecuteContext context;
+    res = engine.Execute(MinisqlGetParserRootNode(), &context);
+  }
+  MinisqlParserFinish();
+  yy_delete_buffer(bp);
+  yylex_destroy();
+  return res;
+}
+
+/**
+ * Execute a select and collect the fields of the rows it prints
+ */
+static std::vector<std::vector<std::string>> Select(ExecuteEngine &engine, const std::string &sql) {
+  testing::internal::CaptureStdout();
+  dberr_t res = Execute(engine, sql);
+  std::stringstream out(testing::internal::GetCapturedStdout());
+  EXPECT_EQ(DB_SUCCESS, res) << sql;
+  std::vector<std::vector<std::string>> rows;
+  std::string line;
+  while (std::getline(out, line)) {
+    if (line.empty() || line[0] != '|') continue;
+    // |row number|field|field|...|
+    std::vector<std::string> fields;
+    std::stringstream cells(line.substr(1));
+    std::string cell;
+    std::getline(cells, cell, '|');
+    while (std::getline(cells, cell, '|')) fields.push_back(cell.substr(0, cell.find_last_not_of(' ') + 1));
+    rows.push_back(std::move(fields));
+  }
+  return rows;
+}
+
+static std::set<int> SelectIds(ExecuteEngine &engine, const std::string &sql) {
+  std::set<int> ids;
+  for (auto &row : Select(engine, sql)) ids.insert(std::stoi(row[0]));
+  return ids;
+}
+
+/**
+ * A fresh database with table t of 200 rows, k = 1000 + id and an index on k
+ */
+static void CreateTable(ExecuteEngine &engine) {
+  Execute(engine, "drop database " + db_name + ";");
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create database " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "use " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create table t(id int, k int unique, name char(16), primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create index idx_k on t(k);"));
+  for (int i = 0; i < 200; i++) {
+    std::string values = std::to_string(i) + ", " + std::to_string(1000 + i) + ", \"name" + std::to_string(i % 10);
+    ASSERT_EQ(DB_SUCCESS, Execute(engine, "insert into t values(" + values + "\");"));
+  }
+}
+
+TEST(ExecuteEngineTest, IndexedConjunctTest) {
+  ExecuteEngine engine;
+  CreateTable(engine);
+
+  // the index on k finds the candidates, the rest of the conjunction filters them
+  std::set<int> expected;
+  for (int i = 3; i < 50; i += 10) expected.insert(i);
+  ASSERT_EQ(expected, SelectIds(engine, "select id from t where k < 1050 and name = \"name3\";"));
+  ASSERT_EQ(expected, SelectIds(engine, "select id from t where name = \"name3\" and k < 1050;"));
+  expected = {41, 42, 43, 44, 45, 46, 47, 48, 49};
+  ASSERT_EQ(expected, SelectIds(engine, "select id from t where k < 1050 and id > 40;"));
+  expected = {41, 42, 44, 45, 46, 47, 48, 49};
+  ASSERT_EQ(expected, SelectIds(engine, "select id from t where k < 1050 and id > 40 and name <> \"name3\";"));
+  expected.clear();
+  ASSERT_EQ(expected, SelectIds(engine, "select id from t where k = 1003 and name = \"name4\";"));
+
+  // either side of an or may come from the index
+  expected = {3, 13, 195, 196};
+  ASSERT_EQ(expected,
+            SelectIds(engine, "select id from t where k < 1020 and name = \"name3\" or k > 1194 and name <> \"name7\" "
+                              "and id < 197;"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "drop database " + db_name + ";"));
+}
+
+TEST(ExecuteEngineTest, UpdateTest) {
+  ExecuteEngine engine;
+  CreateTable(engine);
+
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "update t set name = \"updated\" where k < 1050 and name = \"name3\";"));
+  auto rows = Select(engine, "select id, name from t where k < 1100;");
+  ASSERT_EQ(100u, rows.size());
+  for (auto &row : rows) {
+    int id = std::stoi(row[0]);
+    ASSERT_EQ(id < 50 && id % 10 == 3 ? "updated" : "name" + std::to_string(id % 10), row[1]) << "row " << id;
+  }
+
+  // an update of the key of an index moves the row in it
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "update t set k = 5000 where id = 5;"));
+  std::set<int> expected = {5};
+  ASSERT_EQ(expected, SelectIds(engine, "select id from t where k = 5000;"));
+  ASSERT_TRUE(SelectIds(engine, "select id from t where k = 1005;").empty());
+  ASSERT_EQ(expected, SelectIds(engine, "select id from t where id = 5;"));
+
+  // without a where clause every row is updated
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "update t set name = \"all\";"));
+  rows = Select(engine, "select name from t;");
+  ASSERT_EQ(200u, rows.size());
+  for (auto &row : rows) ASSERT_EQ("all", row[0]);
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "drop database " + db_name + ";"));
+}
+
+TEST(ExecuteEngineTest, CreateIndexOverRowsTest) {
+  ExecuteEngine engine;
+  Execute(engine, "drop database " + db_name + ";");
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create database " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "use " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create table t(a int not null, b int);"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "insert into t values(2, 1);"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "insert into t values(1, 2);"));
+
+  // the rows inserted before the index are in it as well
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create index ia on t(a);"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "insert into t values(0, 4);"));
+  auto rows = Select(engine, "select * from t order by a;");
+  std::vector<std::vector<std::string>> expected = {{"0", "4"}, {"1", "2"}, {"2", "1"}};
+  ASSERT_EQ(expected, rows);
+  expected = {{"2", "1"}};
+  ASSERT_EQ(expected, Select(engine, "select * from t where a = 2;"));
+  ASSERT_NE(DB_SUCCESS, Execute(engine, "insert into t values(1, 5);"));
+
+  // an index over keys that are not unique is not created
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "insert into t values(3, 1);"));
+  ASSERT_NE(DB_SUCCESS, Execute(engine, "create index ib on t(b);"));
+  expected = {{"2", "1"}, {"3", "1"}};
+  ASSERT_EQ(expected, Select(engine, "select * from t where b = 1;"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "delete from t where a = 3;"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create index ib on t(b);"));
+  expected = {{"1", "2"}};
+  ASSERT_EQ(expected, Select(engine, "select * from t where b = 2;"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "drop database " + db_name + ";"));
+}
+
+TEST(ExecuteEngineTest, JoinTest) {
+  ExecuteEngine engine;
+  Execute(engine, "drop database " + db_name + ";");
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create database " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "use " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create table t(a int, b int, c int unique, primary key(a));"));
+  for (int i = 0; i < 2000; i++) {
+    std::string values = std::to_string(i) + ", " + std::to_string(2 * i) + ", " + std::to_string(10000 + i);
+    ASSERT_EQ(DB_SUCCESS, Execute(engine, "insert into t values(" + values + ");"));
+  }
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create index ib on t(b);"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "create table u(x int);"));
+  for (int x : {7, 1500, 5000, 10007}) {
+    ASSERT_EQ(DB_SUCCESS, Execute(engine, "insert into u values(" + std::to_string(x) + ");"));
+  }
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "analyze u;"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "analyze t;"));
+
+  // the few rows of u look their keys up in t, through the index of the primary key, of a unique column or
+  // one created over the rows t had
+  using Rows = std::vector<std::vector<std::string>>;
+  auto sorted = [](Rows rows) {
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+  Rows expected = {{"1500", "1500", "3000", "11500"}, {"7", "7", "14", "10007"}};
+  ASSERT_EQ(expected, sorted(Select(engine, "select * from u join t on u.x = t.a;")));
+  expected = {{"1500", "750", "1500", "10750"}};
+  ASSERT_EQ(expected, sorted(Select(engine, "select * from u join t on u.x = t.b;")));
+  expected = {{"10007", "7", "14", "10007"}};
+  ASSERT_EQ(expected, sorted(Select(engine, "select * from u join t on t.c = u.x;")));
+  expected = {{"7", "7", "14", "10007"}};
+  ASSERT_EQ(expected, sorted(Select(engine, "select * from u join t on u.x = t.a and u.x < 100;")));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "drop database " + db_name + ";"));
+}
+
+TEST(ExecuteEngineTest, KeyColumnsNotNullTest) {
+  {
+    ExecuteEngine engine;
+    Execute(engine, "drop database " + db_name + ";");
+    ASSERT_EQ(DB_SUCCESS, Execute(engine, "create database " + db_name + ";"));
+    ASSERT_EQ(DB_SUCCESS, Execute(engine, "use " + db_name + ";"));
+    ASSERT_EQ(DB_SUCCESS, Execute(engine, "create table t(id int, k float unique, v int, primary key(id));"));
+    ASSERT_EQ(DB_SUCCESS, Execute(engine, "insert into t values(1, 1.5, null);"));
+    ASSERT_NE(DB_SUCCESS, Execute(engine, "insert into t values(null, 2.5, 2);"));
+    ASSERT_NE(DB_SUCCESS, Execute(engine, "insert into t values(3, null, 3);"));
+  }
+
+  // the columns of the primary key and the unique ones are not null, their indexes compare keys by number
+  {
+    DBStorageEngine db((std::filesystem::current_path() / "database" / (db_name + ".db")).string(), false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, db.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_FALSE(table_info->GetSchema()->GetColumn(0)->IsNullable());
+    ASSERT_FALSE(table_info->GetSchema()->GetColumn(1)->IsNullable());
+    ASSERT_TRUE(table_info->GetSchema()->GetColumn(2)->IsNullable());
+    std::vector<IndexInfo *> indexes;
+    ASSERT_EQ(DB_SUCCESS, db.catalog_mgr_->GetTableIndexes("t", indexes));
+    ASSERT_EQ(2u, indexes.size());
+    for (auto index : indexes) {
+      Schema *key_schema = index->GetIndexKeySchema();
+      std::vector<Field> fields;
+      if (key_schema->GetColumn(0)->GetType() == TypeId::kTypeInt) {
+        fields.emplace_back(TypeId::kTypeInt, 1);
+      } else {
+        fields.emplace_back(TypeId::kTypeFloat, 1.5f);
+      }
+      Row key_row(fields);
+      GenericKey<32> key;
+      key.SerializeFromKey(key_row, key_schema);
+      ASSERT_GE(GenericComparator<32>(key_schema).GetNumberOffset(key), 0) << index->GetIndexName();
+    }
+  }
+
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "drop database " + db_name + ";"));
+}
+
+TEST(ExecuteEngineTest, AggregateTest) {
+  ExecuteEngine engine;
+  CreateTable(engine);
+
+  // a scan of the whole table is aggregated a batch at a time, the rows of an index lookup one at a time
+  using Rows = std::vector<std::vector<std::string>>;
+  Rows expected = {{"200", "219900"}};
+  ASSERT_EQ(expected, Select(engine, "select count(*), sum(k) from t;"));
+  expected = {{"20", "21960"}};
+  ASSERT_EQ(expected, Select(engine, "select count(id), sum(k) from t where name = \"name3\";"));
+  expected = {{"10", "1000", "1009"}};
+  ASSERT_EQ(expected, Select(engine, "select count(*), min(k), max(k) from t where k < 1010;"));
+  expected = {{"name0", "10", "1045"}, {"name1", "10", "1046"}};
+  ASSERT_EQ(expected, Select(engine, "select name, count(*), avg(k) from t where id < 100 group by name order by name "
+                                     "limit 2;"));
+  ASSERT_EQ(DB_SUCCESS, Execute(engine, "drop database " + db_name + ";"));
+}
@@ -0,0 +1,704 @@
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/operators.h"
+#include "gtest/gtest.h"
+
+static string db_file_name = "operators_test.db";
+using Fields = std::vector<Field>;
+
+static Fields MakeFields(int i) {
+  std::string name = "name" + std::to_string(i);
+  return Fields{Field(TypeId::kTypeInt, i),
+                Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+                Field(TypeId::kTypeFloat, static_cast<float>(i % 100))};
+}
+
+/**
+ * Pull every row of op, the id is taken from column id_column
+ */
+static std::vector<int> Drain(PhysicalOperator &op, uint32_t id_column = 0) {
+  std::vector<int> ids;
+  op.Init();
+  const Row *row;
+  while (op.Next(&row)) {
+    for (int i = 0;; i++) {
+      if (row->GetField(id_column)->CompareEquals(Field(TypeId::kTypeInt, i)) == CmpBool::kTrue) {
+        ids.push_back(i);
+        break;
+      }
+    }
+  }
+  return ids;
+}
+
+static std::unique_ptr<ScanPredicate> Compare(Schema *schema, uint32_t column, CompareOp op, const Field &key) {
+  return ScanPredicate::Create(schema, column, op, key);
+}
+
+TEST(OperatorTest, ScanFilterProjectLimitTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 3000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields = MakeFields(i);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  table_heap->ReleaseInsertPage();
+  std::vector<uint32_t> all = {0, 1, 2};
+
+  // a plain scan gives every row in heap order
+  SeqScanOperator scan(table_heap, all);
+  auto ids = Drain(scan);
+  ASSERT_EQ(static_cast<size_t>(row_nums), ids.size());
+  for (int i = 0; i < row_nums; i++) ASSERT_EQ(i, ids[i]);
+
+  // a pushed down predicate, then a filter with an or on what it leaves
+  auto filtered = std::make_unique<FilterOperator>(
+      std::make_unique<SeqScanOperator>(table_heap, all,
+                                        Compare(schema.get(), 0, CompareOp::kLt, Field(TypeId::kTypeInt, 1000))),
+      std::make_unique<RowCondition>(
+          false,
+          std::make_unique<RowCondition>(Compare(schema.get(), 2, CompareOp::kEq, Field(TypeId::kTypeFloat, 7.0f))),
+          std::make_unique<RowCondition>(Compare(schema.get(), 0, CompareOp::kGe, Field(TypeId::kTypeInt, 990)))));
+  std::vector<int> expected;
+  for (int i = 0; i < 1000; i++) {
+    if (i % 100 == 7 || i >= 990) expected.push_back(i);
+  }
+  ASSERT_EQ(expected, Drain(*filtered));
+  // operators can be run again from Init
+  ASSERT_EQ(expected, Drain(*filtered));
+
+  // a projection reorders the columns, the page of its row stays pinned until it is destroyed
+  {
+    ProjectionOperator projection(std::make_unique<SeqScanOperator>(table_heap, all), {2, 0});
+    projection.Init();
+    const Row *row;
+    ASSERT_TRUE(projection.Next(&row));
+    ASSERT_TRUE(projection.Next(&row));
+    ASSERT_EQ(2u, row->GetFieldCount());
+    ASSERT_EQ(CmpBool::kTrue, row->GetField(0)->CompareEquals(Field(TypeId::kTypeFloat, 1.0f)));
+    ASSERT_EQ(CmpBool::kTrue, row->GetField(1)->CompareEquals(Field(TypeId::kTypeInt, 1)));
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+
+  // the rows an index finds are read in page order
+  std::vector<RowId> probed = {rids[2500], rids[3], rids[1200], rids[4], rids[2999]};
+  IndexScanOperator index_scan(table_heap, all, [&](std::unordered_set<RowId> &found) {
+    found.insert(probed.begin(), probed.end());
+  });
+  ASSERT_EQ(std::vector<int>({3, 4, 1200, 2500, 2999}), Drain(index_scan));
+
+  // a limit skips the offset and stops early
+  {
+    LimitOperator limit(std::make_unique<SeqScanOperator>(table_heap, all), 10, 5);
+    ASSERT_EQ(std::vector<int>({5, 6, 7, 8, 9, 10, 11, 12, 13, 14}), Drain(limit));
+  }
+  LimitOperator past_end(std::make_unique<SeqScanOperator>(table_heap, all), 10, row_nums - 3);
+  ASSERT_EQ(std::vector<int>({row_nums - 3, row_nums - 2, row_nums - 1}), Drain(past_end));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(OperatorTest, OutputTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = OUTPUT_BLOCK_ROWS + 20;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields = MakeFields(i);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  table_heap->ReleaseInsertPage();
+
+  // the first block is printed before the scan reaches the rows after it
+  std::stringstream out;
+  OutputOperator output(std::make_unique<ProjectionOperator>(
+                            std::make_unique<SeqScanOperator>(table_heap, std::vector<uint32_t>{0, 1}),
+                            std::vector<uint32_t>{1, 0}),
+                        out);
+  output.Init();
+  const Row *row;
+  for (int i = 0; i < OUTPUT_BLOCK_ROWS - 1; i++) ASSERT_TRUE(output.Next(&row));
+  ASSERT_TRUE(out.str().empty());
+  ASSERT_TRUE(output.Next(&row));
+  ASSERT_FALSE(out.str().empty());
+  while (output.Next(&row)) {
+  }
+
+  // every row is numbered on its own line between borders, a block as wide as the one before goes on below it
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(out, line)) lines.push_back(line);
+  ASSERT_EQ("|0  |name0  |0  |", lines[1]);
+  ASSERT_EQ("+---+-------+---+", lines[0]);
+  ASSERT_EQ("|255|name255|255|", lines[2 * OUTPUT_BLOCK_ROWS - 1]);
+  ASSERT_EQ(static_cast<size_t>(2 * row_nums + 1), lines.size());
+  ASSERT_EQ("|275|name275|275|", lines[lines.size() - 2]);
+
+  std::stringstream empty;
+  {
+    OutputOperator nothing(
+        std::make_unique<LimitOperator>(std::make_unique<SeqScanOperator>(table_heap, std::vector<uint32_t>{0}), 0),
+        empty);
+    ASSERT_EQ(0u, nothing.Run());
+  }
+  ASSERT_TRUE(empty.str().empty());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+/**
+ * Ids of the rows a vectorized plan hands out, in their order, and check the chars of column name
+ */
+static std::vector<int> DrainVector(VectorOperatorPtr child, const std::vector<std::string> &names) {
+  VectorProjectionOperator projection(std::move(child), {1, 0});
+  std::vector<int> ids;
+  projection.Init();
+  const Row *row;
+  while (projection.Next(&row)) {
+    int id;
+    row->GetField(1)->SerializeTo(reinterpret_cast<char *>(&id));
+    if (names[id].empty()) {
+      EXPECT_TRUE(row->GetField(0)->IsNull());
+    } else {
+      EXPECT_EQ(names[id], std::string(row->GetField(0)->GetData(), row->GetField(0)->GetLength()));
+    }
+    ids.push_back(id);
+  }
+  return ids;
+}
+
+TEST(OperatorTest, VectorPipelineTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 2 * VECTOR_BATCH_SIZE + 300;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 400, 1, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  // every seventh name is null, every fifth is long enough to be stored out of line by a heap of rows
+  std::vector<std::string> names;
+  for (int i = 0; i < row_nums; i++) {
+    names.push_back(i % 7 == 0 ? "" : "name" + std::to_string(i) + std::string(i % 5 == 0 ? 300 : 0, 'x'));
+  }
+  for (auto layout : {TableLayout::kRow, TableLayout::kColumn}) {
+    TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap, layout);
+    std::vector<RowId> rids;
+    for (int i = 0; i < row_nums; i++) {
+      Fields fields;
+      fields.reserve(3);
+      fields.emplace_back(TypeId::kTypeInt, i);
+      if (names[i].empty()) {
+        fields.emplace_back(TypeId::kTypeChar);
+      } else {
+        fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(names[i].c_str()), names[i].size(), true);
+      }
+      fields.emplace_back(TypeId::kTypeFloat, static_cast<float>(i % 100));
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    table_heap->ReleaseInsertPage();
+    std::vector<RowId> deleted;
+    for (int i = 3; i < row_nums; i += 100) {
+      table_heap->ApplyDelete(rids[i], nullptr);
+      deleted.push_back(rids[i]);
+    }
+    auto is_live = [](int i) { return i < 3 || (i - 3) % 100 != 0; };
+
+    // a scan fills the batches with the tuples of several pages and leaves out the deleted ones
+    std::vector<int> expected;
+    for (int i = 0; i < row_nums; i++) {
+      if (is_live(i)) expected.push_back(i);
+    }
+    std::vector<uint32_t> read = {0, 1, 2};
+    VectorScanOperator scan(table_heap, read);
+    scan.Init();
+    VectorBatch *batch;
+    ASSERT_TRUE(scan.Next(&batch));
+    ASSERT_TRUE(batch->IsFull());
+    ASSERT_EQ(static_cast<uint32_t>(VECTOR_BATCH_SIZE), batch->GetSelectedCount());
+    ASSERT_EQ(expected, DrainVector(std::make_unique<VectorScanOperator>(table_heap, read), names));
+
+    // a pushed down predicate, then a filter with an or and a null check
+    std::vector<int> filtered;
+    for (int i = 0; i < 1500; i++) {
+      if (is_live(i) && (i % 100 == 7 || i % 7 == 0)) filtered.push_back(i);
+    }
+    auto filter = std::make_unique<VectorFilterOperator>(
+        std::make_unique<VectorScanOperator>(table_heap, read,
+                                             Compare(schema.get(), 0, CompareOp::kLt, Field(TypeId::kTypeInt, 1500))),
+        std::make_unique<RowCondition>(
+            false,
+            std::make_unique<RowCondition>(Compare(schema.get(), 2, CompareOp::kEq, Field(TypeId::kTypeFloat, 7.0f))),
+            std::make_unique<RowCondition>(Compare(schema.get(), 1, CompareOp::kIsNull, Field(TypeId::kTypeChar)))));
+    ASSERT_EQ(filtered, DrainVector(std::move(filter), names));
+
+    // chars are compared whole, stored out of line or not
+    std::string key = names[1605];
+    filtered.clear();
+    for (int i = 0; i < row_nums; i++) {
+      if (is_live(i) && !names[i].empty() && names[i] >= key) filtered.push_back(i);
+    }
+    Field key_field(TypeId::kTypeChar, const_cast<char *>(key.c_str()), key.size(), true);
+    auto chars = std::make_unique<VectorFilterOperator>(
+        std::make_unique<VectorScanOperator>(table_heap, read),
+        std::make_unique<RowCondition>(Compare(schema.get(), 1, CompareOp::kGe, key_field)));
+    ASSERT_EQ(filtered, DrainVector(std::move(chars), names));
+    ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  }
+}
+
+/**
+ * Pairs of the ids of the rows a join hands out, the id of the right row is its score
+ */
+static std::vector<std::pair<int, int>> DrainJoin(PhysicalOperator &op) {
+  std::vector<std::pair<int, int>> pairs;
+  op.Init();
+  const Row *row;
+  char buf[sizeof(int32_t)];
+  while (op.Next(&row)) {
+    EXPECT_EQ(6u, row->GetFieldCount());
+    row->GetField(0)->SerializeTo(buf);
+    int left = MACH_READ_FROM(int32_t, buf);
+    row->GetField(5)->SerializeTo(buf);
+    pairs.emplace_back(left, static_cast<int>(MACH_READ_FROM(float, buf)));
+  }
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
+}
+
+TEST(OperatorTest, HashJoinTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  // the left ids are unique, each is the id of two right rows, every tenth left and seventh right name is null
+  TableHeap *left = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  TableHeap *right = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  for (int j = 0; j < 3000; j++) {
+    int i = j % 1000;
+    std::string name = "name" + std::to_string(i);
+    Fields fields;
+    fields.reserve(3);
+    fields.emplace_back(TypeId::kTypeInt, i);
+    if (j < 1000 ? i % 10 == 0 : j % 7 == 0) {
+      fields.emplace_back(TypeId::kTypeChar);
+    } else {
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true);
+    }
+    fields.emplace_back(TypeId::kTypeFloat, static_cast<float>(j));
+    Row row(fields);
+    ASSERT_TRUE((j < 1000 ? left : right)->InsertTuple(row, nullptr));
+  }
+  left->ReleaseInsertPage();
+  right->ReleaseInsertPage();
+  std::vector<uint32_t> all = {0, 1, 2};
+  auto scan = [&all](TableHeap *table_heap) { return std::make_unique<SeqScanOperator>(table_heap, all); };
+
+  std::vector<std::pair<int, int>> by_id, by_name;
+  for (int j = 1000; j < 3000; j++) {
+    by_id.emplace_back(j % 1000, j);
+    // null names join nothing
+    if (j % 1000 % 10 != 0 && j % 7 != 0) by_name.emplace_back(j % 1000, j);
+  }
+  std::sort(by_id.begin(), by_id.end());
+  std::sort(by_name.begin(), by_name.end());
+
+  // either side may be built, a small budget partitions both sides to temporary files
+  for (size_t budget : {static_cast<size_t>(JOIN_MEMORY_BUDGET), static_cast<size_t>(1024)}) {
+    for (bool build_left : {true, false}) {
+      HashJoinOperator ids(scan(left), scan(right), schema.get(), schema.get(), {0}, {0}, build_left, budget);
+      ASSERT_EQ(by_id, DrainJoin(ids));
+      ASSERT_EQ(budget == 1024, ids.IsSpilled());
+      // a join can be run again from Init
+      ASSERT_EQ(by_id, DrainJoin(ids));
+
+      HashJoinOperator names(scan(left), scan(right), schema.get(), schema.get(), {1}, {1}, build_left, budget);
+      ASSERT_EQ(by_name, DrainJoin(names));
+      HashJoinOperator both(scan(left), scan(right), schema.get(), schema.get(), {1, 0}, {1, 0}, build_left, budget);
+      ASSERT_EQ(by_name, DrainJoin(both));
+    }
+  }
+  // with no keys every pair of rows is joined, the pages of the limited scans stay pinned until it is destroyed
+  {
+    HashJoinOperator cross(std::make_unique<LimitOperator>(scan(left), 20),
+                           std::make_unique<LimitOperator>(scan(right), 30, 1000), schema.get(), schema.get(), {},
+                           {}, true);
+    auto pairs = DrainJoin(cross);
+    ASSERT_EQ(600u, pairs.size());
+    ASSERT_EQ(std::make_pair(0, 2000), pairs.front());
+    ASSERT_EQ(std::make_pair(19, 2029), pairs.back());
+  }
+  // 0 and -0 join, and a key too frequent for any partition to fit the budget is still joined whole
+  {
+    TableHeap *zeros = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+    TableHeap *negative_zeros = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+    for (int j = 0; j < 400; j++) {
+      Fields fields;
+      fields.reserve(3);
+      fields.emplace_back(TypeId::kTypeInt, j);
+      fields.emplace_back(TypeId::kTypeChar);
+      fields.emplace_back(TypeId::kTypeFloat, j < 200 ? 0.0f : -0.0f);
+      Row row(fields);
+      ASSERT_TRUE((j < 200 ? zeros : negative_zeros)->InsertTuple(row, nullptr));
+    }
+    zeros->ReleaseInsertPage();
+    negative_zeros->ReleaseInsertPage();
+    for (size_t budget : {static_cast<size_t>(JOIN_MEMORY_BUDGET), static_cast<size_t>(1024)}) {
+      HashJoinOperator join(scan(zeros), scan(negative_zeros), schema.get(), schema.get(), {2}, {2}, true, budget);
+      join.Init();
+      const Row *row;
+      size_t count = 0;
+      while (join.Next(&row)) count++;
+      ASSERT_EQ(200u * 200u, count);
+      ASSERT_EQ(budget == 1024, join.IsSpilled());
+    }
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(OperatorTest, IndexJoinTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  // the outer rows have ids 0..999 twice, the table each id once with the id as its score, every tenth
+  // table name and seventh outer name is null
+  TableHeap *outer = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  TableHeap *table = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  std::unordered_map<int, RowId> index;
+  for (int j = 0; j < 3000; j++) {
+    int i = j % 1000;
+    std::string name = "name" + std::to_string(i);
+    Fields fields;
+    fields.reserve(3);
+    fields.emplace_back(TypeId::kTypeInt, i);
+    if (j < 1000 ? i % 10 == 0 : j % 7 == 0) {
+      fields.emplace_back(TypeId::kTypeChar);
+    } else {
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true);
+    }
+    fields.emplace_back(TypeId::kTypeFloat, static_cast<float>(i));
+    Row row(fields);
+    ASSERT_TRUE((j < 1000 ? table : outer)->InsertTuple(row, nullptr));
+    if (j < 1000) index.emplace(i, row.GetRowId());
+  }
+  outer->ReleaseInsertPage();
+  table->ReleaseInsertPage();
+  std::vector<uint32_t> all = {0, 1, 2};
+  uint32_t lookups = 0;
+  auto lookup = [&index, &lookups](const Field &key, std::vector<RowId> &rids) {
+    lookups++;
+    char buf[sizeof(int32_t)];
+    key.SerializeTo(buf);
+    auto it = index.find(MACH_READ_FROM(int32_t, buf));
+    if (it != index.end()) rids.push_back(it->second);
+  };
+  auto join = [&](std::vector<uint32_t> keys, std::unique_ptr<RowCondition> condition = nullptr) {
+    return IndexJoinOperator(std::make_unique<SeqScanOperator>(outer, all), table, all, all, keys, keys, lookup,
+                             std::move(condition));
+  };
+
+  std::vector<std::pair<int, int>> by_id, by_name, below;
+  for (int j = 1000; j < 3000; j++) {
+    int i = j % 1000;
+    by_id.emplace_back(i, i);
+    if (i % 10 != 0 && j % 7 != 0) by_name.emplace_back(i, i);
+    if (i < 100) below.emplace_back(i, i);
+  }
+  std::sort(by_id.begin(), by_id.end());
+  std::sort(by_name.begin(), by_name.end());
+  std::sort(below.begin(), below.end());
+
+  {
+    // a distinct key of a batch of outer rows is looked up once
+    auto ids = join({0});
+    ASSERT_EQ(by_id, DrainJoin(ids));
+    ASSERT_EQ(1000u + (2000u - INDEX_JOIN_BATCH), lookups);
+    // a join can be run again from Init
+    ASSERT_EQ(by_id, DrainJoin(ids));
+    // the keys after the first are compared on the rows found, null names join nothing
+    auto both = join({0, 1});
+    ASSERT_EQ(by_name, DrainJoin(both));
+    // the condition is checked on the rows of the table
+    auto filtered = join({0}, std::make_unique<RowCondition>(
+                                  Compare(schema.get(), 2, CompareOp::kLt, Field(TypeId::kTypeFloat, 100.0f))));
+    ASSERT_EQ(below, DrainJoin(filtered));
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+/**
+ * Rows an aggregation hands out as the texts of their fields, sorted
+ */
+static std::vector<std::string> DrainGroups(PhysicalOperator &op) {
+  std::vector<std::string> groups;
+  op.Init();
+  const Row *row;
+  while (op.Next(&row)) {
+    std::string text;
+    for (uint32_t i = 0; i < row->GetFieldCount(); i++) text += OutputOperator::FieldText(*row->GetField(i)) + "|";
+    groups.push_back(text);
+  }
+  std::sort(groups.begin(), groups.end());
+  return groups;
+}
+
+TEST(OperatorTest, HashAggregateTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  // ids 0..9999, 500 names of which every tenth row's is null, scores 0..3 and null for ids 1000..1999
+  const int row_nums = 10000;
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name" + std::to_string(i % 500);
+    Fields fields;
+    fields.reserve(3);
+    fields.emplace_back(TypeId::kTypeInt, i);
+    if (i % 10 == 0) {
+      fields.emplace_back(TypeId::kTypeChar);
+    } else {
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true);
+    }
+    if (i >= 1000 && i < 2000) {
+      fields.emplace_back(TypeId::kTypeFloat);
+    } else {
+      fields.emplace_back(TypeId::kTypeFloat, static_cast<float>(i % 4));
+    }
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  table_heap->ReleaseInsertPage();
+  std::vector<uint32_t> all = {0, 1, 2};
+  auto scan = [&]() { return std::make_unique<SeqScanOperator>(table_heap, all); };
+
+  std::vector<Aggregate> aggregates = {{AggregateFunction::kCountAll, 0}, {AggregateFunction::kCount, 1},
+                                       {AggregateFunction::kSum, 0},      {AggregateFunction::kAvg, 2},
+                                       {AggregateFunction::kMin, 1},      {AggregateFunction::kMax, 0}};
+  // without keys the whole table is a single group
+  HashAggregateOperator total(scan(), schema.get(), {}, aggregates);
+  ASSERT_EQ(std::vector<std::string>{"10000|9000|49995000|1.5|name1|9999|"}, DrainGroups(total));
+  // an empty group still has its row, only the counts are not null
+  {
+    HashAggregateOperator empty(std::make_unique<LimitOperator>(scan(), 0), schema.get(), {}, aggregates);
+    ASSERT_EQ(std::vector<std::string>{"0|0|null|null|null|null|"}, DrainGroups(empty));
+  }
+
+  // the ids of each score, the rows with a null score are one group
+  std::vector<std::string> by_score;
+  for (int score = 0; score < 4; score++) {
+    int64_t sum = 0;
+    for (int i = score; i < row_nums; i += 4) sum += (i >= 1000 && i < 2000) ? 0 : i;
+    by_score.push_back(std::to_string(score) + "|2250|" + std::to_string(sum) + "|" + std::to_string(score) + "|");
+  }
+  by_score.emplace_back("null|1000|1499500|null|");
+  std::sort(by_score.begin(), by_score.end());
+  // a small budget partitions the rows of the groups that do not fit, more than once for the ids
+  std::vector<Aggregate> score_aggregates = {
+      {AggregateFunction::kCountAll, 0}, {AggregateFunction::kSum, 0}, {AggregateFunction::kMax, 2}};
+  for (size_t budget : {static_cast<size_t>(AGGREGATE_MEMORY_BUDGET), static_cast<size_t>(1024)}) {
+    HashAggregateOperator scores(scan(), schema.get(), {2}, score_aggregates, budget);
+    ASSERT_EQ(by_score, DrainGroups(scores));
+    ASSERT_FALSE(scores.IsSpilled());
+
+    HashAggregateOperator names(scan(), schema.get(), {1}, {{AggregateFunction::kCountAll, 0}}, budget);
+    auto groups = DrainGroups(names);
+    ASSERT_EQ(budget == 1024, names.IsSpilled());
+    // the names of ids that are multiples of ten are null, the other 450 have 20 rows each
+    ASSERT_EQ(451u, groups.size());
+    ASSERT_TRUE(std::binary_search(groups.begin(), groups.end(), std::string("name1|20|")));
+    ASSERT_EQ(450, std::count_if(groups.begin(), groups.end(), [](const std::string &group) {
+                return group.size() > 3 && group.compare(group.size() - 3, 3, "20|") == 0;
+              }));
+    ASSERT_EQ("null|1000|", groups.back());
+    // a group of each id is run again from Init
+    HashAggregateOperator ids(scan(), schema.get(), {0, 1}, {{AggregateFunction::kMin, 2}}, budget);
+    ASSERT_EQ(static_cast<size_t>(row_nums), DrainGroups(ids).size());
+    ASSERT_EQ(static_cast<size_t>(row_nums), DrainGroups(ids).size());
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(OperatorTest, VectorAggregateTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  // like HashAggregateTest, with a score of -0 for every eighth row
+  const int row_nums = 10000;
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name" + std::to_string(i % 500);
+    Fields fields;
+    fields.reserve(3);
+    fields.emplace_back(TypeId::kTypeInt, i);
+    if (i % 10 == 0) {
+      fields.emplace_back(TypeId::kTypeChar);
+    } else {
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true);
+    }
+    if (i >= 1000 && i < 2000) {
+      fields.emplace_back(TypeId::kTypeFloat);
+    } else {
+      fields.emplace_back(TypeId::kTypeFloat, i % 8 == 0 ? -0.0f : static_cast<float>(i % 4));
+    }
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  table_heap->ReleaseInsertPage();
+
+  // the batches are aggregated to the same groups as the rows made of them, spilled or not
+  std::vector<uint32_t> all = {0, 1, 2};
+  std::vector<Aggregate> aggregates = {{AggregateFunction::kCountAll, 0}, {AggregateFunction::kCount, 1},
+                                       {AggregateFunction::kSum, 0},      {AggregateFunction::kAvg, 2},
+                                       {AggregateFunction::kMin, 1},      {AggregateFunction::kMax, 2}};
+  std::vector<std::vector<uint32_t>> key_sets = {{}, {2}, {1}, {0, 1}, {1, 2}};
+  for (auto &keys : key_sets) {
+    for (size_t budget : {static_cast<size_t>(AGGREGATE_MEMORY_BUDGET), static_cast<size_t>(1024)}) {
+      HashAggregateOperator rows(std::make_unique<SeqScanOperator>(table_heap, all), schema.get(), keys, aggregates,
+                                 budget);
+      HashAggregateOperator batches(std::make_unique<VectorScanOperator>(table_heap, all), all, schema.get(), keys,
+                                    aggregates, budget);
+      auto groups = DrainGroups(rows);
+      ASSERT_EQ(groups, DrainGroups(batches));
+      ASSERT_EQ(rows.IsSpilled(), batches.IsSpilled());
+    }
+  }
+  // 0 and -0 are one group
+  HashAggregateOperator scores(std::make_unique<VectorScanOperator>(table_heap, all), all, schema.get(), {2},
+                               {{AggregateFunction::kCountAll, 0}});
+  std::vector<std::string> by_score = {"0|2250|", "1|2250|", "2|2250|", "3|2250|", "null|1000|"};
+  ASSERT_EQ(by_score, DrainGroups(scores));
+
+  // only the selected tuples count, and count leaves out the null names of ids 0, 10, 20 and 30; the columns of
+  // the batches are in the order of the schema given
+  std::vector<Column *> score_name = {columns[2], columns[1]};
+  auto projected = std::make_shared<Schema>(score_name);
+  auto filtered = [&]() {
+    VectorOperatorPtr scan = std::make_unique<VectorScanOperator>(table_heap, all);
+    return std::make_unique<VectorFilterOperator>(
+        std::move(scan),
+        std::make_unique<RowCondition>(Compare(schema.get(), 0, CompareOp::kLt, Field(TypeId::kTypeInt, 40))));
+  };
+  HashAggregateOperator names(filtered(), {2, 1}, projected.get(), {0},
+                              {{AggregateFunction::kCount, 1}, {AggregateFunction::kMax, 1}});
+  std::vector<std::string> by_name = {"0|8|name8|", "1|10|name9|", "2|8|name6|", "3|10|name7|"};
+  ASSERT_EQ(by_name, DrainGroups(names));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+/**
+ * Ids of the rows op hands out, in their order
+ */
+static std::vector<int> DrainOrder(PhysicalOperator &op) {
+  std::vector<int> ids;
+  op.Init();
+  const Row *row;
+  while (op.Next(&row)) ids.push_back(std::stoi(OutputOperator::FieldText(*row->GetField(0))));
+  return ids;
+}
+
+TEST(OperatorTest, SortTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 48, 1, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  // names share a prefix longer than the one kept with the entries, every seventh is null,
+  // scores are -50..49 and null for every thirteenth row
+  const int row_nums = 10000;
+  std::vector<std::string> names(row_nums);
+  std::vector<float> scores(row_nums);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  for (int i = 0; i < row_nums; i++) {
+    names[i] = i % 7 == 0 ? "" : "a name longer than the prefix " + std::to_string(i * 37 % 1000);
+    scores[i] = i % 13 == 0 ? 1000 : static_cast<float>(i % 100 - 50);
+    Fields fields;
+    fields.reserve(3);
+    fields.emplace_back(TypeId::kTypeInt, i);
+    if (i % 7 == 0) {
+      fields.emplace_back(TypeId::kTypeChar);
+    } else {
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(names[i].c_str()), names[i].size(), true);
+    }
+    if (i % 13 == 0) {
+      fields.emplace_back(TypeId::kTypeFloat);
+    } else {
+      fields.emplace_back(TypeId::kTypeFloat, scores[i]);
+    }
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  table_heap->ReleaseInsertPage();
+  std::vector<uint32_t> all = {0, 1, 2};
+  auto scan = [&]() { return std::make_unique<SeqScanOperator>(table_heap, all); };
+
+  // nulls come first in ascending order and last in descending order
+  std::vector<int> by_name(row_nums), by_score(row_nums);
+  for (int i = 0; i < row_nums; i++) by_name[i] = by_score[i] = i;
+  auto null_name = [](int i) { return i % 7 == 0; };
+  auto null_score = [](int i) { return i % 13 == 0; };
+  std::sort(by_name.begin(), by_name.end(), [&](int a, int b) {
+    if (null_name(a) != null_name(b)) return null_name(a);
+    if (names[a] != names[b]) return names[a] < names[b];
+    return a > b;
+  });
+  std::sort(by_score.begin(), by_score.end(), [&](int a, int b) {
+    if (null_score(a) != null_score(b)) return null_score(b);
+    if (scores[a] != scores[b]) return scores[a] > scores[b];
+    return a < b;
+  });
+
+  // a small budget spills more runs than are merged at once
+  for (size_t budget : {static_cast<size_t>(SORT_MEMORY_BUDGET), static_cast<size_t>(1024)}) {
+    SortOperator names_sort(scan(), {{1, false}, {0, true}}, SIZE_MAX, budget);
+    ASSERT_EQ(by_name, DrainOrder(names_sort));
+    ASSERT_EQ(budget == 1024, names_sort.IsSpilled());
+    // run again from Init
+    ASSERT_EQ(by_name, DrainOrder(names_sort));
+    SortOperator scores_sort(scan(), {{2, true}, {0, false}}, SIZE_MAX, budget);
+    ASSERT_EQ(by_score, DrainOrder(scores_sort));
+
+    // with a limit only the first rows are kept
+    for (size_t limit : {0, 1, 10, 5000, 20000}) {
+      SortOperator top(scan(), {{2, true}, {0, false}}, limit, budget);
+      auto expected = by_score;
+      expected.resize(std::min<size_t>(limit, row_nums));
+      ASSERT_EQ(expected, DrainOrder(top));
+    }
+    {
+      SortOperator empty(std::make_unique<LimitOperator>(scan(), 0), {{0, false}}, SIZE_MAX, budget);
+      ASSERT_TRUE(DrainOrder(empty).empty());
+    }
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
@@ -78,4 +78,13 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     ASSERT_EQ(i, (*iter).second.GetSlotNum());
     i++;
   }
+  // Ordered Scan
+  std::vector<RowId> ordered;
+  index->ScanInOrder(ordered);
+  ASSERT_EQ(10u, ordered.size());
+  for (i = 0; i < 10; i++) ASSERT_EQ(i, ordered[i].GetSlotNum());
+  ordered.clear();
+  index->ScanInOrder(ordered, 3);
+  ASSERT_EQ(3u, ordered.size());
+  ASSERT_EQ(2u, ordered.back().GetSlotNum());
 }
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "catalog/catalog.h"
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/bloom_filter.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "bloom_filter_test.db";
+
+TEST(BloomFilterTest, SampleTest) {
+  SimpleMemHeap heap;
+  BloomFilter *filter = BloomFilter::Create(&heap);
+  const int n = 1000;
+  for (int i = 0; i < n; i++) filter->Insert(reinterpret_cast<char *>(&i), sizeof(i));
+  for (int i = 0; i < n; i++) ASSERT_TRUE(filter->MayContain(reinterpret_cast<char *>(&i), sizeof(i)));
+  int false_positives = 0;
+  for (int i = n; i < 2 * n; i++) false_positives += filter->MayContain(reinterpret_cast<char *>(&i), sizeof(i));
+  ASSERT_LT(false_positives, n / 10);
+  // serialize, the bits go to a page chain
+  DBStorageEngine engine(db_name, true);
+  char *buf = reinterpret_cast<char *>(heap.Allocate(PAGE_SIZE));
+  ASSERT_EQ(filter->GetSerializedSize(), filter->SerializeTo(buf, engine.bpm_));
+  BloomFilter *other = BloomFilter::Create(&heap);
+  ASSERT_EQ(filter->GetSerializedSize(), other->DeserializeFrom(buf, engine.bpm_));
+  ASSERT_EQ(n, other->GetKeyCount());
+  ASSERT_EQ(filter->GetBitCount(), other->GetBitCount());
+  for (int i = 0; i < 2 * n; i++) {
+    ASSERT_EQ(filter->MayContain(reinterpret_cast<char *>(&i), sizeof(i)),
+              other->MayContain(reinterpret_cast<char *>(&i), sizeof(i)));
+  }
+  // a filter that was not written back at a clean close is not read
+  BloomFilter::MarkOpen(buf);
+  ASSERT_EQ(0, other->DeserializeFrom(buf, engine.bpm_));
+  memset(buf, 0, PAGE_SIZE);
+  ASSERT_EQ(0, other->DeserializeFrom(buf, engine.bpm_));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(BloomFilterTest, SizeTest) {
+  SimpleMemHeap heap;
+  BloomFilter *filter = BloomFilter::Create(&heap);
+  ASSERT_GE(filter->GetBitCount(), BLOOM_FILTER_MIN_KEYS * BLOOM_FILTER_BITS_PER_KEY);
+  ASSERT_LT(filter->GetBitCount(), 2 * BLOOM_FILTER_MIN_KEYS * BLOOM_FILTER_BITS_PER_KEY);
+  const int n = 100000;
+  filter->Reset(n);
+  ASSERT_GE(filter->GetBitCount(), static_cast<uint32_t>(n * BLOOM_FILTER_BITS_PER_KEY));
+  for (int i = 0; i < n; i++) filter->Insert(reinterpret_cast<char *>(&i), sizeof(i));
+  ASSERT_FALSE(filter->IsFull());
+  int false_positives = 0;
+  for (int i = n; i < 2 * n; i++) false_positives += filter->MayContain(reinterpret_cast<char *>(&i), sizeof(i));
+  ASSERT_LT(false_positives, n / 50);
+  // the bits span several pages and are read back whole
+  DBStorageEngine engine(db_name, true);
+  char *buf = reinterpret_cast<char *>(heap.Allocate(PAGE_SIZE));
+  filter->SerializeTo(buf, engine.bpm_);
+  BloomFilter *other = BloomFilter::Create(&heap);
+  ASSERT_NE(0, other->DeserializeFrom(buf, engine.bpm_));
+  for (int i = 0; i < n; i++) ASSERT_TRUE(other->MayContain(reinterpret_cast<char *>(&i), sizeof(i)));
+  // a smaller filter reuses the head of the chain
+  other->Reset(0);
+  other->SerializeTo(buf, engine.bpm_);
+  ASSERT_NE(0, filter->DeserializeFrom(buf, engine.bpm_));
+  ASSERT_EQ(other->GetBitCount(), filter->GetBitCount());
+  ASSERT_EQ(0, filter->GetKeyCount());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(BloomFilterTest, IndexFilterTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_name, true);
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("t", schema.get(), nullptr, table_info));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("t", "idx", {"id"}, nullptr, index_info));
+  const int n = 200;
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i * 2)};
+    Row key(fields);
+    ASSERT_FALSE(index_info->MayContain(key));
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, RowId(1000, i), nullptr));
+    index_info->AddToFilter(key);
+    ASSERT_TRUE(index_info->MayContain(key));
+  }
+  delete db_01;
+  // the filter is read back from the index meta page
+  auto db_02 = new DBStorageEngine(db_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("t", "idx", index_info));
+  ASSERT_EQ(n, index_info->GetFilter()->GetKeyCount());
+  int misses = 0;
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> hit{Field(TypeId::kTypeInt, i * 2)};
+    std::vector<Field> miss{Field(TypeId::kTypeInt, i * 2 + 1)};
+    ASSERT_TRUE(index_info->MayContain(Row(hit)));
+    misses += !index_info->MayContain(Row(miss));
+  }
+  ASSERT_GT(misses, n * 9 / 10);
+  // rebuilding from the tree yields the same answers
+  index_info->RebuildFilter();
+  ASSERT_EQ(n, index_info->GetFilter()->GetKeyCount());
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> hit{Field(TypeId::kTypeInt, i * 2)};
+    ASSERT_TRUE(index_info->MayContain(Row(hit)));
+  }
+  delete db_02;
+}
+
+TEST(BloomFilterTest, GrowTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_name, true);
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("t", schema.get(), nullptr, table_info));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("t", "idx", {"id"}, nullptr, index_info));
+  uint32_t bits = index_info->GetFilter()->GetBitCount();
+  const int n = 20 * BLOOM_FILTER_MIN_KEYS;
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i * 2)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, RowId(1000, i), nullptr));
+    index_info->AddToFilter(key);
+  }
+  // rebuilt from the index as it filled up
+  ASSERT_GT(index_info->GetFilter()->GetBitCount(), bits);
+  ASSERT_FALSE(index_info->GetFilter()->IsFull());
+  ASSERT_EQ(n, index_info->GetFilter()->GetKeyCount());
+  int false_positives = 0;
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> hit{Field(TypeId::kTypeInt, i * 2)};
+    std::vector<Field> miss{Field(TypeId::kTypeInt, i * 2 + 1)};
+    ASSERT_TRUE(index_info->MayContain(Row(hit)));
+    false_positives += index_info->MayContain(Row(miss));
+  }
+  ASSERT_LT(false_positives, n / 50);
+  delete db_01;
+}
+
+TEST(BloomFilterTest, CrashTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_name, true);
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("t", schema.get(), nullptr, table_info));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("t", "idx", {"id"}, nullptr, index_info));
+  const int n = 100;
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, RowId(1000, i), nullptr));
+    index_info->AddToFilter(key);
+  }
+  delete db_01;
+  // keys inserted after a clean open reach the disk, the catalog shutdown does not
+  auto db_02 = new DBStorageEngine(db_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("t", "idx", index_info));
+  for (int i = n; i < 2 * n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, RowId(1000, i), nullptr));
+    index_info->AddToFilter(key);
+  }
+  // crash: pages are written back but the catalog is never shut down
+  delete db_02->bpm_;
+  delete db_02->disk_mgr_;
+  // the stale filter on disk is rebuilt instead of hiding the new keys
+  auto db_03 = new DBStorageEngine(db_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_03->catalog_mgr_->GetIndex("t", "idx", index_info));
+  ASSERT_EQ(2 * n, index_info->GetFilter()->GetKeyCount());
+  for (int i = 0; i < 2 * n; i++) {
+    std::vector<Field> hit{Field(TypeId::kTypeInt, i)};
+    ASSERT_TRUE(index_info->MayContain(Row(hit)));
+  }
+  delete db_03;
+}
@@ -0,0 +1,112 @@
+#include <deque>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/b_plus_tree_index.h"
+#include "index/basic_comparator.h"
+#include "index/generic_key.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "bulk_load_test.db";
+
+TEST(BulkLoadTest, TreeTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 16, 16);
+  const int n = 5000;
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < n; i++) items.emplace_back(2 * i, i);
+  ASSERT_TRUE(tree.BulkLoad(items));
+  ASSERT_TRUE(tree.Check());
+  // only an empty tree can be loaded
+  ASSERT_FALSE(tree.BulkLoad(items));
+  std::vector<int> ans;
+  for (int i = 0; i < n; i++) {
+    ASSERT_TRUE(tree.GetValue(2 * i, ans));
+    ASSERT_EQ(i, ans.back());
+  }
+  // a range spans many leaves, the key itself is in it only if it is included
+  auto range = [&](int key, bool to_left, bool key_included) {
+    std::unordered_set<int> values;
+    tree.RangeScan(key, values, to_left, key_included);
+    return values;
+  };
+  ASSERT_EQ(100u, range(200, true, false).size());
+  ASSERT_EQ(101u, range(200, true, true).size());
+  ASSERT_EQ(101u, range(201, true, false).size());
+  ASSERT_EQ(0u, range(200, true, false).count(100));
+  ASSERT_EQ(1u, range(200, true, true).count(100));
+  ASSERT_EQ(9u, range(2 * 4990, false, false).size());
+  ASSERT_EQ(10u, range(2 * 4990, false, true).size());
+  ASSERT_EQ(static_cast<size_t>(n), range(2 * n, true, false).size());
+  ASSERT_TRUE(range(0, true, false).empty());
+  ASSERT_TRUE(range(2 * n, false, true).empty());
+  // the loaded tree keeps working with single inserts and removes
+  for (int i = 0; i < n; i++) ASSERT_TRUE(tree.Insert(2 * i + 1, n + i));
+  ASSERT_TRUE(tree.Check());
+  for (int i = 0; i < n; i += 2) tree.Remove(2 * i);
+  int expected = 0;
+  for (auto it = tree.Begin(); it != tree.End(); ++it) {
+    while (expected % 4 == 0) expected++;
+    ASSERT_EQ(expected, (*it).first);
+    expected++;
+  }
+  ASSERT_EQ(2 * n, expected);
+}
+
+TEST(BulkLoadTest, IndexTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  auto make_keys = [](int begin, int end, std::deque<Row> &keys, std::vector<RowId> &rids) {
+    // loaded out of order, the index sorts the keys itself
+    for (int i = end - 1; i >= begin; i--) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+      keys.emplace_back(fields);
+      rids.emplace_back(1000, i);
+    }
+  };
+
+  std::deque<Row> keys;
+  std::vector<RowId> rids;
+  make_keys(0, 1000, keys, rids);
+  // a key repeated inside the batch
+  keys.push_back(keys.front());
+  rids.push_back(rids.front());
+  ASSERT_EQ(DB_FAILED, index->BulkLoad(keys, rids, nullptr));
+  ASSERT_EQ(index->GetBeginIterator(), index->GetEndIterator());
+  keys.pop_back();
+  rids.pop_back();
+  ASSERT_EQ(DB_SUCCESS, index->BulkLoad(keys, rids, nullptr));
+
+  // a second batch goes to the non-empty index one key at a time
+  std::deque<Row> more_keys;
+  std::vector<RowId> more_rids;
+  make_keys(900, 1100, more_keys, more_rids);
+  ASSERT_EQ(DB_FAILED, index->BulkLoad(more_keys, more_rids, nullptr));
+  more_keys.clear();
+  more_rids.clear();
+  make_keys(1000, 1100, more_keys, more_rids);
+  ASSERT_EQ(DB_SUCCESS, index->BulkLoad(more_keys, more_rids, nullptr));
+
+  uint32_t i = 0;
+  for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter) {
+    ASSERT_EQ(i, (*iter).second.GetSlotNum());
+    i++;
+  }
+  ASSERT_EQ(1100, i);
+  std::vector<RowId> ret;
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 1050)};
+  Row key(fields);
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, ret, nullptr));
+  ASSERT_EQ(1050, ret.back().GetSlotNum());
+}
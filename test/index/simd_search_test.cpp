@@ -0,0 +1,122 @@
+#include <algorithm>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/b_plus_tree_index.h"
+#include "index/basic_comparator.h"
+#include "index/simd_search.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "simd_search_test.db";
+
+TEST(SimdSearchTest, LowerBoundTest) {
+  LOG(INFO) << "node search implementation: " << simd::Implementation();
+  for (int n : {0, 1, 7, 31, 32, 33, 100, 511}) {
+    vector<int32_t> keys;
+    vector<std::pair<float, int>> pairs;
+    for (int i = 0; i < n; i++) {
+      keys.push_back(i * 3 - 50);
+      pairs.emplace_back(static_cast<float>(i) * 0.5f, i);
+    }
+    for (int32_t key = -60; key < n * 3; key++) {
+      int expected = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+      ASSERT_EQ(expected, simd::LowerBound(keys.data(), n, 1, key));
+    }
+    for (int i = -2; i <= n + 1; i++) {
+      float key = static_cast<float>(i) * 0.5f - 0.25f;
+      int expected = std::lower_bound(pairs.begin(), pairs.end(), std::make_pair(key, 0)) - pairs.begin();
+      ASSERT_EQ(expected, simd::LowerBound(&pairs.data()->first, n, 2, key));
+    }
+  }
+}
+
+TEST(SimdSearchTest, FloatTreeTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<float> comparator;
+  BPlusTree<float, int, BasicComparator<float>> tree(0, engine.bpm_, comparator);
+  const int n = 2000;
+  vector<int> keys;
+  for (int i = 0; i < n; i++) keys.push_back(i);
+  ShuffleArray(keys);
+  for (int i = 0; i < n; i++) ASSERT_TRUE(tree.Insert(static_cast<float>(keys[i]) / 4, keys[i]));
+  ASSERT_TRUE(tree.Check());
+  vector<int> ans;
+  for (int i = 0; i < n; i++) {
+    ASSERT_TRUE(tree.GetValue(static_cast<float>(i) / 4, ans));
+    ASSERT_EQ(i, ans.back());
+    ASSERT_FALSE(tree.GetValue(static_cast<float>(i) / 4 + 0.1f, ans));
+  }
+  ASSERT_TRUE(tree.Check());
+}
+
+TEST(SimdSearchTest, GenericKeyTest) {
+  // keys further apart than a pair of words are gathered
+  for (int stride : {12, 40}) {
+    for (int n : {0, 1, 9, 33, 200}) {
+      vector<char> ints(n * stride + 1, 0), floats(n * stride + 1, 0);
+      vector<int32_t> keys;
+      for (int i = 0; i < n; i++) {
+        keys.push_back(i * 2 - 20);
+        float value = static_cast<float>(keys.back());
+        memcpy(ints.data() + 1 + i * stride, &keys.back(), sizeof(int32_t));
+        memcpy(floats.data() + 1 + i * stride, &value, sizeof(float));
+      }
+      for (int32_t key = -25; key < n * 2; key++) {
+        int expected = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+        ASSERT_EQ(expected, simd::LowerBound(ints.data() + 1, n, stride, key));
+        ASSERT_EQ(expected, simd::LowerBound(floats.data() + 1, n, stride, static_cast<float>(key)));
+      }
+    }
+  }
+
+  // the keys of a float column that is never null are compared as numbers, others field by field
+  using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<32>, RowId, GenericComparator<32>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 0, false, false),
+                                   ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 1, true, false)};
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> score_map{0}, id_map{1};
+  auto *score_schema = Schema::ShallowCopySchema(&table_schema, score_map, &heap);
+  auto *id_schema = Schema::ShallowCopySchema(&table_schema, id_map, &heap);
+  auto make_row = [](TypeId type, float value) {
+    std::vector<Field> fields;
+    if (type == TypeId::kTypeInt) {
+      fields.emplace_back(type, static_cast<int32_t>(value));
+    } else {
+      fields.emplace_back(type, value);
+    }
+    return Row(fields);
+  };
+  GenericKey<32> key;
+  key.SerializeFromKey(make_row(TypeId::kTypeFloat, 1.5f), score_schema);
+  ASSERT_LT(0, GenericComparator<32>(score_schema).GetNumberOffset(key));
+  key.SerializeFromKey(make_row(TypeId::kTypeInt, 1), id_schema);
+  ASSERT_EQ(-1, GenericComparator<32>(id_schema).GetNumberOffset(key));
+
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, score_schema, engine.bpm_);
+  const int n = 3000;
+  vector<int> order;
+  for (int i = 0; i < n; i++) order.push_back(i);
+  ShuffleArray(order);
+  for (int i : order) {
+    Row row = make_row(TypeId::kTypeFloat, static_cast<float>(i) / 4 - 100);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row, RowId(i / 100, i % 100), nullptr));
+  }
+  std::vector<RowId> ret;
+  for (int i = 0; i < n; i++) {
+    ret.clear();
+    Row row = make_row(TypeId::kTypeFloat, static_cast<float>(i) / 4 - 100);
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(row, ret, nullptr));
+    ASSERT_EQ(RowId(i / 100, i % 100), ret.back());
+    Row missing = make_row(TypeId::kTypeFloat, static_cast<float>(i) / 4 - 99.9f);
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(missing, ret, nullptr));
+  }
+  int i = 0;
+  for (auto it = index->GetBeginIterator(); it != index->GetEndIterator(); ++it) {
+    ASSERT_EQ(RowId(i / 100, i % 100), (*it).second);
+    i++;
+  }
+  ASSERT_EQ(n, i);
+}
@@ -0,0 +1,52 @@
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "record/row.h"
+#include "utils/mem_heap.h"
+
+TEST(ArenaMemHeapTest, AllocateTest) {
+  ArenaMemHeap heap(256);
+  char *first = static_cast<char *>(heap.Allocate(1));
+  char *second = static_cast<char *>(heap.Allocate(24));
+  ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(first) % ARENA_ALIGNMENT);
+  ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(second) % ARENA_ALIGNMENT);
+  ASSERT_EQ(first + ARENA_ALIGNMENT, second);
+  // larger than a chunk
+  char *large = static_cast<char *>(heap.Allocate(4096));
+  memset(large, 0x5a, 4096);
+  for (int i = 0; i < 100; i++) memset(heap.Allocate(100), i, 100);
+  // everything is handed back, the first chunk is used again
+  heap.Reset();
+  ASSERT_EQ(first, heap.Allocate(8));
+}
+
+TEST(ArenaMemHeapTest, RowTest) {
+  SimpleMemHeap schema_heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(schema_heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(schema_heap)("name", TypeId::kTypeChar, 16, 1, true, false)};
+  Schema schema(columns);
+  ArenaMemHeap heap;
+  char name[] = "minisql";
+  char buf[PAGE_SIZE];
+  for (int i = 0; i < 1000; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, strlen(name), true)};
+    Row row(fields, &heap);
+    Row copy(row);
+    ASSERT_EQ(row.GetSerializedSize(&schema), copy.SerializeTo(buf, &schema));
+    Row read(INVALID_ROWID, &heap);
+    read.DeserializeFrom(buf, &schema);
+    ASSERT_EQ(CmpBool::kTrue, read.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+    ASSERT_EQ(CmpBool::kTrue, read.GetField(1)->CompareEquals(*row.GetField(1)));
+  }
+  heap.Reset();
+
+  // a row with a heap of its own reuses it every time it is read into
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 7), Field(TypeId::kTypeChar, name, strlen(name), false)};
+  Row row(fields);
+  row.SerializeTo(buf, &schema);
+  Row read(INVALID_ROWID);
+  read.DeserializeFrom(buf, &schema);
+  Field *field = read.GetField(0);
+  read.DeserializeFrom(buf, &schema);
+  ASSERT_EQ(field, read.GetField(0));
+}
@@ -0,0 +1,91 @@
+#include <cstring>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "record/filter_kernels.h"
+#include "record/scan_predicate.h"
+
+template <typename T>
+static bool Expected(T value, CompareOp op, T key) {
+  switch (op) {
+    case CompareOp::kEq:
+      return value == key;
+    case CompareOp::kNe:
+      return value != key;
+    case CompareOp::kLt:
+      return value < key;
+    case CompareOp::kLe:
+      return value <= key;
+    case CompareOp::kGt:
+      return value > key;
+    default:
+      return value >= key;
+  }
+}
+
+template <typename T>
+static void CheckFilter(const std::vector<T> &values, const std::vector<T> &keys) {
+  const CompareOp ops[] = {CompareOp::kEq, CompareOp::kNe, CompareOp::kLt,
+                           CompareOp::kLe, CompareOp::kGt, CompareOp::kGe};
+  uint64_t sel[FILTER_BATCH_WORDS];
+  for (uint32_t n : {0u, 1u, 3u, 4u, 7u, 8u, 9u, 63u, 64u, 65u, 200u, 256u}) {
+    for (CompareOp op : ops) {
+      for (T key : keys) {
+        // stale bits of a former call must be cleared
+        memset(sel, 0xff, sizeof(sel));
+        simd::Filter(values.data(), n, op, key, sel);
+        for (uint32_t i = 0; i < (n + 63) / 64 * 64; i++) {
+          bool selected = (sel[i / 64] >> (i % 64)) & 1;
+          ASSERT_EQ(i < n && Expected(values[i], op, key), selected)
+              << "n " << n << " op " << static_cast<int>(op) << " i " << i;
+        }
+      }
+    }
+  }
+}
+
+TEST(FilterKernelTest, IntTest) {
+  LOG(INFO) << "filter implementation: " << simd::FilterImplementation();
+  std::vector<int32_t> values;
+  for (int32_t i = 0; i < FILTER_BATCH_SIZE; i++) values.push_back((i * 37) % 101 - 50);
+  values[5] = INT32_MIN;
+  values[6] = INT32_MAX;
+  CheckFilter<int32_t>(values, {-50, -1, 0, 7, 50, INT32_MIN, INT32_MAX});
+}
+
+TEST(FilterKernelTest, FloatTest) {
+  std::vector<float> values;
+  for (int32_t i = 0; i < FILTER_BATCH_SIZE; i++) values.push_back(static_cast<float>((i * 37) % 101) * 0.25f - 10);
+  values[3] = -0.f;
+  CheckFilter<float>(values, {-10.f, -0.5f, 0.f, 0.25f, 3.125f, 100.f});
+}
+
+TEST(FilterKernelTest, BatchPredicateTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 1, true, false)};
+  Schema schema(columns);
+  const uint32_t n = 150;
+  std::vector<std::vector<char>> buffers(n, std::vector<char>(64));
+  const char *rows[FILTER_BATCH_SIZE];
+  for (uint32_t i = 0; i < n; i++) {
+    std::vector<Field> fields;
+    fields.push_back(i % 5 == 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, static_cast<int32_t>(i % 20)));
+    fields.push_back(i % 7 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, i * 0.5f));
+    Row row(fields);
+    row.SerializeTo(buffers[i].data(), &schema);
+    rows[i] = buffers[i].data();
+  }
+  uint64_t sel[FILTER_BATCH_WORDS];
+  for (uint32_t column : {0u, 1u}) {
+    for (int op = 0; op <= static_cast<int>(CompareOp::kNotNull); op++) {
+      Field key = column == 0 ? Field(TypeId::kTypeInt, 10) : Field(TypeId::kTypeFloat, 30.f);
+      auto predicate = ScanPredicate::Create(&schema, column, static_cast<CompareOp>(op), key);
+      predicate->EvaluateBatch(rows, n, sel);
+      for (uint32_t i = 0; i < n; i++) {
+        ASSERT_EQ(predicate->Evaluate(rows[i]), static_cast<bool>((sel[i / 64] >> (i % 64)) & 1));
+      }
+      ASSERT_EQ(0u, sel[n / 64] >> (n % 64));
+    }
+  }
+}
@@ -0,0 +1,171 @@
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "index/generic_key.h"
+#include "record/row.h"
+#include "record/row_view.h"
+#include "record/scan_predicate.h"
+
+/**
+ * Write fields the way rows were serialized before the compact format
+ */
+static uint32_t SerializeLegacy(std::vector<Field> &fields, char *buf) {
+  char *begin = buf;
+  uint64_t null_map = 0;
+  MACH_WRITE_UINT32(buf, static_cast<uint32_t>(fields.size()));
+  buf += sizeof(uint32_t) + sizeof(uint64_t);
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    if (fields[i].IsNull()) continue;
+    null_map |= uint64_t(1) << i;
+    buf += fields[i].SerializeTo(buf);
+  }
+  MACH_WRITE_UINT64(begin + sizeof(uint32_t), null_map);
+  return static_cast<uint32_t>(buf - begin);
+}
+
+static void ExpectSameFields(std::vector<Field> &fields, const Row &row) {
+  ASSERT_EQ(fields.size(), row.GetFieldCount());
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    ASSERT_EQ(fields[i].IsNull(), row.GetField(i)->IsNull());
+    if (!fields[i].IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(i)->CompareEquals(fields[i]));
+    }
+  }
+}
+
+TEST(RowFormatTest, CompactTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns;
+  std::vector<Field> fields;
+  char text[] = "compact row";
+  // more columns than the legacy format could hold
+  for (uint32_t i = 0; i < 100; i++) {
+    std::string name = "c" + std::to_string(i);
+    switch (i % 4) {
+      case 0:
+        columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeInt, i, true, false));
+        fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(i) * 3);
+        break;
+      case 1:
+        columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeChar, 16, i, true, false));
+        fields.emplace_back(TypeId::kTypeChar, text, i % 12, false);
+        break;
+      case 2:
+        columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeFloat, i, true, false));
+        fields.emplace_back(TypeId::kTypeFloat, i * 0.5f);
+        break;
+      default:
+        // every other null is a char
+        if (i % 8 == 3) {
+          columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeChar, 16, i, true, false));
+        } else {
+          columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeInt, i, true, false));
+        }
+        fields.emplace_back(columns.back()->GetType());
+        break;
+    }
+  }
+  Schema schema(columns);
+  Row row(fields);
+  char buf[PAGE_SIZE];
+  uint32_t size = row.SerializeTo(buf, &schema);
+  ASSERT_EQ(row.GetSerializedSize(&schema), size);
+
+  Row read(INVALID_ROWID);
+  ASSERT_EQ(size, read.DeserializeFrom(buf, &schema));
+  ExpectSameFields(fields, read);
+
+  RowView view(buf, &schema);
+  ASSERT_EQ(size, view.GetSerializedSize());
+  ASSERT_EQ(72, view.GetInt(24));
+  ASSERT_EQ("compact r", view.GetChars(93));
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    Field field = view.GetField(i);
+    ASSERT_EQ(fields[i].IsNull(), field.IsNull());
+    if (!field.IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, field.CompareEquals(fields[i]));
+    }
+  }
+}
+
+TEST(RowFormatTest, SizeTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)};
+  Schema schema(columns);
+  char name[] = "abc";
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 1), Field(TypeId::kTypeChar, name, 3, false)};
+  Row row(fields);
+  char buf[PAGE_SIZE];
+  // tag, one bitmap byte, the int, one end offset and the chars
+  ASSERT_EQ(1u + 1 + 4 + 2 + 3, row.SerializeTo(buf, &schema));
+  ASSERT_LT(row.GetSerializedSize(&schema), SerializeLegacy(fields, buf));
+}
+
+TEST(RowFormatTest, LegacyTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   ALLOC_COLUMN(heap)("note", TypeId::kTypeChar, 16, 2, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 3, true, false)};
+  Schema schema(columns);
+  char name[] = "legacy";
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 42), Field(TypeId::kTypeChar, name, strlen(name), false),
+                            Field(TypeId::kTypeChar), Field(TypeId::kTypeFloat, -1.5f)};
+  char buf[PAGE_SIZE];
+  uint32_t size = SerializeLegacy(fields, buf);
+
+  Row row(INVALID_ROWID);
+  ASSERT_EQ(size, row.DeserializeFrom(buf, &schema));
+  ExpectSameFields(fields, row);
+  RowView view(buf, &schema);
+  ASSERT_EQ(size, view.GetSerializedSize());
+  ASSERT_EQ(42, view.GetInt(0));
+  ASSERT_EQ("legacy", view.GetChars(1));
+  ASSERT_TRUE(view.IsNull(2));
+  ASSERT_EQ(-1.5f, view.GetFloat(3));
+
+  // index keys written in either format compare equal
+  std::vector<Column *> key_columns = {columns[1], columns[0]};
+  Schema key_schema(key_columns);
+  std::vector<Field> key_fields{Field(TypeId::kTypeChar, name, strlen(name), false), Field(TypeId::kTypeInt, 42)};
+  GenericKey<32> legacy_key, compact_key;
+  memset(legacy_key.data, 0, sizeof(legacy_key.data));
+  SerializeLegacy(key_fields, legacy_key.data);
+  Row key_row(key_fields);
+  compact_key.SerializeFromKey(key_row, &key_schema);
+  GenericComparator<32> comparator(&key_schema);
+  ASSERT_EQ(0, comparator(legacy_key, compact_key));
+  ASSERT_EQ(0, comparator(compact_key, legacy_key));
+}
+
+TEST(RowFormatTest, PredicateTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("a", TypeId::kTypeChar, 16, 0, true, false),
+                                   ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 1, false, false),
+                                   ALLOC_COLUMN(heap)("b", TypeId::kTypeChar, 16, 2, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 3, true, false)};
+  Schema schema(columns);
+  char a[] = "first", b[] = "second";
+  std::vector<Field> fields{Field(TypeId::kTypeChar, a, strlen(a), false), Field(TypeId::kTypeInt, 7),
+                            Field(TypeId::kTypeChar, b, strlen(b), false), Field(TypeId::kTypeFloat)};
+  char compact[PAGE_SIZE], legacy[PAGE_SIZE];
+  Row row(fields);
+  row.SerializeTo(compact, &schema);
+  SerializeLegacy(fields, legacy);
+  for (const char *data : {compact, legacy}) {
+    auto matches = [&](uint32_t column, CompareOp op, const Field &key) {
+      return ScanPredicate::Create(&schema, column, op, key)->Evaluate(data);
+    };
+    ASSERT_TRUE(matches(1, CompareOp::kEq, Field(TypeId::kTypeInt, 7)));
+    ASSERT_FALSE(matches(1, CompareOp::kLt, Field(TypeId::kTypeInt, 7)));
+    ASSERT_TRUE(matches(1, CompareOp::kGe, Field(TypeId::kTypeInt, 7)));
+    ASSERT_TRUE(matches(0, CompareOp::kEq, Field(TypeId::kTypeChar, a, strlen(a), false)));
+    ASSERT_TRUE(matches(2, CompareOp::kEq, Field(TypeId::kTypeChar, b, strlen(b), false)));
+    ASSERT_TRUE(matches(2, CompareOp::kGt, Field(TypeId::kTypeChar, a, strlen(a), false)));
+    ASSERT_FALSE(matches(2, CompareOp::kNe, Field(TypeId::kTypeChar, b, strlen(b), false)));
+    ASSERT_TRUE(matches(3, CompareOp::kIsNull, Field(TypeId::kTypeFloat)));
+    ASSERT_FALSE(matches(3, CompareOp::kNotNull, Field(TypeId::kTypeFloat)));
+    ASSERT_FALSE(matches(3, CompareOp::kNe, Field(TypeId::kTypeFloat, 1.f)));
+  }
+}
@@ -0,0 +1,61 @@
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "index/generic_key.h"
+#include "record/row.h"
+#include "record/row_view.h"
+
+TEST(RowViewTest, AccessTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   ALLOC_COLUMN(heap)("note", TypeId::kTypeChar, 64, 2, true, false),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 3, true, false)};
+  Schema schema(columns);
+  char name[] = "hello";
+  std::vector<Field> fields{Field(TypeId::kTypeInt, -7), Field(TypeId::kTypeChar, name, strlen(name), false),
+                            Field(TypeId::kTypeChar), Field(TypeId::kTypeFloat, 2.5f)};
+  Row row(fields);
+  char buf[PAGE_SIZE];
+  uint32_t size = row.SerializeTo(buf, &schema);
+
+  RowView view(buf, &schema);
+  ASSERT_EQ(4u, view.GetFieldCount());
+  ASSERT_EQ(size, view.GetSerializedSize());
+  ASSERT_FALSE(view.IsNull(0));
+  ASSERT_EQ(-7, view.GetInt(0));
+  ASSERT_EQ("hello", view.GetChars(1));
+  // the chars are not copied
+  ASSERT_TRUE(view.GetChars(1).data() > buf && view.GetChars(1).data() < buf + size);
+  ASSERT_TRUE(view.IsNull(2));
+  ASSERT_EQ(2.5f, view.GetFloat(3));
+  for (uint32_t i = 0; i < 4; i++) {
+    Field field = view.GetField(i);
+    ASSERT_EQ(fields[i].IsNull(), field.IsNull());
+    if (!field.IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, field.CompareEquals(fields[i]));
+    }
+  }
+}
+
+TEST(RowViewTest, CompareTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 0, false, false),
+                                   ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 1, false, false)};
+  Schema schema(columns);
+  GenericComparator<32> comparator(&schema);
+  char a[] = "ab", b[] = "abc";
+  auto make_key = [&](char *name, int32_t id) {
+    GenericKey<32> key;
+    std::vector<Field> fields{Field(TypeId::kTypeChar, name, strlen(name), false), Field(TypeId::kTypeInt, id)};
+    Row row(fields);
+    key.SerializeFromKey(row, &schema);
+    return key;
+  };
+  GenericKey<32> k1 = make_key(a, 5), k2 = make_key(a, -5), k3 = make_key(b, -100);
+  ASSERT_EQ(1, comparator(k1, k2));
+  ASSERT_EQ(-1, comparator(k2, k1));
+  ASSERT_EQ(-1, comparator(k1, k3));
+  ASSERT_EQ(1, comparator(k3, k2));
+  ASSERT_EQ(0, comparator(k1, make_key(a, 5)));
+}
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "cluster_test.db";
+using Fields = std::vector<Field>;
+
+static Fields MakeFields(int i) {
+  std::string name = std::to_string(i) + std::string(40, 'x');
+  return Fields{Field(TypeId::kTypeInt, i),
+                Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+}
+
+/**
+ * The key of a row, read back from its name that starts with it
+ */
+static int KeyOf(const Row &row) {
+  return std::stoi(std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+}
+
+/**
+ * The pages along the chain hold key ranges that follow each other
+ */
+static void ExpectOrdered(TableHeap *table_heap, const std::unordered_map<RowId, int> &rows) {
+  std::vector<std::pair<int, int>> ranges;
+  page_id_t last_page = INVALID_PAGE_ID;
+  size_t count = 0;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    int key = KeyOf(*it);
+    ASSERT_EQ(1u, rows.count(it->GetRowId()));
+    ASSERT_EQ(rows.at(it->GetRowId()), key);
+    if (it->GetRowId().GetPageId() != last_page) {
+      last_page = it->GetRowId().GetPageId();
+      ranges.emplace_back(key, key);
+    }
+    ranges.back().first = std::min(ranges.back().first, key);
+    ranges.back().second = std::max(ranges.back().second, key);
+    count++;
+  }
+  ASSERT_EQ(rows.size(), count);
+  for (size_t i = 1; i < ranges.size(); i++) ASSERT_LT(ranges[i - 1].second, ranges[i].first);
+}
+
+static void ExpectRange(TableHeap *table_heap, const std::unordered_map<RowId, int> &rows, CompareOp op, int key) {
+  std::unordered_set<RowId> expected;
+  for (auto &it : rows) {
+    bool match = op == CompareOp::kEq   ? it.second == key
+                 : op == CompareOp::kLt ? it.second < key
+                 : op == CompareOp::kLe ? it.second <= key
+                 : op == CompareOp::kGt ? it.second > key
+                                        : it.second >= key;
+    if (match) expected.insert(it.first);
+  }
+  std::unordered_set<RowId> found;
+  ASSERT_TRUE(table_heap->FetchKeyRange(found, op, Field(TypeId::kTypeInt, key)));
+  ASSERT_EQ(expected, found) << "op " << static_cast<int>(op) << " key " << key;
+}
+
+TEST(ClusterTest, InsertAndLookupTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap =
+      TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap, TableLayout::kRow, {0});
+  ASSERT_TRUE(table_heap->IsClustered());
+
+  // keys in random order, the rows a split moves are reported at their new rid
+  std::vector<int> keys(row_nums);
+  for (int i = 0; i < row_nums; i++) keys[i] = i * 2;
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(17));
+  std::unordered_map<RowId, int> rows;
+  uint32_t moves = 0;
+  auto moved = [&](Row &row, const RowId &old_rid) {
+    ASSERT_EQ(1u, rows.count(old_rid));
+    ASSERT_EQ(0u, rows.count(row.GetRowId()));
+    ASSERT_EQ(rows[old_rid], KeyOf(row));
+    rows[row.GetRowId()] = rows[old_rid];
+    rows.erase(old_rid);
+    moves++;
+  };
+  for (auto key : keys) {
+    Fields fields = MakeFields(key);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr, moved));
+    rows[row.GetRowId()] = key;
+  }
+  table_heap->ReleaseInsertPage();
+  ASSERT_GT(moves, 0u);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  ExpectOrdered(table_heap, rows);
+
+  // a key is found on its page, a missing key is not
+  std::unordered_map<int, RowId> by_key;
+  for (auto &it : rows) by_key[it.second] = it.first;
+  for (int key : {0, 2, 998, 5000, row_nums * 2 - 2}) {
+    Fields fields = MakeFields(key);
+    Row row(fields);
+    RowId rid;
+    ASSERT_TRUE(table_heap->FindKey(row, &rid));
+    ASSERT_EQ(by_key[key], rid);
+  }
+  for (int key : {-1, 1, 999, row_nums * 2}) {
+    Fields fields = MakeFields(key);
+    Row row(fields);
+    ASSERT_FALSE(table_heap->FindKey(row, nullptr));
+  }
+
+  // key ranges give the rows a full scan would
+  for (auto op : {CompareOp::kEq, CompareOp::kLt, CompareOp::kLe, CompareOp::kGt, CompareOp::kGe}) {
+    for (int key : {-5, 0, 1, 2000, 2001, row_nums * 2 - 2, row_nums * 2 + 3}) ExpectRange(table_heap, rows, op, key);
+  }
+  std::unordered_set<RowId> found;
+  ASSERT_FALSE(table_heap->FetchKeyRange(found, CompareOp::kNe, Field(TypeId::kTypeInt, 0)));
+
+  // an update may not change the key, other columns change in place
+  auto rid = by_key[100];
+  Fields changed_key = MakeFields(101);
+  Row changed_key_row(changed_key);
+  ASSERT_FALSE(table_heap->UpdateTuple(changed_key_row, rid, nullptr));
+  Fields same_key = {Field(TypeId::kTypeInt, 100), Field(TypeId::kTypeChar, const_cast<char *>("y"), 1, true)};
+  Row same_key_row(same_key);
+  ASSERT_TRUE(table_heap->UpdateTuple(same_key_row, rid, nullptr));
+  Row updated(rid);
+  ASSERT_TRUE(table_heap->GetTuple(&updated, nullptr));
+  ASSERT_EQ(CmpBool::kTrue, updated.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 100)));
+  ASSERT_EQ(CmpBool::kTrue, updated.GetField(1)->CompareEquals(same_key[1]));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(ClusterTest, AscendingVacuumReopenTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 6000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap =
+      TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap, TableLayout::kRow, {0});
+
+  // ascending keys fill each page before the next one is started, nothing moves
+  std::unordered_map<RowId, int> rows;
+  std::vector<RowId> rids;
+  uint32_t moves = 0;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields = MakeFields(i);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr, [&](Row &, const RowId &) { moves++; }));
+    rows[row.GetRowId()] = i;
+    rids.push_back(row.GetRowId());
+  }
+  table_heap->ReleaseInsertPage();
+  ASSERT_EQ(0u, moves);
+  std::unordered_set<page_id_t> pages;
+  for (auto &rid : rids) pages.insert(rid.GetPageId());
+  ExpectOrdered(table_heap, rows);
+
+  // keep one row in five, vacuum merges neighbouring pages and keeps the order
+  for (int i = 0; i < row_nums; i++) {
+    if (i % 5 == 0) continue;
+    table_heap->ApplyDelete(rids[i], nullptr);
+    rows.erase(rids[i]);
+  }
+  uint32_t freed = table_heap->Vacuum(nullptr, [&](Row &row, const RowId &old_rid) {
+    ASSERT_EQ(1u, rows.count(old_rid));
+    rows[row.GetRowId()] = rows[old_rid];
+    rows.erase(old_rid);
+  });
+  ASSERT_GT(freed, pages.size() / 2);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  ExpectOrdered(table_heap, rows);
+  ExpectRange(table_heap, rows, CompareOp::kGe, 3000);
+
+  // a reopened heap rebuilds its directory from the pages, new keys land in order
+  TableHeap *reopened =
+      TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), table_heap->GetFsmPageId(), schema.get(), nullptr,
+                        nullptr, &heap, TableLayout::kRow, {0});
+  ExpectRange(reopened, rows, CompareOp::kLt, 1000);
+  auto moved = [&](Row &row, const RowId &old_rid) {
+    rows[row.GetRowId()] = rows[old_rid];
+    rows.erase(old_rid);
+  };
+  for (int i = 1; i < row_nums; i += 10) {
+    Fields fields = MakeFields(i);
+    Row row(fields);
+    ASSERT_TRUE(reopened->InsertTuple(row, nullptr, moved));
+    rows[row.GetRowId()] = i;
+  }
+  reopened->ReleaseInsertPage();
+  ExpectOrdered(reopened, rows);
+  ExpectRange(reopened, rows, CompareOp::kLe, 2501);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
@@ -0,0 +1,160 @@
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "page/column_page.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "column_page_test.db";
+using Fields = std::vector<Field>;
+
+static Fields MakeFields(int i) {
+  std::string name = "name" + std::to_string(i % 97);
+  return Fields{Field(TypeId::kTypeInt, i % 101),
+                i % 7 == 0 ? Field(TypeId::kTypeChar)
+                           : Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.length(), true),
+                i % 5 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, 0.5f * (i % 89))};
+}
+
+static void ExpectFields(const Fields &expected, const Row &row) {
+  ASSERT_EQ(expected.size(), row.GetFieldCount());
+  for (uint32_t j = 0; j < expected.size(); j++) {
+    ASSERT_EQ(expected[j].IsNull(), row.GetField(j)->IsNull());
+    if (!expected[j].IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(j)->CompareEquals(expected[j]));
+    }
+  }
+}
+
+TEST(ColumnPageTest, LayoutTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 13, 1, true, false),
+                                   ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  ColumnPageLayout layout(&schema);
+  ASSERT_EQ(4u + 15 + 4, layout.GetTupleSize());
+  ASSERT_GT(layout.GetCapacity(), 100u);
+  // minipages follow each other, aligned, and the last one ends inside the page
+  uint32_t end = 0;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    ASSERT_EQ(0u, layout.GetNullsOffset(i) % 8);
+    ASSERT_EQ(0u, layout.GetValuesOffset(i) % 8);
+    ASSERT_LE(end, layout.GetNullsOffset(i));
+    ASSERT_LE(layout.GetNullsOffset(i) + (layout.GetCapacity() + 7) / 8, layout.GetValuesOffset(i));
+    end = layout.GetValuesOffset(i) + layout.GetCapacity() * layout.GetWidth(i);
+  }
+  ASSERT_LE(end, static_cast<uint32_t>(PAGE_SIZE));
+
+  std::vector<Column *> wide = {ALLOC_COLUMN(heap)("text", TypeId::kTypeChar, PAGE_SIZE, 0, true, false)};
+  Schema wide_schema(wide);
+  ASSERT_EQ(0u, ColumnPageLayout(&wide_schema).GetCapacity());
+}
+
+TEST(ColumnPageTest, HeapTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 3000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap =
+      TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap, TableLayout::kColumn);
+  ASSERT_EQ(TableLayout::kColumn, table_heap->GetLayout());
+  std::unordered_map<RowId, int> ids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields = MakeFields(i);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    ids[row.GetRowId()] = i;
+  }
+  ASSERT_EQ(static_cast<size_t>(row_nums), ids.size());
+  // a char longer than its column has no room in the minipage
+  char long_name[] = "much longer than sixteen";
+  Fields too_long{Field(TypeId::kTypeInt, 1), Field(TypeId::kTypeChar, long_name, strlen(long_name), false),
+                  Field(TypeId::kTypeFloat)};
+  Row too_long_row(too_long);
+  ASSERT_FALSE(table_heap->InsertTuple(too_long_row, nullptr));
+
+  // point reads
+  for (auto &it : ids) {
+    Row row(it.first);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ExpectFields(MakeFields(it.second), row);
+  }
+
+  // predicate scans run on the minipages, check them against the rows the iterator assembles
+  char name[] = "name42";
+  Fields keys{Field(TypeId::kTypeInt, 50), Field(TypeId::kTypeChar, name, strlen(name), false),
+              Field(TypeId::kTypeFloat, 20.f)};
+  for (uint32_t column = 0; column < 3; column++) {
+    for (int op = 0; op <= static_cast<int>(CompareOp::kNotNull); op++) {
+      auto predicate = ScanPredicate::Create(schema.get(), column, static_cast<CompareOp>(op), keys[column]);
+      std::unordered_set<RowId> expected;
+      std::vector<char> buf(PAGE_SIZE);
+      for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+        it->SerializeTo(buf.data(), schema.get());
+        if (predicate->Evaluate(buf.data())) expected.insert(it->GetRowId());
+      }
+      std::unordered_set<RowId> rids;
+      table_heap->FetchId(rids, *predicate);
+      ASSERT_EQ(expected, rids) << "column " << column << " op " << op;
+    }
+  }
+  std::unordered_set<RowId> rids;
+  table_heap->FetchId(rids, *ScanPredicate::Create(schema.get(), 0, CompareOp::kLt, Field(TypeId::kTypeInt, 10)));
+  size_t small = 0;
+  for (auto &it : ids) small += it.second % 101 < 10;
+  ASSERT_EQ(small, rids.size());
+
+  // deleted slots are hidden at once and reused once the delete is applied
+  std::vector<RowId> deleted;
+  std::unordered_set<page_id_t> pages;
+  for (auto &it : ids) {
+    pages.insert(it.first.GetPageId());
+    if (it.second % 3 == 0) deleted.push_back(it.first);
+  }
+  ASSERT_TRUE(table_heap->MarkDelete(deleted[0], nullptr));
+  rids.clear();
+  table_heap->FetchAllIds(rids);
+  ASSERT_EQ(ids.size() - 1, rids.size());
+  table_heap->RollbackDelete(deleted[0], nullptr);
+  for (auto &rid : deleted) {
+    table_heap->ApplyDelete(rid, nullptr);
+    ids.erase(rid);
+  }
+  rids.clear();
+  table_heap->FetchAllIds(rids);
+  ASSERT_EQ(ids.size(), rids.size());
+  for (size_t i = 0; i < deleted.size(); i++) {
+    Fields fields = MakeFields(row_nums + i);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    ASSERT_EQ(1u, pages.count(row.GetRowId().GetPageId()));
+    ids[row.GetRowId()] = row_nums + i;
+  }
+
+  // updates are done in place
+  auto updated = ids.begin()->first;
+  Fields fields = MakeFields(7);
+  Row row(fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(row, updated, nullptr));
+  ids[updated] = 7;
+  table_heap->ReleaseInsertPage();
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+
+  // a heap opened again keeps its layout
+  TableHeap *reopened = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), table_heap->GetFsmPageId(),
+                                          schema.get(), nullptr, nullptr, &heap, TableLayout::kColumn);
+  size_t count = 0;
+  for (auto it = reopened->Begin(nullptr); it != reopened->End(); ++it) {
+    ASSERT_EQ(1u, ids.count(it->GetRowId()));
+    ExpectFields(MakeFields(ids[it->GetRowId()]), *it);
+    count++;
+  }
+  ASSERT_EQ(ids.size(), count);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
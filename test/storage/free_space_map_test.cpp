@@ -0,0 +1,170 @@
+#include <unordered_set>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "free_space_map_test.db";
+using Fields = std::vector<Field>;
+
+static void InsertRows(TableHeap *table_heap, int begin, int end, std::vector<RowId> &rids) {
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  for (int i = begin; i < end; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, sizeof(name), false)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+}
+
+TEST(FreeSpaceMapTest, ReopenTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  std::vector<RowId> rids;
+  const int n = 2000;
+
+  auto db_01 = new DBStorageEngine(db_name, true);
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("t", schema.get(), nullptr, table_info));
+  auto first_page_id = table_info->GetTableHeap()->GetFirstPageId();
+  InsertRows(table_info->GetTableHeap(), 0, n, rids);
+  // new pages go to the tail, the first page never moves
+  ASSERT_EQ(first_page_id, table_info->GetTableHeap()->GetFirstPageId());
+  ASSERT_NE(INVALID_PAGE_ID, table_info->GetTableHeap()->GetFsmPageId());
+  // empty one page completely, its space has to be handed out again
+  page_id_t freed_page_id = rids[n / 2].GetPageId();
+  for (auto &rid : rids) {
+    if (rid.GetPageId() == freed_page_id) table_info->GetTableHeap()->ApplyDelete(rid, nullptr);
+  }
+  delete db_01;
+
+  auto db_02 = new DBStorageEngine(db_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("t", table_info));
+  auto table_heap = table_info->GetTableHeap();
+  ASSERT_EQ(first_page_id, table_heap->GetFirstPageId());
+  std::vector<RowId> new_rids;
+  InsertRows(table_heap, n, n + 1, new_rids);
+  ASSERT_EQ(freed_page_id, new_rids[0].GetPageId());
+  std::unordered_set<RowId> all;
+  table_heap->FetchAllIds(all);
+  size_t deleted = 0;
+  for (auto &rid : rids) deleted += rid.GetPageId() == freed_page_id;
+  ASSERT_EQ(n - deleted + 1, all.size());
+  delete db_02;
+}
+
+TEST(FreeSpaceMapTest, BuildOnFirstUseTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  DBStorageEngine engine(db_name);
+  std::vector<RowId> rids;
+  auto table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  InsertRows(table_heap, 0, 500, rids);
+  for (auto &rid : rids) {
+    if (rid.GetPageId() == rids[0].GetPageId()) table_heap->ApplyDelete(rid, nullptr);
+  }
+
+  table_heap->ReleaseInsertPage();
+
+  // a heap without a map, as written before free space maps existed
+  auto old_heap = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), INVALID_PAGE_ID, schema.get(), nullptr,
+                                    nullptr, &heap);
+  ASSERT_EQ(INVALID_PAGE_ID, old_heap->GetFsmPageId());
+  // a scan reads the chain and leaves the map to the first write
+  size_t deleted = 0;
+  for (auto &rid : rids) deleted += rid.GetPageId() == rids[0].GetPageId();
+  std::unordered_set<RowId> all;
+  old_heap->FetchAllIds(all);
+  ASSERT_EQ(500 - deleted, all.size());
+  ASSERT_EQ(INVALID_PAGE_ID, old_heap->GetFsmPageId());
+  std::vector<RowId> new_rids;
+  InsertRows(old_heap, 500, 501, new_rids);
+  ASSERT_NE(INVALID_PAGE_ID, old_heap->GetFsmPageId());
+  ASSERT_EQ(rids[0].GetPageId(), new_rids[0].GetPageId());
+  all.clear();
+  old_heap->FetchAllIds(all);
+  ASSERT_EQ(500 - deleted + 1, all.size());
+}
+
+TEST(FreeSpaceMapTest, RootWrittenBackTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  std::vector<RowId> rids;
+
+  auto db_01 = new DBStorageEngine(db_name, true);
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("t", schema.get(), nullptr, table_info));
+  auto table_heap = table_info->GetTableHeap();
+  InsertRows(table_heap, 0, 200, rids);
+  auto first_page_id = table_heap->GetFirstPageId();
+  // the heap gets a new first page and a new map, the old first page is taken by something else
+  table_heap->FreeHeap();
+  page_id_t taken = INVALID_PAGE_ID;
+  ASSERT_NE(nullptr, db_01->bpm_->NewPage(taken));
+  db_01->bpm_->UnpinPage(taken, true);
+  rids.clear();
+  InsertRows(table_heap, 200, 300, rids);
+  ASSERT_NE(first_page_id, table_heap->GetFirstPageId());
+  table_heap->ReleaseInsertPage();
+  // crash: pages are written back but the catalog is never shut down
+  delete db_01->bpm_;
+  delete db_01->disk_mgr_;
+
+  auto db_02 = new DBStorageEngine(db_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("t", table_info));
+  std::unordered_set<RowId> all;
+  table_info->GetTableHeap()->FetchAllIds(all);
+  ASSERT_EQ(rids.size(), all.size());
+  for (auto &rid : rids) ASSERT_TRUE(all.count(rid));
+  delete db_02;
+}
+
+TEST(FreeSpaceMapTest, LoadOnDemandTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  std::vector<RowId> rids;
+
+  auto db_01 = new DBStorageEngine(db_name, true);
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("t", schema.get(), nullptr, table_info));
+  // enough pages for the map to take more than one page
+  int n = 0;
+  std::unordered_set<page_id_t> pages;
+  while (pages.size() <= FreeSpacePage::MAX_ENTRY_COUNT + 10) {
+    InsertRows(table_info->GetTableHeap(), n, n + 100, rids);
+    n += 100;
+    for (auto &rid : rids) pages.insert(rid.GetPageId());
+  }
+  delete db_01;
+
+  // a page listed on the second map page is emptied before that map page was needed
+  auto db_02 = new DBStorageEngine(db_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("t", table_info));
+  auto table_heap = table_info->GetTableHeap();
+  page_id_t emptied_page_id = rids.back().GetPageId();
+  size_t deleted = 0;
+  for (auto &rid : rids) {
+    if (rid.GetPageId() != emptied_page_id) continue;
+    table_heap->ApplyDelete(rid, nullptr);
+    deleted++;
+  }
+  std::vector<RowId> new_rids;
+  InsertRows(table_heap, n, n + 1, new_rids);
+  ASSERT_EQ(emptied_page_id, new_rids[0].GetPageId());
+  std::unordered_set<RowId> all;
+  table_heap->FetchAllIds(all);
+  ASSERT_EQ(n - deleted + 1, all.size());
+  delete db_02;
+}
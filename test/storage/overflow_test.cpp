@@ -0,0 +1,215 @@
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/row_view.h"
+#include "record/scan_predicate.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "overflow_test.db";
+using Fields = std::vector<Field>;
+
+/**
+ * Body of row i, one in three is short enough to stay inline
+ */
+static std::string BodyOf(int i, int version = 0) {
+  std::string prefix = std::to_string(i % 50) + "-" + std::to_string(i) + "-" + std::to_string(version);
+  size_t size = i % 3 == 0 ? 20 : 200 + (i * 37) % 1600;
+  return prefix + std::string(size, static_cast<char>('a' + i % 26));
+}
+
+static Fields MakeFields(int i, int version = 0) {
+  std::string body = BodyOf(i, version);
+  std::string note = "note" + std::to_string(i);
+  return Fields{Field(TypeId::kTypeInt, i),
+                Field(TypeId::kTypeChar, const_cast<char *>(body.c_str()), body.size(), true),
+                Field(TypeId::kTypeChar, const_cast<char *>(note.c_str()), note.size(), true)};
+}
+
+static std::shared_ptr<Schema> MakeSchema(SimpleMemHeap &heap) {
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("body", TypeId::kTypeChar, 2000, 1, true, false),
+                                   ALLOC_COLUMN(heap)("note", TypeId::kTypeChar, 32, 2, true, false)};
+  return std::make_shared<Schema>(columns);
+}
+
+static void ExpectRow(TableHeap *table_heap, const RowId &rid, int i, int version = 0) {
+  Row row(rid);
+  ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+  ASSERT_FALSE(row.HasOverflow());
+  Fields expected = MakeFields(i, version);
+  for (uint32_t j = 0; j < expected.size(); j++) {
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(j)->CompareEquals(expected[j])) << "row " << i;
+  }
+}
+
+/**
+ * First page of the overflow chain of the body of rid, INVALID_PAGE_ID if it is inline
+ */
+static page_id_t ChainOf(BufferPoolManager *bpm, Schema *schema, const RowId &rid) {
+  auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(rid.GetPageId()));
+  RowView view(page->GetTupleData(rid.GetSlotNum()), schema);
+  page_id_t chain = view.IsOverflow(1) ? view.GetOverflow(1).page_id : INVALID_PAGE_ID;
+  bpm->UnpinPage(rid.GetPageId(), false);
+  return chain;
+}
+
+TEST(OverflowTest, LongCharsRoundTripTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 600;
+  auto schema = MakeSchema(heap);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+
+  std::unordered_map<RowId, int> rows;
+  std::unordered_set<page_id_t> pages;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields = MakeFields(i);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    ASSERT_FALSE(row.HasOverflow());
+    rows[row.GetRowId()] = i;
+    pages.insert(row.GetRowId().GetPageId());
+  }
+  table_heap->ReleaseInsertPage();
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  // the rows keep a reference in place of their long bodies, many of them share a page
+  ASSERT_LT(pages.size(), static_cast<size_t>(row_nums / 40));
+  for (auto &it : rows) ExpectRow(table_heap, it.first, it.second);
+
+  // a scan that leaves out the body does not read it
+  size_t count = 0;
+  for (auto it = table_heap->Begin(nullptr, {0, 2}); it != table_heap->End(); ++it) {
+    int i = rows.at(it->GetRowId());
+    ASSERT_EQ(i % 3 != 0, it->IsOverflow(1));
+    ASSERT_FALSE(it->IsOverflow(2));
+    ASSERT_EQ(CmpBool::kTrue, it->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+    count++;
+  }
+  ASSERT_EQ(rows.size(), count);
+  for (auto it = table_heap->Begin(nullptr, {1}); it != table_heap->End(); ++it) {
+    ASSERT_FALSE(it->HasOverflow());
+    ASSERT_EQ(CmpBool::kTrue, it->GetField(1)->CompareEquals(MakeFields(rows.at(it->GetRowId()))[1]));
+  }
+  Row projected(rows.begin()->first);
+  ASSERT_TRUE(table_heap->GetTuple(&projected, nullptr, {0}));
+  ASSERT_EQ(rows.begin()->second % 3 != 0, projected.IsOverflow(1));
+
+  // predicates on the body compare the whole chars, stored inline or not
+  for (int key : {1, 3, 302, 599}) {
+    Field field(MakeFields(key)[1]);
+    for (auto op : {CompareOp::kEq, CompareOp::kNe, CompareOp::kGt, CompareOp::kLe}) {
+      std::unordered_set<RowId> expected;
+      for (auto &it : rows) {
+        Field body(MakeFields(it.second)[1]);
+        CmpBool match = op == CompareOp::kEq   ? body.CompareEquals(field)
+                        : op == CompareOp::kNe ? body.CompareNotEquals(field)
+                        : op == CompareOp::kGt ? body.CompareGreaterThan(field)
+                                               : body.CompareLessThanEquals(field);
+        if (match == CmpBool::kTrue) expected.insert(it.first);
+      }
+      std::unordered_set<RowId> found;
+      table_heap->FetchId(found, *ScanPredicate::Create(schema.get(), 1, op, field));
+      ASSERT_EQ(expected, found) << "op " << static_cast<int>(op) << " key " << key;
+    }
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(OverflowTest, UpdateDeleteVacuumReopenTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 900;
+  auto schema = MakeSchema(heap);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields = MakeFields(i);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  table_heap->ReleaseInsertPage();
+
+  // an update writes a chain of its own and frees the one it replaces
+  std::unordered_map<int, int> versions;
+  for (int i = 1; i < row_nums; i += 9) {
+    page_id_t old_chain = ChainOf(engine.bpm_, schema.get(), rids[i]);
+    ASSERT_NE(INVALID_PAGE_ID, old_chain);
+    Fields fields = MakeFields(i, 1);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->UpdateTuple(row, rids[i], nullptr));
+    ASSERT_TRUE(engine.bpm_->IsPageFree(old_chain));
+    versions[i] = 1;
+    ExpectRow(table_heap, rids[i], i, 1);
+  }
+
+  // a delete frees the chain, keep one row in four
+  std::unordered_map<RowId, int> rows;
+  for (int i = 0; i < row_nums; i++) {
+    if (i % 4 == 0) {
+      rows[rids[i]] = i;
+      continue;
+    }
+    page_id_t chain = ChainOf(engine.bpm_, schema.get(), rids[i]);
+    table_heap->ApplyDelete(rids[i], nullptr);
+    if (chain != INVALID_PAGE_ID) {
+      ASSERT_TRUE(engine.bpm_->IsPageFree(chain));
+    }
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+
+  // summarize every page, so that the zones of the pages rows move to are in use
+  std::unordered_set<RowId> all;
+  table_heap->FetchAllIds(all);
+  ASSERT_EQ(rows.size(), all.size());
+
+  // the moved rows keep their chains and are reported whole
+  uint32_t moves = 0;
+  auto moved = [&](Row &row, const RowId &old_rid) {
+    ASSERT_FALSE(row.HasOverflow());
+    int i = rows.at(old_rid);
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(MakeFields(i, versions[i])[1]));
+    rows.erase(old_rid);
+    rows[row.GetRowId()] = i;
+    moves++;
+  };
+  ASSERT_GT(table_heap->Vacuum(nullptr, moved), 0u);
+  ASSERT_GT(moves, 0u);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  for (auto &it : rows) ExpectRow(table_heap, it.first, it.second, versions[it.second]);
+
+  // the zones took in the long bodies of the moved rows, not the references, an equality query finds them
+  for (auto &it : rows) {
+    Field body(MakeFields(it.second, versions[it.second])[1]);
+    std::unordered_set<RowId> found;
+    table_heap->FetchId(found, *ScanPredicate::Create(schema.get(), 1, CompareOp::kEq, body));
+    ASSERT_EQ(1u, found.count(it.first)) << "row " << it.second;
+  }
+
+  // a reopened heap reads the chains from disk
+  TableHeap *reopened = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), table_heap->GetFsmPageId(),
+                                          schema.get(), nullptr, nullptr, &heap);
+  size_t count = 0;
+  for (auto it = reopened->Begin(nullptr); it != reopened->End(); ++it) {
+    int i = rows.at(it->GetRowId());
+    ASSERT_EQ(CmpBool::kTrue, it->GetField(1)->CompareEquals(MakeFields(i, versions[i])[1]));
+    count++;
+  }
+  ASSERT_EQ(rows.size(), count);
+
+  // freeing the heap frees the chains
+  std::vector<page_id_t> chains;
+  for (auto &it : rows) {
+    page_id_t chain = ChainOf(engine.bpm_, schema.get(), it.first);
+    if (chain != INVALID_PAGE_ID) chains.push_back(chain);
+  }
+  ASSERT_FALSE(chains.empty());
+  reopened->FreeHeap();
+  for (auto chain : chains) ASSERT_TRUE(engine.bpm_->IsPageFree(chain));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
@@ -1,5 +1,6 @@
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
@@ -54,3 +55,189 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
 }
 
+
+TEST(TableHeapTest, AppendTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 100000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  page_id_t last_page_id = INVALID_PAGE_ID;
+  size_t page_count = 0;
+  // a bulk load keeps filling the held page
+  table_heap->HoldInsertPage();
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeFloat, 1.5f * i)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    // rows of a fresh heap fill the pages one after another
+    if (row.GetRowId().GetPageId() != last_page_id) {
+      last_page_id = row.GetRowId().GetPageId();
+      page_count++;
+    }
+  }
+  table_heap->ReleaseInsertPage();
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+
+  std::unordered_set<RowId> rids;
+  table_heap->FetchAllIds(rids);
+  ASSERT_EQ(static_cast<size_t>(row_nums), rids.size());
+  std::unordered_set<page_id_t> pages;
+  for (auto &rid : rids) pages.insert(rid.GetPageId());
+  ASSERT_EQ(page_count, pages.size());
+
+  // other inserts leave no page pinned
+  Fields fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeFloat, 0.5f)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, ParallelScanTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 50000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  std::unordered_set<RowId> all_rids;
+  std::unordered_set<RowId> small_rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeFloat, 1.5f * i)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    all_rids.insert(row.GetRowId());
+    if (i < row_nums / 3) small_rids.insert(row.GetRowId());
+  }
+
+  // more workers than cores, so that the morsels are really shared
+  for (uint32_t workers : {1u, 3u, 8u}) {
+    table_heap->SetScanWorkers(workers);
+    std::unordered_set<RowId> rids;
+    table_heap->FetchAllIds(rids);
+    ASSERT_EQ(all_rids, rids);
+    rids.clear();
+    auto predicate = ScanPredicate::Create(schema.get(), 0, CompareOp::kLt, Field(TypeId::kTypeInt, row_nums / 3));
+    table_heap->FetchId(rids, *predicate);
+    ASSERT_EQ(small_rids, rids);
+  }
+  table_heap->ReleaseInsertPage();
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, PredicateScanTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 3000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name" + std::to_string(i % 97);
+    Fields fields{Field(TypeId::kTypeInt, i % 101),
+                  i % 7 == 0 ? Field(TypeId::kTypeChar)
+                             : Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.length(), true),
+                  i % 5 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, 0.5f * (i % 89))};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  char name[] = "name42";
+  Fields keys{Field(TypeId::kTypeInt, 50), Field(TypeId::kTypeChar, name, strlen(name), false),
+              Field(TypeId::kTypeFloat, 20.f)};
+  std::vector<std::pair<CompareOp, std::function<bool(const Field &, const Field &)>>> ops = {
+          {CompareOp::kEq, [](const Field &a, const Field &b) { return a.CompareEquals(b) == CmpBool::kTrue; }},
+          {CompareOp::kNe, [](const Field &a, const Field &b) { return a.CompareNotEquals(b) == CmpBool::kTrue; }},
+          {CompareOp::kLt, [](const Field &a, const Field &b) { return a.CompareLessThan(b) == CmpBool::kTrue; }},
+          {CompareOp::kLe, [](const Field &a, const Field &b) { return a.CompareLessThanEquals(b) == CmpBool::kTrue; }},
+          {CompareOp::kGt, [](const Field &a, const Field &b) { return a.CompareGreaterThan(b) == CmpBool::kTrue; }},
+          {CompareOp::kGe,
+           [](const Field &a, const Field &b) { return a.CompareGreaterThanEquals(b) == CmpBool::kTrue; }},
+          {CompareOp::kIsNull, [](const Field &a, const Field &b) { return a.IsNull(); }},
+          {CompareOp::kNotNull, [](const Field &a, const Field &b) { return !a.IsNull(); }}};
+  for (uint32_t column = 0; column < 3; column++) {
+    for (auto &op : ops) {
+      std::unordered_set<RowId> expected;
+      for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+        if (op.second(*it->GetField(column), keys[column])) expected.insert(it->GetRowId());
+      }
+      std::unordered_set<RowId> rids;
+      table_heap->FetchId(rids, *ScanPredicate::Create(schema.get(), column, op.first, keys[column]));
+      ASSERT_EQ(expected, rids) << "column " << column << " op " << static_cast<int>(op.first);
+    }
+  }
+  // nothing compares with null
+  std::unordered_set<RowId> rids;
+  table_heap->FetchId(rids, *ScanPredicate::Create(schema.get(), 0, CompareOp::kNe, Field(TypeId::kTypeInt)));
+  ASSERT_TRUE(rids.empty());
+  table_heap->ReleaseInsertPage();
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, IteratorTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  ASSERT_TRUE(table_heap->Begin(nullptr) == table_heap->End());
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name" + std::to_string(i);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()),
+                                                    name.length(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  // empty the first page and a page in the middle, the iterator has to skip them
+  page_id_t first_page_id = rids.front().GetPageId();
+  page_id_t middle_page_id = rids[row_nums / 2].GetPageId();
+  std::unordered_set<int> deleted;
+  for (int i = 0; i < row_nums; i++) {
+    if (rids[i].GetPageId() == first_page_id || rids[i].GetPageId() == middle_page_id) {
+      table_heap->ApplyDelete(rids[i], nullptr);
+      deleted.insert(i);
+    }
+  }
+  table_heap->ReleaseInsertPage();
+
+  std::unordered_map<RowId, int> ids;
+  for (int i = 0; i < row_nums; i++) ids[rids[i]] = i;
+  int count = 0;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    ASSERT_EQ(1, ids.count((*it).GetRowId()));
+    int id = ids[(*it).GetRowId()];
+    ASSERT_EQ(0, deleted.count(id));
+    ASSERT_EQ(CmpBool::kTrue, it->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+    std::string name = "name" + std::to_string(id);
+    ASSERT_EQ(name, std::string(it->GetField(1)->GetData(), it->GetField(1)->GetLength()));
+    count++;
+  }
+  ASSERT_EQ(row_nums - deleted.size(), count);
+
+  // copies pin the page on their own and move independently
+  {
+    auto it = table_heap->Begin(nullptr);
+    auto copy = it++;
+    ASSERT_TRUE(copy != it);
+    ++copy;
+    ASSERT_TRUE(copy == it);
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
@@ -0,0 +1,199 @@
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "vacuum_test.db";
+using Fields = std::vector<Field>;
+
+static Fields MakeFields(int i, size_t name_size) {
+  std::string name = std::to_string(i) + std::string(name_size, 'x');
+  return Fields{Field(TypeId::kTypeInt, i),
+                Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+}
+
+static void ExpectRow(TableHeap *table_heap, const RowId &rid, int i, size_t name_size) {
+  Row row(rid);
+  ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+  Fields expected = MakeFields(i, name_size);
+  for (uint32_t j = 0; j < expected.size(); j++) {
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(j)->CompareEquals(expected[j])) << "row " << i;
+  }
+}
+
+TEST(VacuumTest, PageCompactionTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 256, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  page_id_t page_id;
+  auto page = reinterpret_cast<TablePage *>(engine.bpm_->NewPage(page_id));
+  page->Init(page_id, INVALID_PAGE_ID, nullptr, nullptr);
+
+  // fill the page
+  std::vector<RowId> rids;
+  std::unordered_map<uint32_t, std::pair<int, size_t>> contents;
+  for (int i = 0;; i++) {
+    Fields fields = MakeFields(i, 40);
+    Row row(fields);
+    if (!page->InsertTuple(row, schema.get(), nullptr, nullptr, nullptr)) break;
+    rids.push_back(row.GetRowId());
+    contents[row.GetRowId().GetSlotNum()] = {i, 40};
+  }
+  ASSERT_GT(rids.size(), 10u);
+  auto check = [&]() {
+    for (auto &it : contents) {
+      Row row(RowId(page_id, it.first));
+      ASSERT_TRUE(page->GetTuple(&row, schema.get(), nullptr, nullptr));
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(MakeFields(it.second.first, it.second.second)[1]));
+    }
+  };
+
+  // deletes leave holes that count as free space, the last slots leave the directory
+  int64_t full_remain = page->GetRemain();
+  for (size_t i = 1; i < rids.size(); i += 2) {
+    page->ApplyDelete(rids[i], nullptr, nullptr);
+    contents.erase(rids[i].GetSlotNum());
+  }
+  ASSERT_LT(page->GetRemain(), full_remain);
+  ASSERT_EQ(rids.size() % 2 == 0 ? rids.size() - 1 : rids.size(), page->GetTupleCount());
+  check();
+
+  // a grown row is placed in the holes, its rid stays
+  Fields grown = MakeFields(-1, 200);
+  Row grown_row(grown);
+  Row old_row(rids[0]);
+  ASSERT_TRUE(page->UpdateTuple(grown_row, &old_row, schema.get(), nullptr, nullptr, nullptr));
+  contents[rids[0].GetSlotNum()] = {-1, 200};
+  check();
+
+  // new rows reuse the free slots before the directory grows
+  std::unordered_set<uint32_t> reused;
+  for (int i = 1000;; i++) {
+    Fields fields = MakeFields(i, 40);
+    Row row(fields);
+    if (!page->InsertTuple(row, schema.get(), nullptr, nullptr, nullptr)) break;
+    reused.insert(row.GetRowId().GetSlotNum());
+    contents[row.GetRowId().GetSlotNum()] = {i, 40};
+  }
+  for (auto slot : reused) ASSERT_EQ(1u, slot % 2);
+  ASSERT_GE(reused.size() + 5, rids.size() / 2);
+  check();
+  engine.bpm_->UnpinPage(page_id, true);
+}
+
+static void HeapVacuumTest(TableLayout layout) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 6000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 24, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap, layout);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields = MakeFields(i, 16);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  table_heap->ReleaseInsertPage();
+  std::unordered_set<page_id_t> pages;
+  for (auto &rid : rids) pages.insert(rid.GetPageId());
+
+  // keep one row in five, one of them with a delete that is not applied yet
+  std::unordered_map<RowId, int> kept;
+  for (int i = 0; i < row_nums; i++) {
+    if (i % 5 == 0) {
+      kept[rids[i]] = i;
+    } else {
+      table_heap->ApplyDelete(rids[i], nullptr);
+    }
+  }
+  RowId pending = rids[row_nums - 5];
+  ASSERT_TRUE(table_heap->MarkDelete(pending, nullptr));
+  kept.erase(pending);
+
+  uint32_t moves = 0;
+  uint32_t freed = table_heap->Vacuum(nullptr, [&](Row &row, const RowId &old_rid) {
+    ASSERT_EQ(1u, kept.count(old_rid));
+    ASSERT_EQ(0u, kept.count(row.GetRowId()));
+    kept[row.GetRowId()] = kept[old_rid];
+    kept.erase(old_rid);
+    moves++;
+  });
+  ASSERT_GT(moves, 0u);
+  ASSERT_GT(freed, pages.size() / 2);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+
+  // the freed pages are back with the disk manager, the rest hold every kept row
+  std::unordered_set<page_id_t> left;
+  for (auto page_id : pages) {
+    if (engine.bpm_->IsPageFree(page_id)) continue;
+    left.insert(page_id);
+  }
+  ASSERT_EQ(pages.size() - freed, left.size());
+  ASSERT_EQ(1u, left.count(table_heap->GetFirstPageId()));
+  ASSERT_EQ(1u, left.count(pending.GetPageId()));
+  for (auto &it : kept) {
+    ASSERT_EQ(1u, left.count(it.first.GetPageId()));
+    ExpectRow(table_heap, it.first, it.second, 16);
+  }
+  std::unordered_set<RowId> all;
+  table_heap->FetchAllIds(all);
+  ASSERT_EQ(kept.size(), all.size());
+  table_heap->RollbackDelete(pending, nullptr);
+  kept[pending] = row_nums - 5;
+
+  // the chain and the free space map agree after a reopen, inserts go to the pages left
+  TableHeap *reopened = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), table_heap->GetFsmPageId(),
+                                          schema.get(), nullptr, nullptr, &heap, layout);
+  size_t count = 0;
+  for (auto it = reopened->Begin(nullptr); it != reopened->End(); ++it) {
+    ASSERT_EQ(1u, kept.count(it->GetRowId()));
+    count++;
+  }
+  ASSERT_EQ(kept.size(), count);
+  for (int i = row_nums; i < row_nums + 100; i++) {
+    Fields fields = MakeFields(i, 16);
+    Row row(fields);
+    ASSERT_TRUE(reopened->InsertTuple(row, nullptr));
+    kept[row.GetRowId()] = i;
+  }
+  reopened->ReleaseInsertPage();
+  all.clear();
+  reopened->FetchAllIds(all);
+  ASSERT_EQ(kept.size(), all.size());
+  for (auto &it : kept) ExpectRow(reopened, it.first, it.second, 16);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+
+  // new pages take the map slots of the freed ones instead of growing the map
+  auto map_count = [&]() {
+    auto fsm_page = reinterpret_cast<FreeSpacePage *>(engine.bpm_->FetchPage(reopened->GetFsmPageId())->GetData());
+    uint32_t count = fsm_page->GetCount();
+    engine.bpm_->UnpinPage(reopened->GetFsmPageId(), false);
+    return count;
+  };
+  uint32_t slots = map_count();
+  std::unordered_set<page_id_t> grown;
+  for (int i = row_nums + 100; i < row_nums + 100 + row_nums / 2; i++) {
+    Fields fields = MakeFields(i, 16);
+    Row row(fields);
+    ASSERT_TRUE(reopened->InsertTuple(row, nullptr));
+    if (left.count(row.GetRowId().GetPageId()) == 0) grown.insert(row.GetRowId().GetPageId());
+  }
+  reopened->ReleaseInsertPage();
+  ASSERT_GT(grown.size(), 0u);
+  ASSERT_LE(grown.size(), freed);
+  ASSERT_EQ(slots, map_count());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(VacuumTest, RowHeapTest) { HeapVacuumTest(TableLayout::kRow); }
+
+TEST(VacuumTest, ColumnHeapTest) { HeapVacuumTest(TableLayout::kColumn); }
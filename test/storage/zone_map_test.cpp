@@ -0,0 +1,166 @@
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "zone_map_test.db";
+using Fields = std::vector<Field>;
+
+static std::vector<std::pair<CompareOp, std::function<bool(const Field &, const Field &)>>> Ops() {
+  return {{CompareOp::kEq, [](const Field &a, const Field &b) { return a.CompareEquals(b) == CmpBool::kTrue; }},
+          {CompareOp::kNe, [](const Field &a, const Field &b) { return a.CompareNotEquals(b) == CmpBool::kTrue; }},
+          {CompareOp::kLt, [](const Field &a, const Field &b) { return a.CompareLessThan(b) == CmpBool::kTrue; }},
+          {CompareOp::kLe, [](const Field &a, const Field &b) { return a.CompareLessThanEquals(b) == CmpBool::kTrue; }},
+          {CompareOp::kGt, [](const Field &a, const Field &b) { return a.CompareGreaterThan(b) == CmpBool::kTrue; }},
+          {CompareOp::kGe,
+           [](const Field &a, const Field &b) { return a.CompareGreaterThanEquals(b) == CmpBool::kTrue; }},
+          {CompareOp::kIsNull, [](const Field &a, const Field &b) { return a.IsNull(); }},
+          {CompareOp::kNotNull, [](const Field &a, const Field &b) { return !a.IsNull(); }}};
+}
+
+static Fields MakeFields(int i) {
+  // ids and names grow with i, names share a prefix longer than the zones keep
+  char name[32];
+  snprintf(name, sizeof(name), "customer-%06d", i);
+  return Fields{Field(TypeId::kTypeInt, i),
+                i % 11 == 0 ? Field(TypeId::kTypeChar) : Field(TypeId::kTypeChar, name, strlen(name), true),
+                Field(TypeId::kTypeFloat, 0.25f * (i % 400))};
+}
+
+TEST(ZoneMapTest, CharBoundTest) {
+  // a zone never rules out a value it summarizes
+  std::vector<std::string> values = {"", "a", "abcdefgh", "abcdefghij", "abcdefghzz", "abcdefgi", "b", "zzzzzzzzzzzz"};
+  std::vector<std::string> keys = values;
+  keys.insert(keys.end(), {"abcdefg", "abcdefghi", "abcdefghzzz", "abcdefgj", "c"});
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 0, true, false)};
+  Schema schema(columns);
+  for (uint32_t begin = 0; begin < values.size(); begin++) {
+    for (uint32_t end = begin + 1; end <= values.size(); end++) {
+      ColumnZone zone;
+      for (uint32_t i = begin; i < end; i++) {
+        zone.Add(Field(TypeId::kTypeChar, const_cast<char *>(values[i].data()), values[i].size(), false));
+      }
+      for (auto &key : keys) {
+        Field key_field(TypeId::kTypeChar, const_cast<char *>(key.data()), key.size(), false);
+        for (auto &op : Ops()) {
+          bool any = false;
+          for (uint32_t i = begin; i < end; i++) {
+            any |= op.second(Field(TypeId::kTypeChar, const_cast<char *>(values[i].data()), values[i].size(), false),
+                             key_field);
+          }
+          if (any) {
+            ASSERT_TRUE(ScanPredicate::Create(&schema, 0, op.first, key_field)->MayMatch(zone))
+                << "values [" << begin << ", " << end << ") key " << key << " op " << static_cast<int>(op.first);
+          }
+        }
+      }
+    }
+  }
+}
+
+static void CheckScans(TableHeap *table_heap, Schema *schema) {
+  char name[] = "customer-001500";
+  for (auto &key : {Fields{Field(TypeId::kTypeInt, 1500), Field(TypeId::kTypeChar, name, strlen(name), false),
+                           Field(TypeId::kTypeFloat, 20.f)},
+                    Fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, name, 9, false),
+                           Field(TypeId::kTypeFloat, 200.f)}}) {
+    for (uint32_t column = 0; column < 3; column++) {
+      for (auto &op : Ops()) {
+        std::unordered_set<RowId> expected;
+        for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+          if (op.second(*it->GetField(column), key[column])) expected.insert(it->GetRowId());
+        }
+        std::unordered_set<RowId> rids;
+        table_heap->FetchId(rids, *ScanPredicate::Create(schema, column, op.first, key[column]));
+        ASSERT_EQ(expected, rids) << "column " << column << " op " << static_cast<int>(op.first);
+      }
+    }
+  }
+}
+
+static void ZoneMapHeapTest(TableLayout layout) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap, layout);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields = MakeFields(i);
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  table_heap->ReleaseInsertPage();
+  std::unordered_set<page_id_t> pages;
+  for (auto &rid : rids) pages.insert(rid.GetPageId());
+  ASSERT_GT(pages.size(), 10u);
+
+  // ids are appended in order, a range is found on the page or two holding it
+  auto count_pages = [&](const ScanPredicate &predicate) {
+    size_t count = 0;
+    for (auto page_id : pages) count += table_heap->GetZoneMap().MayMatch(page_id, predicate);
+    return count;
+  };
+  auto range = ScanPredicate::Create(schema.get(), 0, CompareOp::kGe, Field(TypeId::kTypeInt, row_nums - 10));
+  ASSERT_LE(count_pages(*range), 2u);
+  ASSERT_LE(count_pages(*ScanPredicate::Create(schema.get(), 0, CompareOp::kEq, Field(TypeId::kTypeInt, 2500))), 2u);
+  ASSERT_EQ(0u, count_pages(*ScanPredicate::Create(schema.get(), 0, CompareOp::kLt, Field(TypeId::kTypeInt, 0))));
+  ASSERT_EQ(0u, count_pages(*ScanPredicate::Create(schema.get(), 0, CompareOp::kIsNull, Field(TypeId::kTypeInt))));
+  CheckScans(table_heap, schema.get());
+
+  // updates widen the zone of their page
+  Fields fields = MakeFields(-100);
+  Row updated(fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(updated, rids[1000], nullptr));
+  auto negative = ScanPredicate::Create(schema.get(), 0, CompareOp::kLt, Field(TypeId::kTypeInt, 0));
+  ASSERT_EQ(1u, count_pages(*negative));
+  std::unordered_set<RowId> found;
+  table_heap->FetchId(found, *negative);
+  ASSERT_EQ(std::unordered_set<RowId>{rids[1000]}, found);
+
+  // a page whose tuples are all deleted is passed over by any predicate, a rolled back delete counts again
+  auto first_page = rids[0].GetPageId();
+  auto not_null = ScanPredicate::Create(schema.get(), 0, CompareOp::kNotNull, Field(TypeId::kTypeInt));
+  size_t deleted = 0;
+  for (; rids[deleted].GetPageId() == first_page; deleted++) {
+    ASSERT_TRUE(table_heap->MarkDelete(rids[deleted], nullptr));
+  }
+  ASSERT_EQ(pages.size() - 1, count_pages(*not_null));
+  table_heap->RollbackDelete(rids[0], nullptr);
+  ASSERT_EQ(pages.size(), count_pages(*not_null));
+  ASSERT_TRUE(table_heap->MarkDelete(rids[0], nullptr));
+  for (size_t i = 0; i < deleted; i++) table_heap->ApplyDelete(rids[i], nullptr);
+  ASSERT_EQ(pages.size() - 1, count_pages(*not_null));
+  // an undone insert leaves the zone as well
+  table_heap->ApplyDelete(rids[row_nums - 1], nullptr);
+  deleted++;
+  CheckScans(table_heap, schema.get());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+
+  // a heap read again is summarized by its first scan
+  TableHeap *reopened = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), table_heap->GetFsmPageId(),
+                                          schema.get(), nullptr, nullptr, &heap, layout);
+  for (auto page_id : pages) ASSERT_FALSE(reopened->GetZoneMap().IsSummarized(page_id));
+  std::unordered_set<RowId> all;
+  reopened->FetchAllIds(all);
+  ASSERT_EQ(row_nums - deleted, all.size());
+  for (auto page_id : pages) ASSERT_TRUE(reopened->GetZoneMap().IsSummarized(page_id));
+  size_t matches = 0;
+  for (auto page_id : pages) matches += reopened->GetZoneMap().MayMatch(page_id, *range);
+  ASSERT_EQ(count_pages(*range), matches);
+  CheckScans(reopened, schema.get());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(ZoneMapTest, RowHeapTest) { ZoneMapHeapTest(TableLayout::kRow); }
+
+TEST(ZoneMapTest, ColumnHeapTest) { ZoneMapHeapTest(TableLayout::kColumn); }